@@ -35,6 +35,8 @@
 #include "../src/runtime/dso_library.cc"
 #include "../src/runtime/thread_pool.cc"
 #include "../src/runtime/object.cc"
+#include "../src/runtime/memory.cc"
+#include "../src/runtime/mapped_params.cc"
 #include "../src/runtime/threading_backend.cc"
 #include "../src/runtime/ndarray.cc"
 
@@ -0,0 +1,70 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Benchmark of the memory planned for the graph runtime by the two planners.
+
+The pool planner shares whole storages between tensors of similar sizes, the
+arena planner places every tensor at an offset in one arena, packing the
+lifetimes and the sizes. The lower bound is the peak of the bytes live at the
+same time, which no placement can go below.
+"""
+import argparse
+import json
+
+from tvm import relay
+from tvm.relay import testing
+
+
+def get_network(name, batch_size):
+    if name.startswith("resnet"):
+        return testing.resnet.get_workload(num_layers=int(name.split("-")[1]),
+                                           batch_size=batch_size)
+    if name.startswith("vgg"):
+        return testing.vgg.get_workload(num_layers=int(name.split("-")[1]),
+                                        batch_size=batch_size)
+    if name == "mobilenet":
+        return testing.mobilenet.get_workload(batch_size=batch_size)
+    if name == "inception_v3":
+        return testing.inception_v3.get_workload(batch_size=batch_size)
+    raise ValueError("Unsupported network: " + name)
+
+
+def benchmark(networks, batch_size, opt_level):
+    print("%-14s %14s %14s %14s %10s" % ("network", "pool(MB)", "arena(MB)",
+                                         "lower(MB)", "saving"))
+    for name in networks:
+        mod, params = get_network(name, batch_size)
+        with relay.build_config(opt_level=opt_level):
+            mod, _ = relay.optimize(mod, "llvm", params)
+        report = json.loads(relay.backend._backend.GraphMemoryPlanReport(mod["main"]))
+        mb = 1.0 / (1 << 20)
+        print("%-14s %14.2f %14.2f %14.2f %9.1f%%" % (
+            name, report["pool_bytes"] * mb, report["arena_bytes"] * mb,
+            report["lower_bound_bytes"] * mb,
+            100.0 * (1 - report["arena_bytes"] / report["pool_bytes"])))
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--network", type=str, nargs="+",
+                        default=["resnet-18", "resnet-50", "mobilenet", "vgg-16"],
+                        help="The networks, resnet-<layers>, vgg-<layers>, mobilenet or "
+                        "inception_v3")
+    parser.add_argument("--batch-size", type=int, default=1)
+    parser.add_argument("--opt-level", type=int, default=3)
+    args = parser.parse_args()
+
+    benchmark(args.network, args.batch_size, args.opt_level)
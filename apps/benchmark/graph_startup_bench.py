@@ -0,0 +1,79 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Benchmark of the startup time of the graph runtime with the json and the binary graph.
+
+The startup time is the time to create the runtime from the graph and the
+built library, which parses the graph, allocates the storage and resolves the
+functions of the nodes. A chain of operators makes a graph with an arbitrary
+number of nodes, most of them calling the same functions.
+"""
+import argparse
+import timeit
+
+import tvm
+from tvm import relay
+from tvm.contrib import graph_runtime
+from tvm.relay import testing
+
+
+def chain_network(num_layers):
+    """A chain of num_layers dense layers with alternating activations."""
+    x = relay.var("data", shape=(1, 64))
+    y = x
+    for i in range(num_layers):
+        w = relay.var("w%d" % i, shape=(64, 64))
+        y = relay.nn.dense(y, w)
+        y = relay.nn.relu(y) if i % 2 == 0 else relay.sigmoid(y)
+    mod = tvm.IRModule.from_expr(relay.Function(relay.analysis.free_vars(y), y))
+    return testing.create_workload(mod["main"])
+
+
+def benchmark(network, num_layers, repeat):
+    if network == "chain":
+        mod, params = chain_network(num_layers)
+    else:
+        mod, params = testing.resnet.get_workload(num_layers=int(network.split("-")[1]))
+    with relay.build_config(opt_level=3):
+        bld_mod = relay.build_module.BuildModule()
+        graph, lib, params = bld_mod.build(mod, "llvm", params=params)
+        binary = bld_mod.get_graph_binary()
+    num_nodes = graph.count('"op"')
+    ctx = tvm.cpu(0)
+
+    def startup(data):
+        return min(timeit.repeat(lambda: graph_runtime.create(data, lib, ctx),
+                                 number=1, repeat=repeat))
+
+    json_time = startup(graph)
+    binary_time = startup(binary)
+    print("%s: %d nodes" % (network, num_nodes))
+    print("%-8s %12s %14s" % ("format", "size(KB)", "startup(ms)"))
+    print("%-8s %12.1f %14.2f" % ("json", len(graph) / 1024, json_time * 1e3))
+    print("%-8s %12.1f %14.2f" % ("binary", len(binary) / 1024, binary_time * 1e3))
+    print("speedup %.2fx" % (json_time / binary_time))
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--network", type=str, default="chain",
+                        help="'chain' or resnet-<num_layers>")
+    parser.add_argument("--num-layers", type=int, default=5000,
+                        help="The number of layers of the chain network")
+    parser.add_argument("--repeat", type=int, default=10)
+    args = parser.parse_args()
+
+    benchmark(args.network, args.num_layers, args.repeat)
@@ -0,0 +1,72 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Compare the json and the binary serialization of IR modules.
+
+The parameters of the network are bound into the module as constants, so the
+tensors are part of the serialized data as they are in a compile cache.
+"""
+import argparse
+import timeit
+
+import tvm
+from tvm import relay
+from tvm.relay import testing
+
+
+def get_module(network, batch_size):
+    """Get a module with the parameters bound as constants."""
+    if network == "mlp":
+        mod, params = testing.mlp.get_workload(batch_size=batch_size)
+    elif network == "resnet-18":
+        mod, params = testing.resnet.get_workload(num_layers=18, batch_size=batch_size)
+    elif network == "mobilenet":
+        mod, params = testing.mobilenet.get_workload(batch_size=batch_size)
+    else:
+        raise ValueError("Unsupported network: " + network)
+    func = relay.build_module.bind_params_by_name(mod["main"], params)
+    return tvm.IRModule.from_expr(func)
+
+
+def benchmark(network, batch_size, repeat):
+    mod = get_module(network, batch_size)
+    json_str = tvm.ir.save_json(mod)
+    blob = tvm.ir.save_binary(mod)
+    assert tvm.ir.structural_equal(tvm.ir.load_binary(blob), tvm.ir.load_json(json_str))
+
+    def measure(func):
+        return min(timeit.repeat(func, number=1, repeat=repeat))
+
+    print("%-8s %12s %12s %12s" % ("format", "size (MB)", "save (ms)", "load (ms)"))
+    print("%-8s %12.2f %12.2f %12.2f" % (
+        "json", len(json_str) / 2.0**20,
+        measure(lambda: tvm.ir.save_json(mod)) * 1e3,
+        measure(lambda: tvm.ir.load_json(json_str)) * 1e3))
+    print("%-8s %12.2f %12.2f %12.2f" % (
+        "binary", len(blob) / 2.0**20,
+        measure(lambda: tvm.ir.save_binary(mod)) * 1e3,
+        measure(lambda: tvm.ir.load_binary(blob)) * 1e3))
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--network", type=str, default="resnet-18",
+                        choices=["mlp", "resnet-18", "mobilenet"])
+    parser.add_argument("--batch-size", type=int, default=1)
+    parser.add_argument("--repeat", type=int, default=5)
+    args = parser.parse_args()
+
+    benchmark(args.network, args.batch_size, args.repeat)
@@ -0,0 +1,100 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Measure structural hashing of networks with and without a hash cache.
+
+A pass typically rebuilds a few nodes of a function and hashes the result
+again. The benchmark hashes the function, then a copy of it where one call
+close to the output is rebuilt, which shares every other node with the
+original.
+"""
+import argparse
+import timeit
+
+import tvm
+from tvm import relay
+from tvm.relay import testing
+
+
+def get_function(network, batch_size):
+    """Get the main function of a network."""
+    if network == "mlp":
+        mod, _ = testing.mlp.get_workload(batch_size=batch_size)
+    elif network == "resnet-50":
+        mod, _ = testing.resnet.get_workload(num_layers=50, batch_size=batch_size)
+    elif network == "inception_v3":
+        mod, _ = testing.inception_v3.get_workload(batch_size=batch_size)
+    elif network == "densenet":
+        mod, _ = testing.densenet.get_workload(batch_size=batch_size)
+    else:
+        raise ValueError("Unsupported network: " + network)
+    return mod["main"]
+
+
+def rebuild_output(func):
+    """Rebuild the output call of a function, sharing its arguments."""
+    body = func.body
+    if isinstance(body, relay.Call):
+        body = relay.Call(body.op, body.args, body.attrs, body.type_args)
+    else:
+        body = relay.Tuple([body])
+    return relay.Function(func.params, body, func.ret_type, func.type_params, func.attrs)
+
+
+def benchmark(network, batch_size, repeat):
+    func = get_function(network, batch_size)
+    changed = rebuild_output(func)
+
+    def measure(fn):
+        return min(timeit.repeat(fn, number=1, repeat=repeat)) * 1e3
+
+    def hash_again():
+        cache = tvm.ir.StructuralHashCache(max_entries=1 << 24)
+        tvm.ir.structural_hash(func, cache=cache)
+        return lambda: tvm.ir.structural_hash(func, cache=cache)
+
+    def hash_changed():
+        cache = tvm.ir.StructuralHashCache(max_entries=1 << 24)
+        tvm.ir.structural_hash(func, cache=cache)
+        return lambda: tvm.ir.structural_hash(changed, cache=cache)
+
+    expect = tvm.ir.structural_hash(changed)
+    cache = tvm.ir.StructuralHashCache(max_entries=1 << 24)
+    tvm.ir.structural_hash(func, cache=cache)
+    assert tvm.ir.structural_hash(changed, cache=cache) == expect
+
+    print("%-24s %12s" % ("case", "time (ms)"))
+    print("%-24s %12.3f" % ("no cache", measure(lambda: tvm.ir.structural_hash(func))))
+    print("%-24s %12.3f" % (
+        "cold cache", measure(lambda: tvm.ir.structural_hash(
+            func, cache=tvm.ir.StructuralHashCache()))))
+    # The warm cases measure one call on a cache filled by the function.
+    print("%-24s %12.3f" % ("same function", min(
+        timeit.repeat(hash_again(), number=1, repeat=repeat)) * 1e3))
+    print("%-24s %12.3f" % ("changed output", min(
+        timeit.timeit(hash_changed(), number=1) for _ in range(repeat)) * 1e3))
+    print("cached subterms: %d" % len(cache))
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--network", type=str, default="resnet-50",
+                        choices=["mlp", "resnet-50", "inception_v3", "densenet"])
+    parser.add_argument("--batch-size", type=int, default=1)
+    parser.add_argument("--repeat", type=int, default=5)
+    args = parser.parse_args()
+
+    benchmark(args.network, args.batch_size, args.repeat)
@@ -0,0 +1,86 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Throughput and latency of the Relay VM batching server.
+
+The benchmark serves a multi layer perceptron with a dynamic batch dimension
+and sweeps the maximum batch size and the latency budget of the server, with
+concurrent clients that each send single sample requests one after another.
+Every row is a point of the throughput vs. latency curve.
+"""
+import argparse
+
+import numpy as np
+
+import tvm
+from tvm import relay
+from tvm.runtime import vm as vm_rt
+
+
+def mlp_module(num_layers, hidden, dtype="float32"):
+    """Build a multi layer perceptron with a dynamic batch dimension."""
+    data = relay.var("data", shape=(relay.Any(), hidden), dtype=dtype)
+    out = data
+    for i in range(num_layers):
+        weight = relay.const(np.random.uniform(-0.1, 0.1, (hidden, hidden)).astype(dtype))
+        out = relay.nn.relu(relay.nn.dense(out, weight))
+        if i == num_layers - 1:
+            out = relay.nn.softmax(out)
+    mod = tvm.IRModule()
+    mod["main"] = relay.Function([data], out)
+    return mod
+
+
+def benchmark(args):
+    exe = relay.vm.compile(mlp_module(args.layers, args.hidden), args.target)
+    ctx = tvm.context(args.target, 0)
+    data = np.random.uniform(size=(1, args.hidden)).astype("float32")
+    print("%-10s %-12s %-8s %12s %10s %12s %12s %12s" %
+          ("max_batch", "latency_us", "clients", "requests/s", "batch",
+           "p50_us", "p99_us", "max_us"))
+    for max_batch_size in args.max_batch_sizes:
+        for max_latency_us in args.max_latencies_us:
+            server = vm_rt.BatchingServer(exe, ctx, max_batch_size=max_batch_size,
+                                          max_latency_us=max_latency_us,
+                                          num_workers=args.workers)
+            for num_clients in args.clients:
+                # Warm up the workers and the allocator.
+                server.benchmark(data, num_clients=num_clients, num_requests=5)
+                report = server.benchmark(data, num_clients=num_clients,
+                                          num_requests=args.requests)
+                print("%-10d %-12d %-8d %12.1f %10.2f %12.1f %12.1f %12.1f" %
+                      (max_batch_size, max_latency_us, num_clients,
+                       report["requests_per_sec"], report["mean_batch_requests"],
+                       report["p50_latency_us"], report["p99_latency_us"],
+                       report["max_latency_us"]))
+            del server
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--target", type=str, default="llvm")
+    parser.add_argument("--layers", type=int, default=4)
+    parser.add_argument("--hidden", type=int, default=1024)
+    parser.add_argument("--workers", type=int, default=1,
+                        help="The number of VMs running batches at once")
+    parser.add_argument("--max-batch-sizes", type=int, nargs="+", default=[1, 8, 32])
+    parser.add_argument("--max-latencies-us", type=int, nargs="+", default=[0, 500, 2000])
+    parser.add_argument("--clients", type=int, nargs="+", default=[1, 8, 32])
+    parser.add_argument("--requests", type=int, default=200,
+                        help="The number of requests of each client")
+    args = parser.parse_args()
+
+    benchmark(args)
@@ -0,0 +1,86 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Micro-benchmark of the dispatch cost of the Relay VM interpreter.
+
+The benchmark runs a recursive count down loop made of scalar kernels, so the
+time of each iteration is dominated by the interpreter rather than the kernels.
+The cost per instruction is estimated from the instruction count of the loop
+function.
+"""
+import argparse
+import re
+import timeit
+
+import numpy as np
+
+import tvm
+from tvm import relay
+from tvm.runtime import vm as vm_rt
+from tvm.relay.scope_builder import ScopeBuilder
+
+
+def count_down_module():
+    """Build a module which counts down from its argument to zero."""
+    mod = tvm.IRModule({})
+    count_down = relay.GlobalVar('count_down')
+    i = relay.var('i', shape=[], dtype='int32')
+    sb = ScopeBuilder()
+    with sb.if_scope(relay.equal(i, relay.const(0, dtype='int32'))):
+        sb.ret(i)
+    with sb.else_scope():
+        one_less = relay.subtract(i, relay.const(1, dtype='int32'))
+        sb.ret(relay.Call(count_down, [one_less]))
+    mod[count_down] = relay.Function([i], sb.get(), ret_type=relay.TensorType([], 'int32'))
+    iarg = relay.var('i', shape=[], dtype='int32')
+    mod["main"] = relay.Function([iarg], count_down(iarg))
+    return mod
+
+
+def instruction_count(bytecode, func_name):
+    """Get the number of instructions of a function from the bytecode."""
+    match = re.search(r"VM Function\[\d+\]: %s\(.*\)\n# reg file size = \d+\n"
+                      r"# instruction count = (\d+)" % func_name, bytecode)
+    assert match, "cannot find function %s in the bytecode" % func_name
+    return int(match.group(1))
+
+
+def benchmark(iterations, repeat):
+    exe = relay.vm.compile(count_down_module(), "llvm")
+    vm = vm_rt.VirtualMachine(exe)
+    vm.init(tvm.cpu())
+    num_instrs = instruction_count(exe.bytecode, "count_down")
+
+    def run(n):
+        data = np.array(n, dtype='int32')
+        vm.invoke("main", data)
+        return min(timeit.repeat(lambda: vm.invoke("main", data), number=1, repeat=repeat))
+
+    # Subtract the cost of invoking the VM from the outside.
+    per_iter = (run(iterations) - run(0)) / iterations
+    print("%-20s %.2f us" % ("per iteration", per_iter * 1e6))
+    print("%-20s %.2f ns (~%d instructions per iteration)" %
+          ("per instruction", per_iter * 1e9 / num_instrs, num_instrs))
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--iterations", type=int, default=1000,
+                        help="The depth of the count down loop")
+    parser.add_argument("--repeat", type=int, default=10)
+    args = parser.parse_args()
+
+    benchmark(args.iterations, args.repeat)
@@ -33,5 +33,7 @@
 #include "../../src/runtime/thread_pool.cc"
 #include "../../src/runtime/ndarray.cc"
 #include "../../src/runtime/object.cc"
+#include "../../src/runtime/memory.cc"
+#include "../../src/runtime/mapped_params.cc"
 #include "../../src/runtime/system_library.cc"
 #include "../../src/runtime/graph/graph_runtime.cc"
@@ -35,6 +35,8 @@
 #include "../../../src/runtime/dso_library.cc"
 #include "../../../src/runtime/ndarray.cc"
 #include "../../../src/runtime/object.cc"
+#include "../../../src/runtime/memory.cc"
+#include "../../../src/runtime/mapped_params.cc"
 
 // RPC server
 #include "../../../src/runtime/rpc/rpc_session.cc"
@@ -124,6 +124,7 @@ set(USE_LLVM OFF)
 # Contrib libraries
 #---------------------------------------------
 # Whether use BLAS, choices: openblas, mkl, atlas, apple
+# builtin serves the cblas functions with a built-in gemm without linking a BLAS
 set(USE_BLAS none)
 
 # /path/to/mkl: mkl root path when use mkl blas library
@@ -16,7 +16,8 @@
 # under the License.
 
 # Plugin rules for cblas
-file(GLOB CBLAS_CONTRIB_SRC src/runtime/contrib/cblas/*.cc)
+file(GLOB CBLAS_CONTRIB_SRC src/runtime/contrib/cblas/cblas.cc)
+file(GLOB BUILTIN_BLAS_CONTRIB_SRC src/runtime/contrib/cblas/builtin_gemm.cc)
 
 if(USE_BLAS STREQUAL "openblas")
   find_library(BLAS_LIBRARY openblas)
@@ -50,6 +51,9 @@ elseif(USE_BLAS STREQUAL "apple")
   list(APPEND TVM_RUNTIME_LINKER_LIBS ${BLAS_LIBRARY})
   list(APPEND RUNTIME_SRCS ${CBLAS_CONTRIB_SRC})
   message(STATUS "Use BLAS library " ${BLAS_LIBRARY})
+elseif(USE_BLAS STREQUAL "builtin")
+  list(APPEND RUNTIME_SRCS ${BUILTIN_BLAS_CONTRIB_SRC})
+  message(STATUS "Use the built-in gemm for the cblas functions")
 elseif(USE_BLAS STREQUAL "none")
   # pass
 else()
@@ -32,6 +32,8 @@
 #include "src/runtime/thread_pool.cc"
 #include "src/runtime/ndarray.cc"
 #include "src/runtime/object.cc"
+#include "src/runtime/memory.cc"
+#include "src/runtime/mapped_params.cc"
 
 // NOTE: all the files after this are optional modules
 // that you can include remove, depending on how much feature you use.
@@ -32,6 +32,7 @@
 #include <unordered_map>
 #include <memory>
 #include <limits>
+#include <utility>
 
 namespace tvm {
 /*! \brief namespace of arithmetic analysis. */
@@ -155,6 +156,8 @@ class ConstIntBoundAnalyzer {
   std::function<void()> EnterConstraint(const PrimExpr& constraint);
   struct Entry;
   class Impl;
+  /*! \brief The parent analyzer, which memoizes the results. */
+  Analyzer* parent_;
   /*! \brief Internal impl */
   Impl* impl_;
 };
@@ -348,6 +351,10 @@ class ConstraintContext {
   PrimExpr constraint_;
   /*! \brief function to be called in recovery */
   std::function<void()> exit_;
+  /*! \brief The context version of the analyzer when entering the scope. */
+  uint64_t saved_version_{0};
+  /*! \brief The number of updates of the analyzer when entering the scope. */
+  uint64_t saved_update_count_{0};
 };
 
 /*!
@@ -383,6 +390,14 @@ class IntSetAnalyzer {
  * NOTE for sub-analyzer developers:
  * If the analyzer uses memoization, we need to clear the internal
  * cache when information about a Var has been overridden.
+ *
+ * The analyzer memoizes Simplify, CanProve and const_int_bound by
+ * expression identity. Each result is tagged with the version of the
+ * context (the bound vars and the entered constraints) it was computed
+ * in, and only hits while that version is current. Leaving a constraint
+ * scope in which no var was bound makes the outer version current again.
+ * A sub-analyzer that changes the information of a Var outside of Bind
+ * must call UpdateContextVersion.
  */
 class Analyzer {
  public:
@@ -460,6 +475,75 @@ class Analyzer {
    * \note Analyzer will call into sub-analyzers to get the result.
    */
   PrimExpr Simplify(const PrimExpr& expr);
+  /*!
+   * \brief Set the maximum number of memoized expressions.
+   *
+   *  The memo is cleared when it is full. 0 disables the memoization.
+   *
+   * \param capacity The maximum number of expressions.
+   */
+  void SetMemoCapacity(size_t capacity);
+  /*! \return The number of calls answered from the memo. */
+  uint64_t memo_hits() const {
+    return memo_hits_;
+  }
+  /*! \return The number of memoizable calls that missed the memo. */
+  uint64_t memo_misses() const {
+    return memo_misses_;
+  }
+  /*!
+   * \brief Notify that the information of a var has changed,
+   *  so that the memoized results are no longer used.
+   */
+  void UpdateContextVersion();
+
+ private:
+  friend class ConstIntBoundAnalyzer;
+  friend class ConstraintContext;
+  /*! \brief The memoized results of an expression in one context version. */
+  struct MemoEntry {
+    /*! \brief The expression, kept alive as its address is in the key. */
+    PrimExpr expr;
+    /*! \brief The result of Simplify, undefined if unknown. */
+    PrimExpr simplified;
+    /*! \brief The result of const_int_bound, undefined if unknown. */
+    ConstIntBound bound;
+    /*! \brief The result of CanProve, -1 if unknown. */
+    int proved{-1};
+  };
+  /*! \brief The expression and the context version of a memo entry. */
+  using MemoKey = std::pair<const Object*, uint64_t>;
+  /*! \brief Hash function of MemoKey. */
+  struct MemoKeyHash {
+    size_t operator()(const MemoKey& key) const {
+      return std::hash<const Object*>()(key.first) ^
+          std::hash<uint64_t>()(key.second * 0x9e3779b97f4a7c15ULL);
+    }
+  };
+  /*!
+   * \brief Look up the memo entry of expr in the current context.
+   * \return The entry, nullptr if expr is not memoized.
+   */
+  MemoEntry* FindMemo(const PrimExpr& expr);
+  /*!
+   * \brief Get the entry to store the results of expr computed in a version.
+   * \return The entry, nullptr if the context changed since then.
+   */
+  MemoEntry* StoreMemo(const PrimExpr& expr, uint64_t version);
+  /*! \brief The memoized results. */
+  std::unordered_map<MemoKey, MemoEntry, MemoKeyHash> memo_;
+  /*! \brief The maximum number of memoized expressions. */
+  size_t memo_capacity_{4096};
+  /*! \brief The version of the current context. */
+  uint64_t version_{0};
+  /*! \brief The last version that was handed out. */
+  uint64_t max_version_{0};
+  /*! \brief The number of calls to UpdateContextVersion. */
+  uint64_t update_count_{0};
+  /*! \brief The number of hits. */
+  uint64_t memo_hits_{0};
+  /*! \brief The number of misses. */
+  uint64_t memo_misses_{0};
 };
 
 }  // namespace arith
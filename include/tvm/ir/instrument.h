@@ -0,0 +1,212 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file tvm/ir/instrument.h
+ *
+ * Instruments observe the passes run under a PassContext. The context calls
+ * every instrument before and after each pass, including the Sequential
+ * passes, so the calls of the passes run by a Sequential are nested in its
+ * own calls.
+ *
+ * \code
+ *
+ *  auto timing = PassTimingInstrument(true);
+ *  auto ctx = PassContext::Create();
+ *  ctx->instruments = {timing};
+ *  {
+ *    With<PassContext> scope(ctx);
+ *    mod = seq(mod);
+ *  }
+ *  LOG(INFO) << timing->Render();
+ *
+ * \endcode
+ */
+#ifndef TVM_IR_INSTRUMENT_H_
+#define TVM_IR_INSTRUMENT_H_
+
+#include <tvm/ir/module.h>
+#include <tvm/runtime/container.h>
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace tvm {
+namespace transform {
+
+class PassInfo;
+
+/*!
+ * \brief The base class of pass instruments.
+ * \sa PassInstrument
+ */
+class PassInstrumentNode : public Object {
+ public:
+  /*! \brief The name of the instrument. */
+  String name;
+
+  virtual ~PassInstrumentNode() {}
+
+  /*!
+   * \brief Called before a pass runs.
+   * \param mod The module the pass runs on.
+   * \param info The pass information.
+   */
+  virtual void RunBeforePass(const IRModule& mod, const PassInfo& info) const = 0;
+
+  /*!
+   * \brief Called after a pass has run, also when the pass threw.
+   * \param mod The module the pass returned, undefined if the pass threw.
+   * \param info The pass information.
+   */
+  virtual void RunAfterPass(const IRModule& mod, const PassInfo& info) const = 0;
+
+  void VisitAttrs(AttrVisitor* v) {
+    v->Visit("name", &name);
+  }
+
+  static constexpr const char* _type_key = "transform.PassInstrument";
+  static constexpr bool _type_has_method_sequal_reduce = false;
+  TVM_DECLARE_BASE_OBJECT_INFO(PassInstrumentNode, Object);
+};
+
+/*!
+ * \brief Managed reference class for PassInstrumentNode
+ * \sa PassInstrumentNode
+ */
+class PassInstrument : public ObjectRef {
+ public:
+  TVM_DEFINE_OBJECT_REF_METHODS(PassInstrument, ObjectRef, PassInstrumentNode);
+};
+
+/*!
+ * \brief An instrument that records the wall time of each pass, the number
+ *  of IR nodes of the module before and after it and the objects made by it.
+ *
+ *  The records of the passes run by a Sequential are nested in its own. The
+ *  time spent counting the nodes is excluded from the wall times. Passes can
+ *  run under the instrument on several threads, the passes of each thread
+ *  are nested separately.
+ *
+ * \sa PassTimingInstrument
+ */
+class PassTimingInstrumentNode : public PassInstrumentNode {
+ public:
+  /*! \brief The record of one pass. */
+  struct Record {
+    /*! \brief The pass name. */
+    std::string name;
+    /*! \brief The wall time in microseconds, including the nested passes. */
+    double duration_us{0};
+    /*! \brief The nodes of the module before the pass, -1 if not counted. */
+    int64_t nodes_in{-1};
+    /*! \brief The nodes of the module after the pass, -1 if not counted. */
+    int64_t nodes_out{-1};
+    /*! \brief The objects made by the pass on its thread, including the nested passes. */
+    int64_t num_objects{0};
+    /*! \brief The bytes of the objects made by the pass. */
+    int64_t object_bytes{0};
+    /*! \brief The nested passes. */
+    std::vector<std::unique_ptr<Record> > children;
+  };
+
+  /*! \brief Whether to count the nodes of the module before and after each pass. */
+  bool count_nodes{true};
+
+  /*! \brief Enable the counting of the objects made by the passes while the instrument lives. */
+  TVM_DLL PassTimingInstrumentNode();
+  TVM_DLL ~PassTimingInstrumentNode();
+
+  void RunBeforePass(const IRModule& mod, const PassInfo& info) const final;
+
+  void RunAfterPass(const IRModule& mod, const PassInfo& info) const final;
+
+  /*! \brief Drop the records. */
+  TVM_DLL void Reset() const;
+
+  /*!
+   * \return The report as json, with the tree of the records under "passes"
+   *  and their times summed by pass name under "summary".
+   */
+  TVM_DLL std::string ToJSON() const;
+
+  /*! \return The report as a table of the records, indented by nesting. */
+  TVM_DLL std::string Render() const;
+
+  void VisitAttrs(AttrVisitor* v) {
+    PassInstrumentNode::VisitAttrs(v);
+    v->Visit("count_nodes", &count_nodes);
+  }
+
+  static constexpr const char* _type_key = "transform.PassTimingInstrument";
+  TVM_DECLARE_FINAL_OBJECT_INFO(PassTimingInstrumentNode, PassInstrumentNode);
+
+ private:
+  using Clock = std::chrono::high_resolution_clock;
+  /*! \brief A pass that has not returned yet. */
+  struct Frame {
+    /*! \brief The record of the pass. */
+    Record* record;
+    /*! \brief The time the pass started. */
+    Clock::time_point start;
+    /*! \brief The object counters of the thread when the pass started. */
+    int64_t num_objects;
+    int64_t object_bytes;
+    /*! \brief The time spent in the instrument by the nested passes. */
+    Clock::duration overhead{0};
+  };
+  /*! \brief The records of the passes that are not nested. */
+  mutable std::vector<std::unique_ptr<Record> > roots_;
+  /*! \brief The passes of each thread that have not returned. */
+  mutable std::unordered_map<std::thread::id, std::vector<Frame> > stacks_;
+  /*! \brief Protects the records. */
+  mutable std::mutex mutex_;
+};
+
+/*!
+ * \brief Managed reference class for PassTimingInstrumentNode
+ * \sa PassTimingInstrumentNode
+ */
+class PassTimingInstrument : public PassInstrument {
+ public:
+  /*!
+   * \brief Create a timing instrument.
+   * \param count_nodes Whether to count the nodes of the module before and after each pass.
+   */
+  TVM_DLL explicit PassTimingInstrument(bool count_nodes);
+
+  TVM_DEFINE_OBJECT_REF_METHODS(PassTimingInstrument, PassInstrument, PassTimingInstrumentNode);
+};
+
+/*!
+ * \brief Count the distinct nodes reachable from a module.
+ * \param mod The module.
+ * \return The number of nodes, including the containers.
+ */
+TVM_DLL int64_t CountIRNodes(const IRModule& mod);
+
+}  // namespace transform
+}  // namespace tvm
+
+#endif  // TVM_IR_INSTRUMENT_H_
@@ -60,6 +60,7 @@
 #include <tvm/runtime/container.h>
 #include <tvm/node/container.h>
 #include <tvm/ir/error.h>
+#include <tvm/ir/instrument.h>
 #include <tvm/ir/module.h>
 #include <string>
 #include <utility>
@@ -103,6 +104,21 @@ class PassContextNode : public Object {
 
   TraceFunc trace_func;
 
+  /*!
+   * \brief Whether the nodes made by a pass are allocated from a runtime::ObjectArena,
+   *  which function passes scope to each function.
+   */
+  bool use_object_arena{false};
+
+  /*!
+   * \brief Whether the graph runtime codegen places the storages of each device
+   *  in one arena at byte offsets, instead of sharing storages by size.
+   */
+  bool graph_memory_arena{false};
+
+  /*! \brief The instruments called before and after each pass. */
+  Array<PassInstrument> instruments;
+
   PassContextNode() = default;
 
   void VisitAttrs(AttrVisitor* v) {
@@ -110,6 +126,9 @@ class PassContextNode : public Object {
     v->Visit("fallback_device", &fallback_device);
     v->Visit("required_pass", &required_pass);
     v->Visit("disabled_pass", &disabled_pass);
+    v->Visit("use_object_arena", &use_object_arena);
+    v->Visit("graph_memory_arena", &graph_memory_arena);
+    v->Visit("instruments", &instruments);
   }
 
   static constexpr const char* _type_key = "transform.PassContext";
@@ -171,6 +190,28 @@ class PassContext : public ObjectRef {
    */
   TVM_DLL void Trace(const IRModule& module, const PassInfo& info, bool is_before) const;
 
+  /*!
+   * \brief Call the instruments of the context before a pass.
+   * \param module The IRModule the pass runs on.
+   * \param info The pass information.
+   */
+  TVM_DLL void InstrumentBeforePass(const IRModule& module, const PassInfo& info) const;
+
+  /*!
+   * \brief Call the instruments of the context after a pass, in the reverse order.
+   * \param module The IRModule the pass returned.
+   * \param info The pass information.
+   */
+  TVM_DLL void InstrumentAfterPass(const IRModule& module, const PassInfo& info) const;
+
+  /*!
+   * \brief Call the instruments of the context after a pass that threw, in the
+   *  reverse order, with an undefined module. The errors of the instruments are
+   *  logged so that the error of the pass propagates.
+   * \param info The pass information.
+   */
+  TVM_DLL void InstrumentAfterFailedPass(const PassInfo& info) const;
+
   // accessor.
   using ContainerType = PassContextNode;
   class Internal;
@@ -29,6 +29,10 @@
 
 #include <string>
 
+namespace dmlc {
+class Stream;
+}  // namespace dmlc
+
 namespace tvm {
 /*!
  * \brief save the node as well as all the node it depends on as json.
@@ -47,5 +51,26 @@ TVM_DLL std::string SaveJSON(const runtime::ObjectRef& node);
  */
 TVM_DLL runtime::ObjectRef LoadJSON(std::string json_str);
 
+/*!
+ * \brief save the node as well as all the node it depends on in binary.
+ *  The nodes are visited by the same reflection as SaveJSON, but integers
+ *  are varint encoded, strings are interned and arrays are stored raw,
+ *  which makes the result smaller and much faster to load.
+ *
+ * \param strm The output stream.
+ * \param node The node to save.
+ */
+TVM_DLL void SaveBinary(dmlc::Stream* strm, const runtime::ObjectRef& node);
+
+/*!
+ * \brief Load tvm Node object saved by SaveBinary.
+ *  Exactly the bytes written by SaveBinary are read, so other data can
+ *  follow the node in the stream.
+ * \param strm The input stream.
+ *
+ * \return The loaded node.
+ */
+TVM_DLL runtime::ObjectRef LoadBinary(dmlc::Stream* strm);
+
 }  // namespace tvm
 #endif  // TVM_NODE_SERIALIZATION_H_
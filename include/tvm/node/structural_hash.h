@@ -28,6 +28,8 @@
 #include <tvm/node/container.h>
 #include <string>
 #include <functional>
+#include <memory>
+#include <mutex>
 
 namespace tvm {
 
@@ -97,6 +99,75 @@ class StructuralHash : public BaseValueHash {
   TVM_DLL size_t operator()(const ObjectRef& key) const;
 };
 
+/*!
+ * \brief Structural hashes of subterms memoised across hash calls.
+ *
+ *  Hashing through a cache records the hash of each subterm together with
+ *  the state of the traversal it depends on: the counters of free vars and
+ *  graph nodes when it was entered, and the hashes of the nodes outside of
+ *  it that it refers to. A later hash that reaches the same subterm in the
+ *  same state reuses the recorded value instead of visiting it, so hashing
+ *  an object that shares most of its subterms with a hashed one only visits
+ *  the changed nodes and the subterms whose state they changed.
+ *
+ *  The hash values are the same as the ones of StructuralHash. The cache
+ *  keeps the hashed subterms alive until it is cleared, which happens
+ *  before a hash call once it holds more than max_entries subterms.
+ */
+class SHashCacheNode : public Object {
+ public:
+  /*! \brief The default bound on the number of memoised subterms. */
+  static constexpr size_t kDefaultMaxEntries = 1 << 16;
+  /*!
+   * \brief Create an empty cache.
+   * \param max_entries The number of memoised subterms that clears the cache.
+   */
+  explicit SHashCacheNode(size_t max_entries = kDefaultMaxEntries);
+  ~SHashCacheNode();
+  /*!
+   * \brief Compute the structural hash of an object through the cache.
+   * \param key The object to be hashed.
+   * \param map_free_vars Whether to map free variables by their occurence number.
+   * \return The hash value.
+   */
+  TVM_DLL size_t Hash(const ObjectRef& key, bool map_free_vars);
+  /*! \brief Drop all the memoised hashes. */
+  TVM_DLL void Clear();
+  /*! \return The number of memoised subterms. */
+  TVM_DLL size_t size() const;
+
+  static constexpr const char* _type_key = "node.SHashCache";
+  TVM_DECLARE_FINAL_OBJECT_INFO(SHashCacheNode, Object);
+
+ private:
+  friend class VarCountingSHashHandler;
+  struct Impl;
+  /*! \brief The memoised hashes. */
+  std::unique_ptr<Impl> impl_;
+  /*! \brief The number of memoised subterms that clears the cache. */
+  size_t max_entries_;
+  /*! \brief Serializes the hash calls. */
+  mutable std::mutex mutex_;
+};
+
+/*!
+ * \brief Managed reference to SHashCacheNode.
+ * \sa SHashCacheNode
+ */
+class SHashCache : public ObjectRef {
+ public:
+  /*!
+   * \brief Create an empty cache.
+   * \param max_entries The number of memoised subterms that clears the cache.
+   */
+  TVM_DLL explicit SHashCache(size_t max_entries = SHashCacheNode::kDefaultMaxEntries);
+  explicit SHashCache(ObjectPtr<Object> n) : ObjectRef(n) {}
+  SHashCacheNode* operator->() const {
+    return static_cast<SHashCacheNode*>(data_.get());
+  }
+  using ContainerType = SHashCacheNode;
+};
+
 /*!
  * \brief A Reducer class to reduce the structural hash value.
  *
@@ -38,12 +38,17 @@ struct AllocTensorAttrs : public tvm::AttrsNode<AllocTensorAttrs> {
   Constant const_shape;
   Array<IndexExpr> assert_shape;
   DataType dtype;
+  int64_t offset;
 
   TVM_DECLARE_ATTRS(AllocTensorAttrs, "relay.attrs.AllocTensorAttrs") {
     TVM_ATTR_FIELD(dtype)
       .describe(
          "The dtype of the tensor to allocate.")
       .set_default(DataType::Float(32, 1));
+    TVM_ATTR_FIELD(offset)
+      .describe(
+         "The offset in bytes of the tensor in the storage.")
+      .set_default(0);
     TVM_ATTR_FIELD(const_shape)
       .describe(
          "The shape of constant used to aid in type inference.");
@@ -142,6 +142,26 @@ TVM_DLL int TVMBackendParallelLaunch(FTVMParallelLambda flambda,
                                      void* cdata,
                                      int num_task);
 
+/*!
+ * \brief Backend function for running parallel jobs that never call
+ *  TVMBackendParallelBarrier.
+ *
+ *  When work stealing is enabled with runtime.config_threadpool_work_stealing
+ *  or TVM_THREAD_POOL_CHUNKS_PER_WORKER, a launch with num_task 0 is split into
+ *  more tasks than threads that idle threads steal from each other, so the
+ *  tasks of one launch do not all run at the same time.
+ *
+ * \param flambda The parallel function to be launched.
+ * \param cdata The closure data.
+ * \param num_task Number of tasks to launch, can be 0, means launch
+ *           with all available threads, or chunks when work stealing.
+ *
+ * \return 0 when no error is thrown, -1 when failure happens
+ */
+TVM_DLL int TVMBackendParallelLaunchBarrierFree(FTVMParallelLambda flambda,
+                                                void* cdata,
+                                                int num_task);
+
 /*!
  * \brief BSP barrrier between parallel threads
  * \param task_id the task id of the function.
@@ -24,9 +24,12 @@
 #define TVM_RUNTIME_MEMORY_H_
 
 #include <tvm/runtime/object.h>
+#include <atomic>
+#include <cstdint>
 #include <cstdlib>
 #include <utility>
 #include <type_traits>
+#include <vector>
 
 namespace tvm {
 namespace runtime {
@@ -45,10 +48,126 @@ inline ObjectPtr<T> make_object(Args&&... args);
 // allocator pattern when necessary.
 //
 // Possible future allocator optimizations:
-// - Arena allocator that gives ownership of memory to arena (deleter_= nullptr)
 // - Thread-local object pools: one pool per size and alignment requirement.
 // - Can specialize by type of object to give the specific allocator to each object.
 
+/*!
+ * \brief An arena the objects made on a thread are allocated from while it is in scope.
+ *
+ *  The objects are bump allocated in pages, so making the many short-lived
+ *  nodes of a pass does not go through the heap. A page counts its objects
+ *  plus one reference held by the arena: objects that escape the scope keep
+ *  their page alive and the page is freed with the last of them, while pages
+ *  whose objects were all deleted are reused as long as the arena is in scope.
+ *  Objects can be deleted on any thread.
+ *
+ * \code
+ *
+ *  {
+ *    ObjectArena arena;
+ *    // make_object on this thread allocates from arena.
+ *  }
+ *  // The objects that are still referenced stay valid.
+ *
+ * \endcode
+ */
+class ObjectArena {
+ public:
+  /*! \brief A page of objects. */
+  struct Page;
+  /*! \brief The counters of arenas. */
+  struct Stats {
+    /*! \brief The number of objects allocated from the arena. */
+    int64_t num_objects{0};
+    /*! \brief The bytes of the objects allocated from the arena. */
+    int64_t object_bytes{0};
+    /*! \brief The objects made in scope that were too large for a page. */
+    int64_t num_heap_objects{0};
+    /*! \brief The number of pages allocated from the heap. */
+    int64_t num_pages{0};
+    /*! \brief The number of pages reused after all their objects were deleted. */
+    int64_t num_reused_pages{0};
+    /*! \brief The number of pages kept alive by escaped objects when the arena exits. */
+    int64_t num_escaped_pages{0};
+  };
+  /*! \brief The size and alignment of a page. */
+  static constexpr size_t kPageSize = 64 << 10;
+  /*! \brief The largest object allocated from a page. */
+  static constexpr size_t kMaxObjectSize = kPageSize / 16;
+  /*! \brief Enter the scope of a new arena on this thread. */
+  TVM_DLL ObjectArena();
+  /*! \brief Exit the scope, the arena must be the innermost one of the thread. */
+  TVM_DLL ~ObjectArena();
+  ObjectArena(const ObjectArena&) = delete;
+  ObjectArena& operator=(const ObjectArena&) = delete;
+  /*!
+   * \brief Allocate the space of an object.
+   * \param size The size of the object, at most kMaxObjectSize.
+   * \param align The alignment of the object.
+   * \return The space, to be released by Free.
+   */
+  TVM_DLL void* Alloc(size_t size, size_t align);
+  /*! \brief Count an object made in scope on the heap. */
+  void AddHeapObject() {
+    ++stats_.num_heap_objects;
+  }
+  /*! \return The counters of this arena. */
+  const Stats& stats() const {
+    return stats_;
+  }
+  /*!
+   * \brief Release the space of an object allocated by any arena.
+   * \param ptr The space returned by Alloc.
+   */
+  TVM_DLL static void Free(void* ptr);
+  /*! \return The innermost arena in scope on this thread, nullptr if none. */
+  TVM_DLL static ObjectArena* Current();
+  /*!
+   * \brief Count an object made on this thread, see ThreadObjectCounts.
+   * \param size The size of the object.
+   * \return The innermost arena in scope on this thread, nullptr if none.
+   */
+  TVM_DLL static ObjectArena* CountObject(size_t size);
+  /*!
+   * \return Whether an arena is in scope or the counting is enabled on any thread.
+   *  When neither is, make_object goes straight to the heap.
+   */
+  static bool Tracking() {
+    return num_trackers_.load(std::memory_order_relaxed) != 0;
+  }
+  /*!
+   * \brief Enable or disable the counting of the objects made on every thread.
+   *  The calls nest, the counting stays enabled until each enable is disabled.
+   * \param enable Whether to enable the counting.
+   */
+  TVM_DLL static void EnableCounting(bool enable);
+  /*!
+   * \brief Get the counters of the objects made on this thread while the counting
+   *  was enabled or an arena was in scope.
+   * \param num_objects The number of objects.
+   * \param object_bytes The bytes of the objects.
+   */
+  TVM_DLL static void ThreadObjectCounts(int64_t* num_objects, int64_t* object_bytes);
+  /*! \return The counters summed over the arenas that have exited. */
+  TVM_DLL static Stats GlobalStats();
+
+ private:
+  /*! \brief Get a page to allocate from, a reused one if possible. */
+  Page* NewPage();
+  /*! \brief The arenas in scope plus the enabled countings, over all threads. */
+  TVM_DLL static std::atomic<int> num_trackers_;
+  /*! \brief The enclosing arena of the thread. */
+  ObjectArena* prev_{nullptr};
+  /*! \brief The page that is allocated from. */
+  Page* page_{nullptr};
+  /*! \brief The full pages, the candidates for reuse. */
+  std::vector<Page*> full_pages_;
+  /*! \brief The next full page checked for reuse. */
+  size_t next_reuse_{0};
+  /*! \brief The counters. */
+  Stats stats_;
+};
+
 /*!
  * \brief Base class of object allocators that implements make.
  *  Use curiously recurring template pattern.
@@ -198,13 +317,94 @@ class SimpleObjAllocator :
   };
 };
 
+// Allocator that draws from the arena in scope.
+class ArenaObjAllocator :
+      public ObjAllocatorBase<ArenaObjAllocator> {
+ public:
+  explicit ArenaObjAllocator(ObjectArena* arena) : arena_(arena) {}
+
+  template<typename T>
+  class Handler {
+   public:
+    template<typename... Args>
+    static T* New(ArenaObjAllocator* self, Args&&... args) {
+      void* data = self->arena_->Alloc(sizeof(T), alignof(T));
+      new (data) T(std::forward<Args>(args)...);
+      return static_cast<T*>(data);
+    }
+
+    static Object::FDeleter Deleter() {
+      return Deleter_;
+    }
+
+   private:
+    static void Deleter_(Object* objptr) {
+      T* tptr = static_cast<T*>(objptr);
+      tptr->T::~T();
+      ObjectArena::Free(tptr);
+    }
+  };
+
+  // Array handler that places the elements after the array header.
+  template<typename ArrayType, typename ElemType>
+  class ArrayHandler {
+   public:
+    static_assert(alignof(ArrayType) % alignof(ElemType) == 0 &&
+                  sizeof(ArrayType) % alignof(ElemType) == 0,
+                  "element alignment constraint");
+
+    template<typename... Args>
+    static ArrayType* New(ArenaObjAllocator* self, size_t num_elems, Args&&... args) {
+      void* data = self->arena_->Alloc(
+          sizeof(ArrayType) + num_elems * sizeof(ElemType), alignof(ArrayType));
+      new (data) ArrayType(std::forward<Args>(args)...);
+      return static_cast<ArrayType*>(data);
+    }
+
+    static Object::FDeleter Deleter() {
+      return Deleter_;
+    }
+
+   private:
+    static void Deleter_(Object* objptr) {
+      ArrayType* tptr = static_cast<ArrayType*>(objptr);
+      tptr->ArrayType::~ArrayType();
+      ObjectArena::Free(tptr);
+    }
+  };
+
+ private:
+  ObjectArena* arena_;
+};
+
 template<typename T, typename... Args>
 inline ObjectPtr<T> make_object(Args&&... args) {
+  if (!ObjectArena::Tracking()) {
+    return SimpleObjAllocator().make_object<T>(std::forward<Args>(args)...);
+  }
+  if (ObjectArena* arena = ObjectArena::CountObject(sizeof(T))) {
+    if (sizeof(T) <= ObjectArena::kMaxObjectSize) {
+      return ArenaObjAllocator(arena).make_object<T>(std::forward<Args>(args)...);
+    }
+    arena->AddHeapObject();
+  }
   return SimpleObjAllocator().make_object<T>(std::forward<Args>(args)...);
 }
 
 template<typename ArrayType, typename ElemType, typename... Args>
 inline ObjectPtr<ArrayType> make_inplace_array_object(size_t num_elems, Args&&... args) {
+  size_t size = sizeof(ArrayType) + num_elems * sizeof(ElemType);
+  if (!ObjectArena::Tracking()) {
+    return SimpleObjAllocator().make_inplace_array<ArrayType, ElemType>(
+      num_elems, std::forward<Args>(args)...);
+  }
+  if (ObjectArena* arena = ObjectArena::CountObject(size)) {
+    if (size <= ObjectArena::kMaxObjectSize) {
+      return ArenaObjAllocator(arena).make_inplace_array<ArrayType, ElemType>(
+          num_elems, std::forward<Args>(args)...);
+    }
+    arena->AddHeapObject();
+  }
   return SimpleObjAllocator().make_inplace_array<ArrayType, ElemType>(
     num_elems, std::forward<Args>(args)...);
 }
@@ -44,6 +44,7 @@
 #define TVM_RUNTIME_REGISTRY_H_
 
 #include <tvm/runtime/packed_func.h>
+#include <atomic>
 #include <string>
 #include <vector>
 #include <utility>
@@ -51,7 +52,24 @@
 namespace tvm {
 namespace runtime {
 
-/*! \brief Registry for global function */
+/*!
+ * \brief Registry for global function
+ *
+ *  The lookups do not lock, so that the threads of a server can look up
+ *  functions while others register them. A name keeps the same registry
+ *  entry for the life of the process, through removals and registrations,
+ *  so callers on hot paths can intern the name once and skip the lookup.
+ *  Each body set on an entry is published as a new function that is never
+ *  changed. The function a registration or removal replaces is freed after
+ *  a grace period of a few seconds, so a function pointer that was looked
+ *  up stays valid for the calls in progress. Callers that keep a function
+ *  across registrations should copy the PackedFunc or intern the name.
+ *
+ * \code
+ *   static const Registry* fconfig = Registry::Intern("runtime.config_threadpool");
+ *   if (const PackedFunc* f = fconfig->function()) (*f)(1, 4);
+ * \endcode
+ */
 class Registry {
  public:
   /*!
@@ -237,11 +255,14 @@ class Registry {
    * \brief Register a function with given name
    * \param name The name of the function.
    * \param override Whether allow oveeride existing function.
+   *  The overridden function is freed after a grace period, pointers to it
+   *  returned by Get or function() must not be used after that.
    * \return Reference to theregistry.
    */
   TVM_DLL static Registry& Register(const std::string& name, bool override = false);  // NOLINT(*)
   /*!
    * \brief Erase global function from registry, if exist.
+   *  The function is freed after a grace period, as on an override.
    * \param name The name of the function.
    * \return Whether function exist.
    */
@@ -253,6 +274,23 @@ class Registry {
    *   nullptr if it does not exist.
    */
   TVM_DLL static const PackedFunc* Get(const std::string& name);  // NOLINT(*)
+  /*!
+   * \brief Get the entry of a name, adding it unregistered if it does not exist.
+   * \param name The name of the function.
+   * \return The entry, valid for the life of the process.
+   */
+  TVM_DLL static const Registry* Intern(const std::string& name);
+  /*!
+   * \return The function registered under the name of the entry,
+   *   nullptr if it is not registered.
+   */
+  const PackedFunc* function() const {
+    return func_.load(std::memory_order_acquire);
+  }
+  /*! \return The name of the entry. */
+  const std::string& name() const {
+    return name_;
+  }
   /*!
    * \brief Get the names of currently registered global function.
    * \return The names
@@ -265,8 +303,12 @@ class Registry {
  protected:
   /*! \brief name of the function */
   std::string name_;
-  /*! \brief internal packed function */
-  PackedFunc func_;
+  /*! \brief The published function, nullptr if the name is not registered. */
+  std::atomic<const PackedFunc*> func_{nullptr};
+  /*! \brief The hash of the name. */
+  size_t hash_{0};
+  /*! \brief Whether the name is registered, guarded by the mutex of the manager. */
+  bool registered_{false};
   friend struct Manager;
 };
 
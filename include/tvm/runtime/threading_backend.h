@@ -76,10 +76,16 @@ class ThreadGroup {
    *        If  `true`, worker0 will not be launched in a new thread and
    *        `worker_callback` will only be called for values >= 1. This
    *        allows use of the main thread as a worker.
+   * \param core_offset The position in the sorted core order of the first core
+   *        to bind to, or -1 to spread the workers over all the cores. When set,
+   *        the used workers, including the main thread if `exclude_worker0 = true`,
+   *        are bound to the `nthreads` cores that start at the offset, so that
+   *        several groups can run side by side on disjoint cores.
    *
    * \return The number of workers to use.
    */
-  int Configure(AffinityMode mode, int nthreads, bool exclude_worker0);
+  int Configure(AffinityMode mode, int nthreads, bool exclude_worker0,
+                int core_offset = -1);
 
  private:
   Impl* impl_;
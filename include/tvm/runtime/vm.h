@@ -135,6 +135,8 @@ struct Instruction {
     struct /* AllocTensor Operands */ {
       /*! \brief The storage to allocate from. */
       RegName storage;
+      /*! \brief The offset in bytes of the tensor in the storage. */
+      Index offset;
       /*! \brief The number of dimensions. */
       uint32_t ndim;
       /*! \brief The shape of tensor. */
@@ -145,6 +147,8 @@ struct Instruction {
     struct /* AllocTensorReg Operands */ {
       /*! \brief The storage to allocate from. */
       RegName storage;
+      /*! \brief The offset in bytes of the tensor in the storage. */
+      Index offset;
       /*! \brief The register to read the shape out of. */
       RegName shape_register;
       /*! \brief The datatype of tensor to be allocated. */
@@ -266,22 +270,24 @@ struct Instruction {
   /*!
    * \brief Construct an allocate tensor instruction with constant shape.
    * \param storage The storage to allocate out of.
+   * \param offset The offset in bytes of the tensor in the storage.
    * \param shape The shape of the tensor.
    * \param dtype The dtype of the tensor.
    * \param dst The destination register.
    * \return The allocate tensor instruction.
    */
-  static Instruction AllocTensor(RegName storage,
+  static Instruction AllocTensor(RegName storage, Index offset,
                                  const std::vector<int64_t>& shape, DLDataType dtype, RegName dst);
   /*!
    * \brief Construct an allocate tensor instruction with register.
    * \param storage The storage to allocate out of.
+   * \param offset The offset in bytes of the tensor in the storage.
    * \param shape_register The register containing the shape.
    * \param dtype The dtype of the tensor.
    * \param dst The destination register.
    * \return The allocate tensor instruction.
    */
-  static Instruction AllocTensorReg(RegName storage,
+  static Instruction AllocTensorReg(RegName storage, Index offset,
                                     RegName shape_register, DLDataType dtype, RegName dst);
   /*!
    * \brief Construct an allocate datatype instruction.
@@ -494,6 +500,26 @@ class Executable : public ModuleNode {
    */
   static runtime::Module Load(const std::string& code, const runtime::Module lib);
 
+  /*!
+   * \brief Save the constant pool into a mapped params file.
+   *
+   *  Later calls to `Save` leave the constants out of the executable,
+   *  they must be loaded with `LoadConstants` before running it.
+   *
+   * \param file_name The name of the file.
+   */
+  void SaveConstants(const std::string& file_name);
+
+  /*!
+   * \brief Load the constant pool from a file written by `SaveConstants`.
+   *
+   *  The constants view the mapped file instead of being copied, so the
+   *  pages are shared by every process running the same executable.
+   *
+   * \param file_name The name of the file.
+   */
+  void LoadConstants(const std::string& file_name);
+
   /*!
    * \brief Get the serialized form of the `functions`. This is
    * essentially bytecode serialization.
@@ -568,6 +594,8 @@ class Executable : public ModuleNode {
   runtime::Module lib;
   /*! \brief The global constant pool. */
   std::vector<ObjectRef> constants;
+  /*! \brief Whether the constants are saved in a separate file. */
+  bool external_constants{false};
   /*! \brief A map from globals (as strings) to their index in the function map. */
   std::unordered_map<std::string, Index> global_map;
   /*! \brief A mapping from the packed function (as string) to the index that
@@ -677,7 +705,8 @@ class VirtualMachine : public runtime::ModuleNode {
     return "VirtualMachine";
   }
 
-  VirtualMachine() : frames_(), func_index_(0), code_(nullptr), pc_(0), exec_(nullptr) {}
+  VirtualMachine()
+      : frames_(), func_index_(0), code_(nullptr), dispatch_(nullptr), pc_(0), exec_(nullptr) {}
 
   /*!
    * \brief load the executable for the virtual machine.
@@ -694,6 +723,14 @@ class VirtualMachine : public runtime::ModuleNode {
   Index func_index_;
   /*! \brief The current pointer to the code section. */
   const Instruction* code_;
+  /*! \brief The current pointer to the pre-decoded dispatch keys of the code section. */
+  const uint8_t* dispatch_;
+  /*!
+   * \brief The pre-decoded dispatch keys of each function, indexed by the
+   *  function table index. A key is either the opcode of the instruction or
+   *  a superinstruction covering it and the instructions that follow.
+   */
+  std::vector<std::vector<uint8_t>> dispatch_tables_;
   /*! \brief The virtual machine PC. */
   Index pc_;
   /*! \brief The special return register. */
@@ -724,9 +761,9 @@ class VirtualMachine : public runtime::ModuleNode {
   /*!
    * \brief Read a VM register.
    * \param reg The register to read from.
-   * \return The read object.
+   * \return The read object, valid until the call stack changes.
    */
-  inline ObjectRef ReadRegister(RegName reg) const;
+  inline const ObjectRef& ReadRegister(RegName reg) const;
 
   /*!
    * \brief Read a VM register and cast it to int32_t
@@ -786,8 +823,11 @@ class VirtualMachine : public runtime::ModuleNode {
    * \brief Invoke a global setting up the VM state to execute.
    *
    * This does not begin execution of the VM.
+   *
+   * \param func_index The index of the function in the function table.
+   * \param args The arguments to the function.
    */
-  void InvokeGlobal(const VMFunction& func, const std::vector<ObjectRef>& args);
+  void InvokeGlobal(Index func_index, const std::vector<ObjectRef>& args);
 
   /*!
    * \brief The constant pool for runtime. It caches the device dependent
@@ -74,6 +74,17 @@ Array<Var> UndefinedVars(const Stmt& stmt, const Array<Var>& defs);
  */
 void VerifyMemory(const IRModule& mod);
 
+/*!
+ * \brief Estimate the floating point operations of a lowered function.
+ *
+ *  Every floating point arithmetic operation and math call is counted
+ *  once per lane and per iteration of the enclosing loops and threads.
+ *
+ * \param func The function to be analyzed.
+ * \return The estimated operations, -1 if a loop extent is not constant.
+ */
+TVM_DLL int64_t EstimateFlops(const PrimFunc& func);
+
 }  // namespace tir
 }  // namespace tvm
 #endif  // TVM_TIR_ANALYSIS_H_
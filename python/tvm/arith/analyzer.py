@@ -88,6 +88,8 @@ class Analyzer:
         self._canonical_simplify = _mod("canonical_simplify")
         self._int_set = _mod("int_set")
         self._enter_constraint_context = _mod("enter_constraint_context")
+        self._memo_stats = _mod("memo_stats")
+        self._set_memo_capacity = _mod("set_memo_capacity")
 
     def const_int_bound(self, expr):
         """Find constant integer bound for expr.
@@ -243,3 +245,27 @@ class Analyzer:
         else:
             raise TypeError(
                 "Do not know how to handle type {}".format(type(info)))
+
+    def memo_stats(self):
+        """Get the number of hits and misses of the memoized results.
+
+        Simplify, CanProve and const_int_bound results are memoized by
+        expression identity until a variable is bound.
+
+        Returns
+        -------
+        stats : Tuple[int, int]
+            The number of hits and misses.
+        """
+        hits, misses = self._memo_stats()
+        return int(hits), int(misses)
+
+    def set_memo_capacity(self, capacity):
+        """Set the maximum number of memoized expressions.
+
+        Parameters
+        ----------
+        capacity : int
+            The maximum number of expressions, 0 disables the memoization.
+        """
+        self._set_memo_capacity(capacity)
@@ -140,6 +140,17 @@ class DispatchContext(object):
         """
         raise NotImplementedError()
 
+    def cache_key(self):
+        """Get a key of the configs this context and the upper contexts give.
+
+        Returns
+        -------
+        key : Optional[str]
+            The same key is returned by the contexts that give the same configs,
+            None if the configs cannot be keyed.
+        """
+        return None
+
     def __enter__(self):
         self._old_ctx = DispatchContext.current
         DispatchContext.current = self
@@ -190,6 +201,7 @@ class ApplyHistoryBest(DispatchContext):
         self.best_by_targetkey = {}
         self.best_by_model = {}
         self._best_user_defined = {}
+        self._cache_key = None
 
         if records:
             self.load(records)
@@ -218,6 +230,7 @@ class ApplyHistoryBest(DispatchContext):
 
         best_by_targetkey = self.best_by_targetkey
         best_by_model = self.best_by_model
+        self._cache_key = None
 
         counter = 0
         for inp, res in records:
@@ -272,6 +285,23 @@ class ApplyHistoryBest(DispatchContext):
 
         return None
 
+    def cache_key(self):
+        if self._best_user_defined or self._old_ctx is None:
+            return None
+        old_key = self._old_ctx.cache_key()
+        if old_key is None:
+            return None
+        if self._cache_key is None:
+            # pylint: disable=import-outside-toplevel
+            import hashlib
+            digest = hashlib.sha1()
+            for best in [self.best_by_targetkey, self.best_by_model]:
+                for key, (inp, _) in sorted(best.items(), key=lambda kv: str(kv[0])):
+                    digest.update(("%s=%s\n" % (key, inp.config)).encode())
+                digest.update(b"\n")
+            self._cache_key = "history:" + digest.hexdigest()
+        return self._cache_key + "," + old_key
+
     def update(self, target, workload, cfg):
         model = target.model
         key = (model, workload)
@@ -296,6 +326,7 @@ class FallbackContext(DispatchContext):
         super(FallbackContext, self).__init__()
         self.memory = {}
         self.silent = False
+        self._updated = False
 
         # a set to prevent print duplicated message
         self.messages = set()
@@ -332,9 +363,14 @@ class FallbackContext(DispatchContext):
         if key in self.memory:
             del self.memory[key]
 
+    def cache_key(self):
+        # The fallback configs only depend on the workloads.
+        return None if self._updated else "fallback"
+
     def update(self, target, workload, cfg):
         key = (str(target), workload)
         self.memory[key] = cfg
+        self._updated = True
 
 
 DispatchContext.current = FallbackContext()
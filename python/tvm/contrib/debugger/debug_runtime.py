@@ -16,6 +16,7 @@
 # under the License.
 """Graph debug runtime executes TVM debug packed functions."""
 
+import json
 import os
 import tempfile
 import shutil
@@ -104,6 +105,7 @@ class GraphModuleDebug(graph_runtime.GraphModule):
         self._dump_path = None
         self._get_output_by_layer = module["get_output_by_layer"]
         self._run_individual = module["run_individual"]
+        self._profile = module["profile"]
         graph_runtime.GraphModule.__init__(self, module)
         self._create_debug_env(graph_json_str, ctx)
 
@@ -244,6 +246,28 @@ class GraphModuleDebug(graph_runtime.GraphModule):
         ret = self._run_individual(number, repeat, min_repeat_ms)
         return ret.strip(",").split(",") if ret else []
 
+    def profile(self, number=1):
+        """Profile each op of the graph.
+
+        Every invocation is recorded with its wall time, the bytes of its
+        arguments, the floating point operations estimated from the lowered
+        function and, when the kernel allows it, the cycles, instructions and
+        last level cache misses read from perf_event. The bytes moved and the
+        operations per byte tell memory bound ops from compute bound ones.
+
+        Parameters
+        ----------
+        number : int
+            The number of times to run the graph after a warmup run.
+
+        Returns
+        -------
+        profile : dict
+            The profile in the Chrome trace format, with a "summary" of the
+            invocations of each op. Save it as json to open it in chrome://tracing.
+        """
+        return json.loads(self._profile(number))
+
     def exit(self):
         """Exits the dump folder and all its contents"""
         self._remove_dump_root()
@@ -28,8 +28,9 @@ def create(graph_json_str, libmod, ctx):
 
     Parameters
     ----------
-    graph_json_str : str or graph class
-        The graph to be deployed in json format output by json graph.
+    graph_json_str : str, bytes, bytearray or graph class
+        The graph to be deployed in json format output by json graph,
+        or in the binary format made by :py:func:`graph_json_to_binary`.
         The graph can only contain one operator(tvm_op) that
         points to the name of PackedFunc in the libmod.
 
@@ -47,11 +48,14 @@ def create(graph_json_str, libmod, ctx):
     graph_module : GraphModule
         Runtime graph module that can be used to execute the graph.
     """
-    if not isinstance(graph_json_str, string_types):
+    if not isinstance(graph_json_str, (string_types, bytes, bytearray)):
         try:
             graph_json_str = graph_json_str._tvm_graph_json()
         except AttributeError:
             raise ValueError("Type %s is not supported" % type(graph_json_str))
+    # The FFI only passes bytearray as bytes, e.g. a binary graph read from a file.
+    if isinstance(graph_json_str, bytes):
+        graph_json_str = bytearray(graph_json_str)
 
     ctx, num_rpc_ctx, device_type_id = get_device_ctx(libmod, ctx)
 
@@ -63,6 +67,68 @@ def create(graph_json_str, libmod, ctx):
     return GraphModule(fcreate(graph_json_str, libmod, *device_type_id))
 
 
+def graph_json_to_binary(graph_json_str):
+    """Convert a graph from json to the binary format.
+
+    The binary format holds the same graph with the strings in a table and
+    the numbers in fixed width, so that the runtime loads it without
+    parsing. It is in the byte order of the machine that made it.
+
+    Parameters
+    ----------
+    graph_json_str : str
+        The graph in json format.
+
+    Returns
+    -------
+    graph_binary : bytearray
+        The graph in the binary format.
+    """
+    return tvm._ffi.get_global_func("tvm.graph_runtime.json_to_binary")(graph_json_str)
+
+
+def create_pool(graph_json_str, libmod, ctx):
+    """Create a pool of execution contexts given a graph and module.
+
+    The graph, the module and the parameters are shared by all the
+    execution contexts of the pool, each context only owns the
+    intermediate storage of one request.
+
+    Parameters
+    ----------
+    graph_json_str : str, bytes, bytearray or graph class
+        The graph to be deployed in json or in the binary format, see :py:func:`create`.
+
+    libmod : tvm.runtime.Module
+        The module of the corresponding function
+
+    ctx : TVMContext or list of TVMContext
+        The context to deploy the module, see :py:func:`create`.
+
+    Returns
+    -------
+    graph_module_pool : GraphModulePool
+        The pool of execution contexts.
+    """
+    if not isinstance(graph_json_str, (string_types, bytes, bytearray)):
+        try:
+            graph_json_str = graph_json_str._tvm_graph_json()
+        except AttributeError:
+            raise ValueError("Type %s is not supported" % type(graph_json_str))
+    # The FFI only passes bytearray as bytes, e.g. a binary graph read from a file.
+    if isinstance(graph_json_str, bytes):
+        graph_json_str = bytearray(graph_json_str)
+
+    ctx, num_rpc_ctx, device_type_id = get_device_ctx(libmod, ctx)
+
+    if num_rpc_ctx == len(ctx):
+        fcreate = ctx[0]._rpc_sess.get_function("tvm.graph_runtime_pool.create")
+    else:
+        fcreate = tvm._ffi.get_global_func("tvm.graph_runtime_pool.create")
+
+    return GraphModulePool(fcreate(graph_json_str, libmod, *device_type_id))
+
+
 def get_device_ctx(libmod, ctx):
     """Parse and validate all the device context(s).
 
@@ -175,6 +241,23 @@ class GraphModule(object):
             self.set_input(**input_dict)
         self._run()
 
+    def run_parallel(self, num_workers=0, **input_dict):
+        """Run forward execution of the graph, executing independent
+        operators concurrently.
+
+        Parameters
+        ----------
+        num_workers: int, optional
+            The number of inter-operator workers, the number of cores
+            is used when it is 0.
+
+        input_dict: dict of str to NDArray
+            List of input values to be feed to
+        """
+        if input_dict:
+            self.set_input(**input_dict)
+        self.module["run_parallel"](num_workers)
+
     def get_num_outputs(self):
         """Get the number of outputs from the graph
 
@@ -243,6 +326,19 @@ class GraphModule(object):
         """
         self._load_params(bytearray(params_bytes))
 
+    def load_mapped_params(self, path):
+        """Load parameters from a file saved by relay.save_mapped_param_dict.
+
+        Parameters of CPU inputs view the memory mapped file instead of
+        being copied, other parameters are copied to their device.
+
+        Parameters
+        ----------
+        path : str
+            The path of the file, on the device when the module is remote.
+        """
+        self.module["load_mapped_params"](path)
+
     def share_params(self, other, params_bytes):
         """Share parameters from pre-existing GraphRuntime instance.
 
@@ -265,3 +361,105 @@ class GraphModule(object):
             The key to the module.
         """
         return self.module[key]
+
+
+class GraphExecutionContext(GraphModule):
+    """An execution context of a GraphModulePool.
+
+    The parameters are shared by every context of the pool, so they
+    cannot be set or loaded through a context.
+
+    Parameters
+    ----------
+    module : tvm.runtime.Module
+        The internal tvm module of the execution context.
+    """
+
+    def __init__(self, module):
+        super(GraphExecutionContext, self).__init__(module)
+        self._is_param_input = module["is_param_input"]
+
+    def set_input(self, key=None, value=None, **params):
+        """Set inputs to the context via kwargs, the parameters excepted.
+
+        Parameters
+        ----------
+        key : int or str
+           The input key
+
+        value : the input value.
+           The input key
+
+        params : dict of str to NDArray
+           Additional arguments
+        """
+        keys = ([key] if key is not None else []) + list(params.keys())
+        for k in keys:
+            if self._is_param_input(k):
+                raise ValueError("Cannot set the parameter input %s of an execution context, "
+                                 "the parameters are shared by the pool" % str(k))
+        super(GraphExecutionContext, self).set_input(key, value, **params)
+
+
+class GraphModulePool(object):
+    """Wrapper of a pool of graph runtime execution contexts.
+
+    Parameters
+    ----------
+    module : tvm.runtime.Module
+        The internal tvm module that holds the pool.
+    """
+
+    def __init__(self, module):
+        self.module = module
+        self._load_params = module["load_params"]
+        self._create_execution_context = module["create_execution_context"]
+        self._release_idle = module["release_idle"]
+        self._get_num_contexts = module["get_num_contexts"]
+        self._get_num_idle = module["get_num_idle"]
+
+    def load_params(self, params_bytes):
+        """Load the shared parameters, before creating any execution context.
+
+        Parameters
+        ----------
+        params_bytes : bytearray
+            The serialized parameter dict.
+        """
+        self._load_params(bytearray(params_bytes))
+
+    def load_mapped_params(self, path):
+        """Load the shared parameters from a file saved by
+        relay.save_mapped_param_dict, before creating any execution context.
+
+        Parameters
+        ----------
+        path : str
+            The path of the file.
+        """
+        self.module["load_mapped_params"](path)
+
+    def create_execution_context(self):
+        """Get an execution context, an idle one is reused when available.
+        The context goes back to the pool once it is no longer referenced.
+
+        Returns
+        -------
+        graph_module : GraphExecutionContext
+            The execution context.
+        """
+        return GraphExecutionContext(self._create_execution_context())
+
+    def release_idle(self):
+        """Free the storage of the idle execution contexts."""
+        self._release_idle()
+
+    @property
+    def num_contexts(self):
+        """Number of execution contexts created, idle or in use."""
+        return self._get_num_contexts()
+
+    @property
+    def num_idle(self):
+        """Number of idle execution contexts."""
+        return self._get_num_idle()
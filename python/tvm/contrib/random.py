@@ -94,4 +94,94 @@ def normal(loc, scale, size):
         "tvm.contrib.random.normal", float(loc), float(scale), outs[0]), dtype='float32')
 
 
+def philox_randint(low, high, size, seed, offset=0, dtype='int32'):
+    """Return random integers from low (inclusive) to high (exclusive) drawn
+    from a counter based generator.
+
+    Element i of the output is the number offset + i of the stream of seed,
+    so the result is reproducible and independent of the number of threads
+    filling the tensor. Draws with non overlapping [offset, offset + n)
+    ranges of the same seed are independent.
+
+    Parameters
+    ----------
+    low : int
+        Lowest (signed) integer to be drawn from the distribution
+    high : int
+        One above the largest (signed) integer to be drawn from the distribution
+    size : tuple of ints
+        Output shape.
+    seed : int
+        The seed of the stream.
+    offset : int
+        The position in the stream of the first element.
+
+    Returns
+    -------
+    out : Tensor
+        A tensor with specified size and dtype
+    """
+    assert 'int' in dtype, "the type of randint output must be int or uint"
+    return te.extern(size, [], lambda ins, outs: tvm.tir.call_packed(
+        "tvm.contrib.random.philox_randint", int(low), int(high),
+        int(seed), int(offset), outs[0]), dtype=dtype)
+
+
+def philox_uniform(low, high, size, seed, offset=0):
+    """Draw samples from a uniform distribution over [low, high) with a
+    counter based generator.
+
+    See philox_randint for the meaning of seed and offset.
+
+    Parameters
+    ----------
+    low : float
+        Lower boundary of the output interval.
+    high : float
+        Upper boundary of the output interval.
+    size : tuple of ints
+        Output shape.
+    seed : int
+        The seed of the stream.
+    offset : int
+        The position in the stream of the first element.
+
+    Returns
+    -------
+    out : Tensor
+        A tensor with specified size and dtype.
+    """
+    return te.extern(size, [], lambda ins, outs: tvm.tir.call_packed(
+        "tvm.contrib.random.philox_uniform", float(low), float(high),
+        int(seed), int(offset), outs[0]), dtype='float32')
+
+
+def philox_normal(loc, scale, size, seed, offset=0):
+    """Draw samples from a normal distribution with a counter based generator.
+
+    See philox_randint for the meaning of seed and offset.
+
+    Parameters
+    ----------
+    loc : float
+        loc of the distribution.
+    scale : float
+        Standard deviation of the distribution.
+    size : tuple of ints
+        Output shape.
+    seed : int
+        The seed of the stream.
+    offset : int
+        The position in the stream of the first element.
+
+    Returns
+    ------
+    out : Tensor
+        A tensor with specified size and dtype
+    """
+    return te.extern(size, [], lambda ins, outs: tvm.tir.call_packed(
+        "tvm.contrib.random.philox_normal", float(loc), float(scale),
+        int(seed), int(offset), outs[0]), dtype='float32')
+
+
 tvm._ffi._init_api("tvm.contrib.random")
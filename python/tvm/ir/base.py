@@ -151,6 +151,41 @@ def save_json(node):
     return tvm.runtime._ffi_node_api.SaveJSON(node)
 
 
+def load_binary(blob):
+    """Load tvm object from the binary format.
+
+    Parameters
+    ----------
+    blob : bytearray
+        The bytes saved by save_binary.
+
+    Returns
+    -------
+    node : Object
+        The loaded tvm node.
+    """
+    return tvm.runtime._ffi_node_api.LoadBinary(blob)
+
+
+def save_binary(node):
+    """Save tvm object in the binary format.
+
+    The binary format visits the same fields as save_json, but it is
+    much more compact and faster to load for large modules.
+
+    Parameters
+    ----------
+    node : Object
+        A TVM object to be saved.
+
+    Returns
+    -------
+    blob : bytearray
+        The saved bytes.
+    """
+    return tvm.runtime._ffi_node_api.SaveBinary(node)
+
+
 def structural_equal(lhs, rhs, map_free_vars=False):
     """Check structural equality of lhs and rhs.
 
@@ -233,7 +268,7 @@ def assert_structural_equal(lhs, rhs, map_free_vars=False):
         lhs, rhs, True, map_free_vars)
 
 
-def structural_hash(node, map_free_vars=False):
+def structural_hash(node, map_free_vars=False, cache=None):
     """Compute structural hash of node
 
     The structural hash value is recursively defined in the DAG of IRNodes.
@@ -263,6 +298,10 @@ def structural_hash(node, map_free_vars=False):
         by the order of their occurences. Otherwise, we will hash by
         their in-memory pointer address.
 
+    cache : Optional[StructuralHashCache]
+        Reuse the hashes of the subterms hashed before through the cache.
+        The result is the same as without a cache.
+
     Return
     ------
     result : int
@@ -272,4 +311,32 @@ def structural_hash(node, map_free_vars=False):
     --------
     structrual_equal
     """
+    if cache is not None:
+        return tvm.runtime._ffi_node_api.SHashCacheHash(cache, node, map_free_vars)
     return tvm.runtime._ffi_node_api.StructuralHash(node, map_free_vars)
+
+
+@tvm._ffi.register_object("node.SHashCache")
+class StructuralHashCache(Object):
+    """Structural hashes of subterms memoised across structural_hash calls.
+
+    Hashing an object that shares most of its subterms with objects hashed
+    before through the same cache only visits the changed part, which avoids
+    rehashing whole modules when they are hashed repeatedly. The cache keeps
+    the hashed objects alive until it is cleared.
+
+    Parameters
+    ----------
+    max_entries : int
+        The cache is cleared before a hash once it holds more subterms.
+    """
+    def __init__(self, max_entries=65536):
+        self.__init_handle_by_constructor__(
+            tvm.runtime._ffi_node_api.SHashCache, max_entries)
+
+    def clear(self):
+        """Drop all the memoised hashes."""
+        tvm.runtime._ffi_node_api.SHashCacheClear(self)
+
+    def __len__(self):
+        return tvm.runtime._ffi_node_api.SHashCacheSize(self)
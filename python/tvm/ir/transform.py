@@ -19,6 +19,7 @@
 import types
 import inspect
 import functools
+import json
 
 import tvm._ffi
 
@@ -70,13 +71,31 @@ class PassContext(tvm.runtime.Object):
 
     disabled_pass : Optional[Union[List[str], Set[str], Tuple[str]]]
         The list of passes that are disabled.
+
+    use_object_arena : Optional[bool]
+        Whether the nodes made by a pass are allocated from an arena, which
+        function passes scope to each function. The nodes that outlive the
+        pass stay valid, see :py:func:`object_arena_stats`.
+
+    instruments : Optional[Sequence[PassInstrument]]
+        The instruments called before and after each pass, including the
+        Sequential passes, see :py:class:`PassTimingInstrument`.
+
+    graph_memory_arena : Optional[bool]
+        Whether the graph runtime codegen places the storages of each device
+        in one arena at byte offsets, packing them by lifetime and size,
+        instead of sharing whole storages between tensors of similar sizes.
+        Only used when every target has a flat address space (CPU, GPU, ROCm).
     """
     def __init__(self,
                  opt_level=2,
                  fallback_device=_nd.cpu(),
                  required_pass=None,
                  disabled_pass=None,
-                 trace=None):
+                 trace=None,
+                 use_object_arena=False,
+                 instruments=None,
+                 graph_memory_arena=False):
         if isinstance(fallback_device, str):
             fallback_device = _nd.context(fallback_device).device_type
         elif isinstance(fallback_device, tvm.runtime.TVMContext):
@@ -95,9 +114,15 @@ class PassContext(tvm.runtime.Object):
             raise TypeError("disabled_pass is expected to be the type of " +
                             "list/tuple/set.")
 
+        instruments = list(instruments) if instruments else []
+        if not isinstance(instruments, (list, tuple)):
+            raise TypeError("instruments is expected to be the type of " +
+                            "list/tuple/set.")
+
         self.__init_handle_by_constructor__(_ffi_transform_api.PassContext, opt_level,
                                             fallback_device, required,
-                                            disabled, trace)
+                                            disabled, trace, use_object_arena,
+                                            instruments, graph_memory_arena)
 
     def __enter__(self):
         _ffi_transform_api.EnterPassContext(self)
@@ -112,6 +137,126 @@ class PassContext(tvm.runtime.Object):
         return _ffi_transform_api.GetCurrentPassContext()
 
 
+def object_arena_stats():
+    """Get the counters of the object arenas that have exited.
+
+    Returns
+    -------
+    stats : Dict[str, int]
+        The numbers of objects allocated from arenas, their bytes, the objects
+        too large for an arena, the pages allocated, the pages reused after
+        their objects were deleted and the pages kept alive by nodes that
+        outlived their pass.
+    """
+    return {str(k): v.value for k, v in _ffi_transform_api.ObjectArenaStats().items()}
+
+
+@tvm._ffi.register_object("transform.PassInstrument")
+class PassInstrument(tvm.runtime.Object):
+    """The base class of the instruments called before and after each pass
+    run under a :py:class:`PassContext`."""
+
+
+@tvm._ffi.register_object("transform.PackedFuncPassInstrument")
+class PackedFuncPassInstrument(PassInstrument):
+    """An instrument that calls python functions, see :py:func:`pass_instrument`."""
+
+
+def pass_instrument(run_before_pass=None, run_after_pass=None, name="PassInstrument"):
+    """Create an instrument from python functions.
+
+    The functions before and after the passes of a Sequential are called
+    around the calls of its own passes.
+
+    Parameters
+    ----------
+    run_before_pass : Optional[Callable[[tvm.IRModule, PassInfo], None]]
+        Called with the module and the pass information before each pass.
+
+    run_after_pass : Optional[Callable[[tvm.IRModule, PassInfo], None]]
+        Called with the returned module and the pass information after each pass,
+        also after a pass that raised, with None as the module.
+
+    name : str
+        The name of the instrument.
+
+    Returns
+    -------
+    instrument : PassInstrument
+        The instrument.
+    """
+    return _ffi_transform_api.MakePassInstrument(name, run_before_pass, run_after_pass)
+
+
+@tvm._ffi.register_object("transform.PassTimingInstrument")
+class PassTimingInstrument(PassInstrument):
+    """An instrument that records the wall time of each pass, the number of
+    IR nodes of the module before and after it and the objects made by it.
+
+    The records of the passes run by a Sequential are nested in its own.
+
+    Parameters
+    ----------
+    count_nodes : bool
+        Whether to count the nodes of the module before and after each pass.
+        The time spent counting is excluded from the wall times.
+
+    Examples
+    --------
+    .. code-block:: python
+
+        timing = tvm.transform.PassTimingInstrument()
+        with tvm.transform.PassContext(opt_level=3, instruments=[timing]):
+            lib = relay.build(mod, "llvm")
+        print(timing.render())
+    """
+    def __init__(self, count_nodes=True):
+        self.__init_handle_by_constructor__(_ffi_transform_api.PassTimingInstrument,
+                                            count_nodes)
+
+    def report(self):
+        """Get the records.
+
+        Returns
+        -------
+        report : dict
+            The total time under "total_us", the tree of the records under
+            "passes" and the times summed by pass name, sorted by the time
+            spent outside of the nested passes, under "summary".
+        """
+        return json.loads(_ffi_transform_api.PassTimingReport(self))
+
+    def render(self):
+        """Get the records as a table indented by nesting.
+
+        Returns
+        -------
+        table : str
+            The table.
+        """
+        return _ffi_transform_api.PassTimingRender(self)
+
+    def reset(self):
+        """Drop the records."""
+        _ffi_transform_api.PassTimingReset(self)
+
+
+def count_ir_nodes(mod):
+    """Count the distinct nodes reachable from a module.
+
+    Parameters
+    ----------
+    mod : tvm.IRModule
+        The module.
+
+    Returns
+    -------
+    count : int
+        The number of nodes, including the containers.
+    """
+    return _ffi_transform_api.CountIRNodes(mod)
+
+
 @tvm._ffi.register_object("transform.Pass")
 class Pass(tvm.runtime.Object):
     """The base class of all passes. All methods here are just simple wrappers
@@ -137,6 +137,7 @@ fromtext = parser.fromtext
 # Param Serialization
 save_param_dict = param_dict.save_param_dict
 load_param_dict = param_dict.load_param_dict
+save_mapped_param_dict = param_dict.save_mapped_param_dict
 
 # Pass manager
 PassInfo = transform.PassInfo
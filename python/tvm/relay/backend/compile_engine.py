@@ -261,6 +261,15 @@ def lower_call(call, inputs, target):
     return LoweredOutput(outputs, best_impl)
 
 
+@tvm._ffi.register_func("relay.backend._compile_cache_context_key")
+def _compile_cache_context_key():
+    """The key of the python state that selects the implementations of the
+    ops, part of the keys of the disk cache. None bypasses the disk cache."""
+    if _op.op.has_strategy_overrides():
+        return None
+    return autotvm.DispatchContext.current.cache_key()
+
+
 @tvm._ffi.register_object("relay.CompileEngine")
 class CompileEngine(Object):
     """CompileEngine to get lowered code.
@@ -297,6 +306,39 @@ class CompileEngine(Object):
             msg += "--------------------------\n"
             raise RuntimeError(msg)
 
+    def lower_batch(self, source_funcs, target=None):
+        """Lower source_funcs ahead of the calls to lower.
+
+        The lowering passes of the functions run concurrently when the engine
+        uses more than one thread, see set_num_threads. The functions get the
+        names they would get if they were lowered in order.
+
+        Parameters
+        ----------
+        source_funcs : List[Union[tvm.relay.Function, CCacheKey]]
+            The source relay functions.
+
+        target : tvm.Target
+            The target platform.
+        """
+        keys = [_get_cache_key(source_func, target) for source_func in source_funcs]
+        _backend._CompileEngineLowerBatch(self, keys)
+
+    def set_num_threads(self, num_threads):
+        """Set the number of threads that lower the functions of a build.
+
+        The functions are scheduled serially, and then lowered by the c++
+        lowering pipeline in parallel, unless the build config has custom
+        lower passes. The number of threads can also be set by the
+        TVM_NUM_LOWER_THREADS environment variable.
+
+        Parameters
+        ----------
+        num_threads : int
+            The number of threads, 1 to lower serially and 0 to use all the cores.
+        """
+        _backend._CompileEngineSetNumThreads(self, num_threads)
+
     def lower_shape_func(self, source_func, target=None):
         key = _get_cache_key(source_func, target)
         return _backend._CompileEngineLowerShapeFunc(self, key)
@@ -324,6 +366,27 @@ class CompileEngine(Object):
         """clear the existing cached functions"""
         _backend._CompileEngineClear(self)
 
+    def set_disk_cache(self, path, max_bytes=1 << 30):
+        """Set a persistent cache of lowered functions shared across processes.
+
+        The cache is consulted before lowering a function and is keyed by the
+        structural hash of the function and the target, the pass context, the
+        build config and the AutoTVM configs in use. The cache is bypassed under
+        a dispatch context that cannot be keyed, such as ApplyConfig, or once a
+        strategy is registered over the default one of an op. The least recently used
+        entries are removed once the cache grows over the size limit. The cache
+        can also be enabled by the TVM_COMPILE_CACHE_DIR environment variable.
+
+        Parameters
+        ----------
+        path : Optional[str]
+            The cache directory, None to disable the cache.
+
+        max_bytes : int
+            The size limit of the cache directory.
+        """
+        _backend._CompileEngineSetDiskCache(self, path if path else "", max_bytes)
+
     def items(self):
         """List items in the cache.
 
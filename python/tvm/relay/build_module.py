@@ -69,6 +69,7 @@ class BuildModule(object):
     def __init__(self):
         self.mod = _build_module._BuildModule()
         self._get_graph_json = self.mod["get_graph_json"]
+        self._get_graph_binary = self.mod["get_graph_binary"]
         self._get_module = self.mod["get_module"]
         self._build = self.mod["build"]
         self._optimize = self.mod["optimize"]
@@ -168,6 +169,11 @@ class BuildModule(object):
         """Return the json file of the built program."""
         return self._get_graph_json()
 
+    def get_graph_binary(self):
+        """Return the graph of the built program in the binary format,
+        which the graph runtime loads faster than the json."""
+        return self._get_graph_binary()
+
     def get_module(self):
         """Return the built module."""
         return self._get_module()
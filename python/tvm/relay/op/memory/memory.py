@@ -36,7 +36,7 @@ def invoke_tvm_op(func, inputs, outputs):
     """
     return _make.invoke_tvm_op(func, inputs, outputs)
 
-def alloc_tensor(storage, shape, dtype='float32', assert_shape=None):
+def alloc_tensor(storage, shape, dtype='float32', assert_shape=None, offset=0):
     """Allocate a tensor with the provided shape, and dtype.
 
     Parameters
@@ -52,12 +52,15 @@ def alloc_tensor(storage, shape, dtype='float32', assert_shape=None):
 
     assert_shape: Control the static shape when computed by dynamic shape expression.
 
+    offset: int
+        The offset in bytes of the tensor in the storage.
+
     Returns
     -------
     result : tvm.relay.Expr
         The alloc_tensor expression.
     """
-    return _make.alloc_tensor(storage, shape, dtype, assert_shape)
+    return _make.alloc_tensor(storage, shape, dtype, assert_shape, offset)
 
 def alloc_storage(size, alignment, dtype_hint='float32'):
     """Allocate a piece of tensor storage.
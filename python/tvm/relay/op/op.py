@@ -279,9 +279,21 @@ def register_strategy(op_name, fstrategy=None, level=10):
     if not isinstance(fstrategy, GenericFunc):
         assert hasattr(fstrategy, "generic_func_node")
         fstrategy = fstrategy.generic_func_node
+    if level > 10:
+        global _num_strategy_overrides  # pylint: disable=global-statement
+        _num_strategy_overrides += 1
     return register(op_name, "FTVMStrategy", fstrategy, level)
 
 
+# The strategies registered over the default ones, which the compile cache cannot key.
+_num_strategy_overrides = 0
+
+
+def has_strategy_overrides():
+    """Whether a strategy was registered over the default strategy of an op."""
+    return _num_strategy_overrides > 0
+
+
 def register_schedule(op_name, schedule, level=10):
     """Register schedule function for an op.
 
@@ -22,6 +22,7 @@ import tvm._ffi
 
 _save_param_dict = tvm._ffi.get_global_func("tvm.relay._save_param_dict")
 _load_param_dict = tvm._ffi.get_global_func("tvm.relay._load_param_dict")
+_save_mapped_params = tvm._ffi.get_global_func("runtime.SaveMappedParams")
 
 def save_param_dict(params):
     """Save parameter dictionary to binary bytes.
@@ -59,6 +60,38 @@ def save_param_dict(params):
     return _save_param_dict(*args)
 
 
+def save_mapped_param_dict(params, path):
+    """Save parameter dictionary to a file that can be memory mapped.
+
+    The file can be loaded by the GraphModule with API
+    "load_mapped_params". Parameters on CPU then view the mapped
+    file instead of being copied, pages are read in lazily and are
+    shared between processes loading the same file.
+
+    Parameters
+    ----------
+    params : dict of str to NDArray
+        The parameter dictionary.
+
+    path : str
+        The path of the file.
+
+    Examples
+    --------
+    .. code-block:: python
+
+       graph, lib, params = tvm.relay.build(func, target=target, params=params)
+       tvm.relay.save_mapped_param_dict(params, "deploy.params")
+       module = graph_runtime.create(graph, lib, tvm.cpu(0))
+       module.load_mapped_params("deploy.params")
+    """
+    args = [path]
+    for k, v in params.items():
+        args.append(k)
+        args.append(tvm.nd.array(v))
+    _save_mapped_params(*args)
+
+
 def load_param_dict(param_bytes):
     """Load parameter dictionary to binary bytes.
 
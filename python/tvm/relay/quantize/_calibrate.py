@@ -17,7 +17,6 @@
 """Find scales for quantization on the dataset."""
 from __future__ import absolute_import
 import logging
-import multiprocessing as mp
 import numpy as np
 import tvm
 import tvm.driver
@@ -31,7 +30,6 @@ from .. import analysis as _analysis
 from .. import transform as _transform
 from .. import build_module as _build_module
 from ...contrib import graph_runtime
-from .kl_divergence import _find_scale_by_kl
 
 
 def _get_profile_runtime(mod):
@@ -53,53 +51,22 @@ def _get_profile_runtime(mod):
     return runtime
 
 
-def collect_stats(mod, dataset, chunk_by=-1):
-    """Given an annotated graph, create a profile graph to collect profile data from the
-    calibration dataset. This pass collects simulated_quantize op input into a tuple.
-    Simulated_quantize ops are rewritten to identity mode. The tuple is the output of the profile
-    graph.
-
-    Parameters
-    ----------
-    mod: Module
-        The simulation graph after annotation.
-
-    dataset: Iterable[NDArray]
-        The calibration dataset.
-
-    chunk_by: optional, int
-        The size of chunk to be returned in one iteration. It is meant to be
-        used for reducing memory usage. If not specified, return samples for
-        all layers in one chunk.
-
-    Returns
-    -------
-    ret: Iterable[list of ndarray]
-        List of output data of each layer, chunked by the chunk_by parameter
-    """
+def _native_scale(mod, dataset, mode, num_bins=8001, num_quantized_bins=255):
+    """Find the scales of the layers from histograms accumulated natively,
+    in parallel over the layers, while the batches stream through the
+    profile graph."""
+    cfg = quantize.current_qconfig()
     logging.info("collecting statistics for calibration...")
     runtime = _get_profile_runtime(mod)
-    num_outputs = runtime.get_num_outputs()
-    chunk_by = num_outputs if chunk_by == -1 else chunk_by
-
-    for i in range(0, num_outputs, chunk_by):
-        outputs = [[] for i in range(min(chunk_by, num_outputs - i))]
-        for batch in dataset:
-            runtime.set_input(**batch)
-            runtime.run()
-            for j in range(i, min(i+chunk_by, num_outputs)):
-                outputs[j-i].append(runtime.get_output(j).asnumpy())
-        yield [np.concatenate(output).reshape(-1) for output in outputs]
-
-
-def _kl_scale(mod, dataset):
-    cfg = quantize.current_qconfig()
-    chunk_by = cfg.calibrate_chunk_by
-    scales = []
-    for samples in collect_stats(mod, dataset, chunk_by):
-        logging.info("finding threshold with kl for calibration...")
-        with mp.Pool() as pool:
-            scales += list(pool.map(_find_scale_by_kl, samples))
+    stats = _quantize.CalibrationStats(runtime.get_num_outputs(), num_bins)
+    for batch in dataset:
+        runtime.set_input(**batch)
+        runtime.run()
+        _quantize.CalibrationStatsUpdate(stats, runtime.module)
+    logging.info("finding threshold with %s for calibration...", mode)
+    thresholds = _quantize.CalibrationStatsFindThresholds(
+        stats, mode, num_quantized_bins, cfg.calibrate_percentile)
+    scales = [threshold.value for threshold in thresholds]
 
     def func(_):
         scale = scales[func.scale_idx]
@@ -187,8 +154,8 @@ def calibrate(dataset=None):
         """make transform.module pass happy"""
         cfg = quantize.current_qconfig()
 
-        if cfg.calibrate_mode == 'kl_divergence':
-            input_scale_func = _kl_scale(mod, dataset)
+        if cfg.calibrate_mode in ('kl_divergence', 'percentile', 'mse'):
+            input_scale_func = _native_scale(mod, dataset, cfg.calibrate_mode)
         elif cfg.calibrate_mode == 'global_scale':
             input_scale_func = _global_scale
         else:
@@ -16,6 +16,8 @@
 # under the License.
 #pylint: disable=unused-argument, not-context-manager
 """Automatic quantization toolkit."""
+import warnings
+
 import tvm.ir
 from tvm.runtime import Object
 
@@ -76,6 +78,7 @@ class QConfig(Object):
         "dtype_activation": "int32",
         "calibrate_mode": "global_scale",
         "global_scale": 8.0,
+        "calibrate_percentile": 0.99999,
         "weight_scale": "power2",
         "skip_conv_layers": [0],
         "do_simulation": False,
@@ -143,13 +146,19 @@ def qconfig(**kwargs):
         Number of bit for every kind of annotate field.
 
     calibrate_mode: str
-        The calibration mode. 'global_scale' or 'kl_divergence'.
+        The calibration mode. 'global_scale', 'kl_divergence', 'percentile' or 'mse'.
         global_scale: use global scale
         kl_divergence: find scales by kl divergence on the dataset.
+        percentile: find scales that cover calibrate_percentile of the absolute values.
+        mse: find scales that minimize the squared quantization error on the dataset.
 
     global_scale: float
         The global scale for calibration.
 
+    calibrate_percentile: float
+        The fraction of the absolute values of each layer within its scale, in the
+        percentile calibration mode.
+
     weight_scale: str
         The way to calculate scales for weights (annotated with QAnnotateKind.WEIGHT).
         power2: Find the maximum of the absolute value of the tensor, and then round up to power
@@ -174,11 +183,19 @@ def qconfig(**kwargs):
     rounding: "UPWARD" or "TONEAREST"
         Rounding direction for fixed point multiplications.
 
+    calibrate_chunk_by: int
+        Deprecated and has no effect. The calibration accumulates a histogram
+        per layer while the batches stream through, so its memory no longer
+        grows with the dataset.
+
     Returns
     -------
     config: QConfig
         The quantization configuration
     """
+    if kwargs.get("calibrate_chunk_by", -1) != -1:
+        warnings.warn("calibrate_chunk_by has no effect, the calibration no longer keeps "
+                      "the outputs of the layers in memory", DeprecationWarning)
     node_args = {k: v if k not in kwargs else kwargs[k]
                  for k, v in QConfig._node_defaults.items()}
     return tvm.ir.make_node("relay.quantize.QConfig", **node_args)
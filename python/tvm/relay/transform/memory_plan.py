@@ -0,0 +1,191 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=no-else-return,invalid-name,len-as-condition,too-many-nested-blocks
+"""
+A pass for statically planning the storage manifested by ManifestAlloc.
+
+Storages with a constant size whose tensors never escape the let chain that
+allocates them are coalesced into a single arena. Each storage is assigned
+an offset in the arena so that storages with overlapping live ranges never
+overlap in memory, in the spirit of graph_plan_memory.cc for the graph
+runtime. Storages with data-dependent sizes are left to dynamic allocation.
+"""
+from ..expr_functor import ExprMutator
+from ..scope_builder import ScopeBuilder
+from ..analysis import free_vars
+from . import transform
+from .. import op
+from ... import register_func
+from .. import expr
+
+
+class StorageInfo:
+    """The live range and placement of a statically sized storage."""
+
+    def __init__(self, index, size, alignment):
+        self.start = index
+        self.end = index
+        self.size = size
+        self.alignment = alignment
+        self.offset = 0
+        self.escaped = False
+
+    def overlaps(self, other):
+        return self.start <= other.end and other.start <= self.end
+
+
+def _as_int(e):
+    if isinstance(e, expr.Constant) and len(e.data.shape) == 0:
+        return int(e.data.asnumpy())
+    return None
+
+
+def _align_up(value, alignment):
+    return (value + alignment - 1) // alignment * alignment
+
+
+class MemoryPlanPass(ExprMutator):
+    """A pass for coalescing static storage allocations into arenas."""
+
+    def __init__(self):
+        self.alloc_storage = op.op.get("memory.alloc_storage")
+        self.alloc_tensor = op.op.get("memory.alloc_tensor")
+        self.invoke_tvm = op.op.get("memory.invoke_tvm_op")
+        self.shape_func = op.op.get("memory.shape_func")
+        super().__init__()
+
+    def is_op(self, value, target_op):
+        return isinstance(value, expr.Call) and value.op.same_as(target_op)
+
+    def analyze(self, bindings, body):
+        """Compute the live range of each candidate storage in a let chain."""
+        storages = {}
+        # Maps each bound variable to the candidate storages it may alias.
+        aliases = {}
+
+        def lookup(e):
+            if isinstance(e, expr.Var):
+                return aliases.get(e, [])
+            return []
+
+        def escape(e):
+            for v in free_vars(e):
+                for info in aliases.get(v, []):
+                    info.escaped = True
+
+        for i, (var, value) in enumerate(bindings):
+            if self.is_op(value, self.alloc_storage):
+                size = _as_int(value.args[0])
+                alignment = _as_int(value.args[1])
+                if size is not None and alignment is not None:
+                    info = StorageInfo(i, size, alignment)
+                    storages[var] = info
+                    aliases[var] = [info]
+            elif self.is_op(value, self.alloc_tensor):
+                infos = lookup(value.args[0])
+                if value.attrs.offset != 0:
+                    for info in infos:
+                        info.escaped = True
+                aliases[var] = infos
+                escape(value.args[1])
+            elif self.is_op(value, self.invoke_tvm) or self.is_op(value, self.shape_func):
+                for arg in value.args[1:]:
+                    fields = arg.fields if isinstance(arg, expr.Tuple) else [arg]
+                    for field in fields:
+                        for info in lookup(field):
+                            info.end = i
+                        if not isinstance(field, expr.Var):
+                            escape(field)
+            elif isinstance(value, expr.Var):
+                aliases[var] = lookup(value)
+            elif isinstance(value, expr.Tuple) and \
+                    all(isinstance(field, expr.Var) for field in value.fields):
+                aliases[var] = [info for field in value.fields for info in lookup(field)]
+            elif isinstance(value, expr.TupleGetItem) and isinstance(value.tuple_value, expr.Var):
+                aliases[var] = lookup(value.tuple_value)
+            else:
+                # Any other use may keep the tensor alive past the chain.
+                escape(value)
+        escape(body)
+
+        return [info for info in storages.values() if not info.escaped], storages
+
+    def plan(self, candidates):
+        """Place the candidates greedily by decreasing size."""
+        placed = []
+        for info in sorted(candidates, key=lambda info: (-info.size, info.start)):
+            offset = 0
+            conflicts = sorted([other for other in placed if other.overlaps(info)],
+                               key=lambda other: other.offset)
+            for other in conflicts:
+                offset = _align_up(offset, info.alignment)
+                if offset + info.size <= other.offset:
+                    break
+                offset = max(offset, other.offset + other.size)
+            info.offset = _align_up(offset, info.alignment)
+            placed.append(info)
+        return max(info.offset + info.size for info in placed)
+
+    def visit_let(self, let):
+        bindings = []
+        while isinstance(let, expr.Let):
+            bindings.append((let.var, self.visit(let.value)))
+            let = let.body
+        body = self.visit(let)
+
+        candidates, storages = self.analyze(bindings, body)
+        if len(candidates) < 2:
+            scope = ScopeBuilder()
+            for var, value in bindings:
+                scope.let(var, value)
+            scope.ret(body)
+            return scope.get()
+
+        total = self.plan(candidates)
+        alignment = max(info.alignment for info in candidates)
+        first = min(info.start for info in candidates)
+        arena = expr.var("arena")
+        planned = {var: info for var, info in storages.items() if not info.escaped}
+
+        scope = ScopeBuilder()
+        for i, (var, value) in enumerate(bindings):
+            if var in planned:
+                if i == first:
+                    scope.let(arena, op.memory.alloc_storage(
+                        expr.const(total, dtype="int64"),
+                        expr.const(alignment, dtype="int64"),
+                        "uint8"))
+                continue
+            if self.is_op(value, self.alloc_tensor) and value.args[0] in planned:
+                info = planned[value.args[0]]
+                value = op.memory.alloc_tensor(
+                    arena, value.args[1], value.attrs.dtype,
+                    value.attrs.assert_shape, info.offset)
+            scope.let(var, value)
+        scope.ret(body)
+        return scope.get()
+
+
+@transform.function_pass(opt_level=0)
+class MemoryPlan:
+    """The explicit pass wrapper around MemoryPlan."""
+
+    def transform_function(self, func, mod, _):
+        return MemoryPlanPass().visit(func)
+
+
+register_func("relay.transform.MemoryPlan", MemoryPlan)
@@ -147,6 +147,37 @@ class RPCSession(object):
         """
         return base._LoadRemoteModule(self._sess, path)
 
+    def call_and_fetch(self, mod, func_name, args, fetch):
+        """Call a function of a remote module and copy arrays back to the host.
+
+        The call and the copies are pipelined into one round trip,
+        arrays passed as arguments are uploaded without waiting as well.
+
+        Parameters
+        ----------
+        mod : Module
+            The remote module.
+
+        func_name : str
+            The name of the function in the module.
+
+        args : list
+            The arguments of the function.
+
+        fetch : list of tuple of NDArray
+            Pairs of remote array and local CPU array to copy it into,
+            the copies happen after the call returns.
+
+        Returns
+        -------
+        ret : object
+            The return value of the function.
+        """
+        flat_fetch = []
+        for remote, local in fetch:
+            flat_fetch += [remote, local]
+        return base._CallAndFetch(mod, func_name, len(fetch), *(flat_fetch + list(args)))
+
     def cpu(self, dev_id=0):
         """Construct CPU device."""
         return self.context(1, dev_id)
@@ -206,6 +237,12 @@ class LocalSession(RPCSession):
     def load_module(self, path):
         return _load_module(self._temp.relpath(path))
 
+    def call_and_fetch(self, mod, func_name, args, fetch):
+        ret = mod[func_name](*args)
+        for remote, local in fetch:
+            remote.copyto(local)
+        return ret
+
 
 class TrackerSession(object):
     """Tracker client session.
@@ -298,9 +298,14 @@ class Module(object):
                     assert module.type_key == "c"
                     object_format = "cc"
                     has_c_module = True
-            path_obj = temp.relpath("lib" + str(index) + "." + object_format)
-            module.save(path_obj)
-            files.append(path_obj)
+            if module.type_key == "llvm" and object_format == "o":
+                # A module generated in parts saves one object file per part.
+                files += [str(path) for path in
+                          module.get_function("_save_objects")(temp.relpath("lib" + str(index)))]
+            else:
+                path_obj = temp.relpath("lib" + str(index) + "." + object_format)
+                module.save(path_obj)
+                files.append(path_obj)
             is_system_lib = (module.type_key == "llvm" and
                              module.get_function("__tvm_is_system_module")())
             llvm_target_triple = (module.type_key == "llvm" and
@@ -20,6 +20,7 @@ The Relay Virtual Machine profiler.
 
 Provides extra APIs for profiling vm execution.
 """
+import json
 from tvm.runtime import _ffi_api
 from . import vm
 
@@ -36,6 +37,7 @@ class VirtualMachineProfiler(vm.VirtualMachine):
         self._init = self.mod["init"]
         self._invoke = self.mod["invoke"]
         self._get_stat = self.mod["get_stat"]
+        self._get_profile = self.mod["get_profile"]
         self._set_input = self.mod["set_input"]
         self._reset = self.mod["reset"]
 
@@ -55,5 +57,20 @@ class VirtualMachineProfiler(vm.VirtualMachine):
         """
         return self._get_stat(sort_by_time)
 
+    def get_profile(self):
+        """Get the profile of the executed ops.
+
+        Every invocation is recorded with its wall time, the bytes of its
+        arguments and, when the kernel allows it, the cycles, instructions
+        and last level cache misses read from perf_event.
+
+        Returns
+        -------
+        profile : dict
+            The profile in the Chrome trace format, with a "summary" of the
+            invocations of each op. Save it as json to open it in chrome://tracing.
+        """
+        return json.loads(self._get_profile())
+
     def reset(self):
         self._reset()
@@ -20,6 +20,8 @@ The Relay Virtual Machine runtime.
 
 Implements a Python interface to executing the compiled VM object.
 """
+import json
+
 import numpy as np
 
 import tvm
@@ -49,6 +51,58 @@ def _convert(arg, cargs):
         raise TypeError("Unsupported type: %s" % (type(arg)))
 
 
+def set_allocator(ctx, kind="naive", max_cached_bytes=0):
+    """Set the allocator used by the VM for the storage on a context.
+
+    The allocator can only be replaced while no buffer allocated from it is alive.
+
+    Parameters
+    ----------
+    ctx : :py:class:`TVMContext`
+        The context.
+
+    kind : str
+        "naive" allocates every storage from the device, "pooled" recycles
+        buffers of the same page-rounded size, "best_fit" serves size classes
+        from large chunks with best-fit search, splitting and coalescing.
+
+    max_cached_bytes : int
+        For "best_fit", the free memory kept before returning free chunks
+        to the device, 0 for no limit.
+    """
+    kinds = {"naive": 1, "pooled": 2, "best_fit": 3}
+    if kind not in kinds:
+        raise ValueError("Unknown allocator kind %s, expected one of %s" %
+                         (kind, list(kinds.keys())))
+    _ffi_api.VMSetAllocator(ctx.device_type, ctx.device_id, kinds[kind],
+                            max_cached_bytes)
+
+
+def get_allocator_stats(ctx):
+    """Get the statistics of the VM allocator of a context.
+
+    Parameters
+    ----------
+    ctx : :py:class:`TVMContext`
+        The context.
+
+    Returns
+    -------
+    stats : dict
+        The raw counters reported by the allocator, plus "hit_rate", the
+        fraction of the allocations served from cached memory, and
+        "fragmentation", the fraction of the reserved memory not requested
+        by live allocations.
+    """
+    stats = json.loads(_ffi_api.VMGetAllocatorStats(ctx.device_type, ctx.device_id))
+    num_allocs = stats["num_allocs"]
+    reserved = stats["reserved_bytes"]
+    stats["hit_rate"] = stats["num_hits"] / num_allocs if num_allocs else 0.0
+    stats["fragmentation"] = \
+        1.0 - stats["requested_bytes"] / reserved if reserved else 0.0
+    return stats
+
+
 def convert(args):
     cargs = []
     for arg in args:
@@ -136,6 +190,32 @@ from tvm import te
         """
         return self._save(), self._get_lib()
 
+    def save_constants(self, path):
+        """Save the constant pool into a file that can be memory mapped.
+
+        Later calls to save leave the constants out of the bytecode, they
+        must be loaded with load_constants before running the executable.
+
+        Parameters
+        ----------
+        path : str
+            The path of the file.
+        """
+        self.mod["save_constants"](path)
+
+    def load_constants(self, path):
+        """Load the constant pool from a file written by save_constants.
+
+        The constants view the memory mapped file instead of being copied,
+        pages are read in lazily and are shared between processes.
+
+        Parameters
+        ----------
+        path : str
+            The path of the file.
+        """
+        self.mod["load_constants"](path)
+
     @staticmethod
     def load_exec(bytecode, lib):
         """Construct an executable from saved artifacts.
@@ -364,3 +444,100 @@ class VirtualMachine(object):
             The output.
         """
         return self.invoke("main", *args, **kwargs)
+
+
+class BatchingServer(object):
+    """Serve concurrent requests by running them in batches on the Relay VM.
+
+    Requests are queued and a batch is formed from the requests at the front
+    of the queue by concatenating their inputs along the batch axis. A batch
+    is run once it holds max_batch_size samples or the oldest request has
+    waited max_latency_us, and the outputs are split back along the same axis.
+
+    Parameters
+    ----------
+    mod : Executable or tvm.runtime.Module
+        The VM executable.
+
+    ctx : TVMContext
+        The context to run on.
+
+    func_name : str
+        The function serving the requests.
+
+    batch_axis : int
+        The axis of every input and output the requests are batched along.
+
+    max_batch_size : int
+        The number of samples at which a batch is run without waiting.
+
+    max_latency_us : int
+        The time in microseconds a request waits for others at most.
+
+    num_workers : int
+        The number of VMs, each running one batch at a time.
+    """
+    def __init__(self, mod, ctx, func_name="main", batch_axis=0, max_batch_size=8,
+                 max_latency_us=1000, num_workers=1):
+        if not isinstance(mod, (Executable, tvm.runtime.Module)):
+            raise TypeError("mod is expected to be the type of Executable or " +
+                            "tvm.runtime.Module, but received {}".format(type(mod)))
+        m = mod.module if isinstance(mod, Executable) else mod
+        self.mod = _ffi_api._VMBatchingServer(
+            m, func_name, batch_axis, max_batch_size, max_latency_us, num_workers,
+            ctx.device_type, ctx.device_id)
+        self._infer = self.mod["infer"]
+        self._benchmark = self.mod["benchmark"]
+        self._get_stats = self.mod["get_stats"]
+
+    def infer(self, *args):
+        """Run a request, blocking until its batch has run.
+
+        This can be called from several threads at once.
+
+        Parameters
+        ----------
+        args : list[tvm.runtime.NDArray] or list[np.ndarray]
+            The inputs of the request.
+
+        Returns
+        -------
+        result : Object
+            The output of the request.
+        """
+        return self._infer(*convert(args))
+
+    def benchmark(self, *args, num_clients=1, num_requests=100):
+        """Measure the server with clients that send requests one after another.
+
+        The clients are native threads, so the measurement is not bound by
+        the Python interpreter.
+
+        Parameters
+        ----------
+        args : list[tvm.runtime.NDArray] or list[np.ndarray]
+            The inputs of every request.
+
+        num_clients : int
+            The number of concurrent clients.
+
+        num_requests : int
+            The number of requests of each client.
+
+        Returns
+        -------
+        result : dict
+            The requests per second, the mean number of requests per batch and
+            the mean, p50, p90, p99 and max latencies in microseconds.
+        """
+        return json.loads(self._benchmark(num_clients, num_requests, *convert(args)))
+
+    def stats(self):
+        """Get the numbers of requests, samples and batches run so far.
+
+        Returns
+        -------
+        stats : dict
+            The counters of the server.
+        """
+        return json.loads(self._get_stats())
@@ -51,6 +51,14 @@ The list of options include:
    It is useful in environments where dynamic loading api like dlopen is banned.
    The system lib will be available as long as the result code is linked by the program.
 
+- **-codegen-threads=<number>**
+
+   Generate the LLVM code of the functions in parts on this many threads,
+   0 uses all the cores. Every part is optimized on its own and the object
+   code of the parts is emitted in parallel by ``export_library``, so the
+   functions are not inlined across parts. By default the code is generated
+   on one thread.
+
 We can use :py:func:`tvm.target.create` to create a tvm.target.Target from the target string.
 We can also use other specific function in this module to create specific targets.
 """
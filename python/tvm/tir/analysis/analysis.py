@@ -66,3 +66,19 @@ def verify_memory(mod):
         The module to be verified.
     """
     _ffi_api.verify_memory(mod)
+
+
+def estimate_flops(func):
+    """Estimate the floating point operations of a lowered function.
+
+    Parameters
+    ----------
+    func : tvm.tir.PrimFunc
+        The function to be analyzed.
+
+    Returns
+    -------
+    flops : int
+        The estimated operations, -1 if a loop extent is not constant.
+    """
+    return _ffi_api.estimate_flops(func)
@@ -45,6 +45,7 @@ void Analyzer::Bind(const Var& var, const PrimExpr& expr) {
   this->modular_set.Update(var, this->modular_set(new_expr));
   this->rewrite_simplify.Update(var, new_expr);
   this->canonical_simplify.Update(var, new_expr);
+  this->UpdateContextVersion();
 }
 
 void Analyzer::Bind(const Var& var, const Range& range) {
@@ -64,8 +65,43 @@ void Analyzer::Bind(const Map<Var, Range>& variables) {
   }
 }
 
+void Analyzer::SetMemoCapacity(size_t capacity) {
+  memo_capacity_ = capacity;
+  memo_.clear();
+}
+
+void Analyzer::UpdateContextVersion() {
+  ++update_count_;
+  version_ = ++max_version_;
+}
+
+Analyzer::MemoEntry* Analyzer::FindMemo(const PrimExpr& expr) {
+  if (memo_capacity_ == 0) return nullptr;
+  auto it = memo_.find(MemoKey(expr.get(), version_));
+  if (it == memo_.end()) return nullptr;
+  return &(it->second);
+}
+
+Analyzer::MemoEntry* Analyzer::StoreMemo(const PrimExpr& expr, uint64_t version) {
+  // A Let in the expression may have bound a var during the analysis.
+  if (memo_capacity_ == 0 || version != version_) return nullptr;
+  MemoKey key(expr.get(), version);
+  auto it = memo_.find(key);
+  if (it == memo_.end()) {
+    if (memo_.size() >= memo_capacity_) memo_.clear();
+    it = memo_.emplace(key, MemoEntry()).first;
+    it->second.expr = expr;
+  }
+  return &(it->second);
+}
+
 void ConstraintContext::EnterWithScope() {
   CHECK(exit_ == nullptr);
+  // the constraint gives a new context, the results of the
+  // outer context are valid again after exiting the scope.
+  saved_version_ = analyzer_->version_;
+  saved_update_count_ = analyzer_->update_count_;
+  analyzer_->version_ = ++analyzer_->max_version_;
   // entering the scope.
   auto f0 = analyzer_->const_int_bound.EnterConstraint(constraint_);
   auto f1 = analyzer_->modular_set.EnterConstraint(constraint_);
@@ -81,6 +117,12 @@ void ConstraintContext::EnterWithScope() {
 void ConstraintContext::ExitWithScope() {
   CHECK(exit_ != nullptr);
   exit_();
+  // vars bound in the scope outlive it.
+  if (analyzer_->update_count_ == saved_update_count_) {
+    analyzer_->version_ = saved_version_;
+  } else {
+    analyzer_->version_ = ++analyzer_->max_version_;
+  }
 }
 
 bool Analyzer::CanProveGreaterEqual(const PrimExpr& expr, int64_t lower_bound) {
@@ -96,22 +138,47 @@ bool Analyzer::CanProve(const PrimExpr& expr) {
   if (const auto* ptr = expr.as<IntImmNode>()) {
     return ptr->value != 0;
   }
+  if (MemoEntry* entry = FindMemo(expr)) {
+    if (entry->proved != -1) {
+      ++memo_hits_;
+      return entry->proved != 0;
+    }
+  }
+  if (memo_capacity_ != 0) ++memo_misses_;
+  uint64_t version = version_;
+  bool proved = false;
   auto res = this->rewrite_simplify(expr);
   if (const auto* ptr = res.as<IntImmNode>()) {
-    return ptr->value != 0;
+    proved = ptr->value != 0;
+  } else {
+    res = this->canonical_simplify(expr);
+    if (const auto* ptr = res.as<IntImmNode>()) {
+      proved = ptr->value != 0;
+    }
   }
-  res = this->canonical_simplify(expr);
-  if (const auto* ptr = res.as<IntImmNode>()) {
-    return ptr->value != 0;
+  if (MemoEntry* entry = StoreMemo(expr, version)) {
+    entry->proved = proved;
   }
-  return false;
+  return proved;
 }
 
 PrimExpr Analyzer::Simplify(const PrimExpr& expr) {
   if (tir::is_const(expr)) return expr;
+  if (MemoEntry* entry = FindMemo(expr)) {
+    if (entry->simplified.defined()) {
+      ++memo_hits_;
+      return entry->simplified;
+    }
+  }
+  if (memo_capacity_ != 0) ++memo_misses_;
+  uint64_t version = version_;
   auto res = this->rewrite_simplify(expr);
-  if (tir::is_const(res)) return res;
-  res = this->canonical_simplify(res);
+  if (!tir::is_const(res)) {
+    res = this->canonical_simplify(res);
+  }
+  if (MemoEntry* entry = StoreMemo(expr, version)) {
+    entry->simplified = res;
+  }
   return res;
 }
 
@@ -129,6 +196,18 @@ TVM_REGISTER_GLOBAL("arith.CreateAnalyzer")
         return PackedFunc([self](TVMArgs args, TVMRetValue *ret) {
             *ret = self->modular_set(args[0]);
         });
+      } else if (name == "memo_stats") {
+        return PackedFunc([self](TVMArgs args, TVMRetValue *ret) {
+            DataType dtype = DataType::Int(64);
+            *ret = Array<IntImm>({IntImm(dtype, static_cast<int64_t>(self->memo_hits())),
+                                  IntImm(dtype, static_cast<int64_t>(self->memo_misses()))});
+        });
+      } else if (name == "set_memo_capacity") {
+        return PackedFunc([self](TVMArgs args, TVMRetValue *ret) {
+            int capacity = args[0];
+            CHECK_GE(capacity, 0);
+            self->SetMemoCapacity(static_cast<size_t>(capacity));
+        });
       } else if (name == "const_int_bound_update") {
         return PackedFunc([self](TVMArgs args, TVMRetValue *ret) {
             self->const_int_bound.Update(args[0], args[1], args[2]);
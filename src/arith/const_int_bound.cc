@@ -556,8 +556,26 @@ class ConstIntBoundAnalyzer::Impl :
 };
 
 ConstIntBound ConstIntBoundAnalyzer::operator()(const PrimExpr& expr) {
+  // The leaves are cheaper to analyze than to look up.
+  bool memoize = expr.as<IntImmNode>() == nullptr && expr.as<VarNode>() == nullptr;
+  if (memoize) {
+    if (Analyzer::MemoEntry* entry = parent_->FindMemo(expr)) {
+      if (entry->bound.defined()) {
+        ++parent_->memo_hits_;
+        return entry->bound;
+      }
+    }
+    if (parent_->memo_capacity_ != 0) ++parent_->memo_misses_;
+  }
+  uint64_t version = parent_->version_;
   Entry ret = impl_->VisitExpr(expr);
-  return ConstIntBound(ret.min_value, ret.max_value);
+  ConstIntBound bound(ret.min_value, ret.max_value);
+  if (memoize) {
+    if (Analyzer::MemoEntry* entry = parent_->StoreMemo(expr, version)) {
+      entry->bound = bound;
+    }
+  }
+  return bound;
 }
 
 ConstIntBound ConstIntBoundAnalyzer::operator()(const PrimExpr& expr,
@@ -572,10 +590,12 @@ void ConstIntBoundAnalyzer::Update(const Var& var,
                                    const ConstIntBound& info,
                                    bool override) {
   impl_->Update(var, info, override);
+  parent_->UpdateContextVersion();
 }
 
 void ConstIntBoundAnalyzer::Bind(const Var& var, const Range& range) {
   impl_->Bind(var, range);
+  parent_->UpdateContextVersion();
 }
 
 std::function<void()> ConstIntBoundAnalyzer::EnterConstraint(const PrimExpr& constraint) {
@@ -583,7 +603,7 @@ std::function<void()> ConstIntBoundAnalyzer::EnterConstraint(const PrimExpr& con
 }
 
 ConstIntBoundAnalyzer::ConstIntBoundAnalyzer(Analyzer* parent)
-    : impl_(new Impl()) {
+    : parent_(parent), impl_(new Impl()) {
 }
 
 ConstIntBoundAnalyzer::~ConstIntBoundAnalyzer() {
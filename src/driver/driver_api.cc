@@ -99,7 +99,12 @@ void GetBinds(const Array<te::Tensor>& args,
 
   for (const auto &x : args) {
     if (out_binds->find(x) == out_binds->end()) {
-      auto buf = BufferWithOffsetAlignment(x->shape, x->dtype, x->op->name,
+      // Name the buffer like Tensor.name in python.
+      std::string name = x->op->name;
+      if (x->op->num_outputs() != 1) {
+        name += ".v" + std::to_string(x->value_index);
+      }
+      auto buf = BufferWithOffsetAlignment(x->shape, x->dtype, name,
         config->data_alignment, config->offset_factor, compact);
       out_binds->Set(x, buf);
       out_arg_list->push_back(buf);
@@ -125,11 +130,11 @@ tir::Stmt BuildStmt(te::Schedule sch,
                     bool loop_partition,
                     Array<ObjectRef> *out_arg_list,
                     const BuildConfig& config) {
-  sch = sch.normalize();
+  te::Schedule normalized = sch.normalize();
 
   // Phase 0
-  auto bounds = te::InferBound(sch);
-  auto stmt = te::ScheduleOps(sch, bounds, false);
+  auto bounds = te::InferBound(normalized);
+  auto stmt = te::ScheduleOps(normalized, bounds, false);
   stmt = tir::InjectPrefetch(stmt);
 
   bool compact = tir::VerifyCompactBuffer(stmt);
@@ -137,8 +142,10 @@ tir::Stmt BuildStmt(te::Schedule sch,
   GetBinds(args, compact, binds, &out_binds, out_arg_list, config);
 
   // Phase 1
+  stmt = tir::RewriteForTensorCore(stmt, sch, out_binds);
   stmt = tir::StorageFlatten(stmt, out_binds, 64,
                             config->instrument_bound_checkers);
+  stmt = tir::NarrowDataType(stmt, 32);
   stmt = tir::CanonicalSimplify(stmt);
   if (loop_partition) {
     stmt = tir::LoopPartition(stmt, config->partition_const_loop);
@@ -214,7 +221,7 @@ IRModule lower(te::Schedule sch,
   f = WithAttr(std::move(f), "global_symbol", runtime::String(name));
 
   if (config->restricted_func) {
-    f = WithAttr(std::move(f), "tir.noalias", Integer(1));
+    f = WithAttr(std::move(f), "tir.noalias", Bool(true));
   }
   return IRModule(Map<GlobalVar, BaseFunc>({{GlobalVar(name), f}}));
 }
@@ -0,0 +1,356 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/ir/instrument.cc
+ * \brief Instruments of the passes run under a PassContext.
+ */
+#include <dmlc/json.h>
+#include <tvm/ir/instrument.h>
+#include <tvm/ir/transform.h>
+#include <tvm/node/container.h>
+#include <tvm/node/reflection.h>
+#include <tvm/runtime/memory.h>
+#include <tvm/runtime/registry.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <unordered_set>
+#include <utility>
+
+namespace tvm {
+namespace transform {
+
+/*! \brief An instrument that calls packed functions, used by the python instruments. */
+class PackedFuncPassInstrumentNode : public PassInstrumentNode {
+ public:
+  /*! \brief Called before a pass, may be null. */
+  runtime::TypedPackedFunc<void(IRModule, PassInfo)> run_before_pass;
+  /*! \brief Called after a pass, may be null. */
+  runtime::TypedPackedFunc<void(IRModule, PassInfo)> run_after_pass;
+
+  void RunBeforePass(const IRModule& mod, const PassInfo& info) const final {
+    if (run_before_pass != nullptr) run_before_pass(mod, info);
+  }
+
+  void RunAfterPass(const IRModule& mod, const PassInfo& info) const final {
+    if (run_after_pass != nullptr) run_after_pass(mod, info);
+  }
+
+  static constexpr const char* _type_key = "transform.PackedFuncPassInstrument";
+  TVM_DECLARE_FINAL_OBJECT_INFO(PackedFuncPassInstrumentNode, PassInstrumentNode);
+};
+
+// Counts the nodes without recursion, the bodies of large functions are deep.
+class IRNodeCounter : public AttrVisitor {
+ public:
+  int64_t Count(const Object* root) {
+    Push(root);
+    while (!stack_.empty()) {
+      Object* node = const_cast<Object*>(stack_.back());
+      stack_.pop_back();
+      if (node->IsInstance<ArrayNode>()) {
+        for (const auto& elem : static_cast<ArrayNode*>(node)->data) {
+          Push(elem.get());
+        }
+      } else if (node->IsInstance<MapNode>()) {
+        for (const auto& kv : static_cast<MapNode*>(node)->data) {
+          Push(kv.first.get());
+          Push(kv.second.get());
+        }
+      } else if (node->IsInstance<StrMapNode>()) {
+        for (const auto& kv : static_cast<StrMapNode*>(node)->data) {
+          Push(kv.second.get());
+        }
+      } else if (!reflection_->GetReprBytes(node, nullptr)) {
+        reflection_->VisitAttrs(node, this);
+      }
+    }
+    return static_cast<int64_t>(visited_.size());
+  }
+
+  void Visit(const char* key, double* value) final {}
+  void Visit(const char* key, int64_t* value) final {}
+  void Visit(const char* key, uint64_t* value) final {}
+  void Visit(const char* key, int* value) final {}
+  void Visit(const char* key, bool* value) final {}
+  void Visit(const char* key, std::string* value) final {}
+  void Visit(const char* key, void** value) final {}
+  void Visit(const char* key, DataType* value) final {}
+  void Visit(const char* key, runtime::NDArray* value) final {}
+  void Visit(const char* key, ObjectRef* value) final {
+    Push(value->get());
+  }
+
+ private:
+  void Push(const Object* node) {
+    if (node != nullptr && visited_.insert(node).second) {
+      stack_.push_back(node);
+    }
+  }
+
+  ReflectionVTable* reflection_ = ReflectionVTable::Global();
+  std::unordered_set<const Object*> visited_;
+  std::vector<const Object*> stack_;
+};
+
+int64_t CountIRNodes(const IRModule& mod) {
+  return IRNodeCounter().Count(mod.get());
+}
+
+PassTimingInstrumentNode::PassTimingInstrumentNode() {
+  runtime::ObjectArena::EnableCounting(true);
+}
+
+PassTimingInstrumentNode::~PassTimingInstrumentNode() {
+  runtime::ObjectArena::EnableCounting(false);
+}
+
+PassTimingInstrument::PassTimingInstrument(bool count_nodes) {
+  auto n = make_object<PassTimingInstrumentNode>();
+  n->name = String("PassTimingInstrument");
+  n->count_nodes = count_nodes;
+  data_ = std::move(n);
+}
+
+void PassTimingInstrumentNode::RunBeforePass(const IRModule& mod, const PassInfo& info) const {
+  Clock::time_point enter = Clock::now();
+  std::unique_ptr<Record> record(new Record());
+  record->name = info->name;
+  if (count_nodes) record->nodes_in = CountIRNodes(mod);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<Frame>& stack = stacks_[std::this_thread::get_id()];
+  Frame frame;
+  frame.record = record.get();
+  if (stack.empty()) {
+    roots_.push_back(std::move(record));
+  } else {
+    stack.back().record->children.push_back(std::move(record));
+  }
+  stack.push_back(frame);
+  // The counting is charged to the enclosing pass as overhead.
+  if (stack.size() > 1) {
+    stack[stack.size() - 2].overhead += Clock::now() - enter;
+  }
+  runtime::ObjectArena::ThreadObjectCounts(&stack.back().num_objects,
+                                           &stack.back().object_bytes);
+  stack.back().start = Clock::now();
+}
+
+void PassTimingInstrumentNode::RunAfterPass(const IRModule& mod, const PassInfo& info) const {
+  Clock::time_point end = Clock::now();
+  int64_t num_objects, object_bytes;
+  runtime::ObjectArena::ThreadObjectCounts(&num_objects, &object_bytes);
+  int64_t nodes_out = count_nodes && mod.defined() ? CountIRNodes(mod) : -1;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<Frame>& stack = stacks_[std::this_thread::get_id()];
+  // Drop the passes that were left by an error.
+  while (!stack.empty() && stack.back().record->name != info->name) {
+    stack.pop_back();
+  }
+  if (stack.empty()) return;
+  Frame frame = stack.back();
+  stack.pop_back();
+  Record* record = frame.record;
+  record->duration_us =
+      std::chrono::duration<double, std::micro>(end - frame.start - frame.overhead).count();
+  record->num_objects = num_objects - frame.num_objects;
+  record->object_bytes = object_bytes - frame.object_bytes;
+  record->nodes_out = nodes_out;
+  if (!stack.empty()) {
+    stack.back().overhead += frame.overhead + (Clock::now() - end);
+  }
+}
+
+void PassTimingInstrumentNode::Reset() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  roots_.clear();
+  stacks_.clear();
+}
+
+namespace {
+using Record = PassTimingInstrumentNode::Record;
+
+double SelfTime(const Record& record) {
+  double self_us = record.duration_us;
+  for (const auto& child : record.children) {
+    self_us -= child->duration_us;
+  }
+  return std::max(self_us, 0.0);
+}
+
+// A record in the json report.
+struct RecordJSON {
+  const Record* record;
+
+  void Save(dmlc::JSONWriter* writer) const {
+    std::vector<RecordJSON> children;
+    for (const auto& child : record->children) {
+      children.push_back({child.get()});
+    }
+    writer->BeginObject();
+    writer->WriteObjectKeyValue("name", record->name);
+    writer->WriteObjectKeyValue("duration_us", record->duration_us);
+    writer->WriteObjectKeyValue("self_us", SelfTime(*record));
+    writer->WriteObjectKeyValue("nodes_in", record->nodes_in);
+    writer->WriteObjectKeyValue("nodes_out", record->nodes_out);
+    writer->WriteObjectKeyValue("num_objects", record->num_objects);
+    writer->WriteObjectKeyValue("object_bytes", record->object_bytes);
+    writer->WriteObjectKeyValue("passes", children);
+    writer->EndObject();
+  }
+};
+
+// The records of a pass name.
+struct PassSummary {
+  std::string name;
+  int64_t count{0};
+  double duration_us{0};
+  double self_us{0};
+  int64_t num_objects{0};
+
+  void Save(dmlc::JSONWriter* writer) const {
+    writer->BeginObject(false);
+    writer->WriteObjectKeyValue("name", name);
+    writer->WriteObjectKeyValue("count", count);
+    writer->WriteObjectKeyValue("duration_us", duration_us);
+    writer->WriteObjectKeyValue("self_us", self_us);
+    writer->WriteObjectKeyValue("num_objects", num_objects);
+    writer->EndObject();
+  }
+};
+
+void Summarize(const Record& record,
+               std::vector<PassSummary>* summary,
+               std::unordered_map<std::string, size_t>* index) {
+  auto it = index->find(record.name);
+  if (it == index->end()) {
+    it = index->emplace(record.name, summary->size()).first;
+    summary->emplace_back();
+    summary->back().name = record.name;
+  }
+  PassSummary& pass = (*summary)[it->second];
+  pass.count += 1;
+  pass.duration_us += record.duration_us;
+  pass.self_us += SelfTime(record);
+  pass.num_objects += record.num_objects;
+  for (const auto& child : record.children) {
+    Summarize(*child, summary, index);
+  }
+}
+
+void RenderRecord(const Record& record, int depth, std::ostream& os) {
+  std::string name = std::string(depth * 2, ' ') + record.name;
+  os << std::left << std::setw(48) << name << std::right
+     << std::setw(14) << record.duration_us
+     << std::setw(14) << SelfTime(record)
+     << std::setw(12) << record.nodes_in
+     << std::setw(12) << record.nodes_out
+     << std::setw(12) << record.num_objects << "\n";
+  for (const auto& child : record.children) {
+    RenderRecord(*child, depth + 1, os);
+  }
+}
+}  // namespace
+
+std::string PassTimingInstrumentNode::ToJSON() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<RecordJSON> passes;
+  std::vector<PassSummary> summary;
+  std::unordered_map<std::string, size_t> index;
+  double total_us = 0;
+  for (const auto& root : roots_) {
+    passes.push_back({root.get()});
+    Summarize(*root, &summary, &index);
+    total_us += root->duration_us;
+  }
+  std::sort(summary.begin(), summary.end(), [](const PassSummary& lhs, const PassSummary& rhs) {
+    return lhs.self_us > rhs.self_us;
+  });
+
+  std::ostringstream os;
+  os << std::fixed << std::setprecision(3);
+  dmlc::JSONWriter writer(&os);
+  writer.BeginObject();
+  writer.WriteObjectKeyValue("total_us", total_us);
+  writer.WriteObjectKeyValue("passes", passes);
+  writer.WriteObjectKeyValue("summary", summary);
+  writer.EndObject();
+  return os.str();
+}
+
+std::string PassTimingInstrumentNode::Render() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::ostringstream os;
+  os << std::fixed << std::setprecision(1);
+  os << std::left << std::setw(48) << "Pass" << std::right
+     << std::setw(14) << "Time(us)"
+     << std::setw(14) << "Self(us)"
+     << std::setw(12) << "Nodes in"
+     << std::setw(12) << "Nodes out"
+     << std::setw(12) << "Objects" << "\n";
+  for (const auto& root : roots_) {
+    RenderRecord(*root, 0, os);
+  }
+  return os.str();
+}
+
+TVM_REGISTER_NODE_TYPE(PackedFuncPassInstrumentNode);
+
+TVM_REGISTER_NODE_TYPE(PassTimingInstrumentNode);
+
+TVM_REGISTER_GLOBAL("transform.MakePassInstrument")
+.set_body_typed([](String name,
+                   runtime::TypedPackedFunc<void(IRModule, PassInfo)> run_before_pass,
+                   runtime::TypedPackedFunc<void(IRModule, PassInfo)> run_after_pass) {
+  auto n = make_object<PackedFuncPassInstrumentNode>();
+  n->name = std::move(name);
+  n->run_before_pass = std::move(run_before_pass);
+  n->run_after_pass = std::move(run_after_pass);
+  return PassInstrument(n);
+});
+
+TVM_REGISTER_GLOBAL("transform.PassTimingInstrument")
+.set_body_typed([](bool count_nodes) {
+  return PassTimingInstrument(count_nodes);
+});
+
+TVM_REGISTER_GLOBAL("transform.PassTimingReport")
+.set_body_typed([](PassTimingInstrument instrument) {
+  return instrument->ToJSON();
+});
+
+TVM_REGISTER_GLOBAL("transform.PassTimingRender")
+.set_body_typed([](PassTimingInstrument instrument) {
+  return instrument->Render();
+});
+
+TVM_REGISTER_GLOBAL("transform.PassTimingReset")
+.set_body_typed([](PassTimingInstrument instrument) {
+  instrument->Reset();
+});
+
+TVM_REGISTER_GLOBAL("transform.CountIRNodes")
+.set_body_typed(CountIRNodes);
+
+}  // namespace transform
+}  // namespace tvm
@@ -31,6 +31,7 @@
 // TODO(tqchen): Update to use String container after it is merged.
 #include <tvm/tir/expr.h>
 
+#include <memory>
 #include <stack>
 #include <unordered_set>
 
@@ -92,6 +93,31 @@ void PassContext::Trace(const IRModule& module, const PassInfo& info, bool is_be
     }
 }
 
+void PassContext::InstrumentBeforePass(const IRModule& module, const PassInfo& info) const {
+  for (const PassInstrument& instrument : (*this)->instruments) {
+    instrument->RunBeforePass(module, info);
+  }
+}
+
+void PassContext::InstrumentAfterPass(const IRModule& module, const PassInfo& info) const {
+  const Array<PassInstrument>& instruments = (*this)->instruments;
+  for (size_t i = instruments.size(); i != 0; --i) {
+    instruments[i - 1]->RunAfterPass(module, info);
+  }
+}
+
+void PassContext::InstrumentAfterFailedPass(const PassInfo& info) const {
+  const Array<PassInstrument>& instruments = (*this)->instruments;
+  for (size_t i = instruments.size(); i != 0; --i) {
+    try {
+      instruments[i - 1]->RunAfterPass(IRModule(), info);
+    } catch (const std::exception& e) {
+      LOG(WARNING) << "Instrument " << instruments[i - 1]->name
+                   << " failed after the failed pass " << info->name << ": " << e.what();
+    }
+  }
+}
+
 class ModulePass;
 
 /*!
@@ -241,8 +267,18 @@ IRModule ModulePassNode::operator()(IRModule mod,
 
   CHECK(mod.defined());
   pass_ctx.Trace(mod, pass_info, true);
-  mod = pass_func(std::move(mod), pass_ctx);
+  pass_ctx.InstrumentBeforePass(mod, pass_info);
+  try {
+    // The temporary nodes of the pass are released with the arena.
+    std::unique_ptr<runtime::ObjectArena> arena;
+    if (pass_ctx->use_object_arena) arena.reset(new runtime::ObjectArena());
+    mod = pass_func(std::move(mod), pass_ctx);
+  } catch (...) {
+    pass_ctx.InstrumentAfterFailedPass(pass_info);
+    throw;
+  }
   CHECK(mod.defined());
+  pass_ctx.InstrumentAfterPass(mod, pass_info);
   pass_ctx.Trace(mod, pass_info, false);
   return mod;
 }
@@ -317,16 +353,23 @@ Pass GetPass(const std::string& pass_name) {
 // ordering problem needs to be handled in the future.
 IRModule SequentialNode::operator()(IRModule mod,
                                     const PassContext& pass_ctx) const {
-  for (const Pass& pass : passes) {
-    CHECK(pass.defined()) << "Found undefined pass for optimization.";
-    const PassInfo& pass_info = pass->Info();
-    if (!PassEnabled(pass_info))  continue;
-    // resolve dependencies
-    for (const auto& it : pass_info->required) {
-      mod = GetPass(it)(std::move(mod), pass_ctx);
+  pass_ctx.InstrumentBeforePass(mod, pass_info);
+  try {
+    for (const Pass& pass : passes) {
+      CHECK(pass.defined()) << "Found undefined pass for optimization.";
+      const PassInfo& pass_info = pass->Info();
+      if (!PassEnabled(pass_info))  continue;
+      // resolve dependencies
+      for (const auto& it : pass_info->required) {
+        mod = GetPass(it)(std::move(mod), pass_ctx);
+      }
+      mod = pass(std::move(mod), pass_ctx);
     }
-    mod = pass(std::move(mod), pass_ctx);
+  } catch (...) {
+    pass_ctx.InstrumentAfterFailedPass(pass_info);
+    throw;
   }
+  pass_ctx.InstrumentAfterPass(mod, pass_info);
   return mod;
 }
 
@@ -423,11 +466,17 @@ TVM_REGISTER_GLOBAL("transform.PassContext")
   tvm::Array<runtime::String> required = args[2];
   tvm::Array<runtime::String> disabled = args[3];
   TraceFunc trace_func = args[4];
+  bool use_object_arena = args[5];
+  tvm::Array<PassInstrument> instruments = args[6];
+  bool graph_memory_arena = args[7];
   pctx->opt_level = opt_level;
   pctx->fallback_device = fallback_device;
   pctx->required_pass = std::move(required);
   pctx->disabled_pass = std::move(disabled);
   pctx->trace_func = std::move(trace_func);
+  pctx->use_object_arena = use_object_arena;
+  pctx->instruments = std::move(instruments);
+  pctx->graph_memory_arena = graph_memory_arena;
   *ret = pctx;
 });
 
@@ -450,6 +499,15 @@ TVM_STATIC_IR_FUNCTOR(ReprPrinter, vtable)
   for (const auto& it : node->disabled_pass) {
     p->stream << it << " ";
   }
+  p->stream << "]\n";
+
+  p->stream << "\tuse object arena: " << node->use_object_arena << "\n";
+  p->stream << "\tgraph memory arena: " << node->graph_memory_arena << "\n";
+
+  p->stream << "\tinstruments: [";
+  for (const auto& it : node->instruments) {
+    p->stream << it->name << " ";
+  }
   p->stream << "]";
 });
 
@@ -464,6 +522,19 @@ class PassContext::Internal {
   }
 };
 
+TVM_REGISTER_GLOBAL("transform.ObjectArenaStats")
+.set_body_typed([]() {
+  runtime::ObjectArena::Stats stats = runtime::ObjectArena::GlobalStats();
+  Map<String, PrimExpr> ret;
+  ret.Set("num_objects", IntImm(DataType::Int(64), stats.num_objects));
+  ret.Set("object_bytes", IntImm(DataType::Int(64), stats.object_bytes));
+  ret.Set("num_heap_objects", IntImm(DataType::Int(64), stats.num_heap_objects));
+  ret.Set("num_pages", IntImm(DataType::Int(64), stats.num_pages));
+  ret.Set("num_reused_pages", IntImm(DataType::Int(64), stats.num_reused_pages));
+  ret.Set("num_escaped_pages", IntImm(DataType::Int(64), stats.num_escaped_pages));
+  return ret;
+});
+
 TVM_REGISTER_GLOBAL("transform.GetCurrentPassContext")
 .set_body_typed(PassContext::Current);
 
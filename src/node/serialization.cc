@@ -31,9 +31,13 @@
 #include <tvm/node/serialization.h>
 #include <tvm/ir/attrs.h>
 
-#include <string>
+#include <algorithm>
 #include <cctype>
+#include <cstring>
+#include <deque>
 #include <map>
+#include <string>
+#include <vector>
 
 #include "../support/base64.h"
 
@@ -497,9 +501,445 @@ ObjectRef LoadJSON(std::string json_str) {
   return ObjectRef(nodes.at(jgraph.root));
 }
 
+/*! \brief Magic number of the binary node format. */
+constexpr uint64_t kTVMNodeBinaryMagic = 0xB1A2E5E71A11E0D3;
+/*! \brief Version of the binary node format, bumped on any layout change. */
+constexpr uint64_t kTVMNodeBinaryVersion = 1;
+/*! \brief Maximum size of a chunk of the binary node format. */
+constexpr size_t kTVMNodeBinaryChunkSize = 1 << 16;
+
+// Buffered output stream of the binary format.
+// Integers are written as varints and strings are interned,
+// so a repeated type key or field name costs a single byte.
+// The data goes out in chunks prefixed by their size and ends with an
+// empty chunk, so the reader never reads past the node.
+class BinaryNodeWriter : public dmlc::Stream {
+ public:
+  explicit BinaryNodeWriter(dmlc::Stream* strm) : strm_(strm) {}
+
+  size_t Read(void* ptr, size_t size) final {
+    LOG(FATAL) << "BinaryNodeWriter is write only";
+    return 0;
+  }
+  void Write(const void* ptr, size_t size) final {
+    const char* data = static_cast<const char*>(ptr);
+    while (size != 0) {
+      size_t n = std::min(size, kTVMNodeBinaryChunkSize - buffer_.size());
+      buffer_.insert(buffer_.end(), data, data + n);
+      data += n;
+      size -= n;
+      if (buffer_.size() == kTVMNodeBinaryChunkSize) Flush();
+    }
+  }
+  using dmlc::Stream::Write;
+
+  void WriteVarint(uint64_t value) {
+    char buf[10];
+    size_t n = 0;
+    while (value >= 0x80) {
+      buf[n++] = static_cast<char>(value | 0x80);
+      value >>= 7;
+    }
+    buf[n++] = static_cast<char>(value);
+    Write(buf, n);
+  }
+  void WriteSigned(int64_t value) {
+    // zigzag encoding keeps small negative numbers short.
+    WriteVarint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+  }
+  void WriteBytes(const std::string& value) {
+    WriteVarint(value.size());
+    Write(value.data(), value.size());
+  }
+  void WriteString(const std::string& value) {
+    auto it = strings_.find(value);
+    if (it != strings_.end()) {
+      WriteVarint(it->second + 1);
+    } else {
+      uint64_t id = strings_.size();
+      strings_.emplace(value, id);
+      WriteVarint(0);
+      WriteBytes(value);
+    }
+  }
+  void Flush() {
+    if (buffer_.size() != 0) {
+      strm_->Write(static_cast<uint64_t>(buffer_.size()));
+      strm_->Write(buffer_.data(), buffer_.size());
+      buffer_.clear();
+    }
+  }
+  // Flush and write the empty chunk that ends the node.
+  void Finish() {
+    Flush();
+    strm_->Write(static_cast<uint64_t>(0));
+  }
+
+ private:
+  dmlc::Stream* strm_;
+  std::vector<char> buffer_;
+  std::unordered_map<std::string, uint64_t> strings_;
+};
+
+// Buffered input stream of the binary format.
+class BinaryNodeReader : public dmlc::Stream {
+ public:
+  explicit BinaryNodeReader(dmlc::Stream* strm)
+      : strm_(strm), buffer_(kTVMNodeBinaryChunkSize) {}
+
+  size_t Read(void* ptr, size_t size) final {
+    char* data = static_cast<char*>(ptr);
+    size_t nread = 0;
+    while (nread < size) {
+      if (pos_ == end_ && !Fill()) break;
+      size_t n = std::min(size - nread, end_ - pos_);
+      std::memcpy(data + nread, &buffer_[pos_], n);
+      pos_ += n;
+      nread += n;
+    }
+    return nread;
+  }
+  void Write(const void* ptr, size_t size) final {
+    LOG(FATAL) << "BinaryNodeReader is read only";
+  }
+  using dmlc::Stream::Read;
+
+  uint64_t ReadVarint() {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      if (pos_ == end_) {
+        CHECK(Fill()) << "BinaryReader: unexpected end of stream";
+      }
+      uint8_t byte = static_cast<uint8_t>(buffer_[pos_++]);
+      value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0) return value;
+    }
+    LOG(FATAL) << "BinaryReader: invalid varint";
+    return 0;
+  }
+  int64_t ReadSigned() {
+    uint64_t value = ReadVarint();
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+  }
+  std::string ReadBytes() {
+    std::string value(ReadVarint(), '\0');
+    CHECK_EQ(Read(dmlc::BeginPtr(value), value.size()), value.size())
+        << "BinaryReader: unexpected end of stream";
+    return value;
+  }
+  const std::string& ReadString() {
+    uint64_t id = ReadVarint();
+    if (id == 0) {
+      strings_.emplace_back(ReadBytes());
+      return strings_.back();
+    }
+    CHECK_LE(id, strings_.size()) << "BinaryReader: invalid string id";
+    return strings_[id - 1];
+  }
+  // Check that the node is fully read and consume its end.
+  void Finish() {
+    CHECK(pos_ == end_ && !Fill()) << "BinaryReader: unexpected data after the node";
+  }
+
+ private:
+  // Read the next chunk, exactly its bytes are taken from the stream.
+  bool Fill() {
+    pos_ = end_ = 0;
+    if (finished_) return false;
+    uint64_t size;
+    CHECK(strm_->Read(&size)) << "BinaryReader: unexpected end of stream";
+    CHECK_LE(size, kTVMNodeBinaryChunkSize) << "BinaryReader: invalid chunk size";
+    if (size == 0) {
+      finished_ = true;
+      return false;
+    }
+    end_ = static_cast<size_t>(size);
+    CHECK_EQ(strm_->Read(dmlc::BeginPtr(buffer_), end_), end_)
+        << "BinaryReader: unexpected end of stream";
+    return true;
+  }
+
+  dmlc::Stream* strm_;
+  std::vector<char> buffer_;
+  size_t pos_{0}, end_{0};
+  // Whether the empty chunk at the end of the node was read.
+  bool finished_{false};
+  // deque keeps references to the strings valid.
+  std::deque<std::string> strings_;
+};
+
+// Helper class to write the fields of a node
+// using the existing index.
+class BinaryAttrGetter : public AttrVisitor {
+ public:
+  const std::unordered_map<Object*, size_t>* node_index_;
+  const std::unordered_map<DLTensor*, size_t>* tensor_index_;
+  BinaryNodeWriter* writer_;
+  ReflectionVTable* reflection_ = ReflectionVTable::Global();
+
+  void Visit(const char* key, double* value) final {
+    writer_->WriteString(key);
+    writer_->Write(*value);
+  }
+  void Visit(const char* key, int64_t* value) final {
+    writer_->WriteString(key);
+    writer_->WriteSigned(*value);
+  }
+  void Visit(const char* key, uint64_t* value) final {
+    writer_->WriteString(key);
+    writer_->WriteVarint(*value);
+  }
+  void Visit(const char* key, int* value) final {
+    writer_->WriteString(key);
+    writer_->WriteSigned(*value);
+  }
+  void Visit(const char* key, bool* value) final {
+    writer_->WriteString(key);
+    writer_->WriteVarint(*value);
+  }
+  void Visit(const char* key, std::string* value) final {
+    writer_->WriteString(key);
+    writer_->WriteString(*value);
+  }
+  void Visit(const char* key, void** value) final {
+    LOG(FATAL) << "not allowed to serialize a pointer";
+  }
+  void Visit(const char* key, DataType* value) final {
+    writer_->WriteString(key);
+    writer_->WriteVarint(value->code());
+    writer_->WriteVarint(value->bits());
+    writer_->WriteVarint(value->lanes());
+  }
+  void Visit(const char* key, runtime::NDArray* value) final {
+    writer_->WriteString(key);
+    writer_->WriteVarint(tensor_index_->at(const_cast<DLTensor*>((*value).operator->())));
+  }
+  void Visit(const char* key, ObjectRef* value) final {
+    writer_->WriteString(key);
+    writer_->WriteVarint(node_index_->at(const_cast<Object*>(value->get())));
+  }
+
+  // Write the fields of the node.
+  void Get(Object* node) {
+    if (node->IsInstance<ArrayNode>()) {
+      ArrayNode* n = static_cast<ArrayNode*>(node);
+      writer_->WriteVarint(n->data.size());
+      for (const auto& sp : n->data) {
+        writer_->WriteVarint(node_index_->at(const_cast<Object*>(sp.get())));
+      }
+    } else if (node->IsInstance<MapNode>()) {
+      MapNode* n = static_cast<MapNode*>(node);
+      writer_->WriteVarint(n->data.size());
+      for (const auto& kv : n->data) {
+        writer_->WriteVarint(node_index_->at(const_cast<Object*>(kv.first.get())));
+        writer_->WriteVarint(node_index_->at(const_cast<Object*>(kv.second.get())));
+      }
+    } else if (node->IsInstance<StrMapNode>()) {
+      StrMapNode* n = static_cast<StrMapNode*>(node);
+      writer_->WriteVarint(n->data.size());
+      for (const auto& kv : n->data) {
+        writer_->WriteString(kv.first);
+        writer_->WriteVarint(node_index_->at(const_cast<Object*>(kv.second.get())));
+      }
+    } else {
+      reflection_->VisitAttrs(node, this);
+    }
+  }
+};
+
+// Helper class to set the fields of a node
+// from the binary stream.
+class BinaryAttrSetter : public AttrVisitor {
+ public:
+  const std::vector<ObjectPtr<Object> >* node_list_;
+  const std::vector<runtime::NDArray>* tensor_list_;
+  BinaryNodeReader* reader_;
+  ReflectionVTable* reflection_ = ReflectionVTable::Global();
+
+  void ReadKey(const char* key) {
+    const std::string& field = reader_->ReadString();
+    if (field != key) {
+      LOG(FATAL) << "BinaryReader: expect field " << key << " but get " << field;
+    }
+  }
+  void Visit(const char* key, double* value) final {
+    ReadKey(key);
+    CHECK(reader_->Read(value)) << "BinaryReader: unexpected end of stream";
+  }
+  void Visit(const char* key, int64_t* value) final {
+    ReadKey(key);
+    *value = reader_->ReadSigned();
+  }
+  void Visit(const char* key, uint64_t* value) final {
+    ReadKey(key);
+    *value = reader_->ReadVarint();
+  }
+  void Visit(const char* key, int* value) final {
+    ReadKey(key);
+    *value = static_cast<int>(reader_->ReadSigned());
+  }
+  void Visit(const char* key, bool* value) final {
+    ReadKey(key);
+    *value = reader_->ReadVarint() != 0;
+  }
+  void Visit(const char* key, std::string* value) final {
+    ReadKey(key);
+    *value = reader_->ReadString();
+  }
+  void Visit(const char* key, void** value) final {
+    LOG(FATAL) << "not allowed to deserialize a pointer";
+  }
+  void Visit(const char* key, DataType* value) final {
+    ReadKey(key);
+    int code = static_cast<int>(reader_->ReadVarint());
+    int bits = static_cast<int>(reader_->ReadVarint());
+    int lanes = static_cast<int>(reader_->ReadVarint());
+    *value = DataType(code, bits, lanes);
+  }
+  void Visit(const char* key, runtime::NDArray* value) final {
+    ReadKey(key);
+    *value = tensor_list_->at(reader_->ReadVarint());
+  }
+  void Visit(const char* key, ObjectRef* value) final {
+    ReadKey(key);
+    *value = ObjectRef(node_list_->at(reader_->ReadVarint()));
+  }
+
+  // Read the fields of the node.
+  void Set(Object* node) {
+    if (node->IsInstance<ArrayNode>()) {
+      ArrayNode* n = static_cast<ArrayNode*>(node);
+      n->data.resize(reader_->ReadVarint());
+      for (auto& sp : n->data) {
+        sp = ObjectRef(node_list_->at(reader_->ReadVarint()));
+      }
+    } else if (node->IsInstance<MapNode>()) {
+      MapNode* n = static_cast<MapNode*>(node);
+      for (uint64_t i = reader_->ReadVarint(); i != 0; --i) {
+        ObjectRef key(node_list_->at(reader_->ReadVarint()));
+        n->data[key] = ObjectRef(node_list_->at(reader_->ReadVarint()));
+      }
+    } else if (node->IsInstance<StrMapNode>()) {
+      StrMapNode* n = static_cast<StrMapNode*>(node);
+      for (uint64_t i = reader_->ReadVarint(); i != 0; --i) {
+        std::string key = reader_->ReadString();
+        n->data[key] = ObjectRef(node_list_->at(reader_->ReadVarint()));
+      }
+    } else {
+      reflection_->VisitAttrs(node, this);
+    }
+  }
+};
+
+void SaveBinary(dmlc::Stream* strm, const ObjectRef& n) {
+  NodeIndexer indexer;
+  indexer.MakeIndex(const_cast<Object*>(n.get()));
+  strm->Write(kTVMNodeBinaryMagic);
+  strm->Write(kTVMNodeBinaryVersion);
+  BinaryNodeWriter writer(strm);
+  writer.WriteVarint(indexer.node_list_.size());
+  writer.WriteVarint(indexer.node_index_.at(const_cast<Object*>(n.get())));
+  // The type and repr bytes of every node come first,
+  // so that the reader can create all of them before setting the fields.
+  ReflectionVTable* reflection = ReflectionVTable::Global();
+  std::vector<bool> has_repr(indexer.node_list_.size(), false);
+  std::string repr_bytes;
+  for (size_t i = 0; i < indexer.node_list_.size(); ++i) {
+    Object* node = indexer.node_list_[i];
+    if (node == nullptr) {
+      writer.WriteString("");
+      continue;
+    }
+    writer.WriteString(node->GetTypeKey());
+    repr_bytes.clear();
+    has_repr[i] = reflection->GetReprBytes(node, &repr_bytes);
+    if (has_repr[i]) {
+      writer.WriteVarint(1);
+      writer.WriteBytes(repr_bytes);
+    } else {
+      writer.WriteVarint(0);
+    }
+  }
+  writer.WriteVarint(indexer.tensor_list_.size());
+  for (DLTensor* tensor : indexer.tensor_list_) {
+    runtime::SaveDLTensor(&writer, tensor);
+  }
+  BinaryAttrGetter getter;
+  getter.node_index_ = &indexer.node_index_;
+  getter.tensor_index_ = &indexer.tensor_index_;
+  getter.writer_ = &writer;
+  for (size_t i = 0; i < indexer.node_list_.size(); ++i) {
+    if (indexer.node_list_[i] != nullptr && !has_repr[i]) {
+      getter.Get(indexer.node_list_[i]);
+    }
+  }
+  writer.Finish();
+}
+
+ObjectRef LoadBinary(dmlc::Stream* strm) {
+  uint64_t header, version;
+  CHECK(strm->Read(&header) && header == kTVMNodeBinaryMagic)
+      << "Invalid binary node format";
+  CHECK(strm->Read(&version)) << "Invalid binary node format";
+  CHECK_EQ(version, kTVMNodeBinaryVersion)
+      << "Unsupported binary node format version " << version;
+  BinaryNodeReader reader(strm);
+  size_t num_nodes = reader.ReadVarint();
+  size_t root = reader.ReadVarint();
+  CHECK_LT(root, num_nodes) << "Invalid binary node format";
+
+  ReflectionVTable* reflection = ReflectionVTable::Global();
+  std::vector<ObjectPtr<Object> > nodes;
+  std::vector<bool> has_repr(num_nodes, false);
+  nodes.reserve(num_nodes);
+  for (size_t i = 0; i < num_nodes; ++i) {
+    const std::string& type_key = reader.ReadString();
+    if (type_key.length() == 0) {
+      nodes.emplace_back(ObjectPtr<Object>());
+      continue;
+    }
+    has_repr[i] = reader.ReadVarint() != 0;
+    nodes.emplace_back(reflection->CreateInitObject(
+        type_key, has_repr[i] ? reader.ReadBytes() : std::string()));
+  }
+  std::vector<runtime::NDArray> tensors(reader.ReadVarint());
+  for (runtime::NDArray& tensor : tensors) {
+    CHECK(tensor.Load(&reader));
+  }
+  BinaryAttrSetter setter;
+  setter.node_list_ = &nodes;
+  setter.tensor_list_ = &tensors;
+  setter.reader_ = &reader;
+  for (size_t i = 0; i < num_nodes; ++i) {
+    if (nodes[i] != nullptr && !has_repr[i]) {
+      setter.Set(nodes[i].get());
+    }
+  }
+  reader.Finish();
+  return ObjectRef(nodes.at(root));
+}
+
 TVM_REGISTER_GLOBAL("node.SaveJSON")
 .set_body_typed(SaveJSON);
 
 TVM_REGISTER_GLOBAL("node.LoadJSON")
 .set_body_typed(LoadJSON);
+
+TVM_REGISTER_GLOBAL("node.SaveBinary")
+.set_body([](TVMArgs args, TVMRetValue* rv) {
+    std::string blob;
+    dmlc::MemoryStringStream strm(&blob);
+    SaveBinary(&strm, args[0]);
+    TVMByteArray arr;
+    arr.data = blob.data();
+    arr.size = blob.size();
+    *rv = arr;
+  });
+
+TVM_REGISTER_GLOBAL("node.LoadBinary")
+.set_body([](TVMArgs args, TVMRetValue* rv) {
+    std::string blob = args[0];
+    dmlc::MemoryStringStream strm(&blob);
+    *rv = LoadBinary(&strm);
+  });
 }  // namespace tvm
@@ -52,6 +52,18 @@ SHashReduce(const Object* self, SHashReducer reducer) const {
 class VarCountingSHashHandler :
       public SHashReducer::Handler {
  public:
+  /*!
+   * \brief A node hashed before a subterm that the hash of the subterm
+   *  depends on, only tracked with a cache.
+   */
+  struct OuterRef {
+    /*! \brief The node, kept alive by the subterm. */
+    const Object* object;
+    /*! \brief The hash of the node. */
+    size_t hash;
+    /*! \brief The position of the node in the memo. */
+    size_t memo_index;
+  };
   /*! \brief Pending reduce tasks. */
   struct Task {
     /*!
@@ -70,14 +82,46 @@ class VarCountingSHashHandler :
     bool graph_node_hash{false};
     /*! \brief whether to map the free variables. */
     bool map_free_vars;
+    // The fields below are only maintained with a cache.
+    /*! \brief Whether the node reduced a free var itself. */
+    bool free_var{false};
+    /*! \brief Whether the hash depends on nodes missing from the memo. */
+    bool pinned{false};
+    /*! \brief The nodes hashed before the task that the hash depends on. */
+    std::vector<OuterRef> outer_refs;
+    /*! \brief The nodes that the hash depends on not having been hashed. */
+    std::vector<const Object*> absent_refs;
+    /*! \brief The size of the memo when the children were expanded. */
+    size_t memo_begin{0};
+    /*! \brief The number of exported nodes when the children were expanded. */
+    size_t export_begin{0};
+    /*! \brief The free var counter when the children were expanded. */
+    size_t free_var_begin{0};
+    /*! \brief The graph node counter when the children were expanded. */
+    size_t graph_node_begin{0};
+    /*! \brief The free var fingerprint when the children were expanded. */
+    size_t free_var_fp_begin{0};
 
     Task() = default;
     explicit Task(ObjectRef object, size_t reduced_hash, bool map_free_vars)
         : object(object), reduced_hash(reduced_hash), map_free_vars(map_free_vars) {}
   };
+  /*! \brief A hashed node. */
+  struct MemoEntry {
+    /*! \brief The hash value. */
+    size_t hash;
+    /*! \brief The position in the memo. */
+    size_t index;
+    /*! \brief Whether the node reduced a free var itself. */
+    bool free_var;
+  };
+  /*! \brief The free vars and graph nodes hashed in a hash call. */
+  using ExportLog = std::vector<std::pair<ObjectRef, MemoEntry> >;
 
-
-  VarCountingSHashHandler() {}
+  explicit VarCountingSHashHandler(SHashCacheNode::Impl* cache = nullptr)
+      : cache_(cache) {
+    if (cache_ != nullptr) exports_ = std::make_shared<ExportLog>();
+  }
 
   void MarkGraphNode() final {
     // need to push to pending tasks in this case
@@ -88,9 +132,12 @@ class VarCountingSHashHandler :
   bool LookupHashedValue(const ObjectRef& key, size_t* hash_value) final {
     auto it = hash_memo_.find(key);
     if (it != hash_memo_.end()) {
-      hash_value[0] = it->second;
+      hash_value[0] = it->second.hash;
+      if (cache_ != nullptr) AddOuterRef(&task_stack_.back(), key, it->second);
       return true;
     }
+    // The caller branches on whether the key was hashed before.
+    if (cache_ != nullptr) task_stack_.back().absent_refs.push_back(key.get());
     return false;
   }
 
@@ -101,17 +148,17 @@ class VarCountingSHashHandler :
 
   void SHashReduceFreeVar(const runtime::Object* var, bool map_free_vars) final {
     CHECK(!hash_memo_.count(GetRef<ObjectRef>(var)));
+    size_t value;
     if (map_free_vars) {
       // use counter value.
-      size_t value = std::hash<size_t>()(free_var_counter_++);
-      pending_tasks_.emplace_back(
-          Task(ObjectRef(nullptr), value, false));
+      value = std::hash<size_t>()(free_var_counter_++);
     } else {
       // use pointer hash
-      size_t value = std::hash<const runtime::Object*>()(var);
-      pending_tasks_.emplace_back(
-          Task(ObjectRef(nullptr), value, false));
+      value = std::hash<const runtime::Object*>()(var);
     }
+    if (cache_ != nullptr) task_stack_.back().free_var = true;
+    pending_tasks_.emplace_back(
+        Task(ObjectRef(nullptr), value, false));
   }
 
   void SHashReduce(const ObjectRef& object, bool map_free_vars) final {
@@ -125,7 +172,10 @@ class VarCountingSHashHandler :
     auto it = hash_memo_.find(object);
     if (it != hash_memo_.end()) {
       pending_tasks_.emplace_back(
-          Task(ObjectRef(nullptr), it->second, false));
+          Task(ObjectRef(nullptr), it->second.hash, false));
+      if (cache_ != nullptr) {
+        AddOuterRef(&pending_tasks_.back(), object, it->second);
+      }
     } else {
       // Push a pending task with initial value.
       pending_tasks_.emplace_back(
@@ -149,32 +199,67 @@ class VarCountingSHashHandler :
     CHECK_EQ(result_stack_.size(), 1U);
     size_t ret = result_stack_.back();
     result_stack_.pop_back();
+    result_infos_.clear();
     return ret;
   }
 
  protected:
+  /*! \brief What a result depends on besides its content, only tracked with a cache. */
+  struct ResultInfo {
+    bool pinned;
+    std::vector<OuterRef> outer_refs;
+    std::vector<const Object*> absent_refs;
+  };
   /*!
    * \brief Pop the top entry of the task stack and push the hash into the result stack.
    */
   void PopTaskStack() {
-    const auto& entry = task_stack_.back();
+    auto& entry = task_stack_.back();
     result_stack_.push_back(entry.reduced_hash);
+    if (cache_ != nullptr) {
+      result_infos_.push_back(ResultInfo{
+          entry.pinned, std::move(entry.outer_refs), std::move(entry.absent_refs)});
+    }
     task_stack_.pop_back();
   }
   /*!
    * \brief Compute the reduced hash value for the task.
    * \param task The indicated task.
    */
-  size_t ReduceHash(const Task& task) {
-    size_t stack_begin = task.result_stack_index;
+  size_t ReduceHash(Task* task) {
+    size_t stack_begin = task->result_stack_index;
     CHECK_LE(stack_begin, result_stack_.size());
 
     // combine in the reverse order of the stack.
-    size_t reduced_hash = task.reduced_hash;
+    size_t reduced_hash = task->reduced_hash;
     for (size_t i = result_stack_.size(); i != stack_begin; --i) {
       reduced_hash = HashCombine(reduced_hash, result_stack_[i - 1]);
     }
     result_stack_.resize(stack_begin);
+    if (cache_ != nullptr) {
+      // Keep the references to the nodes hashed before the task.
+      for (size_t i = stack_begin; i < result_infos_.size(); ++i) {
+        task->pinned |= result_infos_[i].pinned;
+        for (const OuterRef& ref : result_infos_[i].outer_refs) {
+          if (ref.memo_index < task->memo_begin) task->outer_refs.push_back(ref);
+        }
+        task->absent_refs.insert(task->absent_refs.end(),
+                                 result_infos_[i].absent_refs.begin(),
+                                 result_infos_[i].absent_refs.end());
+      }
+      result_infos_.resize(stack_begin);
+      auto& refs = task->outer_refs;
+      std::sort(refs.begin(), refs.end(), [](const OuterRef& lhs, const OuterRef& rhs) {
+        return lhs.object < rhs.object;
+      });
+      refs.erase(std::unique(refs.begin(), refs.end(), [](const OuterRef& lhs,
+                                                          const OuterRef& rhs) {
+        return lhs.object == rhs.object;
+      }), refs.end());
+      auto& absent = task->absent_refs;
+      std::sort(absent.begin(), absent.end());
+      absent.erase(std::unique(absent.begin(), absent.end()), absent.end());
+    }
     return reduced_hash;
   }
   // run the tasks.
@@ -184,13 +269,14 @@ class VarCountingSHashHandler :
       auto& entry = task_stack_.back();
       if (entry.children_expanded) {
         // reduce hash
-        entry.reduced_hash = ReduceHash(entry);
+        entry.reduced_hash = ReduceHash(&entry);
         // When all the children has expanded and visited.
         // entry.reduced_hash contains the reduced hash result.
         auto it = hash_memo_.find(entry.object);
         if (it != hash_memo_.end()) {
           // use the pre-computed hash for the object.
-          entry.reduced_hash = it->second;
+          entry.reduced_hash = it->second.hash;
+          entry.pinned = true;
         } else {
           // Append the graph node counter to the hash
           // so that we can distinguish DAG from trees.
@@ -199,7 +285,20 @@ class VarCountingSHashHandler :
                 entry.reduced_hash,
                 std::hash<size_t>()(graph_node_counter_++));
           }
-          hash_memo_[entry.object] = entry.reduced_hash;
+          MemoEntry memo{entry.reduced_hash, hash_memo_.size(), entry.free_var};
+          hash_memo_[entry.object] = memo;
+          if (cache_ != nullptr) {
+            if (entry.free_var) {
+              // The hash of the later uses of the var depends on the order of the free vars.
+              size_t var_hash = HashCombine(
+                  std::hash<const Object*>()(entry.object.get()), entry.reduced_hash);
+              free_var_fp_ = HashCombine(free_var_fp_, var_hash);
+            }
+            if (entry.free_var || entry.graph_node_hash) {
+              exports_->emplace_back(entry.object, memo);
+            }
+            if (!entry.pinned) this->StoreCache(entry);
+          }
         }
         // send value to parent.
         this->PopTaskStack();
@@ -210,13 +309,23 @@ class VarCountingSHashHandler :
         // check if there are already hash for object.
         auto it = hash_memo_.find(entry.object);
         if (it != hash_memo_.end()) {
-          entry.reduced_hash = it->second;
+          entry.reduced_hash = it->second.hash;
+          if (cache_ != nullptr) AddOuterRef(&entry, entry.object, it->second);
+          this->PopTaskStack();
+        } else if (cache_ != nullptr && this->LoadCache(&entry)) {
           this->PopTaskStack();
         } else {
           // NOTE: important to modify entry before visit.
           // as entry becomes invalid after we change the stack.
           entry.children_expanded = true;
           entry.result_stack_index = result_stack_.size();
+          entry.memo_begin = hash_memo_.size();
+          if (cache_ != nullptr) {
+            entry.export_begin = exports_->size();
+            entry.free_var_begin = free_var_counter_;
+            entry.graph_node_begin = graph_node_counter_;
+            entry.free_var_fp_begin = free_var_fp_;
+          }
 
           CHECK_EQ(pending_tasks_.size(), 0U);
           allow_push_to_stack_ = false;
@@ -250,6 +359,18 @@ class VarCountingSHashHandler :
   }
 
  private:
+  // Record that the task uses the memoised hash of object.
+  void AddOuterRef(Task* task, const ObjectRef& object, const MemoEntry& memo) {
+    // The free vars are covered by the free var fingerprint.
+    if (!memo.free_var) {
+      task->outer_refs.push_back(OuterRef{object.get(), memo.hash, memo.index});
+    }
+  }
+  // Memoise the hash of a task whose children have been reduced.
+  void StoreCache(const Task& task);
+  // Reuse the memoised hash of a task if the state of the traversal allows it.
+  bool LoadCache(Task* task);
+
   // free var counter.
   size_t free_var_counter_{0};
   // graph node counter.
@@ -265,9 +386,130 @@ class VarCountingSHashHandler :
   // reflection vtable
   ReflectionVTable* vtable_ = ReflectionVTable::Global();
   // map from lhs to rhs
-  std::unordered_map<ObjectRef, size_t, ObjectHash, ObjectEqual> hash_memo_;
+  std::unordered_map<ObjectRef, MemoEntry, ObjectHash, ObjectEqual> hash_memo_;
+  // The cache, nullptr if hashing without one.
+  SHashCacheNode::Impl* cache_;
+  // The dependencies of the results, parallel to result_stack_.
+  std::vector<ResultInfo> result_infos_;
+  // The free vars and graph nodes hashed so far.
+  std::shared_ptr<ExportLog> exports_;
+  // The fingerprint of the free vars hashed so far.
+  size_t free_var_fp_{0};
 };
 
+/*! \brief A memoised hash of a subterm. */
+struct SHashCacheEntry {
+  /*! \brief The hash value. */
+  size_t hash;
+  /*! \brief Whether the node reduced a free var itself. */
+  bool free_var;
+  /*! \brief Whether the free vars were mapped. */
+  bool map_free_vars;
+  /*! \brief The state of the traversal before and after the subterm. */
+  size_t free_var_begin, free_var_end;
+  size_t graph_node_begin, graph_node_end;
+  size_t free_var_fp_begin, free_var_fp_end;
+  /*! \brief The nodes hashed before the subterm that its hash depends on. */
+  std::vector<VarCountingSHashHandler::OuterRef> outer_refs;
+  /*! \brief The nodes that its hash depends on not having been hashed before. */
+  std::vector<const Object*> absent_refs;
+  /*! \brief The free vars and graph nodes of the subterm, the later nodes may refer to them. */
+  std::shared_ptr<VarCountingSHashHandler::ExportLog> exports;
+  size_t export_begin, export_end;
+};
+
+struct SHashCacheNode::Impl {
+  std::unordered_map<ObjectRef, SHashCacheEntry, ObjectHash, ObjectEqual> entries;
+};
+
+void VarCountingSHashHandler::StoreCache(const Task& task) {
+  SHashCacheEntry& entry = cache_->entries[task.object];
+  entry.hash = task.reduced_hash;
+  entry.free_var = task.free_var;
+  entry.map_free_vars = task.map_free_vars;
+  entry.free_var_begin = task.free_var_begin;
+  entry.free_var_end = free_var_counter_;
+  entry.graph_node_begin = task.graph_node_begin;
+  entry.graph_node_end = graph_node_counter_;
+  entry.free_var_fp_begin = task.free_var_fp_begin;
+  entry.free_var_fp_end = free_var_fp_;
+  entry.outer_refs = task.outer_refs;
+  entry.absent_refs = task.absent_refs;
+  entry.exports = exports_;
+  entry.export_begin = task.export_begin;
+  entry.export_end = exports_->size();
+}
+
+bool VarCountingSHashHandler::LoadCache(Task* task) {
+  auto it = cache_->entries.find(task->object);
+  if (it == cache_->entries.end()) return false;
+  const SHashCacheEntry& entry = it->second;
+  if (entry.map_free_vars != task->map_free_vars ||
+      entry.free_var_begin != free_var_counter_ ||
+      entry.graph_node_begin != graph_node_counter_ ||
+      entry.free_var_fp_begin != free_var_fp_) {
+    return false;
+  }
+  for (const Object* ref : entry.absent_refs) {
+    if (hash_memo_.count(GetRef<ObjectRef>(ref))) return false;
+  }
+  std::vector<OuterRef> outer_refs;
+  for (const OuterRef& ref : entry.outer_refs) {
+    auto mit = hash_memo_.find(GetRef<ObjectRef>(ref.object));
+    if (mit == hash_memo_.end() || mit->second.hash != ref.hash) return false;
+    outer_refs.push_back(OuterRef{ref.object, ref.hash, mit->second.index});
+  }
+  // The root has no later nodes that could refer to its free vars and graph nodes.
+  bool is_root = task_stack_.size() == 1 && result_stack_.empty();
+  if (!is_root) {
+    for (size_t i = entry.export_begin; i < entry.export_end; ++i) {
+      if (hash_memo_.count((*entry.exports)[i].first)) return false;
+    }
+    for (size_t i = entry.export_begin; i < entry.export_end; ++i) {
+      const auto& kv = (*entry.exports)[i];
+      MemoEntry memo{kv.second.hash, hash_memo_.size(), kv.second.free_var};
+      hash_memo_[kv.first] = memo;
+      exports_->emplace_back(kv.first, memo);
+    }
+  }
+  if (!hash_memo_.count(task->object)) {
+    hash_memo_[task->object] = MemoEntry{entry.hash, hash_memo_.size(), entry.free_var};
+  }
+  free_var_counter_ = entry.free_var_end;
+  graph_node_counter_ = entry.graph_node_end;
+  free_var_fp_ = entry.free_var_fp_end;
+  task->reduced_hash = entry.hash;
+  task->outer_refs = std::move(outer_refs);
+  task->absent_refs = entry.absent_refs;
+  return true;
+}
+
+SHashCacheNode::SHashCacheNode(size_t max_entries)
+    : impl_(new Impl()), max_entries_(max_entries) {}
+
+SHashCacheNode::~SHashCacheNode() {}
+
+size_t SHashCacheNode::Hash(const ObjectRef& key, bool map_free_vars) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  // Bound the memory, the entries keep their subterms alive.
+  if (impl_->entries.size() > max_entries_) impl_->entries.clear();
+  return VarCountingSHashHandler(impl_.get()).Hash(key, map_free_vars);
+}
+
+void SHashCacheNode::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  impl_->entries.clear();
+}
+
+size_t SHashCacheNode::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return impl_->entries.size();
+}
+
+SHashCache::SHashCache(size_t max_entries)
+    : SHashCache(make_object<SHashCacheNode>(max_entries)) {}
+
+TVM_REGISTER_OBJECT_TYPE(SHashCacheNode);
 
 TVM_REGISTER_GLOBAL("node.StructuralHash")
 .set_body_typed([](const ObjectRef& object, bool map_free_vars) -> int64_t {
@@ -276,6 +518,27 @@ TVM_REGISTER_GLOBAL("node.StructuralHash")
   return static_cast<int64_t>(hashed_value);
 });
 
+TVM_REGISTER_GLOBAL("node.SHashCache")
+.set_body_typed([](int64_t max_entries) {
+  CHECK_GE(max_entries, 0);
+  return SHashCache(static_cast<size_t>(max_entries));
+});
+
+TVM_REGISTER_GLOBAL("node.SHashCacheHash")
+.set_body_typed([](SHashCache cache, const ObjectRef& object, bool map_free_vars) -> int64_t {
+  return static_cast<int64_t>(cache->Hash(object, map_free_vars));
+});
+
+TVM_REGISTER_GLOBAL("node.SHashCacheClear")
+.set_body_typed([](SHashCache cache) {
+  cache->Clear();
+});
+
+TVM_REGISTER_GLOBAL("node.SHashCacheSize")
+.set_body_typed([](SHashCache cache) -> int64_t {
+  return static_cast<int64_t>(cache->size());
+});
+
 size_t StructuralHash::operator()(const ObjectRef& object) const {
   return VarCountingSHashHandler().Hash(object, false);
 }
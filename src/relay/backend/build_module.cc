@@ -48,6 +48,7 @@ using namespace tvm::relay::transform;
  */
 struct BuildOutput {
   std::string graph_json;
+  std::string graph_binary;
   runtime::Module mod;
   std::unordered_map<std::string, tvm::runtime::NDArray> params;
 };
@@ -128,6 +129,19 @@ class RelayBuildModule : public runtime::ModuleNode {
       return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
         *rv = this->GetGraphJSON();
       });
+    } else if (name == "get_graph_binary") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        // Most builds only need the json, the binary is made on request.
+        if (this->ret_.graph_binary.empty()) {
+          this->ret_.graph_binary =
+              (*GetPackedFunc("tvm.graph_runtime.json_to_binary"))(this->ret_.graph_json)
+                  .operator std::string();
+        }
+        TVMByteArray arr;
+        arr.data = this->ret_.graph_binary.data();
+        arr.size = this->ret_.graph_binary.size();
+        *rv = arr;
+      });
     } else if (name == "get_module") {
       return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
         *rv = this->GetModule();
@@ -450,6 +464,7 @@ class RelayBuildModule : public runtime::ModuleNode {
     graph_codegen_->Codegen(func);
 
     ret_.graph_json = graph_codegen_->GetJSON();
+    ret_.graph_binary.clear();
     ret_.params = graph_codegen_->GetParams();
 
     auto lowered_funcs = graph_codegen_->GetIRModule();
@@ -0,0 +1,287 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file relay/backend/compile_cache.cc
+ * \brief Persistent on-disk cache of the compile engine.
+ */
+#include "compile_cache.h"
+
+#include <dmlc/memory_io.h>
+#include <tvm/ir/transform.h>
+#include <tvm/node/serialization.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/target/target.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#if defined(_WIN32)
+#include <direct.h>
+#include <process.h>
+#else
+#include <dirent.h>
+#include <unistd.h>
+#include <utime.h>
+#endif
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../../runtime/file_util.h"
+
+namespace tvm {
+namespace relay {
+
+static bool FileExists(const std::string& path) {
+  struct stat st;
+  return stat(path.c_str(), &st) == 0;
+}
+
+// Mark an entry as recently used.
+static void TouchFile(const std::string& path) {
+#if !defined(_WIN32)
+  utime(path.c_str(), nullptr);
+#endif
+}
+
+static bool IsEntryName(const std::string& name) {
+  if (name.find(".tmp") != std::string::npos) return false;
+  for (const char* prefix : {"lower-", "shape_func-", "jit-"}) {
+    if (name.compare(0, strlen(prefix), prefix) == 0) return true;
+  }
+  return false;
+}
+
+// A temporary file name unique to the process and the thread.
+static std::string TempPath(const std::string& path) {
+  std::ostringstream os;
+#if defined(_WIN32)
+  os << path << ".tmp" << _getpid();
+#else
+  os << path << ".tmp" << getpid();
+#endif
+  os << "." << std::this_thread::get_id();
+  return os.str();
+}
+
+DiskCompileCache::DiskCompileCache(std::string dir, int64_t max_bytes)
+    : dir_(std::move(dir)), max_bytes_(max_bytes) {
+  CHECK(!dir_.empty()) << "The compile cache directory is empty";
+  CHECK_GT(max_bytes_, 0) << "The compile cache size limit must be positive";
+#if defined(_WIN32)
+  _mkdir(dir_.c_str());
+#else
+  mkdir(dir_.c_str(), 0777);
+#endif
+  struct stat st;
+  CHECK(stat(dir_.c_str(), &st) == 0 && (st.st_mode & S_IFDIR))
+      << "Cannot create the compile cache directory " << dir_;
+}
+
+// Print the scalar attributes of a node.
+class ScalarAttrPrinter : public AttrVisitor {
+ public:
+  explicit ScalarAttrPrinter(std::ostream* os) : os_(os) {}
+
+  void Visit(const char* key, double* value) final { Print(key, *value); }
+  void Visit(const char* key, int64_t* value) final { Print(key, *value); }
+  void Visit(const char* key, uint64_t* value) final { Print(key, *value); }
+  void Visit(const char* key, int* value) final { Print(key, *value); }
+  void Visit(const char* key, bool* value) final { Print(key, *value); }
+  void Visit(const char* key, std::string* value) final { Print(key, *value); }
+  void Visit(const char* key, DataType* value) final { Print(key, *value); }
+  void Visit(const char* key, void** value) final {}
+  void Visit(const char* key, runtime::NDArray* value) final {}
+  void Visit(const char* key, runtime::ObjectRef* value) final {}
+
+ private:
+  template<typename T>
+  void Print(const char* key, const T& value) {
+    *os_ << key << "=" << value << ";";
+  }
+
+  std::ostream* os_;
+};
+
+bool DiskCompileCache::ContextKey(std::string* context) {
+  std::ostringstream os;
+  transform::PassContext pass_ctx = transform::PassContext::Current();
+  os << "opt_level=" << pass_ctx->opt_level << ";fallback_device=" << pass_ctx->fallback_device
+     << ";required_pass=";
+  for (const auto& name : pass_ctx->required_pass) {
+    os << static_cast<std::string>(name) << ",";
+  }
+  os << ";disabled_pass=";
+  for (const auto& name : pass_ctx->disabled_pass) {
+    os << static_cast<std::string>(name) << ",";
+  }
+  os << ";";
+  BuildConfig config = BuildConfig::Current();
+  // The custom lower passes are python functions.
+  if (!config->add_lower_pass.empty()) return false;
+  ScalarAttrPrinter printer(&os);
+  const_cast<BuildConfigNode*>(config.operator->())->VisitAttrs(&printer);
+  if (const auto* fkey = runtime::Registry::Get("relay.backend._compile_cache_context_key")) {
+    TVMRetValue key = (*fkey)();
+    if (key.type_code() == kTVMNullptr) return false;
+    os << "dispatch=" << key.operator std::string() << ";";
+  }
+  *context = os.str();
+  return true;
+}
+
+std::string DiskCompileCache::EntryPath(const std::string& kind, const CCacheKey& key,
+                                        const std::string& context,
+                                        const std::string& ext) const {
+  // Lowered code changes between versions.
+  size_t hash = dmlc::HashCombine(key->Hash(), std::hash<std::string>()(TVM_VERSION));
+  hash = dmlc::HashCombine(hash, std::hash<std::string>()(context));
+  std::ostringstream os;
+  os << dir_ << "/" << kind << "-" << std::hex << std::setw(16) << std::setfill('0')
+     << static_cast<uint64_t>(hash) << "." << ext;
+  return os.str();
+}
+
+CachedFunc DiskCompileCache::Load(const std::string& kind, const CCacheKey& key) {
+  std::string context;
+  if (!ContextKey(&context)) return CachedFunc();
+  std::string path = EntryPath(kind, key, context, "bin");
+  if (!FileExists(path)) return CachedFunc();
+  try {
+    std::string blob;
+    runtime::LoadBinaryFromFile(path, &blob);
+    dmlc::MemoryStringStream strm(&blob);
+    Array<ObjectRef> entry = Downcast<Array<ObjectRef> >(LoadBinary(&strm));
+    CHECK_EQ(entry.size(), 3U);
+    // Different keys can have the same hash.
+    if (!(Downcast<CCacheKey>(entry[0]) == key) ||
+        Downcast<String>(entry[2]) != context) {
+      return CachedFunc();
+    }
+    TouchFile(path);
+    return Downcast<CachedFunc>(entry[1]);
+  } catch (const dmlc::Error& e) {
+    LOG(WARNING) << "Ignore the broken compile cache entry " << path << ": " << e.what();
+    return CachedFunc();
+  }
+}
+
+void DiskCompileCache::Save(const std::string& kind, const CCacheKey& key,
+                            const CachedFunc& cached_func) {
+  std::string context;
+  if (!ContextKey(&context)) return;
+  // The schedule is only needed to lower, it is not persisted.
+  auto node = make_object<CachedFuncNode>(*cached_func.operator->());
+  node->schedule = te::Schedule();
+  std::string blob;
+  try {
+    dmlc::MemoryStringStream strm(&blob);
+    SaveBinary(&strm, Array<ObjectRef>({key, CachedFunc(node), String(context)}));
+  } catch (const dmlc::Error& e) {
+    LOG(WARNING) << "Cannot save " << cached_func->func_name
+                 << " in the compile cache: " << e.what();
+    return;
+  }
+  WriteEntry(EntryPath(kind, key, context, "bin"), blob);
+}
+
+runtime::Module DiskCompileCache::LoadModule(const CCacheKey& key) {
+  std::string context;
+  if (!ContextKey(&context)) return runtime::Module();
+  std::string path = EntryPath("jit", key, context, "ll");
+  const auto* loadfile = runtime::Registry::Get("runtime.module.loadfile_ll");
+  if (loadfile == nullptr || !FileExists(path)) return runtime::Module();
+  try {
+    runtime::Module mod = (*loadfile)(path, "ll");
+    TouchFile(path);
+    return mod;
+  } catch (const dmlc::Error& e) {
+    LOG(WARNING) << "Ignore the broken compile cache entry " << path << ": " << e.what();
+    return runtime::Module();
+  }
+}
+
+void DiskCompileCache::SaveModule(const CCacheKey& key, runtime::Module mod) {
+  // Only a self contained LLVM module can be loaded back from its IR.
+  if (std::string(mod->type_key()) != "llvm" || mod->imports().size() != 0) return;
+  std::string context;
+  if (!ContextKey(&context)) return;
+  std::string path = EntryPath("jit", key, context, "ll");
+  std::string tmp = TempPath(path);
+  mod->SaveToFile(tmp, "ll");
+  if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+    runtime::RemoveFile(tmp);
+    return;
+  }
+  Evict();
+}
+
+void DiskCompileCache::WriteEntry(const std::string& path, const std::string& data) {
+  std::string tmp = TempPath(path);
+  runtime::SaveBinaryToFile(tmp, data);
+  if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+    runtime::RemoveFile(tmp);
+    return;
+  }
+  Evict();
+}
+
+void DiskCompileCache::Evict() {
+#if !defined(_WIN32)
+  struct Entry {
+    std::string path;
+    int64_t size;
+    time_t mtime;
+  };
+  std::vector<Entry> entries;
+  int64_t total = 0;
+  DIR* dir = opendir(dir_.c_str());
+  if (dir == nullptr) return;
+  while (dirent* ent = readdir(dir)) {
+    std::string name = ent->d_name;
+    // Only entries of the cache are counted, never other files.
+    if (!IsEntryName(name)) continue;
+    std::string path = dir_ + "/" + name;
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0 || !(st.st_mode & S_IFREG)) continue;
+    entries.push_back({path, static_cast<int64_t>(st.st_size), st.st_mtime});
+    total += st.st_size;
+  }
+  closedir(dir);
+  if (total <= max_bytes_) return;
+  std::sort(entries.begin(), entries.end(), [](const Entry& lhs, const Entry& rhs) {
+    return lhs.mtime < rhs.mtime;
+  });
+  for (const Entry& entry : entries) {
+    if (total <= max_bytes_) break;
+    // Another process may have removed it already.
+    unlink(entry.path.c_str());
+    total -= entry.size;
+  }
+#endif
+}
+
+}  // namespace relay
+}  // namespace tvm
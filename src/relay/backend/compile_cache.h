@@ -0,0 +1,115 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file relay/backend/compile_cache.h
+ * \brief Persistent on-disk cache of the compile engine.
+ *
+ *  Every entry is a file named after the hash of its CCacheKey, which
+ *  combines the structural hash of the primitive function and the target
+ *  string. Lowered functions are stored in the binary node format together
+ *  with their key, so a hash collision is detected on load. Modules built by
+ *  JIT are stored as LLVM IR when the target is LLVM.
+ *
+ *  Loading an entry refreshes its modification time, and once the
+ *  directory grows over the size limit the entries used least recently
+ *  are removed. Entries are written to a temporary file and renamed, so
+ *  several processes can share a directory.
+ *
+ *  The cache does not know about the AutoTVM dispatch context: use one
+ *  directory per set of tuning logs.
+ */
+#ifndef TVM_RELAY_BACKEND_COMPILE_CACHE_H_
+#define TVM_RELAY_BACKEND_COMPILE_CACHE_H_
+
+#include <tvm/runtime/module.h>
+
+#include <string>
+
+#include "compile_engine.h"
+
+namespace tvm {
+namespace relay {
+
+/*! \brief Persistent cache of lowered functions and JIT modules. */
+class DiskCompileCache {
+ public:
+  /*!
+   * \brief Create a cache in a directory, which is created if needed.
+   * \param dir The cache directory.
+   * \param max_bytes The size limit of all the entries in the directory.
+   */
+  DiskCompileCache(std::string dir, int64_t max_bytes);
+  /*!
+   * \brief Load a lowered function.
+   * \param kind The kind of the function, "lower" or "shape_func".
+   * \param key The key of the function.
+   * \return The lowered function, undefined if it is not cached.
+   */
+  CachedFunc Load(const std::string& kind, const CCacheKey& key);
+  /*!
+   * \brief Save a lowered function.
+   * \param kind The kind of the function, "lower" or "shape_func".
+   * \param key The key of the function.
+   * \param cached_func The lowered function.
+   */
+  void Save(const std::string& kind, const CCacheKey& key, const CachedFunc& cached_func);
+  /*!
+   * \brief Load the module built by JIT.
+   * \param key The key of the function.
+   * \return The module, undefined if it is not cached.
+   */
+  runtime::Module LoadModule(const CCacheKey& key);
+  /*!
+   * \brief Save the module built by JIT, only LLVM modules are saved.
+   * \param key The key of the function.
+   * \param mod The built module.
+   */
+  void SaveModule(const CCacheKey& key, runtime::Module mod);
+  /*! \return The cache directory. */
+  const std::string& dir() const {
+    return dir_;
+  }
+  /*!
+   * \brief Get the key of the state of this thread that changes the lowered code:
+   *  the pass context, the build config and, from python, the AutoTVM configs
+   *  and the strategies of the ops.
+   * \param context The key of the state.
+   * \return Whether the state can be keyed, the cache is bypassed when it cannot.
+   */
+  static bool ContextKey(std::string* context);
+
+ private:
+  /*! \brief Get the path of an entry. */
+  std::string EntryPath(const std::string& kind, const CCacheKey& key,
+                        const std::string& context, const std::string& ext) const;
+  /*! \brief Atomically write an entry and evict old entries. */
+  void WriteEntry(const std::string& path, const std::string& data);
+  /*! \brief Remove the least recently used entries over the size limit. */
+  void Evict();
+
+  /*! \brief The cache directory. */
+  std::string dir_;
+  /*! \brief The size limit of the directory. */
+  int64_t max_bytes_;
+};
+
+}  // namespace relay
+}  // namespace tvm
+#endif  // TVM_RELAY_BACKEND_COMPILE_CACHE_H_
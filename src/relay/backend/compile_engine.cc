@@ -26,6 +26,7 @@
 #include <topi/tags.h>
 #include <tvm/driver/driver_api.h>
 #include <tvm/ir/type_functor.h>
+#include <tvm/node/structural_hash.h>
 #include <tvm/relay/analysis.h>
 #include <tvm/relay/attrs/device_copy.h>
 #include <tvm/relay/expr.h>
@@ -37,14 +38,22 @@
 #include <tvm/te/operation.h>
 #include <tvm/te/schedule.h>
 #include <tvm/te/schedule_pass.h>
+#include <tvm/tir/function.h>
 
+#include <atomic>
+#include <cstdlib>
 #include <functional>
 #include <limits>
+#include <memory>
 #include <mutex>
+#include <string>
+#include <thread>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
+#include "compile_cache.h"
 #include "utils.h"
 
 namespace tvm {
@@ -70,6 +79,19 @@ CCacheKey::CCacheKey(Function source_func, Target target) {
   data_ = std::move(n);
 }
 
+size_t CCacheKeyNode::Hash() const {
+  if (hash_ != 0) return hash_;
+  // The graph codegen, the VM compiler and the batched lowering each make
+  // keys for the same primitive functions, the cache hashes them once.
+  static SHashCache cache;
+  // do structral hash, avoid 0.
+  hash_ = cache->Hash(this->source_func, false);
+  hash_ = dmlc::HashCombine(
+      hash_, std::hash<std::string>()(target->str()));
+  if (hash_ == 0) hash_ = 1;
+  return hash_;
+}
+
 struct IsDynamicVisitor : public TypeVisitor {
   bool is_dyn{false};
   void VisitType_(const TensorTypeNode* tt) {
@@ -213,7 +235,10 @@ class ScheduleGetter : public backend::MemoizedExprTranslator<Array<te::Tensor>>
   Array<te::Tensor> VisitExpr_(const CallNode* call_node) final {
     static auto fpattern =
         Op::GetAttr<TOpPattern>("TOpPattern");
-    static auto flower_call = tvm::runtime::Registry::Get("relay.backend.lower_call");
+    // Interned, as the function registered from python can be registered again.
+    static const runtime::Registry* lower_call =
+        runtime::Registry::Intern("relay.backend.lower_call");
+    const PackedFunc* flower_call = lower_call->function();
     CHECK(flower_call) << "relay.backend.lower_call is not registered.";
 
     Array<te::Tensor> inputs;
@@ -569,6 +594,18 @@ class MakeShapeFunc : public backend::MemoizedExprTranslator<Array<te::Tensor>>
 
 class CompileEngineImpl : public CompileEngineNode {
  public:
+  CompileEngineImpl() {
+    if (const char* dir = getenv("TVM_COMPILE_CACHE_DIR")) {
+      int64_t max_mb = kDefaultDiskCacheMB;
+      if (const char* size = getenv("TVM_COMPILE_CACHE_SIZE_MB")) {
+        max_mb = atol(size);
+      }
+      SetDiskCache(dir, max_mb << 20);
+    }
+    if (const char* num_threads = getenv("TVM_NUM_LOWER_THREADS")) {
+      num_threads_ = atoi(num_threads);
+    }
+  }
   // Lower the function.
   CachedFunc Lower(const CCacheKey& key)  {
     return LowerInternal(key)->cached_func;
@@ -578,6 +615,15 @@ class CompileEngineImpl : public CompileEngineNode {
   PackedFunc JIT(const CCacheKey& key) final {
     CCacheValue value = LowerInternal(key);
     if (value->packed_func != nullptr) return value->packed_func;
+    std::shared_ptr<DiskCompileCache> disk_cache = GetDiskCache();
+    if (disk_cache != nullptr) {
+      tvm::runtime::Module m = disk_cache->LoadModule(key);
+      // The function may have been renamed since the module was saved.
+      if (m.defined()) {
+        value->packed_func = m.GetFunction(value->cached_func->func_name);
+        if (value->packed_func != nullptr) return value->packed_func;
+      }
+    }
     // build the function.
     tvm::runtime::Module m;
     if (const auto* f = runtime::Registry::Get("relay.backend.build")) {
@@ -586,6 +632,9 @@ class CompileEngineImpl : public CompileEngineNode {
       m = build(value->cached_func->funcs, key->target, Target(nullptr), BuildConfig::Current());
     }
     value->packed_func = m.GetFunction(value->cached_func->func_name);
+    if (disk_cache != nullptr) {
+      disk_cache->SaveModule(key, m);
+    }
     return value->packed_func;
   }
 
@@ -593,6 +642,98 @@ class CompileEngineImpl : public CompileEngineNode {
     return LowerShapeFuncInternal(key)->cached_func;
   }
 
+  void LowerBatch(const Array<CCacheKey>& keys) final {
+    int num_threads = GetNumThreads();
+    if (num_threads <= 0) {
+      num_threads = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+    }
+    // Use the config Lower would use, the python lower uses the current one.
+    BuildConfig config = runtime::Registry::Get("relay.backend.lower") != nullptr ?
+        BuildConfig::Current() : BuildConfig::Create();
+    // The custom lower passes are python functions.
+    if (num_threads == 1 || !config->add_lower_pass.empty() || config->dump_pass_ir) return;
+    // The functions are scheduled serially as the strategies are python functions,
+    // and in the order of the keys so that they get the names of a serial lowering.
+    std::vector<CCacheKey> lower_keys;
+    std::vector<ObjectPtr<CachedFuncNode> > lower_funcs;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      std::unordered_set<CCacheKey> visited;
+      for (const CCacheKey& key : keys) {
+        if (!visited.insert(key).second || prelowered_.count(key)) continue;
+        auto it = cache_.find(key);
+        if (it != cache_.end() && it->second->cached_func.defined()) continue;
+        if (key->source_func->GetAttr<String>(attr::kCompiler).defined()) continue;
+        With<Target> target_scope(key->target);
+        if (disk_cache_ != nullptr) {
+          CachedFunc cached_func = disk_cache_->Load("lower", key);
+          if (cached_func.defined()) {
+            prelowered_[key] =
+                RenameCachedFunc(cached_func, GetUniqueName(cached_func->func_name));
+            continue;
+          }
+        }
+        auto cfunc = CreateSchedule(key->source_func, key->target);
+        auto cache_node = make_object<CachedFuncNode>(*(cfunc.operator->()));
+        const Expr body = (key->source_func)->body;
+        if (const CallNode* call_node = body.as<CallNode>()) {
+          if (call_node->attrs.as<DeviceCopyAttrs>()) {
+            prelowered_[key] = CachedFunc(cache_node);
+            continue;
+          }
+        }
+        cache_node->func_name = GetUniqueName(cache_node->func_name);
+        lower_keys.push_back(key);
+        lower_funcs.push_back(cache_node);
+      }
+    }
+    // Lower the schedules concurrently, which only runs the passes of the c++ pipeline.
+    std::vector<std::string> errors(lower_keys.size());
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+      for (size_t i = next++; i < lower_keys.size(); i = next++) {
+        CachedFuncNode* cache_node = lower_funcs[i].get();
+        try {
+          With<Target> target_scope(lower_keys[i]->target);
+          With<BuildConfig> config_scope(config);
+          Array<te::Tensor> all_args = cache_node->inputs;
+          for (te::Tensor arg : cache_node->outputs) {
+            all_args.push_back(arg);
+          }
+          std::unordered_map<te::Tensor, tir::Buffer> binds;
+          cache_node->funcs = tvm::lower(cache_node->schedule, all_args, cache_node->func_name,
+                                         binds, config);
+        } catch (const dmlc::Error& e) {
+          errors[i] = e.what();
+        }
+      }
+    };
+    std::vector<std::thread> threads;
+    size_t num_workers = std::min(static_cast<size_t>(num_threads), lower_keys.size());
+    for (size_t i = 1; i < num_workers; ++i) {
+      threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    for (size_t i = 0; i < lower_keys.size(); ++i) {
+      CHECK(errors[i].empty())
+          << errors[i] << "\n"
+          << "Error during compile function\n"
+          << "-----------------------------\n"
+          << AsText(lower_keys[i]->source_func, false);
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < lower_keys.size(); ++i) {
+      CachedFunc cached_func(lower_funcs[i]);
+      prelowered_[lower_keys[i]] = cached_func;
+      if (disk_cache_ != nullptr) {
+        disk_cache_->Save("lower", lower_keys[i], cached_func);
+      }
+    }
+  }
+
   Array<tvm::runtime::Module> LowerExternalFunctions() {
     std::unordered_map<std::string, IRModule> ext_mods;
     std::vector<CCacheKey> cached_ext_funcs;
@@ -635,6 +776,39 @@ class CompileEngineImpl : public CompileEngineNode {
 
   void Clear() final {
     cache_.clear();
+    prelowered_.clear();
+  }
+  /*!
+   * \brief Set the number of threads used by LowerBatch.
+   * \param num_threads The number of threads, 1 to lower serially
+   *  and 0 to use all the cores.
+   */
+  void SetNumThreads(int num_threads) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    num_threads_ = num_threads;
+  }
+  // Get the number of threads used by LowerBatch.
+  int GetNumThreads() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return num_threads_;
+  }
+  /*!
+   * \brief Set the persistent cache consulted before lowering.
+   * \param dir The cache directory, empty to disable the cache.
+   * \param max_bytes The size limit of the cache directory.
+   */
+  void SetDiskCache(const std::string& dir, int64_t max_bytes) {
+    std::shared_ptr<DiskCompileCache> disk_cache;
+    if (!dir.empty()) {
+      disk_cache = std::make_shared<DiskCompileCache>(dir, max_bytes);
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    disk_cache_ = disk_cache;
+  }
+  // Get the persistent cache, nullptr if disabled.
+  std::shared_ptr<DiskCompileCache> GetDiskCache() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return disk_cache_;
   }
   // List all items in the cache.
   Array<ObjectRef> ListItems() {
@@ -685,10 +859,23 @@ class CompileEngineImpl : public CompileEngineNode {
       value->cached_func = CachedFunc(cache_node);
       return value;
     }
+    auto pit = prelowered_.find(key);
+    if (pit != prelowered_.end()) {
+      value->cached_func = pit->second;
+      prelowered_.erase(pit);
+      return value;
+    }
     // Enforce use the target.
     With<Target> target_scope(key->target);
 
     CHECK(!value->cached_func.defined());
+    if (disk_cache_ != nullptr) {
+      CachedFunc cached_func = disk_cache_->Load("lower", key);
+      if (cached_func.defined()) {
+        value->cached_func = RenameCachedFunc(cached_func, GetUniqueName(cached_func->func_name));
+        return value;
+      }
+    }
     auto cfunc = CreateSchedule(key->source_func, key->target);
     auto cache_node = make_object<CachedFuncNode>(
         *(cfunc.operator->()));
@@ -719,6 +906,9 @@ class CompileEngineImpl : public CompileEngineNode {
                                      binds, bcfg);
     }
     value->cached_func = CachedFunc(cache_node);
+    if (disk_cache_ != nullptr) {
+      disk_cache_->Save("lower", key, value->cached_func);
+    }
     return value;
   }
   // implement lowered shape func
@@ -739,6 +929,13 @@ class CompileEngineImpl : public CompileEngineNode {
     With<Target> target_scope(key->target);
 
     CHECK(!value->cached_func.defined());
+    if (disk_cache_ != nullptr) {
+      CachedFunc cached_func = disk_cache_->Load("shape_func", key);
+      if (cached_func.defined()) {
+        value->cached_func = RenameCachedFunc(cached_func, GetUniqueName(cached_func->func_name));
+        return value;
+      }
+    }
     auto spair = MakeShapeFunc().Create(key->source_func);
     auto cache_node = make_object<CachedFuncNode>(
             *(spair.second.operator->()));
@@ -753,6 +950,9 @@ class CompileEngineImpl : public CompileEngineNode {
     std::unordered_map<te::Tensor, tir::Buffer> binds;
     cache_node->funcs = tvm::lower(spair.first, all_args, cache_node->func_name, binds, bcfg);
     value->cached_func = CachedFunc(cache_node);
+    if (disk_cache_ != nullptr) {
+      disk_cache_->Save("shape_func", key, value->cached_func);
+    }
     return value;
   }
   /*!
@@ -778,6 +978,31 @@ class CompileEngineImpl : public CompileEngineNode {
     }
     return name;
   }
+  /*!
+   * \brief Rename a function loaded from the persistent cache.
+   * \param cached_func The loaded function.
+   * \param name The new name, unique in this engine.
+   * \return The renamed function.
+   */
+  CachedFunc RenameCachedFunc(const CachedFunc& cached_func, const std::string& name) {
+    if (cached_func->func_name == name) return cached_func;
+    auto cache_node = make_object<CachedFuncNode>(*(cached_func.operator->()));
+    cache_node->func_name = name;
+    cache_node->funcs = IRModule::Empty();
+    for (const auto& kv : cached_func->funcs->functions) {
+      if (kv.first->name_hint != cached_func->func_name) {
+        cache_node->funcs->Add(kv.first, kv.second);
+      } else if (const auto* prim_func = kv.second.as<tir::PrimFuncNode>()) {
+        cache_node->funcs->Add(GlobalVar(name), WithAttr(GetRef<tir::PrimFunc>(prim_func),
+                                                         tvm::attr::kGlobalSymbol, String(name)));
+      } else {
+        cache_node->funcs->Add(GlobalVar(name), kv.second);
+      }
+    }
+    return CachedFunc(cache_node);
+  }
+  /*! \brief Default size limit of the persistent cache in MB. */
+  static constexpr int64_t kDefaultDiskCacheMB = 1024;
   /*! \brief compiler cache lock*/
   std::mutex mutex_;
   /*! \brief internal name map to get an unique name */
@@ -786,6 +1011,12 @@ class CompileEngineImpl : public CompileEngineNode {
   std::unordered_map<CCacheKey, CCacheValue> cache_;
   /*! \brief internal compiler cache for shape funcs */
   std::unordered_map<CCacheKey, CCacheValue> shape_func_cache_;
+  /*! \brief persistent compiler cache, nullptr if disabled */
+  std::shared_ptr<DiskCompileCache> disk_cache_;
+  /*! \brief functions lowered by LowerBatch that were not requested yet */
+  std::unordered_map<CCacheKey, CachedFunc> prelowered_;
+  /*! \brief number of threads used by LowerBatch */
+  int num_threads_{1};
 };
 
 /*! \brief The global compile engine */
@@ -840,6 +1071,24 @@ TVM_REGISTER_GLOBAL("relay.backend._CompileEngineJIT")
   return self->JIT(key);
 });
 
+TVM_REGISTER_GLOBAL("relay.backend._CompileEngineSetDiskCache")
+.set_body_typed(
+    [](CompileEngine self, std::string dir, int64_t max_bytes) {
+  static_cast<CompileEngineImpl*>(self.operator->())->SetDiskCache(dir, max_bytes);
+});
+
+TVM_REGISTER_GLOBAL("relay.backend._CompileEngineLowerBatch")
+.set_body_typed(
+    [](CompileEngine self, Array<CCacheKey> keys) {
+  self->LowerBatch(keys);
+});
+
+TVM_REGISTER_GLOBAL("relay.backend._CompileEngineSetNumThreads")
+.set_body_typed(
+    [](CompileEngine self, int num_threads) {
+  static_cast<CompileEngineImpl*>(self.operator->())->SetNumThreads(num_threads);
+});
+
 TVM_REGISTER_GLOBAL("relay.backend._CompileEngineListItems")
 .set_body_typed(
     [](CompileEngine self){
@@ -119,7 +119,7 @@ class CCacheKeyNode : public Object {
     v->Visit("target", &target);
   }
   /*! \return The hash value of CCacheKey. */
-  inline size_t Hash() const;
+  size_t Hash() const;
   /*!
    * \brief check content equality
    * \param other The other value.
@@ -219,6 +219,18 @@ class CompileEngineNode : public Object {
    * \return The result.
    */
   virtual CachedFunc LowerShapeFunc(const CCacheKey& key) = 0;
+  /*!
+   * \brief Lower the functions of the keys that are not lowered yet ahead of
+   *  the calls to Lower, running the lowering passes of independent keys
+   *  concurrently. The functions get the names they would get if they were
+   *  lowered in the order of the keys.
+   *
+   *  Nothing is done when the engine lowers with a single thread, or when
+   *  the build config has custom lower passes.
+   *
+   * \param keys The keys in the order they will be lowered.
+   */
+  virtual void LowerBatch(const Array<CCacheKey>& keys) = 0;
   /*!
    * \brief Lower the external function using external codegen tools.
    * \return The runtime moduels for each needed external codegen tool.
@@ -256,16 +268,6 @@ class CompileEngine : public ObjectRef {
 bool IsDynamic(const Type& ty);
 
 // implementations
-inline size_t CCacheKeyNode::Hash() const {
-  if (hash_ != 0) return hash_;
-  // do structral hash, avoid 0.
-  hash_ = tvm::StructuralHash()(this->source_func);
-  hash_ = dmlc::HashCombine(
-      hash_, std::hash<std::string>()(target->str()));
-  if (hash_ == 0) hash_ = 1;
-  return hash_;
-}
-
 inline bool CCacheKeyNode::Equal(
     const CCacheKeyNode* other) const {
   if (Hash() != other->Hash()) return false;
@@ -22,10 +22,20 @@
  * \brief Memory index assignment pass for executing
  *   the program in the graph runtime.
  */
+#include <dmlc/json.h>
 #include <tvm/tir/op.h>
 #include <tvm/relay/expr.h>
 #include <tvm/relay/expr_functor.h>
 #include <tvm/relay/analysis.h>
+#include <tvm/runtime/device_api.h>
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
 #include "../../support/arena.h"
 
 namespace tvm {
@@ -45,8 +55,45 @@ struct StorageToken {
   int device_type{0};
   /*! \brief The storage id */
   int64_t storage_id{-1};
+  /*! \brief The offset in bytes in the arena of the device, for the arena planner. */
+  int64_t offset{-1};
+  /*! \brief The first and the last call the storage is live in, for the arena planner. */
+  size_t begin{0};
+  size_t end{0};
 };
 
+/*!
+ * \brief ceil(size/word_size) to get number of words.
+ * \param size The original size.
+ * \param word_size The element size.
+ */
+static size_t DivRoundUp(size_t size, size_t word_size) {
+  return (size + word_size - 1) / word_size;
+}
+
+/*!
+ * \brief Get the memory requirement.
+ * \param prototype The prototype token.
+ * \return The required memory size.
+ */
+static size_t GetMemorySize(const StorageToken* prototype) {
+  const TensorTypeNode* ttype = prototype->ttype;
+  CHECK(ttype != nullptr);
+  size_t size = 1;
+  for (IndexExpr dim : ttype->shape) {
+    const int64_t* pval = tir::as_const_int(dim);
+    CHECK(pval != nullptr)
+        << "Cannot allocate memory symbolic tensor shape "
+        << ttype->shape;
+    CHECK_GE(*pval, 0)
+        << "Cannot allocate memory for tensor with negative shape"
+        << *pval;
+    size *= static_cast<size_t>(pval[0]);
+  }
+  size *= DivRoundUp(ttype->dtype.bits() * ttype->dtype.lanes(), 8);
+  return size;
+}
+
 class StorageAllocaBaseVisitor : public ExprVisitor {
  public:
   // run the visitor on a function.
@@ -191,12 +238,13 @@ class StorageAllocaInit : protected StorageAllocaBaseVisitor {
 class StorageAllocator : public StorageAllocaBaseVisitor {
  public:
   /*!
+   * \param alignment The alignment each storage is rounded up to.
    * \return totoal number of bytes allocated
    */
-  size_t TotalAllocBytes() const {
+  size_t TotalAllocBytes(size_t alignment = 1) const {
     size_t total = 0;
     for (const auto* p : data_) {
-      total += p->max_bytes;
+      total += DivRoundUp(p->max_bytes, alignment) * alignment;
     }
     return total;
   }
@@ -277,36 +325,6 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
       CheckForRelease(tok);
     }
   }
-  /*!
-   * \brief ceil(size/word_size) to get number of words.
-   * \param size The original size.
-   * \param word_size The element size.
-   */
-  static size_t DivRoundUp(size_t size, size_t word_size) {
-    return (size + word_size - 1) / word_size;
-  }
-  /*!
-   * \brief Get the memory requirement.
-   * \param prototype The prototype token.
-   * \return The required memory size.
-   */
-  size_t GetMemorySize(StorageToken* prototype) {
-    const TensorTypeNode* ttype = prototype->ttype;
-    CHECK(ttype != nullptr);
-    size_t size = 1;
-    for (IndexExpr dim : ttype->shape) {
-      const int64_t* pval = tir::as_const_int(dim);
-      CHECK(pval != nullptr)
-          << "Cannot allocate memory symbolic tensor shape "
-          << ttype->shape;
-      CHECK_GE(*pval, 0)
-          << "Cannot allocate memory for tensor with negative shape"
-          << *pval;
-      size *= static_cast<size_t>(pval[0]);
-    }
-    size *= DivRoundUp(ttype->dtype.bits() * ttype->dtype.lanes(), 8);
-    return size;
-  }
   /*!
    * \brief Request a storage token for a given prototype.
    * \param prototype. The prototype storage token.
@@ -386,12 +404,226 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
   std::unordered_map<const ExprNode*, std::vector<StorageToken*> > prototype_;
 };
 
+/*!
+ * \brief Plan the storages of each device into one arena at byte offsets.
+ *
+ *  Every tensor gets its own storage, live from the call making it to the last
+ *  call reading it, or for the whole run for the params, the constants and the
+ *  outputs. This is a packing of the lifetimes and the sizes into the arena:
+ *  the storages are placed from the largest, each in the smallest gap that
+ *  fits it between the storages live at the same time, or above them all.
+ */
+class StorageArenaPlanner : public StorageAllocaBaseVisitor {
+ public:
+  // Run the arena planning for a function.
+  Map<Expr, Array<IntegerArray> > Plan(const Function& func) {
+    prototype_ = StorageAllocaInit(&arena_).GetInitTokenMap(func);
+    this->Run(func);
+    this->Place();
+
+    // The value of smap contains the planned storage ids, the device types
+    // and the offsets of the storages in the arena of their device.
+    Map<Expr, Array<IntegerArray> > smap;
+    for (const auto& kv : token_map_) {
+      std::vector<Integer> storage_ids;
+      std::vector<Integer> device_types;
+      std::vector<Integer> offsets;
+      for (StorageToken* tok : kv.second) {
+        storage_ids.push_back(tok->storage_id);
+        device_types.push_back(tok->device_type);
+        offsets.push_back(tok->offset);
+      }
+      smap.Set(GetRef<Expr>(kv.first), Array<IntegerArray>({storage_ids, device_types, offsets}));
+    }
+    return smap;
+  }
+
+  /*!
+   * \brief Report the planned arena size of each device against the peak of
+   *  the bytes live at the same time, which no placement can go below. The
+   *  sizes are rounded up to the allocation alignment.
+   * \param pool_bytes The bytes allocated by the storage sharing planner.
+   * \return The report as json.
+   */
+  std::string Report(size_t pool_bytes) const {
+    // The device type, the arena size, the lower bound and the number of storages.
+    std::map<int, std::vector<int64_t> > devices;
+    std::map<int, std::map<size_t, int64_t> > live_deltas;
+    for (const StorageToken* tok : data_) {
+      std::vector<int64_t>& device = devices[tok->device_type];
+      device.resize(3, 0);
+      int64_t size = static_cast<int64_t>(AlignedSize(tok));
+      device[0] = std::max(device[0], tok->offset + size);
+      device[2] += 1;
+      live_deltas[tok->device_type][tok->begin] += size;
+      if (tok->end != kForever) live_deltas[tok->device_type][tok->end + 1] -= size;
+    }
+    for (const auto& kv : live_deltas) {
+      int64_t live = 0;
+      for (const auto& delta : kv.second) {
+        live += delta.second;
+        devices[kv.first][1] = std::max(devices[kv.first][1], live);
+      }
+    }
+    std::ostringstream os;
+    dmlc::JSONWriter writer(&os);
+    int64_t arena_bytes = 0;
+    int64_t lower_bound_bytes = 0;
+    std::vector<std::map<std::string, int64_t> > device_reports;
+    for (const auto& kv : devices) {
+      arena_bytes += kv.second[0];
+      lower_bound_bytes += kv.second[1];
+      device_reports.push_back({{"device_type", kv.first},
+                                {"arena_bytes", kv.second[0]},
+                                {"lower_bound_bytes", kv.second[1]},
+                                {"num_storages", kv.second[2]}});
+    }
+    writer.BeginObject();
+    writer.WriteObjectKeyValue("arena_bytes", arena_bytes);
+    writer.WriteObjectKeyValue("lower_bound_bytes", lower_bound_bytes);
+    writer.WriteObjectKeyValue("pool_bytes", static_cast<int64_t>(pool_bytes));
+    writer.WriteObjectKeyValue("devices", device_reports);
+    writer.EndObject();
+    return os.str();
+  }
+
+ protected:
+  using StorageAllocaBaseVisitor::VisitExpr_;
+  // Give every tensor its own storage, live from the current call.
+  void CreateToken(const ExprNode* op, bool can_realloc) final {
+    CHECK(!token_map_.count(op));
+    auto it = prototype_.find(op);
+    CHECK(it != prototype_.end());
+    std::vector<StorageToken*> tokens;
+    for (StorageToken* tok : it->second) {
+      tok->max_bytes = GetMemorySize(tok);
+      tok->storage_id = static_cast<int64_t>(data_.size());
+      // The params and the constants are set before the first call.
+      tok->begin = can_realloc ? num_calls_ : 0;
+      tok->end = kForever;
+      if (!can_realloc) {
+        // ensure it never get de-allocated.
+        tok->ref_counter += 1;
+      }
+      data_.push_back(tok);
+      tokens.push_back(tok);
+    }
+    token_map_[op] = tokens;
+  }
+  // The call map
+  void VisitExpr_(const CallNode* op) final {
+    std::vector<StorageToken*> args;
+    // for each input, visit argument token.
+    for (Expr arg : op->args) {
+      for (StorageToken* tok : GetToken(arg)) {
+        args.push_back(tok);
+      }
+    }
+    // create token for the call node.
+    CreateToken(op, true);
+    // check if there is orphaned output that can be released immediately.
+    for (StorageToken* tok : token_map_.at(op)) {
+      CheckForRelease(tok);
+    }
+    for (StorageToken* tok : args) {
+      tok->ref_counter -= 1;
+      CheckForRelease(tok);
+    }
+    ++num_calls_;
+  }
+  /*!
+   * \brief End the lifetime of the token at the current call if it has no more readers.
+   * \tok The token to be released.
+   */
+  void CheckForRelease(StorageToken* tok) {
+    CHECK_GE(tok->ref_counter, 0);
+    if (tok->ref_counter == 0) {
+      tok->end = num_calls_;
+    }
+  }
+  /*! \brief The size of the storage, rounded up so that every offset is aligned. */
+  static size_t AlignedSize(const StorageToken* tok) {
+    return DivRoundUp(tok->max_bytes, runtime::kAllocAlignment) * runtime::kAllocAlignment;
+  }
+  /*!
+   * \brief Place the storages at offsets, greedy by size and best fit.
+   *
+   *  Each storage scans the ones placed before it, which are kept sorted by
+   *  offset, so the planning is O(n^2) in the number of storages. That is
+   *  fine for the thousands of tensors of a graph, not for millions.
+   */
+  void Place() {
+    std::vector<StorageToken*> order = data_;
+    std::stable_sort(order.begin(), order.end(), [](StorageToken* lhs, StorageToken* rhs) {
+      return lhs->max_bytes > rhs->max_bytes;
+    });
+    auto by_offset = [](StorageToken* lhs, StorageToken* rhs) {
+      return lhs->offset < rhs->offset;
+    };
+    std::vector<StorageToken*> placed;
+    std::vector<StorageToken*> live;
+    for (StorageToken* tok : order) {
+      live.clear();
+      for (StorageToken* other : placed) {
+        if (other->device_type == tok->device_type &&
+            other->begin <= tok->end && tok->begin <= other->end) {
+          live.push_back(other);
+        }
+      }
+      size_t size = AlignedSize(tok);
+      size_t top = 0;
+      size_t best_gap = std::numeric_limits<size_t>::max();
+      int64_t best_offset = -1;
+      for (StorageToken* other : live) {
+        size_t offset = static_cast<size_t>(other->offset);
+        if (offset >= top && offset - top >= size && offset - top < best_gap) {
+          best_gap = offset - top;
+          best_offset = static_cast<int64_t>(top);
+        }
+        top = std::max(top, offset + AlignedSize(other));
+      }
+      tok->offset = best_offset >= 0 ? best_offset : static_cast<int64_t>(top);
+      placed.insert(std::upper_bound(placed.begin(), placed.end(), tok, by_offset), tok);
+    }
+  }
+
+ private:
+  /*! \brief The end of the storages that live until the run returns. */
+  static constexpr size_t kForever = std::numeric_limits<size_t>::max();
+  // allocator
+  support::Arena arena_;
+  // the number of calls visited
+  size_t num_calls_{0};
+  // all the storages
+  std::vector<StorageToken*> data_;
+  /*! \brief internal prototype token map */
+  std::unordered_map<const ExprNode*, std::vector<StorageToken*> > prototype_;
+};
+
 Map<Expr, Array<IntegerArray> > GraphPlanMemory(const Function& func) {
   return StorageAllocator().Plan(func);
 }
 
+Map<Expr, Array<IntegerArray> > GraphPlanMemoryArena(const Function& func) {
+  return StorageArenaPlanner().Plan(func);
+}
+
+std::string GraphMemoryPlanReport(const Function& func) {
+  StorageAllocator pool;
+  pool.Plan(func);
+  StorageArenaPlanner planner;
+  planner.Plan(func);
+  return planner.Report(pool.TotalAllocBytes(runtime::kAllocAlignment));
+}
+
 TVM_REGISTER_GLOBAL("relay.backend.GraphPlanMemory")
 .set_body_typed(GraphPlanMemory);
 
+TVM_REGISTER_GLOBAL("relay.backend.GraphPlanMemoryArena")
+.set_body_typed(GraphPlanMemoryArena);
+
+TVM_REGISTER_GLOBAL("relay.backend.GraphMemoryPlanReport")
+.set_body_typed(GraphMemoryPlanReport);
+
 }  // namespace relay
 }  // namespace tvm
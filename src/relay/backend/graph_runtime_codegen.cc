@@ -25,8 +25,10 @@
 #include <dmlc/any.h>
 #include <dmlc/json.h>
 #include <tvm/ir/module.h>
+#include <tvm/ir/transform.h>
 #include <tvm/relay/expr_functor.h>
 #include <tvm/runtime/device_api.h>
+#include <tvm/tir/analysis.h>
 
 #include <list>
 #include <string>
@@ -54,6 +56,8 @@ using TargetsMap = std::unordered_map<int, Target>;
 /*! \brief Lowered outputs */
 struct LoweredOutput {
   std::string graph_json;
+  /*! \brief The binary form of graph_json, made on the first request. */
+  std::string graph_binary;
   Map<std::string, IRModule> lowered_funcs;
   Array<tvm::runtime::Module> external_mods;
   std::unordered_map<std::string, tvm::runtime::NDArray> params;
@@ -188,6 +192,23 @@ class GraphOpNode : public GraphNode {
   const std::string op_type_name_{"tvm_op"};
 };
 
+/*!
+ * \brief Collect the calls in the order GraphRuntimeCodegen visits them,
+ *  a call before its arguments.
+ */
+class PrimitiveCallCollector : public ExprVisitor {
+ public:
+  void VisitExpr_(const CallNode* op) final {
+    calls.push_back(op);
+    for (const Expr& arg : op->args) {
+      VisitExpr(arg);
+    }
+  }
+
+  /*! \brief The calls in visiting order. */
+  std::vector<const CallNode*> calls;
+};
+
 /*! \brief Code generator for graph runtime */
 class GraphRuntimeCodegen : public backend::MemoizedExprTranslator<std::vector<GraphNodeRef>> {
  public:
@@ -197,13 +218,34 @@ class GraphRuntimeCodegen : public backend::MemoizedExprTranslator<std::vector<G
   }
 
   LoweredOutput Codegen(relay::Function func) {
-    auto pf = GetPackedFunc("relay.backend.GraphPlanMemory");
+    // The arena places tensors by offsetting the raw data pointer, which is
+    // only valid for devices with flat address spaces.
+    bool use_arena = transform::PassContext::Current()->graph_memory_arena;
+    for (const auto& it : targets_) {
+      int device_type = it.second->device_type;
+      if (device_type != kDLCPU && device_type != kDLGPU && device_type != kDLROCM) {
+        use_arena = false;
+      }
+    }
+    auto pf = GetPackedFunc(use_arena ? "relay.backend.GraphPlanMemoryArena"
+                                      : "relay.backend.GraphPlanMemory");
     storage_device_map_ = (*pf)(func);
     // First we convert all the parameters into input nodes.
     for (auto param : func->params) {
       auto node_ptr = GraphInputNode::make_node_ptr(param->name_hint(), GraphAttrs());
       var_map_[param.get()] = AddNode(node_ptr, param);
     }
+    // Lower the primitive functions ahead, the engine may lower them concurrently.
+    PrimitiveCallCollector collector;
+    collector(func->body);
+    Array<CCacheKey> keys;
+    for (const CallNode* call : collector.calls) {
+      const auto* prim_func = call->op.as<FunctionNode>();
+      if (prim_func != nullptr && prim_func->HasNonzeroAttr(attr::kPrimitive)) {
+        keys.push_back(CCacheKey(GetRef<Function>(prim_func), GetCallTarget(call)));
+      }
+    }
+    compile_engine_->LowerBatch(keys);
     heads_ = VisitExpr(func->body);
     std::ostringstream os;
     dmlc::JSONWriter writer(&os);
@@ -252,7 +294,7 @@ class GraphRuntimeCodegen : public backend::MemoizedExprTranslator<std::vector<G
     size_t count = storage_device_map_.count(expr);
     CHECK_GT(count, 0) << "Expr is not existing in storage plan";
     auto storage_device_info = storage_device_map_[expr];
-    CHECK_EQ(storage_device_info.size(), 2);
+    CHECK(storage_device_info.size() == 2 || storage_device_info.size() == 3);
     // storage
     std::vector<int64_t> storage_info;
     for (auto& v : storage_device_info[0]) {
@@ -273,6 +315,14 @@ class GraphRuntimeCodegen : public backend::MemoizedExprTranslator<std::vector<G
     if (num_unknown_devices == 0) {
       node->attrs_["device_index"] = device_types;
     }
+    // offset in the arena
+    if (storage_device_info.size() == 3) {
+      std::vector<int64_t> storage_offsets;
+      for (auto& v : storage_device_info[2]) {
+        storage_offsets.push_back(v->value);
+      }
+      node->attrs_["storage_offset"] = std::move(storage_offsets);
+    }
     auto node_id = nodes_.size();
     nodes_.push_back(node);
     // Tuple return value, flatten as tuple
@@ -337,7 +387,8 @@ class GraphRuntimeCodegen : public backend::MemoizedExprTranslator<std::vector<G
 
   std::vector<GraphNodeRef> GraphAddCallNode(const CallNode* op,
                                              const std::string& op_name,
-                                             const std::string& func_name) {
+                                             const std::string& func_name,
+                                             const GraphAttrs& attrs = GraphAttrs()) {
     std::vector<GraphNodeRef> inputs;
     for (auto arg : op->args) {
       auto res = VisitExpr(arg);
@@ -346,15 +397,46 @@ class GraphRuntimeCodegen : public backend::MemoizedExprTranslator<std::vector<G
       }
     }
     auto node = GraphOpNode::make_node_ptr(op_name,
-                                           GraphAttrs(),
+                                           attrs,
                                            func_name,
                                            inputs,
                                            GraphAttrs());
     return AddNode(node, GetRef<Expr>(op));
   }
 
-  std::vector<GraphNodeRef> VisitExpr_(const CallNode* op) override {
+  /*!
+   * \brief Get the target of a call to a primitive function.
+   * \param op The call.
+   * \return The target of the device the call is planned on.
+   */
+  Target GetCallTarget(const CallNode* op) {
+    if (op->op.as<FunctionNode>()->GetAttr<String>(attr::kCompiler).defined()) {
+      return tvm::target::ext_dev();
+    }
     Expr expr = GetRef<Expr>(op);
+    CHECK_GE(storage_device_map_.count(expr), 0);
+    auto &device_type = storage_device_map_[expr][1];
+    auto call_dev_type = device_type[0]->value;
+    if (targets_.size() == 1) {
+       // homogeneous execution.
+      const auto& it = targets_.begin();
+      return (*it).second;
+    }
+    // heterogeneous execution.
+    std::string call_dev_name;
+    if (call_dev_type == 0) {
+      call_dev_name = "llvm";
+    } else {
+      call_dev_name = runtime::DeviceName(call_dev_type);
+    }
+    if (targets_.count(call_dev_type) == 0) {
+      LOG(FATAL) << "No target is provided for device "
+                 << call_dev_name;
+    }
+    return targets_[call_dev_type];
+  }
+
+  std::vector<GraphNodeRef> VisitExpr_(const CallNode* op) override {
     Function func;
     if (op->op.as<OpNode>()) {
       LOG(FATAL) << "Operators should be transformed away; try applying"
@@ -383,37 +465,30 @@ class GraphRuntimeCodegen : public backend::MemoizedExprTranslator<std::vector<G
       return GraphAddCallNode(op, ext_func->func_name, ext_func->func_name);
     }
 
-    CHECK_GE(storage_device_map_.count(expr), 0);
-    auto &device_type = storage_device_map_[expr][1];
-    auto call_dev_type = device_type[0]->value;
     // Normal Relay Function
-    if (targets_.size() == 1) {
-       // homogeneous execution.
-      const auto& it = targets_.begin();
-      target = (*it).second;
-    } else {
-      // heterogeneous execution.
-      std::string call_dev_name;
-      if (call_dev_type == 0) {
-        call_dev_name = "llvm";
-      } else {
-        call_dev_name = runtime::DeviceName(call_dev_type);
-      }
-      if (targets_.count(call_dev_type) == 0) {
-        LOG(FATAL) << "No target is provided for device "
-                   << call_dev_name;
-      }
-      target = targets_[call_dev_type];
-    }
+    target = GetCallTarget(op);
     CCacheKey key = (*pf0)(func, target);
     CachedFunc lowered_func = (*pf1)(compile_engine_, key);
     if (!lowered_funcs_.count(target->str())) {
       lowered_funcs_[target->str()] = IRModule::Empty();
     }
     lowered_funcs_[target->str()]->Update(lowered_func->funcs);
+    // The estimate is reported by the profiler of the debug runtime.
+    GraphAttrs attrs;
+    int64_t flops = 0;
+    for (const auto& kv : lowered_func->funcs->functions) {
+      if (const auto* prim_func = kv.second.as<tir::PrimFuncNode>()) {
+        int64_t func_flops = tir::EstimateFlops(GetRef<tir::PrimFunc>(prim_func));
+        flops = (flops < 0 || func_flops < 0) ? -1 : flops + func_flops;
+      }
+    }
+    if (flops >= 0) {
+      attrs["flops"] = std::to_string(flops);
+    }
     return GraphAddCallNode(op,
                            _GetUniqueName(lowered_func->func_name),
-                           lowered_func->func_name);
+                           lowered_func->func_name,
+                           attrs);
   }
 
   std::vector<GraphNodeRef> VisitExpr_(const LetNode* op) override {
@@ -479,6 +554,7 @@ class GraphRuntimeCodegen : public backend::MemoizedExprTranslator<std::vector<G
     ShapeVector shapes;
     std::vector<size_t> storage_ids;
     std::vector<size_t> device_types;
+    std::vector<int64_t> storage_offsets;
     std::vector<std::string> dltypes;
     std::vector<size_t> node_row_ptr{0};
     for (auto node : nodes_) {
@@ -496,6 +572,10 @@ class GraphRuntimeCodegen : public backend::MemoizedExprTranslator<std::vector<G
         const auto& dev_types = dmlc::get<std::vector<int64_t>>(node->attrs_["device_index"]);
         device_types.insert(device_types.end(), dev_types.begin(), dev_types.end());
       }
+      if (node->attrs_.count("storage_offset")) {
+        const auto& offsets = dmlc::get<std::vector<int64_t>>(node->attrs_["storage_offset"]);
+        storage_offsets.insert(storage_offsets.end(), offsets.begin(), offsets.end());
+      }
       node_row_ptr.push_back(num_entry);
     }
     writer->BeginObject();
@@ -511,6 +591,10 @@ class GraphRuntimeCodegen : public backend::MemoizedExprTranslator<std::vector<G
       attrs["device_index"].emplace_back(std::string("list_int"));
       attrs["device_index"].emplace_back(device_types);
     }
+    if (storage_offsets.size()) {
+      attrs["storage_offset"].emplace_back(std::string("list_int"));
+      attrs["storage_offset"].emplace_back(storage_offsets);
+    }
     attrs["dltype"].emplace_back(std::string("list_str"));
     attrs["dltype"].emplace_back(dltypes);
     writer->WriteObjectKeyValue("attrs", attrs);
@@ -587,6 +671,18 @@ class GraphRuntimeCodegenModule : public runtime::ModuleNode {
       return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
         *rv = this->output_.graph_json;
       });
+    } else if (name == "get_graph_binary") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        if (this->output_.graph_binary.empty()) {
+          this->output_.graph_binary =
+              (*GetPackedFunc("tvm.graph_runtime.json_to_binary"))(this->output_.graph_json)
+                  .operator std::string();
+        }
+        TVMByteArray arr;
+        arr.data = this->output_.graph_binary.data();
+        arr.size = this->output_.graph_binary.size();
+        *rv = arr;
+      });
     } else if (name == "list_params_name") {
       return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
         Array<runtime::String> ret;
@@ -58,6 +58,12 @@ Pass ManifestAlloc(Target target_host) {
   return (*f)(target_host);
 }
 
+Pass MemoryPlan() {
+  auto f = tvm::runtime::Registry::Get("relay.transform.MemoryPlan");
+  CHECK(f != nullptr) << "could not load memory planning pass";
+  return (*f)();
+}
+
 }  // namespace transform
 
 namespace vm {
@@ -558,12 +564,14 @@ class VMFunctionCompiler : ExprFunctor<void(const Expr& expr)> {
             }
 
             // Add context field.
-            Emit(Instruction::AllocTensor(storage_register, raw_shape, dtype, NewRegister()));
+            Emit(Instruction::AllocTensor(storage_register, alloc_attrs->offset, raw_shape,
+                                        dtype, NewRegister()));
           } else {
             this->VisitExpr(args[1]);
             auto shape_register = last_register_;
             Emit(Instruction::AllocTensorReg(
               storage_register,
+              alloc_attrs->offset,
               shape_register,
               dtype,
               NewRegister()));
@@ -941,6 +949,20 @@ IRModule VMCompiler::OptimizeModule(const IRModule& mod, const TargetsMap& targe
   // Manifest the allocations needed for the shape functions.
   pass_seqs.push_back(transform::ManifestAlloc(this->target_host_));
 
+  // Coalesce the statically sized storages into arenas. Tensors are placed by
+  // offsetting the raw data pointer, which is only valid for devices with flat
+  // address spaces.
+  bool flat_address_space = true;
+  for (const auto& it : targets) {
+    int device_type = static_cast<int>(it.first->value);
+    if (device_type != kDLCPU && device_type != kDLGPU && device_type != kDLROCM) {
+      flat_address_space = false;
+    }
+  }
+  if (flat_address_space) {
+    pass_seqs.push_back(transform::MemoryPlan());
+  }
+
   transform::Sequential seq(pass_seqs);
   transform::PassContext pass_ctx = PassContext::Current();
   // TODO(wweic): Support heterogenous execution
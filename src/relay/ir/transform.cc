@@ -26,6 +26,8 @@
 #include <tvm/node/repr_printer.h>
 #include <tvm/relay/transform.h>
 
+#include <memory>
+
 
 namespace tvm {
 namespace relay {
@@ -122,24 +124,33 @@ IRModule FunctionPassNode::operator()(IRModule mod,
              << " with opt level: "
              << pass_info->opt_level;
   pass_ctx.Trace(mod, pass_info, true);
+  pass_ctx.InstrumentBeforePass(mod, pass_info);
 
   // Execute the pass function and return a new module.
   IRModule updated_mod = IRModule(mod->functions, mod->type_definitions, mod->Imports());
   std::vector<std::pair<GlobalVar, Function> > updates;
-  for (const auto& it : updated_mod->functions) {
-    // only picks up relay::Function
-    if (auto* n = it.second.as<FunctionNode>()) {
-      Function func = GetRef<Function>(n);
-      auto updated_func = SkipFunction(func)
-                          ? func
-                          : pass_func(func, updated_mod, pass_ctx);
-      updates.push_back({it.first, updated_func});
+  try {
+    for (const auto& it : updated_mod->functions) {
+      // only picks up relay::Function
+      if (auto* n = it.second.as<FunctionNode>()) {
+        Function func = GetRef<Function>(n);
+        std::unique_ptr<runtime::ObjectArena> arena;
+        if (pass_ctx->use_object_arena) arena.reset(new runtime::ObjectArena());
+        auto updated_func = SkipFunction(func)
+                            ? func
+                            : pass_func(func, updated_mod, pass_ctx);
+        updates.push_back({it.first, updated_func});
+      }
     }
+  } catch (...) {
+    pass_ctx.InstrumentAfterFailedPass(pass_info);
+    throw;
   }
 
   for (const auto& pair : updates) {
     updated_mod->Add(pair.first, pair.second, true);
   }
+  pass_ctx.InstrumentAfterPass(updated_mod, pass_info);
   pass_ctx.Trace(updated_mod, pass_info, false);
   return updated_mod;
 }
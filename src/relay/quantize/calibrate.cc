@@ -26,30 +26,71 @@
 #include <tvm/relay/analysis.h>
 #include <tvm/relay/expr_functor.h>
 #include <tvm/relay/op.h>
+#include <tvm/runtime/c_backend_api.h>
+#include <tvm/runtime/module.h>
+#include <tvm/runtime/ndarray.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <iterator>
+#include <limits>
 #include <numeric>
+#include <string>
+#include <vector>
+
 #include "./quantize.h"
 
 namespace tvm {
 namespace relay {
 namespace quantize {
 
+namespace {
+/*!
+ * \brief Run fn(0), ..., fn(num_jobs - 1) on the runtime thread pool, which
+ *  follows TVM_NUM_THREADS. The jobs are handed out one at a time, as their
+ *  costs differ, and the first error is raised once all of them are done.
+ */
+void ParallelFor(size_t num_jobs, const std::function<void(size_t)>& fn) {
+  struct Closure {
+    size_t num_jobs;
+    const std::function<void(size_t)>* fn;
+    std::atomic<size_t> next{0};
+    std::vector<std::string> errors;
+  } closure;
+  closure.num_jobs = num_jobs;
+  closure.fn = &fn;
+  closure.errors.resize(num_jobs);
+  auto flambda = [](int task_id, TVMParallelGroupEnv* penv, void* cdata) -> int {
+    Closure* closure = static_cast<Closure*>(cdata);
+    for (size_t i = closure->next++; i < closure->num_jobs; i = closure->next++) {
+      try {
+        (*closure->fn)(i);
+      } catch (const std::exception& e) {
+        closure->errors[i] = e.what();
+      } catch (...) {
+        closure->errors[i] = "unknown exception";
+      }
+    }
+    return 0;
+  };
+  if (num_jobs < 2) {
+    flambda(0, nullptr, &closure);
+  } else {
+    CHECK_EQ(TVMBackendParallelLaunchBarrierFree(flambda, &closure, 0), 0) << TVMGetLastError();
+  }
+  for (const std::string& error : closure.errors) {
+    CHECK(error.empty()) << error;
+  }
+}
+}  // namespace
+
 // KL divergence minimization code is adapted from MXNet.
 // The original one is in incubator-mxnet/src/operator/quantization/calibrate.cc
 static std::vector<float> SmoothDistribution(const std::vector<float>& p,
                                              const float eps = 0.0001) {
-  std::vector<size_t> is_zeros(p.size());
-  std::vector<size_t> is_nonzeros(p.size());
-  {
-    auto it = p.begin();
-    std::generate(is_zeros.begin(), is_zeros.end(),
-                  [&it]() { return static_cast<size_t>(*(it++) == 0.f); });
-  }
-  {
-    auto it = p.begin();
-    std::generate(is_nonzeros.begin(), is_nonzeros.end(),
-                  [&it]() { return static_cast<size_t>(*(it++) != 0.f); });
-  }
-  size_t n_zeros = std::accumulate(is_zeros.begin(), is_zeros.end(), 0);
+  size_t n_zeros = std::count(p.begin(), p.end(), 0.f);
   size_t n_nonzeros = p.size() - n_zeros;
   if (!n_nonzeros) {
     // The discrete probability distribution is malformed. All entries are 0.
@@ -59,69 +100,68 @@ static std::vector<float> SmoothDistribution(const std::vector<float>& p,
   if (eps1 >= 1.0) return std::vector<float>();
   auto ret = p;
   for (size_t i = 0; i < p.size(); i++) {
-    ret[i] += eps * is_zeros[i] - eps1 * is_nonzeros[i];
+    ret[i] += p[i] == 0.f ? eps : -eps1;
   }
   return ret;
 }
 
-static float ComputeEntropy(float* p, float* q, size_t size) {
-  float p_sum = std::accumulate(p, p+size, 0.f);
-  float q_sum = std::accumulate(q, q+size, 0.f);
+static float ComputeEntropy(const float* p, const float* q, size_t size) {
+  float p_sum = std::accumulate(p, p + size, 0.f);
+  float q_sum = std::accumulate(q, q + size, 0.f);
+  // sum(p / p_sum * log((p / p_sum) / (q / q_sum))), with the divisions out of the loop.
   float ret = 0;
   for (size_t i = 0; i < size; i++) {
     CHECK(p[i] > 0 && q[i] > 0);
-    p[i] /= p_sum;
-    q[i] /= q_sum;
-    if (p[i] && q[i]) ret += p[i] * std::log(p[i] / q[i]);
+    ret += p[i] * (std::log(p[i]) - std::log(q[i]));
   }
-  return ret;
+  return ret / p_sum + std::log(q_sum / p_sum);
 }
 
-float MinimizeKL(const std::vector<int>& hist,
+float MinimizeKL(const std::vector<int64_t>& hist,
                  const std::vector<float>& hist_edges,
                  int num_bins, int num_quantized_bins) {
   const int zero_bin_idx = num_bins / 2;
   const int num_half_quantized_bins = num_quantized_bins / 2;
   std::vector<float> thresholds(num_bins / 2 + 1 - num_quantized_bins / 2, 0.f);
   std::vector<float> divergence(thresholds.size(), 0.f);
-  std::vector<float> quantized_bins(num_quantized_bins, 0);
-  for (int i = num_quantized_bins / 2; i < zero_bin_idx + 1; ++i) {
+  // The outliers of a candidate are merged into its end bins, from the prefix sums.
+  std::vector<int64_t> prefix(num_bins + 1, 0);
+  for (int j = 0; j < num_bins; j++) {
+    prefix[j + 1] = prefix[j] + hist[j];
+  }
+  // The candidates are independent.
+  ParallelFor(thresholds.size(), [&](size_t index) {
+    const int i = static_cast<int>(index) + num_half_quantized_bins;
     const int p_bin_idx_start = zero_bin_idx - i;
     const int p_bin_idx_stop = zero_bin_idx + i + 1;
     thresholds[i - num_half_quantized_bins] = hist_edges[p_bin_idx_stop];
 
-    std::vector<int> sliced_nd_hist(p_bin_idx_stop - p_bin_idx_start);
-    std::vector<float> p(sliced_nd_hist.size());
-    p[0] = 0;
-    p.back() = 0;
-    for (int j = 0; j < num_bins; j++) {
-      if (j <= p_bin_idx_start) {
-        p[0] += hist[j];
-      } else if (j >= p_bin_idx_stop) {
-        p.back() += hist[j];
-      } else {
-        sliced_nd_hist[j - p_bin_idx_start] = hist[j];
-        p[j - p_bin_idx_start] = hist[j];
-      }
-    }
+    std::vector<int64_t> sliced_nd_hist(hist.begin() + p_bin_idx_start,
+                                        hist.begin() + p_bin_idx_stop);
+    sliced_nd_hist[0] = 0;
+    std::vector<float> p(sliced_nd_hist.begin(), sliced_nd_hist.end());
+    p[0] = static_cast<float>(prefix[p_bin_idx_start + 1]);
+    p.back() += static_cast<float>(prefix[num_bins] - prefix[p_bin_idx_stop]);
     // calculate how many bins should be merged to generate quantized distribution q
     const auto num_merged_bins = sliced_nd_hist.size() / num_quantized_bins;
+    std::vector<float> quantized_bins(num_quantized_bins, 0);
     for (int j = 0; j < num_quantized_bins; j++) {
       const int start = j * num_merged_bins;
       const int stop = (j + 1) * num_merged_bins;
-      quantized_bins[j] =
-          std::accumulate(sliced_nd_hist.begin() + start, sliced_nd_hist.begin() + stop, 0);
+      quantized_bins[j] = static_cast<float>(
+          std::accumulate(sliced_nd_hist.begin() + start, sliced_nd_hist.begin() + stop,
+                          static_cast<int64_t>(0)));
     }
-    quantized_bins.back() += std::accumulate(
+    quantized_bins.back() += static_cast<float>(std::accumulate(
         sliced_nd_hist.begin() + static_cast<int>(num_quantized_bins * num_merged_bins),
-        sliced_nd_hist.end(), 0);
+        sliced_nd_hist.end(), static_cast<int64_t>(0)));
     // expand quantized_bins into p.size bins
     std::vector<float> q(sliced_nd_hist.size(), 0);
     for (int j = 0; j < num_quantized_bins; j++) {
       const int start = j * num_merged_bins;
       const int stop = (j == num_quantized_bins - 1) ? q.size() : ((j + 1) * num_merged_bins);
       int norm = std::count_if(sliced_nd_hist.begin() + start, sliced_nd_hist.begin() + stop,
-                               [](size_t i) { return i != 0; });
+                               [](int64_t i) { return i != 0; });
       if (norm) {
         for (int k = start; k < stop; k++) {
           if (p[k]) q[k] = quantized_bins[j] / norm;
@@ -136,12 +176,318 @@ float MinimizeKL(const std::vector<int>& hist,
     } else {
       divergence[i - num_half_quantized_bins] = ComputeEntropy(p.data(), q.data(), p.size());
     }
-  }
+  });
   auto min_divergence_idx = std::distance(divergence.begin(),
                                           std::min_element(divergence.begin(), divergence.end()));
-  return thresholds[min_divergence_idx];;
+  return thresholds[min_divergence_idx];
 }
 
+/*!
+ * \brief A histogram of the values of a layer, accumulated over the calibration batches.
+ *
+ *  The bins are symmetric around zero, as the ones np.histogram makes over
+ *  (-max_abs, max_abs) with an odd number of bins. The range is set by the
+ *  first batch and tripled, merging the bins three by three so that they stay
+ *  centered, whenever a later batch exceeds it. The bins can therefore be up
+ *  to three times wider than the ones of a histogram over the exact range.
+ */
+class Histogram {
+ public:
+  explicit Histogram(int num_bins) : counts_(num_bins, 0), half_(num_bins / 2) {
+    CHECK(num_bins % 2 == 1) << "The calibration histogram needs an odd number of bins";
+  }
+
+  /*! \brief Add the values of a batch, the values that are not finite are skipped. */
+  void Add(const float* data, int64_t size) {
+    float max_abs = 0;
+    bool all_finite = true;
+    for (int64_t i = 0; i < size; ++i) {
+      float value = std::abs(data[i]);
+      // NaN fails the comparison as well as infinity.
+      all_finite &= value <= std::numeric_limits<float>::max();
+      max_abs = std::max(max_abs, value);
+    }
+    if (!all_finite) {
+      std::vector<float> finite;
+      finite.reserve(size);
+      std::copy_if(data, data + size, std::back_inserter(finite),
+                   [](float value) { return std::isfinite(value); });
+      Add(finite.data(), static_cast<int64_t>(finite.size()));
+      return;
+    }
+    max_abs_ = std::max(max_abs_, max_abs);
+    if (max_abs == 0) {
+      counts_[half_] += size;
+      return;
+    }
+    if (width_ == 0) {
+      width_ = 2.0 * max_abs / counts_.size();
+    }
+    while (max_abs > (half_ + 0.5) * width_) {
+      Grow();
+    }
+    // The bin indices are computed in chunks by a loop that vectorizes, and
+    // counted in interleaved histograms to break the dependency of the
+    // increments of equal bins.
+    const int kChunk = 1024;
+    const int kLanes = 4;
+    int32_t index[kChunk];
+    std::vector<uint32_t> lanes(kLanes * counts_.size(), 0);
+    const float scale = static_cast<float>(1.0 / width_);
+    const float offset = half_ + 0.5f;
+    const float max_index = static_cast<float>(counts_.size() - 1);
+    for (int64_t begin = 0; begin < size; begin += kChunk) {
+      int n = static_cast<int>(std::min<int64_t>(kChunk, size - begin));
+      const float* chunk = data + begin;
+      for (int i = 0; i < n; ++i) {
+        float bin = std::min(std::max(chunk[i] * scale + offset, 0.f), max_index);
+        index[i] = static_cast<int32_t>(bin);
+      }
+      int i = 0;
+      for (; i + kLanes <= n; i += kLanes) {
+        for (int k = 0; k < kLanes; ++k) {
+          ++lanes[index[i + k] * kLanes + k];
+        }
+      }
+      for (; i < n; ++i) {
+        ++lanes[index[i] * kLanes];
+      }
+      // Flush before the 32 bit counters could overflow.
+      if ((begin / kChunk) % (1 << 20) == (1 << 20) - 1) Flush(&lanes);
+    }
+    Flush(&lanes);
+  }
+
+  /*! \return The counts of the bins. */
+  const std::vector<int64_t>& counts() const {
+    return counts_;
+  }
+
+  /*! \return The edges of the bins. */
+  std::vector<float> Edges() const {
+    std::vector<float> edges(counts_.size() + 1);
+    for (size_t i = 0; i < edges.size(); ++i) {
+      edges[i] = static_cast<float>((static_cast<double>(i) - half_ - 0.5) * width_);
+    }
+    return edges;
+  }
+
+  /*! \return The width of the bins, 0 if all values were zero. */
+  double width() const {
+    return width_;
+  }
+
+  /*! \return The largest absolute value. */
+  float max_abs() const {
+    return max_abs_;
+  }
+
+ private:
+  void Flush(std::vector<uint32_t>* lanes) {
+    const int kLanes = static_cast<int>(lanes->size() / counts_.size());
+    for (size_t b = 0; b < counts_.size(); ++b) {
+      for (int k = 0; k < kLanes; ++k) {
+        counts_[b] += (*lanes)[b * kLanes + k];
+        (*lanes)[b * kLanes + k] = 0;
+      }
+    }
+  }
+
+  // Triple the range, bin k of the new histogram holds the bins 3k - 1, 3k and 3k + 1.
+  void Grow() {
+    std::vector<int64_t> counts(counts_.size(), 0);
+    for (int rel = -half_; rel <= half_; ++rel) {
+      int k = rel >= 0 ? (rel + 1) / 3 : -((1 - rel) / 3);
+      counts[k + half_] += counts_[rel + half_];
+    }
+    counts_.swap(counts);
+    width_ *= 3;
+  }
+
+  std::vector<int64_t> counts_;
+  int half_;
+  double width_{0};
+  float max_abs_{0};
+};
+
+/*!
+ * \brief The histograms of the profiled layers, accumulated over the calibration batches
+ *  by running the profile graph of CreateStatsCollector.
+ */
+class CalibrationStatsNode : public Object {
+ public:
+  /*! \brief The histogram of each output of the profile graph. */
+  std::vector<Histogram> histograms;
+  /*! \brief The number of batches added. */
+  int64_t num_batches{0};
+
+  /*!
+   * \brief Add the outputs of the last run of a graph runtime, in parallel over the outputs.
+   * \param runtime The graph runtime of the profile graph.
+   */
+  void Update(runtime::Module runtime) {
+    int num_outputs = runtime.GetFunction("get_num_outputs")();
+    CHECK_EQ(static_cast<size_t>(num_outputs), histograms.size())
+        << "The runtime has " << num_outputs << " outputs, the calibration expects "
+        << histograms.size();
+    PackedFunc get_output = runtime.GetFunction("get_output");
+    std::vector<runtime::NDArray> outputs;
+    for (int i = 0; i < num_outputs; ++i) {
+      outputs.push_back(get_output(i));
+    }
+    ParallelFor(outputs.size(), [&](size_t i) {
+      runtime::NDArray output = outputs[i];
+      CHECK(output->dtype.code == kDLFloat && output->dtype.bits == 32 &&
+            output->dtype.lanes == 1)
+          << "The calibration expects float32 outputs";
+      if (output->ctx.device_type != kDLCPU) {
+        output = output.CopyTo(DLContext{kDLCPU, 0});
+      }
+      int64_t size = 1;
+      for (int k = 0; k < output->ndim; ++k) {
+        size *= output->shape[k];
+      }
+      histograms[i].Add(
+          reinterpret_cast<const float*>(static_cast<char*>(output->data) + output->byte_offset),
+          size);
+    });
+    ++num_batches;
+  }
+
+  /*!
+   * \brief Find the threshold of each layer, in parallel over the layers.
+   * \param mode "kl_divergence", "percentile" or "mse".
+   * \param num_quantized_bins The number of quantization levels.
+   * \param percentile The fraction of the absolute values below the threshold, for "percentile".
+   * \return The thresholds.
+   */
+  std::vector<float> FindThresholds(const std::string& mode,
+                                    int num_quantized_bins,
+                                    double percentile) const {
+    CHECK(mode == "kl_divergence" || mode == "percentile" || mode == "mse")
+        << "Unknown calibrate mode " << mode;
+    std::vector<float> thresholds(histograms.size(), 0.f);
+    // KL runs the candidates in parallel, the other modes are cheap.
+    auto find = [&](size_t i) {
+      const Histogram& hist = histograms[i];
+      // A layer that only output zeros, e.g. a dead relu, gets the threshold
+      // np.histogram gave it by widening the empty range to (-0.5, 0.5), a
+      // zero threshold would make its scale zero.
+      if (hist.width() == 0) {
+        thresholds[i] = 0.5f;
+        return;
+      }
+      if (mode == "kl_divergence") {
+        thresholds[i] = MinimizeKL(hist.counts(), hist.Edges(),
+                                   static_cast<int>(hist.counts().size()), num_quantized_bins);
+      } else if (mode == "percentile") {
+        thresholds[i] = FindPercentile(hist, percentile);
+      } else {
+        thresholds[i] = MinimizeMSE(hist, num_quantized_bins);
+      }
+    };
+    if (mode == "kl_divergence") {
+      for (size_t i = 0; i < histograms.size(); ++i) find(i);
+    } else {
+      ParallelFor(histograms.size(), find);
+    }
+    return thresholds;
+  }
+
+  void VisitAttrs(AttrVisitor* v) {
+    v->Visit("num_batches", &num_batches);
+  }
+
+  static constexpr const char* _type_key = "relay.quantize.CalibrationStats";
+  TVM_DECLARE_FINAL_OBJECT_INFO(CalibrationStatsNode, Object);
+
+ private:
+  // The counts by distance from zero, bin d holds the values of bins half - d and half + d.
+  static std::vector<int64_t> FoldCounts(const Histogram& hist) {
+    const std::vector<int64_t>& counts = hist.counts();
+    int half = static_cast<int>(counts.size() / 2);
+    std::vector<int64_t> folded(half + 1, 0);
+    folded[0] = counts[half];
+    for (int d = 1; d <= half; ++d) {
+      folded[d] = counts[half - d] + counts[half + d];
+    }
+    return folded;
+  }
+
+  // The upper edge of the first bin from zero below which the fraction of the values lies.
+  static float FindPercentile(const Histogram& hist, double percentile) {
+    CHECK(percentile > 0 && percentile <= 1) << "The percentile must be in (0, 1]";
+    std::vector<int64_t> folded = FoldCounts(hist);
+    int64_t total = std::accumulate(folded.begin(), folded.end(), static_cast<int64_t>(0));
+    int64_t cumulative = 0;
+    for (size_t d = 0; d < folded.size(); ++d) {
+      cumulative += folded[d];
+      if (cumulative >= percentile * total) {
+        return std::min(static_cast<float>((d + 0.5) * hist.width()), hist.max_abs());
+      }
+    }
+    return hist.max_abs();
+  }
+
+  // The threshold of the least expected squared error, counting the values of
+  // a bin at its center. The values within the threshold have the rounding
+  // error of a uniform distribution, the others are clipped to it.
+  static float MinimizeMSE(const Histogram& hist, int num_quantized_bins) {
+    std::vector<int64_t> folded = FoldCounts(hist);
+    const double width = hist.width();
+    const int num_levels = std::max(num_quantized_bins / 2, 1);
+    // The candidates are the upper edges of the bins from the one of the maximum down.
+    int max_bin = static_cast<int>(folded.size()) - 1;
+    while (max_bin > 0 && folded[max_bin] == 0) --max_bin;
+    // Prefix sums of the counts, the values and their squares, to get each error in O(1).
+    std::vector<double> count_sum(folded.size() + 1, 0), value_sum(folded.size() + 1, 0),
+        square_sum(folded.size() + 1, 0);
+    for (size_t d = 0; d < folded.size(); ++d) {
+      double x = d * width;
+      count_sum[d + 1] = count_sum[d] + folded[d];
+      value_sum[d + 1] = value_sum[d] + folded[d] * x;
+      square_sum[d + 1] = square_sum[d] + folded[d] * x * x;
+    }
+    double best_error = std::numeric_limits<double>::infinity();
+    float best = static_cast<float>((max_bin + 0.5) * width);
+    for (int d = 0; d <= max_bin; ++d) {
+      double t = (d + 0.5) * width;
+      double step = t / num_levels;
+      double inside = count_sum[d + 1];
+      // sum over the clipped values of (x - t)^2
+      double n = count_sum[folded.size()] - count_sum[d + 1];
+      double sx = value_sum[folded.size()] - value_sum[d + 1];
+      double sxx = square_sum[folded.size()] - square_sum[d + 1];
+      double error = inside * step * step / 12 + sxx - 2 * t * sx + n * t * t;
+      if (error < best_error) {
+        best_error = error;
+        best = static_cast<float>(t);
+      }
+    }
+    return best;
+  }
+};
+
+/*!
+ * \brief Managed reference to CalibrationStatsNode.
+ * \sa CalibrationStatsNode
+ */
+class CalibrationStats : public ObjectRef {
+ public:
+  /*!
+   * \brief Create the histograms of a profile graph.
+   * \param num_layers The number of outputs of the profile graph.
+   * \param num_bins The number of bins of each histogram, odd.
+   */
+  CalibrationStats(int num_layers, int num_bins) {
+    auto n = make_object<CalibrationStatsNode>();
+    n->histograms.resize(num_layers, Histogram(num_bins));
+    data_ = std::move(n);
+  }
+
+  TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(CalibrationStats, ObjectRef, CalibrationStatsNode);
+};
+
 class StatsCollector : private ExprMutator {
  public:
   StatsCollector() : simulated_quantize_op_(Op::Get("relay.op.annotation.simulated_quantize")) {}
@@ -205,16 +551,41 @@ Expr CreateStatsCollector(const Expr& expr) {
 TVM_REGISTER_GLOBAL("relay._quantize.CreateStatsCollector")
 .set_body_typed(CreateStatsCollector);
 
+TVM_REGISTER_NODE_TYPE(CalibrationStatsNode);
+
+TVM_REGISTER_GLOBAL("relay._quantize.CalibrationStats")
+.set_body_typed([](int num_layers, int num_bins) {
+  return CalibrationStats(num_layers, num_bins);
+});
+
+TVM_REGISTER_GLOBAL("relay._quantize.CalibrationStatsUpdate")
+.set_body_typed([](CalibrationStats stats, runtime::Module runtime) {
+  stats->Update(runtime);
+});
+
+TVM_REGISTER_GLOBAL("relay._quantize.CalibrationStatsFindThresholds")
+.set_body_typed([](CalibrationStats stats, std::string mode, int num_quantized_bins,
+                   double percentile) {
+  Array<PrimExpr> ret;
+  for (float threshold : stats->FindThresholds(mode, num_quantized_bins, percentile)) {
+    ret.push_back(FloatImm(DataType::Float(32), threshold));
+  }
+  return ret;
+});
 
-TVM_REGISTER_GLOBAL("relay._quantize.FindScaleByKLMinimization")
-.set_body([](TVMArgs args, TVMRetValue *ret) {
-  int* hist_ptr = static_cast<int*>(static_cast<void*>(args[0]));
-  float* hist_edges_ptr = static_cast<float*>(static_cast<void*>(args[1]));
-  int num_bins = args[2];
-  int num_quantized_bins = args[3];
-  std::vector<int> hist(hist_ptr, hist_ptr + num_bins);
-  std::vector<float> hist_edges(hist_edges_ptr, hist_edges_ptr + num_bins + 1);
-  ret[0] = MinimizeKL(hist, hist_edges, num_bins, num_quantized_bins);
+TVM_REGISTER_GLOBAL("relay._quantize.CalibrationStatsHistogram")
+.set_body_typed([](CalibrationStats stats, int layer) {
+  CHECK(layer >= 0 && static_cast<size_t>(layer) < stats->histograms.size());
+  const Histogram& hist = stats->histograms[layer];
+  Array<PrimExpr> counts;
+  for (int64_t count : hist.counts()) {
+    counts.push_back(IntImm(DataType::Int(64), count));
+  }
+  Array<PrimExpr> edges;
+  for (float edge : hist.Edges()) {
+    edges.push_back(FloatImm(DataType::Float(32), edge));
+  }
+  return Array<ObjectRef>{counts, edges};
 });
 
 }  // namespace quantize
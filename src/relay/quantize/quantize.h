@@ -72,6 +72,7 @@ class QConfigNode : public Object {
   DataType dtype_activation = DataType::Int(32);
   std::string calibrate_mode = "global_scale";
   double global_scale = 8.0;
+  double calibrate_percentile = 0.99999;
   std::string weight_scale = "power2";
   Array<Expr> skip_conv_layers = Array<Expr>(ObjectPtr<Object>(nullptr));
   bool do_simulation = false;
@@ -89,6 +90,7 @@ class QConfigNode : public Object {
     v->Visit("dtype_activation", &dtype_activation);
     v->Visit("calibrate_mode", &calibrate_mode);
     v->Visit("global_scale", &global_scale);
+    v->Visit("calibrate_percentile", &calibrate_percentile);
     v->Visit("weight_scale", &weight_scale);
     v->Visit("skip_conv_layers", &skip_conv_layers);
     v->Visit("do_simulation", &do_simulation);
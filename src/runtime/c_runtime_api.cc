@@ -41,19 +41,22 @@ namespace tvm {
 namespace runtime {
 
 std::string GetCustomTypeName(uint8_t type_code) {
-  auto f = tvm::runtime::Registry::Get("runtime._datatype_get_type_name");
+  static const Registry* handle = Registry::Intern("runtime._datatype_get_type_name");
+  const PackedFunc* f = handle->function();
   CHECK(f) << "Function runtime._datatype_get_type_name not found";
   return (*f)(type_code).operator std::string();
 }
 
 uint8_t GetCustomTypeCode(const std::string& type_name) {
-  auto f = tvm::runtime::Registry::Get("runtime._datatype_get_type_code");
+  static const Registry* handle = Registry::Intern("runtime._datatype_get_type_code");
+  const PackedFunc* f = handle->function();
   CHECK(f) << "Function runtime._datatype_get_type_code not found";
   return (*f)(type_name).operator int();
 }
 
 bool GetCustomTypeRegistered(uint8_t type_code) {
-  auto f = tvm::runtime::Registry::Get("runtime._datatype_get_type_registered");
+  static const Registry* handle = Registry::Intern("runtime._datatype_get_type_registered");
+  const PackedFunc* f = handle->function();
   CHECK(f) << "Function runtime._datatype_get_type_registered not found";
   return (*f)(type_code).operator bool();
 }
@@ -0,0 +1,438 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ * 
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file builtin_gemm.cc
+ * \brief Built-in gemm used for the cblas functions when no BLAS is linked.
+ */
+#include <dmlc/logging.h>
+#include <tvm/runtime/c_backend_api.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/runtime/data_type.h>
+#include <algorithm>
+#include <vector>
+#include "builtin_gemm.h"
+#include "gemm_common.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define TVM_BUILTIN_GEMM_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#define TVM_BUILTIN_GEMM_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace tvm {
+namespace contrib {
+
+using namespace runtime;
+
+/*!
+ * \brief A micro-kernel computing the mr x nr product of a panel of op(A)
+ *  and a panel of op(B) of depth kc. The panels hold mr and nr elements for
+ *  each step of the depth, the product is stored column major in ab.
+ */
+template<typename DType>
+struct GemmMicroKernel {
+  int mr;
+  int nr;
+  void (*func)(int kc, const DType* a, const DType* b, DType* ab);
+};
+
+template<typename DType, int MR, int NR>
+void GemmKernelGeneric(int kc, const DType* a, const DType* b, DType* ab) {
+  DType acc[MR * NR] = {0};
+  for (int p = 0; p < kc; ++p) {
+    for (int j = 0; j < NR; ++j) {
+      for (int i = 0; i < MR; ++i) {
+        acc[j * MR + i] += a[i] * b[j];
+      }
+    }
+    a += MR;
+    b += NR;
+  }
+  std::copy(acc, acc + MR * NR, ab);
+}
+
+#if TVM_BUILTIN_GEMM_X86
+// 16 x 6 tile of C in 12 ymm registers.
+__attribute__((target("avx2,fma")))
+void SgemmKernelAVX2(int kc, const float* a, const float* b, float* ab) {
+#define TVM_GEMM_DECLARE(j)                                        \
+  __m256 c##j##0 = _mm256_setzero_ps(), c##j##1 = _mm256_setzero_ps();
+#define TVM_GEMM_FMA(j)                                            \
+  {                                                                \
+    __m256 bj = _mm256_broadcast_ss(b + j);                        \
+    c##j##0 = _mm256_fmadd_ps(a0, bj, c##j##0);                    \
+    c##j##1 = _mm256_fmadd_ps(a1, bj, c##j##1);                    \
+  }
+#define TVM_GEMM_STORE(j)                                          \
+  _mm256_storeu_ps(ab + j * 16, c##j##0);                          \
+  _mm256_storeu_ps(ab + j * 16 + 8, c##j##1);
+  TVM_GEMM_DECLARE(0) TVM_GEMM_DECLARE(1) TVM_GEMM_DECLARE(2)
+  TVM_GEMM_DECLARE(3) TVM_GEMM_DECLARE(4) TVM_GEMM_DECLARE(5)
+  for (int p = 0; p < kc; ++p) {
+    __m256 a0 = _mm256_loadu_ps(a);
+    __m256 a1 = _mm256_loadu_ps(a + 8);
+    TVM_GEMM_FMA(0) TVM_GEMM_FMA(1) TVM_GEMM_FMA(2)
+    TVM_GEMM_FMA(3) TVM_GEMM_FMA(4) TVM_GEMM_FMA(5)
+    a += 16;
+    b += 6;
+  }
+  TVM_GEMM_STORE(0) TVM_GEMM_STORE(1) TVM_GEMM_STORE(2)
+  TVM_GEMM_STORE(3) TVM_GEMM_STORE(4) TVM_GEMM_STORE(5)
+#undef TVM_GEMM_DECLARE
+#undef TVM_GEMM_FMA
+#undef TVM_GEMM_STORE
+}
+
+// 32 x 8 tile of C in 16 zmm registers.
+__attribute__((target("avx512f")))
+void SgemmKernelAVX512(int kc, const float* a, const float* b, float* ab) {
+#define TVM_GEMM_DECLARE(j)                                        \
+  __m512 c##j##0 = _mm512_setzero_ps(), c##j##1 = _mm512_setzero_ps();
+#define TVM_GEMM_FMA(j)                                            \
+  {                                                                \
+    __m512 bj = _mm512_set1_ps(b[j]);                              \
+    c##j##0 = _mm512_fmadd_ps(a0, bj, c##j##0);                    \
+    c##j##1 = _mm512_fmadd_ps(a1, bj, c##j##1);                    \
+  }
+#define TVM_GEMM_STORE(j)                                          \
+  _mm512_storeu_ps(ab + j * 32, c##j##0);                          \
+  _mm512_storeu_ps(ab + j * 32 + 16, c##j##1);
+  TVM_GEMM_DECLARE(0) TVM_GEMM_DECLARE(1) TVM_GEMM_DECLARE(2) TVM_GEMM_DECLARE(3)
+  TVM_GEMM_DECLARE(4) TVM_GEMM_DECLARE(5) TVM_GEMM_DECLARE(6) TVM_GEMM_DECLARE(7)
+  for (int p = 0; p < kc; ++p) {
+    __m512 a0 = _mm512_loadu_ps(a);
+    __m512 a1 = _mm512_loadu_ps(a + 16);
+    TVM_GEMM_FMA(0) TVM_GEMM_FMA(1) TVM_GEMM_FMA(2) TVM_GEMM_FMA(3)
+    TVM_GEMM_FMA(4) TVM_GEMM_FMA(5) TVM_GEMM_FMA(6) TVM_GEMM_FMA(7)
+    a += 32;
+    b += 8;
+  }
+  TVM_GEMM_STORE(0) TVM_GEMM_STORE(1) TVM_GEMM_STORE(2) TVM_GEMM_STORE(3)
+  TVM_GEMM_STORE(4) TVM_GEMM_STORE(5) TVM_GEMM_STORE(6) TVM_GEMM_STORE(7)
+#undef TVM_GEMM_DECLARE
+#undef TVM_GEMM_FMA
+#undef TVM_GEMM_STORE
+}
+#endif  // TVM_BUILTIN_GEMM_X86
+
+#if TVM_BUILTIN_GEMM_NEON
+// 8 x 8 tile of C in 16 q registers.
+void SgemmKernelNEON(int kc, const float* a, const float* b, float* ab) {
+#define TVM_GEMM_DECLARE(j)                                        \
+  float32x4_t c##j##0 = vdupq_n_f32(0.0f), c##j##1 = vdupq_n_f32(0.0f);
+#define TVM_GEMM_FMA(j, bv, lane)                                  \
+  c##j##0 = vfmaq_laneq_f32(c##j##0, a0, bv, lane);                \
+  c##j##1 = vfmaq_laneq_f32(c##j##1, a1, bv, lane);
+#define TVM_GEMM_STORE(j)                                          \
+  vst1q_f32(ab + j * 8, c##j##0);                                  \
+  vst1q_f32(ab + j * 8 + 4, c##j##1);
+  TVM_GEMM_DECLARE(0) TVM_GEMM_DECLARE(1) TVM_GEMM_DECLARE(2) TVM_GEMM_DECLARE(3)
+  TVM_GEMM_DECLARE(4) TVM_GEMM_DECLARE(5) TVM_GEMM_DECLARE(6) TVM_GEMM_DECLARE(7)
+  for (int p = 0; p < kc; ++p) {
+    float32x4_t a0 = vld1q_f32(a);
+    float32x4_t a1 = vld1q_f32(a + 4);
+    float32x4_t b0 = vld1q_f32(b);
+    float32x4_t b1 = vld1q_f32(b + 4);
+    TVM_GEMM_FMA(0, b0, 0) TVM_GEMM_FMA(1, b0, 1) TVM_GEMM_FMA(2, b0, 2) TVM_GEMM_FMA(3, b0, 3)
+    TVM_GEMM_FMA(4, b1, 0) TVM_GEMM_FMA(5, b1, 1) TVM_GEMM_FMA(6, b1, 2) TVM_GEMM_FMA(7, b1, 3)
+    a += 8;
+    b += 8;
+  }
+  TVM_GEMM_STORE(0) TVM_GEMM_STORE(1) TVM_GEMM_STORE(2) TVM_GEMM_STORE(3)
+  TVM_GEMM_STORE(4) TVM_GEMM_STORE(5) TVM_GEMM_STORE(6) TVM_GEMM_STORE(7)
+#undef TVM_GEMM_DECLARE
+#undef TVM_GEMM_FMA
+#undef TVM_GEMM_STORE
+}
+#endif  // TVM_BUILTIN_GEMM_NEON
+
+template<typename DType>
+GemmMicroKernel<DType> SelectGemmKernel() {
+  return {8, 4, GemmKernelGeneric<DType, 8, 4>};
+}
+
+template<>
+GemmMicroKernel<float> SelectGemmKernel<float>() {
+#if TVM_BUILTIN_GEMM_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    return {32, 8, SgemmKernelAVX512};
+  }
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    return {16, 6, SgemmKernelAVX2};
+  }
+#elif TVM_BUILTIN_GEMM_NEON
+  return {8, 8, SgemmKernelNEON};
+#endif
+  return {8, 4, GemmKernelGeneric<float, 8, 4>};
+}
+
+/*! \brief The depth of the packed panels, they stay in the L1/L2 cache. */
+constexpr int kGemmKC = 256;
+/*! \brief The rows of op(A) packed together. */
+constexpr int kGemmMC = 128;
+/*! \brief The columns of op(B) packed together. */
+constexpr int kGemmNC = 256;
+/*! \brief Products with fewer operations are not split across threads. */
+constexpr int64_t kParallelGemmMinFlops = 1 << 18;
+
+/*! \brief The arguments of a batched gemm, see BuiltinGemmBatch. */
+template<typename DType>
+struct GemmProblem {
+  bool ta, tb;
+  int M, N, K;
+  DType alpha, beta;
+  const DType* A;
+  int a_stride, lda;
+  const DType* B;
+  int b_stride, ldb;
+  DType* C;
+  int c_stride, ldc;
+};
+
+/*!
+ * \brief The packing buffer of the calling thread, grown to hold at least size elements.
+ *  It is kept across calls, every element read by the kernels is written by the packing first.
+ */
+template<typename DType>
+DType* GemmThreadWorkspace(size_t size) {
+  static thread_local std::vector<DType> workspace;
+  if (workspace.size() < size) {
+    workspace.resize(size);
+  }
+  return workspace.data();
+}
+
+/*! \brief Computes the tiles of C of a batched gemm. */
+template<typename DType>
+class GemmTileRunner {
+ public:
+  GemmTileRunner(const GemmProblem<DType>& prob, const GemmMicroKernel<DType>& kernel)
+      : prob_(prob), kernel_(kernel),
+        mc_(std::max(kGemmMC / kernel.mr, 1) * kernel.mr),
+        nc_(std::max(kGemmNC / kernel.nr, 1) * kernel.nr) {
+    // The panels are padded to whole micro tiles, small problems only need a small pack.
+    size_t kc = std::min(kGemmKC, prob.K);
+    size_t apack_size = RoundUp(std::min(mc_, prob.M), kernel.mr) * kc;
+    size_t bpack_size = RoundUp(std::min(nc_, prob.N), kernel.nr) * kc;
+    DType* workspace = GemmThreadWorkspace<DType>(
+        apack_size + bpack_size + kernel.mr * kernel.nr);
+    apack_ = workspace;
+    bpack_ = apack_ + apack_size;
+    ab_ = bpack_ + bpack_size;
+  }
+
+  /*! \return The number of tiles of C, the tiles are independent. */
+  static int64_t NumTiles(const GemmProblem<DType>& prob, const GemmMicroKernel<DType>& kernel) {
+    int mc = std::max(kGemmMC / kernel.mr, 1) * kernel.mr;
+    int nc = std::max(kGemmNC / kernel.nr, 1) * kernel.nr;
+    return static_cast<int64_t>((prob.M + mc - 1) / mc) * ((prob.N + nc - 1) / nc);
+  }
+
+  /*! \brief Compute a tile, tiles are numbered over the batch then the columns then the rows. */
+  void Run(int64_t batch_index, int64_t tile) {
+    int num_row_tiles = (prob_.M + mc_ - 1) / mc_;
+    int ic = static_cast<int>(tile % num_row_tiles) * mc_;
+    int jc = static_cast<int>(tile / num_row_tiles) * nc_;
+    int mc = std::min(mc_, prob_.M - ic);
+    int nc = std::min(nc_, prob_.N - jc);
+    const DType* A = prob_.A + batch_index * prob_.a_stride;
+    const DType* B = prob_.B + batch_index * prob_.b_stride;
+    DType* C = prob_.C + batch_index * prob_.c_stride;
+    if (prob_.K == 0) {
+      for (int j = 0; j < nc; ++j) {
+        for (int i = 0; i < mc; ++i) {
+          DType* c = C + (ic + i) + static_cast<int64_t>(jc + j) * prob_.ldc;
+          *c = prob_.beta == DType(0) ? DType(0) : prob_.beta * *c;
+        }
+      }
+      return;
+    }
+    const int mr = kernel_.mr, nr = kernel_.nr;
+    for (int pc = 0; pc < prob_.K; pc += kGemmKC) {
+      int kc = std::min(kGemmKC, prob_.K - pc);
+      PackB(B, pc, kc, jc, nc);
+      PackA(A, pc, kc, ic, mc);
+      for (int jr = 0; jr < nc; jr += nr) {
+        for (int ir = 0; ir < mc; ir += mr) {
+          kernel_.func(kc, apack_ + ir * kc, bpack_ + jr * kc, ab_);
+          int m = std::min(mr, mc - ir), n = std::min(nr, nc - jr);
+          // Only the first block of the depth applies beta.
+          bool first = pc == 0;
+          for (int j = 0; j < n; ++j) {
+            DType* c = C + (ic + ir) + static_cast<int64_t>(jc + jr + j) * prob_.ldc;
+            const DType* ab = ab_ + j * mr;
+            for (int i = 0; i < m; ++i) {
+              if (!first) {
+                c[i] += prob_.alpha * ab[i];
+              } else if (prob_.beta == DType(0)) {
+                c[i] = prob_.alpha * ab[i];
+              } else {
+                c[i] = prob_.alpha * ab[i] + prob_.beta * c[i];
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+ private:
+  // Pack op(A)[ic:ic+mc, pc:pc+kc] into panels of mr rows, zero padded.
+  void PackA(const DType* A, int pc, int kc, int ic, int mc) {
+    const int mr = kernel_.mr;
+    for (int ir = 0; ir < mc; ir += mr) {
+      DType* dst = apack_ + ir * kc;
+      int m = std::min(mr, mc - ir);
+      for (int p = 0; p < kc; ++p) {
+        for (int i = 0; i < m; ++i) {
+          int64_t row = ic + ir + i, col = pc + p;
+          dst[p * mr + i] = prob_.ta ? A[col + row * prob_.lda] : A[row + col * prob_.lda];
+        }
+        std::fill(dst + p * mr + m, dst + (p + 1) * mr, DType(0));
+      }
+    }
+  }
+  // Pack op(B)[pc:pc+kc, jc:jc+nc] into panels of nr columns, zero padded.
+  void PackB(const DType* B, int pc, int kc, int jc, int nc) {
+    const int nr = kernel_.nr;
+    for (int jr = 0; jr < nc; jr += nr) {
+      DType* dst = bpack_ + jr * kc;
+      int n = std::min(nr, nc - jr);
+      for (int p = 0; p < kc; ++p) {
+        for (int j = 0; j < n; ++j) {
+          int64_t row = pc + p, col = jc + jr + j;
+          dst[p * nr + j] = prob_.tb ? B[col + row * prob_.ldb] : B[row + col * prob_.ldb];
+        }
+        std::fill(dst + p * nr + n, dst + (p + 1) * nr, DType(0));
+      }
+    }
+  }
+
+  static size_t RoundUp(int value, int factor) {
+    return static_cast<size_t>((value + factor - 1) / factor) * factor;
+  }
+
+  const GemmProblem<DType>& prob_;
+  const GemmMicroKernel<DType>& kernel_;
+  int mc_, nc_;
+  // Views into the workspace of the thread running the tiles.
+  DType* apack_;
+  DType* bpack_;
+  DType* ab_;
+};
+
+template<typename DType>
+void BuiltinGemmBatch(int batch_size, bool ta, bool tb, int M, int N, int K, DType alpha,
+                      const DType* A, int a_stride, int lda, const DType* B, int b_stride,
+                      int ldb, DType beta, DType* C, int c_stride, int ldc) {
+  if (batch_size <= 0 || M <= 0 || N <= 0) return;
+  static const GemmMicroKernel<DType> kernel = SelectGemmKernel<DType>();
+  struct Closure {
+    GemmProblem<DType> prob;
+    int64_t num_tiles;
+    int64_t num_items;
+  } closure;
+  closure.prob = {ta, tb, M, N, K, alpha, beta, A, a_stride, lda, B, b_stride, ldb,
+                  C, c_stride, ldc};
+  closure.num_tiles = GemmTileRunner<DType>::NumTiles(closure.prob, kernel);
+  closure.num_items = closure.num_tiles * batch_size;
+  auto flambda = [](int task_id, TVMParallelGroupEnv* penv, void* cdata) -> int {
+    const Closure* closure = static_cast<const Closure*>(cdata);
+    int num_task = penv != nullptr ? penv->num_task : 1;
+    if (task_id >= closure->num_items) return 0;
+    GemmTileRunner<DType> runner(closure->prob, kernel);
+    for (int64_t item = task_id; item < closure->num_items; item += num_task) {
+      runner.Run(item / closure->num_tiles, item % closure->num_tiles);
+    }
+    return 0;
+  };
+  double flops = 2.0 * batch_size * M * N * std::max(K, 1);
+  if (closure.num_items < 2 || flops < kParallelGemmMinFlops) {
+    flambda(0, nullptr, &closure);
+  } else {
+    CHECK_EQ(TVMBackendParallelLaunchBarrierFree(flambda, &closure, 0), 0) << TVMGetLastError();
+  }
+}
+
+template void BuiltinGemmBatch<float>(int, bool, bool, int, int, int, float, const float*, int,
+                                      int, const float*, int, int, float, float*, int, int);
+template void BuiltinGemmBatch<double>(int, bool, bool, int, int, int, double, const double*,
+                                       int, int, const double*, int, int, double, double*, int,
+                                       int);
+
+template<typename DType>
+struct BuiltinGemmOp {
+  typedef DType TDatatype;
+  void operator()(bool ta, bool tb, int M, int N, int K, DType alpha, DType* A, int lda,
+                  DType* B, int ldb, DType beta, DType* C, int ldc) {
+    BuiltinGemmBatch<DType>(1, ta, tb, M, N, K, alpha, A, 0, lda, B, 0, ldb, beta, C, 0, ldc);
+  }
+};
+
+template<typename DType>
+struct BuiltinGemmBatchOp {
+  typedef DType TDatatype;
+  void operator()(int batch_size, bool ta, bool tb, int M, int N, int K, DType alpha, DType* A,
+                  int a_stride, int lda, DType* B, int b_stride, int ldb, DType beta, DType* C,
+                  int c_stride, int ldc) {
+    BuiltinGemmBatch<DType>(batch_size, ta, tb, M, N, K, alpha, A, a_stride, lda, B, b_stride,
+                            ldb, beta, C, c_stride, ldc);
+  }
+};
+
+// The cblas functions, served by the built-in gemm.
+TVM_REGISTER_GLOBAL("tvm.contrib.cblas.matmul")
+.set_body([](TVMArgs args, TVMRetValue* ret) {
+  DLTensor* A = args[0];
+  CHECK(TypeMatch(A->dtype, kDLFloat, 32) || TypeMatch(A->dtype, kDLFloat, 64));
+  if (TypeMatch(A->dtype, kDLFloat, 32)) {
+    CallGemm(args, ret, BuiltinGemmOp<float>());
+  } else {
+    CallGemm(args, ret, BuiltinGemmOp<double>());
+  }
+});
+
+TVM_REGISTER_GLOBAL("tvm.contrib.cblas.batch_matmul")
+.set_body([](TVMArgs args, TVMRetValue* ret) {
+  DLTensor* A = args[0];
+  CHECK(TypeMatch(A->dtype, kDLFloat, 32) || TypeMatch(A->dtype, kDLFloat, 64));
+  if (TypeMatch(A->dtype, kDLFloat, 32)) {
+    CallBatchGemm(args, ret, BuiltinGemmBatchOp<float>());
+  } else {
+    CallBatchGemm(args, ret, BuiltinGemmBatchOp<double>());
+  }
+});
+
+// The batch is always computed as a whole, both names do the same.
+TVM_REGISTER_GLOBAL("tvm.contrib.cblas.batch_matmul_iterative")
+.set_body([](TVMArgs args, TVMRetValue* ret) {
+  DLTensor* A = args[0];
+  CHECK(TypeMatch(A->dtype, kDLFloat, 32) || TypeMatch(A->dtype, kDLFloat, 64));
+  if (TypeMatch(A->dtype, kDLFloat, 32)) {
+    CallBatchGemm(args, ret, BuiltinGemmBatchOp<float>());
+  } else {
+    CallBatchGemm(args, ret, BuiltinGemmBatchOp<double>());
+  }
+});
+
+}  // namespace contrib
+}  // namespace tvm
@@ -0,0 +1,64 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ * 
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file builtin_gemm.h
+ * \brief Built-in gemm used for the cblas functions when no BLAS is linked.
+ *
+ *  The gemm follows the usual packed design: blocks of op(B) and op(A) are
+ *  copied into panels laid out in the order a micro-kernel reads them, and
+ *  the micro-kernel keeps a tile of C in registers over the depth of the
+ *  panels. The float micro-kernel is picked for the host at run time among
+ *  AVX-512, AVX2 with FMA, NEON and a portable one. The tiles of C of all
+ *  the matrices of a batch are computed in parallel in the thread pool.
+ */
+#ifndef TVM_RUNTIME_CONTRIB_CBLAS_BUILTIN_GEMM_H_
+#define TVM_RUNTIME_CONTRIB_CBLAS_BUILTIN_GEMM_H_
+
+namespace tvm {
+namespace contrib {
+
+/*!
+ * \brief Compute C = alpha * op(A) * op(B) + beta * C for a batch of column
+ *  major matrices, with the arguments of cblas_sgemm.
+ * \param batch_size The number of matrices.
+ * \param ta Whether to transpose A.
+ * \param tb Whether to transpose B.
+ * \param M The rows of op(A) and C.
+ * \param N The columns of op(B) and C.
+ * \param K The columns of op(A) and rows of op(B).
+ * \param alpha The scale of the product.
+ * \param A The first A.
+ * \param a_stride The elements between two A of the batch.
+ * \param lda The leading dimension of A.
+ * \param B The first B.
+ * \param b_stride The elements between two B of the batch.
+ * \param ldb The leading dimension of B.
+ * \param beta The scale of C, C is not read when it is 0.
+ * \param C The first C.
+ * \param c_stride The elements between two C of the batch.
+ * \param ldc The leading dimension of C.
+ */
+template<typename DType>
+void BuiltinGemmBatch(int batch_size, bool ta, bool tb, int M, int N, int K, DType alpha,
+                      const DType* A, int a_stride, int lda, const DType* B, int b_stride,
+                      int ldb, DType beta, DType* C, int c_stride, int ldc);
+
+}  // namespace contrib
+}  // namespace tvm
+#endif  // TVM_RUNTIME_CONTRIB_CBLAS_BUILTIN_GEMM_H_
@@ -0,0 +1,230 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ * 
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file random/philox_random_engine.cc
+ * \brief Philox4x32-10 counter based random engine
+ */
+#include <dmlc/logging.h>
+#include <tvm/runtime/c_backend_api.h>
+#include <tvm/runtime/c_runtime_api.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+
+namespace tvm {
+namespace contrib {
+
+/*!
+ * \brief A counter based generator for filling tensors in parallel.
+ *
+ *  Philox4x32-10 maps a 64 bit key and a 128 bit counter to 4 random 32 bit
+ *  integers. A stream of values taking w integers each has 4 / w values per
+ *  counter, its n-th value comes from the counter n / (4 / w) under the key
+ *  seed, so any part of the stream is computed directly from (seed, offset)
+ *  without walking the stream before it. A tensor filled from an offset is
+ *  therefore the same for any number of threads, and consecutive fills are
+ *  independent when the offsets do not overlap.
+ */
+class PhiloxRandomEngine {
+ public:
+  /*! \brief The number of integers produced per counter. */
+  static constexpr int kBlockSize = 4;
+  /*! \brief The number of counters generated together. */
+  static constexpr int kBatchBlocks = 16;
+
+  explicit PhiloxRandomEngine(uint64_t seed) : seed_(seed) {}
+
+  /*!
+   * \brief Generate the integers of kBatchBlocks consecutive counters.
+   * \param block The first counter.
+   * \param out The output of kBlockSize * kBatchBlocks integers.
+   */
+  void GenerateBatch(uint64_t block, uint32_t* out) const {
+    // The counters are kept one word per array so the rounds vectorize.
+    uint32_t c0[kBatchBlocks], c1[kBatchBlocks], c2[kBatchBlocks], c3[kBatchBlocks];
+    for (int i = 0; i < kBatchBlocks; ++i) {
+      c0[i] = static_cast<uint32_t>(block + i);
+      c1[i] = static_cast<uint32_t>((block + i) >> 32);
+      c2[i] = 0;
+      c3[i] = 0;
+    }
+    uint32_t k0 = static_cast<uint32_t>(seed_);
+    uint32_t k1 = static_cast<uint32_t>(seed_ >> 32);
+    for (int round = 0; round < 10; ++round) {
+      for (int i = 0; i < kBatchBlocks; ++i) {
+        uint64_t p0 = static_cast<uint64_t>(kMultiplier0) * c0[i];
+        uint64_t p1 = static_cast<uint64_t>(kMultiplier1) * c2[i];
+        c0[i] = static_cast<uint32_t>(p1 >> 32) ^ c1[i] ^ k0;
+        c1[i] = static_cast<uint32_t>(p1);
+        c2[i] = static_cast<uint32_t>(p0 >> 32) ^ c3[i] ^ k1;
+        c3[i] = static_cast<uint32_t>(p0);
+      }
+      k0 += kWeyl0;
+      k1 += kWeyl1;
+    }
+    for (int i = 0; i < kBatchBlocks; ++i) {
+      out[i * kBlockSize] = c0[i];
+      out[i * kBlockSize + 1] = c1[i];
+      out[i * kBlockSize + 2] = c2[i];
+      out[i * kBlockSize + 3] = c3[i];
+    }
+  }
+
+  /*!
+   * \brief Fill data with the values [offset, offset + size) of the stream.
+   * \param offset The position of the first value in the stream.
+   * \param size The number of values.
+   * \param data The output.
+   * \param transform Converts the kBlockSize integers of a counter to the
+   *  kBlockSize / kWordsPerValue values of the counter, called as
+   *  transform(const uint32_t* bits, DType* values).
+   * \tparam kWordsPerValue The number of integers taken by a value.
+   */
+  template<int kWordsPerValue, typename DType, typename FTransform>
+  void Fill(uint64_t offset, int64_t size, DType* data, FTransform transform) const {
+    static_assert(kBlockSize % kWordsPerValue == 0, "a value cannot span two counters");
+    constexpr int kValuesPerBlock = kBlockSize / kWordsPerValue;
+    constexpr int kBatchSize = kValuesPerBlock * kBatchBlocks;
+    uint32_t bits[kBlockSize * kBatchBlocks];
+    DType values[kBatchSize];
+    uint64_t end = offset + size;
+    // Batches start on counter boundaries, so the value at a position of the
+    // stream never depends on where the fill begins.
+    for (uint64_t pos = offset / kValuesPerBlock * kValuesPerBlock; pos < end;
+         pos += kBatchSize) {
+      GenerateBatch(pos / kValuesPerBlock, bits);
+      for (int i = 0; i < kBatchBlocks; ++i) {
+        transform(bits + i * kBlockSize, values + i * kValuesPerBlock);
+      }
+      uint64_t begin = std::max(pos, offset);
+      uint64_t stop = std::min(pos + kBatchSize, end);
+      std::copy(values + (begin - pos), values + (stop - pos), data + (begin - offset));
+    }
+  }
+
+ private:
+  static constexpr uint32_t kMultiplier0 = 0xD2511F53;
+  static constexpr uint32_t kMultiplier1 = 0xCD9E8D57;
+  static constexpr uint32_t kWeyl0 = 0x9E3779B9;
+  static constexpr uint32_t kWeyl1 = 0xBB67AE85;
+  uint64_t seed_;
+};
+
+/*! \brief Fills smaller than this are not split across threads. */
+constexpr int64_t kParallelFillMinSize = 1 << 14;
+
+/*!
+ * \brief Run f(begin, end) over chunks of [0, size) in the thread pool.
+ *  The chunks of the stream [offset, offset + size) split on multiples of
+ *  align, the values per counter, so no counter is generated twice.
+ */
+inline void ParallelForChunks(uint64_t offset, int64_t size, int64_t align,
+                              const std::function<void(int64_t, int64_t)>& f) {
+  if (size < kParallelFillMinSize) {
+    f(0, size);
+    return;
+  }
+  struct Closure {
+    const std::function<void(int64_t, int64_t)>* f;
+    uint64_t offset;
+    int64_t size;
+    int64_t align;
+  } closure{&f, offset, size, align};
+  auto flambda = [](int task_id, TVMParallelGroupEnv* penv, void* cdata) -> int {
+    const Closure* closure = static_cast<const Closure*>(cdata);
+    int64_t chunk = (closure->size + penv->num_task - 1) / penv->num_task;
+    // The k-th boundary is the first counter boundary of the stream at or
+    // after chunk * k.
+    auto boundary = [closure, chunk](int64_t k) -> int64_t {
+      if (k == 0) return 0;
+      uint64_t pos = closure->offset + static_cast<uint64_t>(chunk * k);
+      uint64_t aligned = (pos + closure->align - 1) / closure->align * closure->align;
+      return std::min(closure->size, static_cast<int64_t>(aligned - closure->offset));
+    };
+    int64_t begin = boundary(task_id);
+    int64_t end = boundary(task_id + 1);
+    if (begin < end) (*closure->f)(begin, end);
+    return 0;
+  };
+  CHECK_EQ(TVMBackendParallelLaunchBarrierFree(flambda, &closure, 0), 0) << TVMGetLastError();
+}
+
+/*!
+ * \brief Fill a CPU tensor from the stream of seed starting at offset.
+ * \param data The tensor, compact.
+ * \param seed The seed of the stream.
+ * \param offset The position of the first element in the stream.
+ * \param transform See PhiloxRandomEngine::Fill.
+ * \tparam kWordsPerValue The number of integers taken by a value.
+ */
+template<typename DType, int kWordsPerValue = 1, typename FTransform>
+void PhiloxFill(DLTensor* data, uint64_t seed, uint64_t offset, FTransform transform) {
+  CHECK(data->strides == nullptr);
+  CHECK_EQ(data->ctx.device_type, kDLCPU) << "Do not support philox random on this device yet";
+  int64_t size = 1;
+  for (int i = 0; i < data->ndim; ++i) {
+    size *= data->shape[i];
+  }
+  DType* ptr = static_cast<DType*>(data->data);
+  PhiloxRandomEngine engine(seed);
+  const int64_t align = PhiloxRandomEngine::kBlockSize / kWordsPerValue;
+  ParallelForChunks(offset, size, align, [&](int64_t begin, int64_t end) {
+    engine.Fill<kWordsPerValue>(offset + begin, end - begin, ptr + begin, transform);
+  });
+}
+
+/*! \brief Fills a tensor with values drawn from Unif(low, high) */
+inline void PhiloxSampleUniform(DLTensor* data, uint64_t seed, uint64_t offset,
+                                float low, float high) {
+  CHECK_GT(high, low) << "high must be bigger than low";
+  DLDataType dtype = data->dtype;
+  CHECK(dtype.code == kDLFloat && dtype.bits == 32 && dtype.lanes == 1);
+  float scale = (high - low) / 16777216.0f;
+  // Rounding can reach high, keep the interval half open.
+  float max_value = std::nextafter(high, low);
+  PhiloxFill<float>(data, seed, offset, [=](const uint32_t* bits, float* values) {
+    for (int i = 0; i < PhiloxRandomEngine::kBlockSize; ++i) {
+      values[i] = std::min(low + static_cast<float>(bits[i] >> 8) * scale, max_value);
+    }
+  });
+}
+
+/*! \brief Fills a tensor with values drawn from Normal(loc, scale**2) */
+inline void PhiloxSampleNormal(DLTensor* data, uint64_t seed, uint64_t offset,
+                               float loc, float scale) {
+  CHECK_GT(scale, 0) << "standard deviation must be positive";
+  DLDataType dtype = data->dtype;
+  CHECK(dtype.code == kDLFloat && dtype.bits == 32 && dtype.lanes == 1);
+  const float kTwoPi = 6.283185307179586f;
+  // Box-Muller on the pairs of integers of a counter.
+  PhiloxFill<float>(data, seed, offset, [=](const uint32_t* bits, float* values) {
+    for (int i = 0; i < PhiloxRandomEngine::kBlockSize; i += 2) {
+      // u1 is in (0, 1] so the logarithm is finite.
+      float u1 = static_cast<float>((bits[i] >> 8) + 1) / 16777216.0f;
+      float u2 = static_cast<float>(bits[i + 1] >> 8) / 16777216.0f;
+      float r = scale * std::sqrt(-2.0f * std::log(u1));
+      values[i] = loc + r * std::cos(kTwoPi * u2);
+      values[i + 1] = loc + r * std::sin(kTwoPi * u2);
+    }
+  });
+}
+
+}  // namespace contrib
+}  // namespace tvm
@@ -26,6 +26,7 @@
 #include <dmlc/thread_local.h>
 #include <algorithm>
 #include "mt_random_engine.cc"
+#include "philox_random_engine.cc"
 
 #define DLPACK_INTEGER_TYPE_SWITCH(type, DType, ...)    \
   if (type.code == kDLInt && type.bits == 32) {         \
@@ -122,5 +123,67 @@ TVM_REGISTER_GLOBAL("tvm.contrib.random.normal")
   });
 
 
+/*! \brief The high 64 bits of the 128 bit product a * b. */
+inline uint64_t MulHigh64(uint64_t a, uint64_t b) {
+  uint64_t a_lo = static_cast<uint32_t>(a), a_hi = a >> 32;
+  uint64_t b_lo = static_cast<uint32_t>(b), b_hi = b >> 32;
+  uint64_t lo_lo = a_lo * b_lo;
+  uint64_t hi_lo = a_hi * b_lo;
+  uint64_t lo_hi = a_lo * b_hi;
+  uint64_t cross = (lo_lo >> 32) + static_cast<uint32_t>(hi_lo) + lo_hi;
+  return a_hi * b_hi + (hi_lo >> 32) + (cross >> 32);
+}
+
+TVM_REGISTER_GLOBAL("tvm.contrib.random.philox_randint")
+.set_body([](TVMArgs args, TVMRetValue *ret) {
+    int64_t low = args[0];
+    int64_t high = args[1];
+    uint64_t seed = static_cast<int64_t>(args[2]);
+    uint64_t offset = static_cast<int64_t>(args[3]);
+    DLTensor* out = args[4];
+    CHECK_GT(high, low) << "high must be bigger than low";
+
+    DLPACK_INTEGER_TYPE_SWITCH(out->dtype, DType, {
+      int64_t numeric_low = std::numeric_limits<DType>::min();
+      int64_t numeric_high = std::numeric_limits<DType>::max();
+      numeric_high += 1;  // exclusive upper bound
+      low = std::max(low, numeric_low);
+      high = std::min(high, numeric_high);
+      uint64_t range = static_cast<uint64_t>(high - low);
+      // Lemire's multiply-shift on 64 random bits per value: the range is at
+      // most 2^32, so the bias is below 2^-32 where the modulo of 32 bits
+      // would favour the low values by up to a factor 2.
+      PhiloxFill<DType, 2>(out, seed, offset, [=](const uint32_t* bits, DType* values) {
+        for (int i = 0; i < PhiloxRandomEngine::kBlockSize / 2; ++i) {
+          uint64_t x = (static_cast<uint64_t>(bits[2 * i + 1]) << 32) | bits[2 * i];
+          values[i] = static_cast<DType>(low + static_cast<int64_t>(MulHigh64(x, range)));
+        }
+      });
+    })
+  });
+
+
+TVM_REGISTER_GLOBAL("tvm.contrib.random.philox_uniform")
+.set_body([](TVMArgs args, TVMRetValue *ret) {
+    double low = args[0];
+    double high = args[1];
+    uint64_t seed = static_cast<int64_t>(args[2]);
+    uint64_t offset = static_cast<int64_t>(args[3]);
+    DLTensor* out = args[4];
+    PhiloxSampleUniform(out, seed, offset, low, high);
+  });
+
+
+TVM_REGISTER_GLOBAL("tvm.contrib.random.philox_normal")
+.set_body([](TVMArgs args, TVMRetValue *ret) {
+    double loc = args[0];
+    double scale = args[1];
+    uint64_t seed = static_cast<int64_t>(args[2]);
+    uint64_t offset = static_cast<int64_t>(args[3]);
+    DLTensor* out = args[4];
+    PhiloxSampleNormal(out, seed, offset, loc, scale);
+  });
+
+
 }  // namespace contrib
 }  // namespace tvm
@@ -21,9 +21,17 @@
  * \file Use standard C library call.
  */
 
-#include <tvm/runtime/registry.h>
+#include <builtin_fp16.h>
 #include <dlpack/dlpack.h>
+#include <tvm/runtime/c_backend_api.h>
+#include <tvm/runtime/registry.h>
+
 #include <algorithm>
+#include <cstring>
+#include <functional>
+#include <numeric>
+#include <string>
+#include <type_traits>
 #include <vector>
 
 namespace tvm {
@@ -31,218 +39,253 @@ namespace contrib {
 
 using namespace runtime;
 
-template<typename DType>
-bool CompareAscend(const std::pair<int64_t, DType>& lhs,
-                   const std::pair<int64_t, DType>& rhs) {
-  return lhs.second < rhs.second;
+/*! \brief The bits of a float16 value, they are only compared and copied. */
+struct Half {
+  uint16_t bits;
+};
+
+// Map a value to an unsigned key with the same order, so that all the
+// types are sorted the same way. Negative zero is mapped to zero, as the
+// comparison of the values does not order them.
+inline uint16_t OrderedKey(Half value) {
+  uint16_t u = value.bits == 0x8000 ? 0 : value.bits;
+  return (u & 0x8000) ? static_cast<uint16_t>(~u) : static_cast<uint16_t>(u | 0x8000);
 }
 
-template<typename DType>
-bool CompareDescend(const std::pair<int64_t, DType>& lhs,
-                    const std::pair<int64_t, DType>& rhs) {
-  return lhs.second > rhs.second;
+inline uint32_t OrderedKey(float value) {
+  uint32_t u;
+  std::memcpy(&u, &value, sizeof(u));
+  if (u == 0x80000000U) u = 0;
+  return (u & 0x80000000U) ? ~u : (u | 0x80000000U);
 }
 
+inline uint64_t OrderedKey(double value) {
+  uint64_t u;
+  std::memcpy(&u, &value, sizeof(u));
+  if (u == 0x8000000000000000ULL) u = 0;
+  return (u & 0x8000000000000000ULL) ? ~u : (u | 0x8000000000000000ULL);
+}
 
-// Argsort implemented C library sort for nms.
-// Return indices of sorted tensor.
-// By default, the last axis will be used to sort.
-// sort_num specify the number of elements to be sorted.
-// If input tensor has dimension (d0, d1, ..., d(k-1), dk, d(k+1), ..., d(n-1))
-// and sort axis is dk. sort_num should have dimension of
-// (d1, d2, ..., d(k-1), d(k+1), ..., dn).
-TVM_REGISTER_GLOBAL("tvm.contrib.sort.argsort_nms")
-.set_body([](TVMArgs args, TVMRetValue *ret) {
-  DLTensor *input = args[0];
-  DLTensor *sort_num = args[1];
-  DLTensor *output = args[2];
-  int32_t axis = args[3];
-  bool is_ascend = args[4];
+inline uint32_t OrderedKey(int32_t value) {
+  return static_cast<uint32_t>(value) ^ 0x80000000U;
+}
 
-  auto dtype = input->dtype;
-  auto data_ptr = static_cast<float *>(input->data);
-  auto sort_num_ptr = static_cast<int32_t *>(sort_num->data);
-  std::vector<std::pair<int32_t, float>> sorter;
-  int64_t axis_mul_before = 1;
-  int64_t axis_mul_after = 1;
+inline uint64_t OrderedKey(int64_t value) {
+  return static_cast<uint64_t>(value) ^ 0x8000000000000000ULL;
+}
 
-  if (axis < 0) {
-    axis = input->ndim + axis;
-  }
+template<typename OutType>
+inline OutType IndexAs(int64_t index) {
+  return static_cast<OutType>(index);
+}
 
-  // Currently only supports input dtype to be float32.
-  CHECK_EQ(dtype.code, 2) << "Currently only supports input dtype "
-      "to be float.";
-#if (__ARM_FEATURE_FP16_SCALAR_ARITHMETIC != 1)
-  CHECK_EQ(dtype.bits, 32) << "Currently only supports input dtype "
-      "to be float32.";
-#endif
-  CHECK_LT(axis, input->ndim) << "Axis out of boundary for "
-      "input ndim " << input->ndim;
+template<>
+inline Half IndexAs<Half>(int64_t index) {
+  return Half{__truncXfYf2__<float, uint32_t, 23, uint16_t, uint16_t, 10>(
+      static_cast<float>(index))};
+}
 
-  for (int i = 0; i < input->ndim; ++i) {
-    if (i < axis) {
-      axis_mul_before *= input->shape[i];
-    } else if (i > axis) {
-      axis_mul_after *= input->shape[i];
+/*! \brief Rows shorter than this are sorted by comparison. */
+constexpr int64_t kRadixSortMinSize = 64;
+/*! \brief Rows are sorted in parallel above this number of elements. */
+constexpr int64_t kParallelSortMinSize = 1 << 14;
+
+/*!
+ * \brief Sorts the rows of a tensor along an axis.
+ *
+ *  Every row is gathered into contiguous order preserving keys, which
+ *  are inverted for a descending sort, so that the keys are always sorted
+ *  ascending and ties keep the original order as with std::stable_sort.
+ *  Keys of up to 32 bits are sorted with a radix sort, a topk of a small
+ *  k only selects the first k elements.
+ */
+template<typename DType>
+class RowSorter {
+ public:
+  using KeyType = decltype(OrderedKey(DType()));
+
+  RowSorter(int64_t size, bool is_ascend) : is_ascend_(is_ascend) {
+    // The buffers are reused by all the rows.
+    keys_.reserve(size);
+    index_.reserve(size);
+  }
+
+  /*!
+   * \brief Sort a row.
+   * \param data The first element of the row.
+   * \param stride The distance between the elements of the row.
+   * \param num The number of elements to sort, from the start of the row.
+   * \param k The number of sorted elements needed.
+   * \return The indices of the first k sorted elements.
+   */
+  const int64_t* Sort(const DType* data, int64_t stride, int64_t num, int64_t k) {
+    keys_.resize(num);
+    for (int64_t i = 0; i < num; ++i) {
+      KeyType key = OrderedKey(data[i * stride]);
+      keys_[i] = is_ascend_ ? key : static_cast<KeyType>(~key);
+    }
+    index_.resize(num);
+    std::iota(index_.begin(), index_.end(), 0);
+    auto less = [this](int64_t lhs, int64_t rhs) {
+      return keys_[lhs] < keys_[rhs] || (keys_[lhs] == keys_[rhs] && lhs < rhs);
+    };
+    if (k < num / 8) {
+      std::nth_element(index_.begin(), index_.begin() + k, index_.end(), less);
+      std::sort(index_.begin(), index_.begin() + k, less);
+    } else if (sizeof(KeyType) <= 4 && num >= kRadixSortMinSize) {
+      RadixSort();
+    } else {
+      std::sort(index_.begin(), index_.end(), less);
     }
+    return index_.data();
   }
 
-  for (int64_t i = 0 ; i < axis_mul_before; ++i) {
-    for (int64_t j = 0 ; j < axis_mul_after; ++j) {
-      sorter.clear();
-      int32_t current_sort_num = *(sort_num_ptr + i * axis_mul_after + j);
-      int64_t base_idx = i * input->shape[axis] * axis_mul_after + j;
-      for (int64_t k = 0; k < current_sort_num; ++k) {
-        int64_t full_idx = base_idx + k * axis_mul_after;
-        sorter.emplace_back(std::make_pair(k, *(data_ptr + full_idx)));
+ private:
+  // LSD radix sort of the keys by bytes, which is stable.
+  void RadixSort() {
+    int64_t num = static_cast<int64_t>(keys_.size());
+    keys_out_.resize(num);
+    index_out_.resize(num);
+    for (size_t shift = 0; shift < sizeof(KeyType) * 8; shift += 8) {
+      int64_t count[257] = {0};
+      for (int64_t i = 0; i < num; ++i) {
+        ++count[((keys_[i] >> shift) & 0xFF) + 1];
       }
-      if (is_ascend) {
-#if (__ARM_FEATURE_FP16_SCALAR_ARITHMETIC == 1)
-        if (dtype.bits == 16) {
-          std::stable_sort(sorter.begin(), sorter.end(), CompareAscend<__fp16>);
-        } else {
-#endif
-        std::stable_sort(sorter.begin(), sorter.end(), CompareAscend<float>);
-#if (__ARM_FEATURE_FP16_SCALAR_ARITHMETIC == 1)
-        }
-#endif
-      } else {
-#if (__ARM_FEATURE_FP16_SCALAR_ARITHMETIC == 1)
-        if (dtype.bits == 16) {
-          std::stable_sort(sorter.begin(), sorter.end(), CompareDescend<__fp16>);
-        } else {
-#endif
-        std::stable_sort(sorter.begin(), sorter.end(), CompareDescend<float>);
-#if (__ARM_FEATURE_FP16_SCALAR_ARITHMETIC == 1)
-        }
-#endif
+      // Skip the bytes that are the same for every key.
+      if (count[((keys_[0] >> shift) & 0xFF) + 1] == num) continue;
+      for (int b = 0; b < 256; ++b) {
+        count[b + 1] += count[b];
       }
-      for (int32_t k = 0; k < input->shape[axis]; ++k) {
-        *(static_cast<int32_t *>(output->data) + base_idx + k * axis_mul_after)
-            = k < static_cast<int32_t>(sorter.size()) ? sorter[k].first : k;
+      for (int64_t i = 0; i < num; ++i) {
+        int64_t pos = count[(keys_[i] >> shift) & 0xFF]++;
+        keys_out_[pos] = keys_[i];
+        index_out_[pos] = index_[i];
       }
+      std::swap(keys_, keys_out_);
+      std::swap(index_, index_out_);
     }
   }
-});
 
-template<typename DataType, typename OutType>
-void argsort(DLTensor* input, DLTensor* output, int32_t axis, bool is_ascend) {
-  auto data_ptr = static_cast<DataType *>(input->data);
-  auto out_ptr = static_cast<OutType *>(output->data);
-  std::vector<std::pair<int64_t, DataType> > sorter;
+  bool is_ascend_;
+  std::vector<KeyType> keys_, keys_out_;
+  std::vector<int64_t> index_, index_out_;
+};
+
+/*!
+ * \brief Run f(begin, end) over ranges of rows, in parallel on the
+ *  TVM thread pool when there is enough work.
+ * \param num_rows The number of rows.
+ * \param row_size The number of elements of a row.
+ * \param f The function.
+ */
+void ParallelForRows(int64_t num_rows, int64_t row_size,
+                     const std::function<void(int64_t, int64_t)>& f) {
+  if (num_rows < 2 || num_rows * row_size < kParallelSortMinSize) {
+    f(0, num_rows);
+    return;
+  }
+  struct Closure {
+    const std::function<void(int64_t, int64_t)>* f;
+    int64_t num_rows;
+  } closure{&f, num_rows};
+  auto flambda = [](int task_id, TVMParallelGroupEnv* penv, void* cdata) -> int {
+    const Closure* closure = static_cast<const Closure*>(cdata);
+    int64_t chunk = (closure->num_rows + penv->num_task - 1) / penv->num_task;
+    int64_t begin = std::min(closure->num_rows, chunk * task_id);
+    int64_t end = std::min(closure->num_rows, begin + chunk);
+    if (begin < end) (*closure->f)(begin, end);
+    return 0;
+  };
+  CHECK_EQ(TVMBackendParallelLaunchBarrierFree(flambda, &closure, 0), 0) << TVMGetLastError();
+}
 
-  int axis_mul_before = 1;
-  int axis_mul_after = 1;
+// Get the number of rows before the axis and the stride of the axis.
+void GetAxisExtents(const DLTensor* input, int axis,
+                    int64_t* axis_mul_before, int64_t* axis_mul_after) {
+  *axis_mul_before = 1;
+  *axis_mul_after = 1;
   for (int i = 0; i < input->ndim; ++i) {
     if (i < axis) {
-      axis_mul_before *= input->shape[i];
+      *axis_mul_before *= input->shape[i];
     } else if (i > axis) {
-      axis_mul_after *= input->shape[i];
+      *axis_mul_after *= input->shape[i];
     }
   }
+}
 
-  for (int i = 0 ; i < axis_mul_before; ++i) {
-    for (int j = 0 ; j < axis_mul_after; ++j) {
-      sorter.clear();
-      int64_t base_idx = i * input->shape[axis] * axis_mul_after + j;
-      for (int64_t k = 0; k < input->shape[axis]; ++k) {
-        int64_t full_idx = base_idx + k * axis_mul_after;
-        sorter.emplace_back(std::make_pair(k, data_ptr[full_idx]));
-      }
-      if (is_ascend) {
-        std::stable_sort(sorter.begin(), sorter.end(), CompareAscend<DataType>);
-      } else {
-        std::stable_sort(sorter.begin(), sorter.end(), CompareDescend<DataType>);
-      }
-      for (int64_t k = 0; k < input->shape[axis]; ++k) {
-        out_ptr[base_idx + k * axis_mul_after] = static_cast<OutType>(sorter[k].first);
-      }
-    }
+template<typename T>
+T* DataPtr(const DLTensor* tensor) {
+  return reinterpret_cast<T*>(static_cast<char*>(tensor->data) + tensor->byte_offset);
+}
+
+// Call f with a null pointer of the C type of dtype.
+template<typename F>
+void DispatchSortType(DLDataType dtype, const char* what, F f) {
+  std::string type = DLDataType2String(dtype);
+  if (type == "float32") {
+    f(static_cast<float*>(nullptr));
+  } else if (type == "float64") {
+    f(static_cast<double*>(nullptr));
+  } else if (type == "float16") {
+    f(static_cast<Half*>(nullptr));
+  } else if (type == "int32") {
+    f(static_cast<int32_t*>(nullptr));
+  } else if (type == "int64") {
+    f(static_cast<int64_t*>(nullptr));
+  } else {
+    LOG(FATAL) << "Unsupported " << what << " dtype: " << type;
   }
 }
 
-// Argsort implemented C library sort.
+// Argsort implemented C library sort for nms.
 // Return indices of sorted tensor.
 // By default, the last axis will be used to sort.
 // sort_num specify the number of elements to be sorted.
 // If input tensor has dimension (d0, d1, ..., d(k-1), dk, d(k+1), ..., d(n-1))
 // and sort axis is dk. sort_num should have dimension of
 // (d1, d2, ..., d(k-1), d(k+1), ..., dn).
-TVM_REGISTER_GLOBAL("tvm.contrib.sort.argsort")
+TVM_REGISTER_GLOBAL("tvm.contrib.sort.argsort_nms")
 .set_body([](TVMArgs args, TVMRetValue *ret) {
   DLTensor *input = args[0];
-  DLTensor *output = args[1];
-  int32_t axis = args[2];
-  bool is_ascend = args[3];
+  DLTensor *sort_num = args[1];
+  DLTensor *output = args[2];
+  int32_t axis = args[3];
+  bool is_ascend = args[4];
+
   if (axis < 0) {
     axis = input->ndim + axis;
   }
+  CHECK_EQ(input->dtype.code, kDLFloat) << "Currently only supports input dtype "
+      "to be float.";
+  CHECK(input->dtype.bits == 32 || input->dtype.bits == 16)
+      << "Currently only supports input dtype to be float32 or float16.";
   CHECK_LT(axis, input->ndim) << "Axis out of boundary for "
-                                 "input ndim " << input->ndim;
+      "input ndim " << input->ndim;
 
-  auto data_dtype = DLDataType2String(input->dtype);
-  auto out_dtype = DLDataType2String(output->dtype);
-
-  if (data_dtype == "float32") {
-    if (out_dtype == "int32") {
-      argsort<float, int32_t>(input, output, axis, is_ascend);
-    } else if (out_dtype == "int64") {
-      argsort<float, int64_t>(input, output, axis, is_ascend);
-    } else if (out_dtype == "float32") {
-      argsort<float, float>(input, output, axis, is_ascend);
-    } else if (out_dtype == "float64") {
-      argsort<float, double>(input, output, axis, is_ascend);
-    } else {
-      LOG(FATAL) << "Unsupported output dtype: " << out_dtype;
-    }
-  } else if (data_dtype == "float64") {
-    if (out_dtype == "int32") {
-      argsort<double, int32_t>(input, output, axis, is_ascend);
-    } else if (out_dtype == "int64") {
-      argsort<double, int64_t>(input, output, axis, is_ascend);
-    } else if (out_dtype == "float32") {
-      argsort<double, float>(input, output, axis, is_ascend);
-    } else if (out_dtype == "float64") {
-      argsort<double, double>(input, output, axis, is_ascend);
-    } else {
-      LOG(FATAL) << "Unsupported output dtype: " << out_dtype;
-    }
-#if (__ARM_FEATURE_FP16_SCALAR_ARITHMETIC == 1)
-  } else if (data_dtype == "float16") {
-    if (out_dtype == "float16") {
-      argsort<__fp16, __fp16>(input, output, axis, is_ascend);
-    } else {
-      LOG(FATAL) << "Unsupported output dtype: " << out_dtype;
-    }
-#endif
-  } else if (data_dtype == "int32") {
-    if (out_dtype == "int32") {
-      argsort<int32_t, int32_t>(input, output, axis, is_ascend);
-    } else if (out_dtype == "int64") {
-      argsort<int32_t, int64_t>(input, output, axis, is_ascend);
-    } else if (out_dtype == "float32") {
-      argsort<int32_t, float>(input, output, axis, is_ascend);
-    } else if (out_dtype == "float64") {
-      argsort<int32_t, double>(input, output, axis, is_ascend);
-    } else {
-      LOG(FATAL) << "Unsupported output dtype: " << out_dtype;
-    }
-  }  else if (data_dtype == "int64") {
-    if (out_dtype == "int32") {
-      argsort<int64_t, int32_t>(input, output, axis, is_ascend);
-    } else if (out_dtype == "int64") {
-      argsort<int64_t, int64_t>(input, output, axis, is_ascend);
-    } else if (out_dtype == "float32") {
-      argsort<int64_t, float>(input, output, axis, is_ascend);
-    } else if (out_dtype == "float64") {
-      argsort<int64_t, double>(input, output, axis, is_ascend);
-    } else {
-      LOG(FATAL) << "Unsupported output dtype: " << out_dtype;
-    }
-  } else {
-    LOG(FATAL) << "Unsupported input dtype: " << data_dtype;
-  }
+  int64_t axis_mul_before, axis_mul_after;
+  GetAxisExtents(input, axis, &axis_mul_before, &axis_mul_after);
+  int64_t axis_size = input->shape[axis];
+  const int32_t* sort_num_ptr = DataPtr<int32_t>(sort_num);
+  int32_t* out_ptr = DataPtr<int32_t>(output);
+
+  DispatchSortType(input->dtype, "input", [&](auto* tag) {
+    using DType = typename std::remove_pointer<decltype(tag)>::type;
+    const DType* data_ptr = DataPtr<DType>(input);
+    ParallelForRows(axis_mul_before * axis_mul_after, axis_size,
+                    [&](int64_t begin, int64_t end) {
+      RowSorter<DType> sorter(axis_size, is_ascend);
+      for (int64_t row = begin; row < end; ++row) {
+        int64_t i = row / axis_mul_after, j = row % axis_mul_after;
+        int64_t base_idx = i * axis_size * axis_mul_after + j;
+        int64_t num = std::min<int64_t>(std::max(sort_num_ptr[row], 0), axis_size);
+        const int64_t* index = sorter.Sort(data_ptr + base_idx, axis_mul_after, num, num);
+        for (int64_t k = 0; k < axis_size; ++k) {
+          out_ptr[base_idx + k * axis_mul_after] =
+              static_cast<int32_t>(k < num ? index[k] : k);
+        }
+      }
+    });
+  });
 });
 
 template<typename DataType, typename IndicesType>
@@ -252,62 +295,66 @@ void topk(DLTensor* input,
           int k,
           int axis,
           bool is_ascend) {
-  DataType* data_ptr = static_cast<DataType *>(input->data);
-  DataType* values_ptr = (out_values == nullptr) ? nullptr :
-          static_cast<DataType *>(out_values->data);
+  const DataType* data_ptr = DataPtr<DataType>(input);
+  DataType* values_ptr = (out_values == nullptr) ? nullptr : DataPtr<DataType>(out_values);
   IndicesType* indices_ptr = (out_indices == nullptr) ? nullptr :
-          static_cast<IndicesType *>(out_indices->data);
-  std::vector<std::pair<int64_t, DataType> > sorter;
+      DataPtr<IndicesType>(out_indices);
 
-  int axis_mul_before = 1;
-  int axis_mul_after = 1;
-  for (int i = 0; i < input->ndim; ++i) {
-    if (i < axis) {
-      axis_mul_before *= input->shape[i];
-    } else if (i > axis) {
-      axis_mul_after *= input->shape[i];
-    }
-  }
-  if (k < 1) {
-    k = input->shape[axis];
-  }
+  int64_t axis_mul_before, axis_mul_after;
+  GetAxisExtents(input, axis, &axis_mul_before, &axis_mul_after);
+  int64_t axis_size = input->shape[axis];
+  int64_t cnt = (k < 1 || k > axis_size) ? axis_size : k;
 
-  for (int i = 0 ; i < axis_mul_before; ++i) {
-    for (int j = 0 ; j < axis_mul_after; ++j) {
-      sorter.clear();
-      int64_t src_base_idx = i * input->shape[axis] * axis_mul_after + j;
-      int64_t dst_base_idx = i * k * axis_mul_after + j;
-      for (int64_t kk = 0; kk < input->shape[axis]; ++kk) {
-        int64_t full_idx = src_base_idx + kk * axis_mul_after;
-        sorter.emplace_back(std::make_pair(kk, data_ptr[full_idx]));
-      }
-      if (is_ascend) {
-        std::stable_sort(sorter.begin(), sorter.end(), CompareAscend<DataType>);
-      } else {
-        std::stable_sort(sorter.begin(), sorter.end(), CompareDescend<DataType>);
-      }
-      int64_t cnt = k > 0 ? k : input->shape[axis];
+  ParallelForRows(axis_mul_before * axis_mul_after, axis_size,
+                  [&](int64_t begin, int64_t end) {
+    RowSorter<DataType> sorter(axis_size, is_ascend);
+    for (int64_t row = begin; row < end; ++row) {
+      int64_t i = row / axis_mul_after, j = row % axis_mul_after;
+      int64_t src_base_idx = i * axis_size * axis_mul_after + j;
+      int64_t dst_base_idx = i * cnt * axis_mul_after + j;
+      const int64_t* index =
+          sorter.Sort(data_ptr + src_base_idx, axis_mul_after, axis_size, cnt);
       for (int64_t kk = 0; kk < cnt; ++kk) {
         if (indices_ptr != nullptr) {
-          indices_ptr[dst_base_idx + kk * axis_mul_after] =
-                  static_cast<IndicesType>(sorter[kk].first);
+          indices_ptr[dst_base_idx + kk * axis_mul_after] = IndexAs<IndicesType>(index[kk]);
         }
         if (values_ptr != nullptr) {
           values_ptr[dst_base_idx + kk * axis_mul_after] =
-                  static_cast<DataType>(sorter[kk].second);
+              data_ptr[src_base_idx + index[kk] * axis_mul_after];
         }
       }
     }
-  }
+  });
 }
 
 // Argsort implemented C library sort.
 // Return indices of sorted tensor.
 // By default, the last axis will be used to sort.
-// sort_num specify the number of elements to be sorted.
-// If input tensor has dimension (d0, d1, ..., d(k-1), dk, d(k+1), ..., d(n-1))
-// and sort axis is dk. sort_num should have dimension of
-// (d1, d2, ..., d(k-1), d(k+1), ..., dn).
+TVM_REGISTER_GLOBAL("tvm.contrib.sort.argsort")
+.set_body([](TVMArgs args, TVMRetValue *ret) {
+  DLTensor *input = args[0];
+  DLTensor *output = args[1];
+  int32_t axis = args[2];
+  bool is_ascend = args[3];
+  if (axis < 0) {
+    axis = input->ndim + axis;
+  }
+  CHECK_LT(axis, input->ndim) << "Axis out of boundary for "
+                                 "input ndim " << input->ndim;
+
+  // argsort is a topk of all the indices.
+  DispatchSortType(input->dtype, "input", [&](auto* data_tag) {
+    using DataType = typename std::remove_pointer<decltype(data_tag)>::type;
+    DispatchSortType(output->dtype, "output", [&](auto* out_tag) {
+      using OutType = typename std::remove_pointer<decltype(out_tag)>::type;
+      topk<DataType, OutType>(input, nullptr, output, 0, axis, is_ascend);
+    });
+  });
+});
+
+// Topk implemented with partial selection.
+// Return the values and/or the indices of the first k sorted elements.
+// By default, the last axis will be used to sort.
 TVM_REGISTER_GLOBAL("tvm.contrib.sort.topk")
 .set_body([](TVMArgs args, TVMRetValue* ret) {
   DLTensor* input = args[0];
@@ -332,60 +379,15 @@ TVM_REGISTER_GLOBAL("tvm.contrib.sort.topk")
   }
   CHECK(axis >= 0 && axis < input->ndim) << "Axis out of boundary for input ndim " << input->ndim;
 
-  auto data_dtype = DLDataType2String(input->dtype);
-  auto out_dtype = (indices_out == nullptr) ? "int64" : DLDataType2String(indices_out->dtype);
-
-  if (data_dtype == "float32") {
-    if (out_dtype == "int32") {
-      topk<float, int32_t>(input, values_out, indices_out, k, axis, is_ascend);
-    } else if (out_dtype == "int64") {
-      topk<float, int64_t>(input, values_out, indices_out, k, axis, is_ascend);
-    } else if (out_dtype == "float32") {
-      topk<float, float>(input, values_out, indices_out, k, axis, is_ascend);
-    } else if (out_dtype == "float64") {
-      topk<float, double>(input, values_out, indices_out, k, axis, is_ascend);
-    } else {
-      LOG(FATAL) << "Unsupported output dtype: " << out_dtype;
-    }
-  } else if (data_dtype == "float64") {
-    if (out_dtype == "int32") {
-      topk<double, int32_t>(input, values_out, indices_out, k, axis, is_ascend);
-    } else if (out_dtype == "int64") {
-      topk<double, int64_t>(input, values_out, indices_out, k, axis, is_ascend);
-    } else if (out_dtype == "float32") {
-      topk<double, float>(input, values_out, indices_out, k, axis, is_ascend);
-    } else if (out_dtype == "float64") {
-      topk<double, double>(input, values_out, indices_out, k, axis, is_ascend);
-    } else {
-      LOG(FATAL) << "Unsupported output dtype: " << out_dtype;
-    }
-  } else if (data_dtype == "int32") {
-    if (out_dtype == "int32") {
-      topk<int32_t, int32_t>(input, values_out, indices_out, k, axis, is_ascend);
-    } else if (out_dtype == "int64") {
-      topk<int32_t, int64_t>(input, values_out, indices_out, k, axis, is_ascend);
-    } else if (out_dtype == "float32") {
-      topk<int32_t, float>(input, values_out, indices_out, k, axis, is_ascend);
-    } else if (out_dtype == "float64") {
-      topk<int32_t, double>(input, values_out, indices_out, k, axis, is_ascend);
-    } else {
-      LOG(FATAL) << "Unsupported output dtype: " << out_dtype;
-    }
-  }  else if (data_dtype == "int64") {
-    if (out_dtype == "int32") {
-      topk<int64_t, int32_t>(input, values_out, indices_out, k, axis, is_ascend);
-    } else if (out_dtype == "int64") {
-      topk<int64_t, int64_t>(input, values_out, indices_out, k, axis, is_ascend);
-    } else if (out_dtype == "float32") {
-      topk<int64_t, float>(input, values_out, indices_out, k, axis, is_ascend);
-    } else if (out_dtype == "float64") {
-      topk<int64_t, double>(input, values_out, indices_out, k, axis, is_ascend);
-    } else {
-      LOG(FATAL) << "Unsupported output dtype: " << out_dtype;
-    }
-  } else {
-    LOG(FATAL) << "Unsupported input dtype: " << data_dtype;
-  }
+  DLDataType out_dtype = (indices_out == nullptr) ? DLDataType{kDLInt, 64, 1} :
+      indices_out->dtype;
+  DispatchSortType(input->dtype, "input", [&](auto* data_tag) {
+    using DataType = typename std::remove_pointer<decltype(data_tag)>::type;
+    DispatchSortType(out_dtype, "output", [&](auto* out_tag) {
+      using OutType = typename std::remove_pointer<decltype(out_tag)>::type;
+      topk<DataType, OutType>(input, values_out, indices_out, k, axis, is_ascend);
+    });
+  });
 });
 
 }  // namespace contrib
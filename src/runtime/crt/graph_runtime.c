@@ -88,6 +88,8 @@ void TVMGraphRuntimeNode_LoadAttrs(TVMGraphRuntimeNode * node, JSONReader *reade
     } else if (!strcmp(key, "flatten_data")) {
       param->flatten_data = strtoul(value, 0, 10);
       bitmask |= 8;
+    } else if (!strcmp(key, "flops")) {
+      // only used by the profiler of the debug runtime.
     } else {
       fprintf(stderr, "do not support key %s", key);
     }
@@ -27,6 +27,7 @@
 #include <chrono>
 #include <sstream>
 #include "../graph_runtime.h"
+#include "../../profiling.h"
 
 namespace tvm {
 namespace runtime {
@@ -105,6 +106,39 @@ class GraphRuntimeDebug : public GraphRuntime {
     return os.str();
   }
 
+  /*!
+   * \brief Profile each operation of the graph.
+   * \param number The number of times to run the graph after a warmup run.
+   * \return The report of the OpProfiler in the Chrome trace format.
+   */
+  std::string Profile(int number) {
+    // warmup run, which also starts the threads the counters watch.
+    GraphRuntime::Run();
+    std::vector<int64_t> bytes(op_execs_.size(), 0);
+    for (size_t nid = 0; nid < op_execs_.size(); ++nid) {
+      if (!op_execs_[nid]) continue;
+      for (const auto& e : nodes_[nid].inputs) {
+        bytes[nid] += static_cast<int64_t>(GetDataSize(*data_entry_[entry_id(e)].operator->()));
+      }
+      for (uint32_t i = 0; i < nodes_[nid].param.num_outputs; ++i) {
+        bytes[nid] += static_cast<int64_t>(
+            GetDataSize(*data_entry_[entry_id(nid, i)].operator->()));
+      }
+    }
+    OpProfiler profiler;
+    for (int k = 0; k < number; ++k) {
+      for (size_t nid = 0; nid < op_execs_.size(); ++nid) {
+        if (!op_execs_[nid]) continue;
+        const TVMContext& ctx = data_entry_[entry_id(nid, 0)]->ctx;
+        profiler.Begin();
+        op_execs_[nid]();
+        TVMSynchronize(ctx.device_type, ctx.device_id, nullptr);
+        profiler.End(GetNodeName(nid), bytes[nid], nodes_[nid].param.flops);
+      }
+    }
+    return profiler.ToJSON();
+  }
+
   /*!
    * \brief Run each operation and get the output.
    * \param index The index of op which needs to be returned.
@@ -182,6 +216,12 @@ PackedFunc GraphRuntimeDebug::GetFunction(
           this->DebugGetNodeOutput(args[0], args[1]);
         }
       });
+  } else if (name == "profile") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      int number = args[0];
+      CHECK_GT(number, 0);
+      *rv = this->Profile(number);
+    });
   } else if (name == "run_individual") {
     return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
       int number = args[0];
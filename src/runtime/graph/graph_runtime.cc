@@ -25,17 +25,26 @@
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/registry.h>
 #include <tvm/runtime/serializer.h>
+#include <tvm/runtime/threading_backend.h>
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <numeric>
+#include <set>
 #include <string>
+#include <tuple>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include "graph_runtime.h"
+#include "../mapped_params.h"
 
 namespace tvm {
 namespace runtime {
@@ -45,8 +54,106 @@ inline size_t GetDataAlignment(const DLTensor& arr) {
   if (align < kAllocAlignment) return kAllocAlignment;
   return align;
 }
+
+inline size_t GetDataBytes(const std::vector<int64_t>& shape, DLDataType t) {
+  size_t size = 1;
+  for (int64_t sz : shape) {
+    size *= static_cast<size_t>(sz);
+  }
+  size_t bits = t.bits * t.lanes;
+  CHECK(bits % 8U ==  0U || bits ==1U);
+  return ((bits + 7U) / 8U) * size;
+}
+
+// Whether a tensor can be placed in an arena by offsetting the data pointer.
+inline bool HasFlatAddressSpace(int device_type) {
+  return device_type == kDLCPU || device_type == kDLCPUPinned ||
+         device_type == kDLGPU || device_type == kDLROCM;
+}
 }  // namespace details
 
+/*!
+ * \brief Persistent inter-operator workers used by GraphRuntime::RunParallel.
+ *
+ *  Workers sleep between runs. Each worker restricts the thread pool used by
+ *  the operators it runs to a disjoint range of cores, so that the
+ *  intra-operator parallelism of all the workers together does not
+ *  oversubscribe the cores.
+ */
+class InterOpPool {
+ public:
+  explicit InterOpPool(int num_workers) : num_workers_(num_workers) {
+    threads_.reset(new threading::ThreadGroup(
+        num_workers_, [this](int worker_id) { this->RunWorker(worker_id); },
+        false /* exclude_worker0 */));
+  }
+  ~InterOpPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      exit_now_ = true;
+    }
+    job_cv_.notify_all();
+    threads_.reset();
+  }
+  int num_workers() const {
+    return num_workers_;
+  }
+  /*!
+   * \brief Run the job on every worker and wait for all of them to return.
+   * \param fjob The job, called with the worker id. It must not throw.
+   */
+  void Run(const std::function<void(int)>& fjob) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    job_ = &fjob;
+    num_running_ = num_workers_;
+    ++generation_;
+    job_cv_.notify_all();
+    done_cv_.wait(lock, [this] { return num_running_ == 0; });
+    job_ = nullptr;
+  }
+
+ private:
+  void RunWorker(int worker_id) {
+    // Give each worker its own range of cores. With more workers than cores,
+    // the workers run their operators single threaded and are not bound.
+    int nthreads = std::max(1, threading::MaxConcurrency() / num_workers_);
+    int core_offset = -1;
+    if (num_workers_ <= threading::MaxConcurrency()) {
+      core_offset = worker_id * nthreads;
+    }
+    const PackedFunc* fconfig = Registry::Get("runtime.config_threadpool");
+    if (fconfig != nullptr) {
+      (*fconfig)(static_cast<int>(threading::ThreadGroup::kBig), nthreads, core_offset);
+    }
+    uint64_t generation = 0;
+    while (true) {
+      const std::function<void(int)>* fjob;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        job_cv_.wait(lock, [this, generation] {
+            return exit_now_ || generation_ != generation;
+          });
+        if (exit_now_) return;
+        generation = generation_;
+        fjob = job_;
+      }
+      (*fjob)(worker_id);
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (--num_running_ == 0) done_cv_.notify_one();
+    }
+  }
+  int num_workers_;
+  std::mutex mutex_;
+  std::condition_variable job_cv_;
+  std::condition_variable done_cv_;
+  const std::function<void(int)>* job_{nullptr};
+  uint64_t generation_{0};
+  int num_running_{0};
+  bool exit_now_{false};
+  // Declared last so that the workers are joined before the members they use go away.
+  std::unique_ptr<threading::ThreadGroup> threads_;
+};
+
 /*!
  * \brief Run all the operations one by one.
  */
@@ -56,6 +163,135 @@ void GraphRuntime::Run() {
     if (op_execs_[i]) op_execs_[i]();
   }
 }
+
+/*!
+ * \brief Run the operations concurrently as their dependencies are met.
+ *
+ *  Each worker owns a deque of ready operators. A worker pushes and pops the
+ *  operators it made ready at the back of its own deque, which keeps producer
+ *  and consumer on the same core, and steals from the front of the other
+ *  deques when it runs out of work. A worker that finds no work spins for a
+ *  while and then sleeps until an operator becomes ready, so that the serial
+ *  stretches of the graph do not keep all the workers busy.
+ *
+ * \param num_workers The number of inter-operator workers.
+ */
+void GraphRuntime::RunParallel(int num_workers) {
+  if (num_workers <= 0) num_workers = threading::MaxConcurrency();
+  if (num_workers == 1) {
+    this->Run();
+    return;
+  }
+  if (inter_op_pool_ == nullptr || inter_op_pool_->num_workers() != num_workers) {
+    inter_op_pool_ = std::make_shared<InterOpPool>(num_workers);
+  }
+  struct ReadyQueue {
+    std::mutex mutex;
+    std::deque<uint32_t> nids;
+  };
+  std::unique_ptr<ReadyQueue[]> queues(new ReadyQueue[num_workers]);
+  std::unique_ptr<std::atomic<uint32_t>[]> num_pending(
+      new std::atomic<uint32_t>[op_execs_.size()]);
+  size_t num_ops = 0;
+  for (uint32_t nid = 0; nid < op_execs_.size(); ++nid) {
+    if (!op_execs_[nid]) continue;
+    num_pending[nid].store(op_num_deps_[nid], std::memory_order_relaxed);
+    if (op_num_deps_[nid] == 0) {
+      queues[num_ops % num_workers].nids.push_back(nid);
+    }
+    ++num_ops;
+  }
+  std::atomic<size_t> num_remaining(num_ops);
+  std::atomic<bool> has_error(false);
+  std::mutex error_mutex;
+  std::string error_msg;
+  // The operators in the deques, and the idle workers waiting for them.
+  std::atomic<int64_t> num_ready(0);
+  for (int i = 0; i < num_workers; ++i) {
+    num_ready.fetch_add(static_cast<int64_t>(queues[i].nids.size()));
+  }
+  std::atomic<int> num_sleeping(0);
+  std::mutex idle_mutex;
+  std::condition_variable idle_cv;
+
+  auto pop = [&](int worker_id, uint32_t* nid) {
+    for (int i = 0; i < num_workers; ++i) {
+      int victim = (worker_id + i) % num_workers;
+      ReadyQueue& queue = queues[victim];
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      if (queue.nids.empty()) continue;
+      if (victim == worker_id) {
+        *nid = queue.nids.back();
+        queue.nids.pop_back();
+      } else {
+        *nid = queue.nids.front();
+        queue.nids.pop_front();
+      }
+      num_ready.fetch_sub(1);
+      return true;
+    }
+    return false;
+  };
+  // The sleepers are counted before they check for work under the mutex, so
+  // a worker that sees none of them after publishing its work needs no wakeup.
+  auto wake = [&](bool all) {
+    if (num_sleeping.load() == 0) return;
+    std::lock_guard<std::mutex> lock(idle_mutex);
+    if (all) {
+      idle_cv.notify_all();
+    } else {
+      idle_cv.notify_one();
+    }
+  };
+  auto fjob = [&](int worker_id) {
+    const int kSpinCount = 1000;
+    uint32_t nid;
+    int num_spins = 0;
+    while (num_remaining.load() != 0 && !has_error.load()) {
+      if (!pop(worker_id, &nid)) {
+        if (++num_spins < kSpinCount) {
+          threading::Yield();
+          continue;
+        }
+        std::unique_lock<std::mutex> lock(idle_mutex);
+        num_sleeping.fetch_add(1);
+        idle_cv.wait(lock, [&] {
+            return num_ready.load() > 0 || num_remaining.load() == 0 || has_error.load();
+          });
+        num_sleeping.fetch_sub(1);
+        num_spins = 0;
+        continue;
+      }
+      num_spins = 0;
+      try {
+        op_execs_[nid]();
+      } catch (const std::exception& e) {
+        {
+          std::lock_guard<std::mutex> lock(error_mutex);
+          if (!has_error.load()) error_msg = e.what();
+          has_error.store(true);
+        }
+        wake(true);
+        return;
+      }
+      for (uint32_t consumer : op_consumers_[nid]) {
+        if (num_pending[consumer].fetch_sub(1) == 1) {
+          {
+            ReadyQueue& queue = queues[worker_id];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.nids.push_back(consumer);
+          }
+          num_ready.fetch_add(1);
+          wake(false);
+        }
+      }
+      if (num_remaining.fetch_sub(1) == 1) wake(true);
+    }
+  };
+  inter_op_pool_->Run(fjob);
+  CHECK(!has_error.load()) << error_msg;
+}
+
 /*!
  * \brief Initialize the graph executor with graph and context.
  * \param graph_json The execution graph.
@@ -67,19 +303,45 @@ void GraphRuntime::Run() {
 void GraphRuntime::Init(const std::string& graph_json,
                         tvm::runtime::Module module,
                         const std::vector<TVMContext>& ctxs) {
-  std::istringstream is(graph_json);
-  dmlc::JSONReader reader(&is);
-  this->Load(&reader);
+  uint64_t magic = 0;
+  std::memcpy(&magic, graph_json.data(), std::min(graph_json.size(), sizeof(magic)));
+  if (magic == kTVMGraphBinaryMagic) {
+    this->LoadBinary(graph_json);
+  } else {
+    std::istringstream is(graph_json);
+    dmlc::JSONReader reader(&is);
+    this->Load(&reader);
+  }
   module_ = module;
   ctxs_ = ctxs;
   this->SetupStorage();
   this->SetupOpExecs();
+  this->SetupOpDeps();
   for (size_t i = 0; i < input_nodes_.size(); i++) {
     const uint32_t nid = input_nodes_[i];
     std::string& name = nodes_[nid].name;
     input_map_[name] = i;
   }
 }
+void GraphRuntime::InitExecutionContext(const GraphRuntime& other) {
+  nodes_ = other.nodes_;
+  input_nodes_ = other.input_nodes_;
+  input_map_ = other.input_map_;
+  node_row_ptr_ = other.node_row_ptr_;
+  outputs_ = other.outputs_;
+  attrs_ = other.attrs_;
+  module_ = other.module_;
+  op_funcs_ = other.op_funcs_;
+  ctxs_ = other.ctxs_;
+  param_eids_ = other.param_eids_;
+  data_entry_.resize(num_node_entries());
+  for (uint32_t eid : param_eids_) {
+    data_entry_[eid] = other.data_entry_[eid];
+  }
+  this->SetupStorage();
+  this->SetupOpExecs();
+  this->SetupOpDeps();
+}
 /*!
  * \brief Get the input index given the name of input.
  * \param name The name of the input.
@@ -93,6 +355,10 @@ int GraphRuntime::GetInputIndex(const std::string& name) {
   LOG(WARNING) << "Warning: cannot find \"" << name << "\" among input";
   return -1;
 }
+bool GraphRuntime::IsParamInput(int index) const {
+  CHECK_LT(static_cast<size_t>(index), input_nodes_.size());
+  return param_eids_.count(this->entry_id(input_nodes_[index], 0)) != 0;
+}
 /*!
  * \brief set index-th input to the graph.
  * \param index The input index.
@@ -213,7 +479,50 @@ void GraphRuntime::LoadParams(dmlc::Stream* strm) {
     NDArray temp;
     temp.Load(strm);
     data_entry_[eid].CopyFrom(temp);
+    param_eids_.insert(eid);
+  }
+}
+
+void GraphRuntime::LoadMappedParams(const std::string& file_name) {
+  for (auto& kv : runtime::LoadMappedParams(file_name)) {
+    int in_idx = GetInputIndex(kv.first);
+    CHECK_GE(in_idx, 0) << "Found param for non-existent input: " << kv.first;
+    uint32_t eid = this->entry_id(input_nodes_[in_idx], 0);
+    CHECK_LT(eid, data_entry_.size());
+    const DLTensor* old_t = data_entry_[eid].operator->();
+    const DLTensor* new_t = kv.second.operator->();
+    size_t alignment = details::GetDataAlignment(*old_t);
+    if (old_t->ctx.device_type == kDLCPU &&
+        reinterpret_cast<uintptr_t>(new_t->data) % alignment == 0) {
+      // View the mapped pages instead of copying them into the storage pool.
+      CHECK(TypeEqual(old_t->dtype, new_t->dtype));
+      CHECK_EQ(old_t->ndim, new_t->ndim);
+      for (int i = 0; i < old_t->ndim; ++i) {
+        CHECK_EQ(old_t->shape[i], new_t->shape[i]);
+      }
+      data_entry_[eid] = kv.second;
+      data_alignment_[eid] = alignment;
+    } else {
+      data_entry_[eid].CopyFrom(kv.second);
+    }
+    param_eids_.insert(eid);
+  }
+  // Release the storages that only the mapped params were placed in. The
+  // storages of an arena are shared by offset and stay allocated.
+  if (attrs_.storage_offset.empty()) {
+    std::vector<bool> viewed(storage_pool_.size(), false);
+    for (size_t i = 0; i < data_entry_.size(); ++i) {
+      size_t sid = static_cast<size_t>(attrs_.storage_id[i]);
+      if (sid < storage_pool_.size() && storage_pool_[sid].defined() &&
+          data_entry_[i]->data == storage_pool_[sid]->data) {
+        viewed[sid] = true;
+      }
+    }
+    for (size_t sid = 0; sid < storage_pool_.size(); ++sid) {
+      if (!viewed[sid]) storage_pool_[sid] = NDArray();
+    }
   }
+  this->SetupOpExecs();
 }
 
 void GraphRuntime::ShareParams(const GraphRuntime& other, dmlc::Stream* strm) {
@@ -240,6 +549,7 @@ void GraphRuntime::ShareParams(const GraphRuntime& other, dmlc::Stream* strm) {
     CHECK_GT(data_entry_[eid].use_count(), 1);
     const DLTensor* tmp = data_entry_[eid].operator->();
     data_alignment_[eid] = details::GetDataAlignment(*tmp);
+    param_eids_.insert(eid);
   }
   this->SetupOpExecs();
 }
@@ -251,27 +561,42 @@ void GraphRuntime::SetupStorage() {
     vtype.push_back(tvm::runtime::String2DLDataType(s_type));
   }
 
+  // The storages planned in arenas share one pool entry for each device, the
+  // entries are placed in it at their offsets.
+  bool use_arena = !attrs_.storage_offset.empty();
+  if (use_arena) {
+    CHECK_EQ(attrs_.storage_offset.size(), attrs_.shape.size()) << "invalid format";
+  }
+  std::vector<int> arena_device_types;
+  // The pool entry of each node entry.
+  std::vector<uint32_t> pool_ids(attrs_.shape.size(), 0);
+
   // Size and device type of each storage pool entry.
   std::vector<PoolEntry> pool_entry;
   // Find the maximum space size.
   for (size_t i = 0; i < attrs_.shape.size(); ++i) {
+    // Entries shared from another runtime do not need storage.
+    if (i < data_entry_.size() && data_entry_[i].defined()) continue;
     int storage_id = attrs_.storage_id[i];
     // Use the fallback device if no device index is available.
     int device_type = static_cast<int>(ctxs_[0].device_type);
     if (!attrs_.device_index.empty()) {
       device_type = attrs_.device_index[i];
     }
-    size_t size = 1;
-    for (int64_t sz : attrs_.shape[i]) {
-      size *= static_cast<size_t>(sz);
-    }
     CHECK_GE(storage_id, 0) << "Do not support runtime shape op";
-    DLDataType t = vtype[i];
-    size_t bits = t.bits * t.lanes;
-    CHECK(bits % 8U ==  0U || bits ==1U);
-    size_t bytes = ((bits + 7U) / 8U) * size;
+    size_t bytes = details::GetDataBytes(attrs_.shape[i], vtype[i]);
 
     uint32_t sid = static_cast<uint32_t>(storage_id);
+    if (use_arena) {
+      CHECK(details::HasFlatAddressSpace(device_type))
+          << "Storage offsets are not supported on device " << DeviceName(device_type);
+      CHECK_GE(attrs_.storage_offset[i], 0) << "invalid format";
+      auto it = std::find(arena_device_types.begin(), arena_device_types.end(), device_type);
+      sid = static_cast<uint32_t>(it - arena_device_types.begin());
+      if (it == arena_device_types.end()) arena_device_types.push_back(device_type);
+      bytes += static_cast<size_t>(attrs_.storage_offset[i]);
+    }
+    pool_ids[i] = sid;
     if (sid >= pool_entry.size()) {
       pool_entry.resize(sid + 1, {0, -1});
     } else {
@@ -285,6 +610,10 @@ void GraphRuntime::SetupStorage() {
 
   // Allocate the space.
   for (const auto& pit : pool_entry) {
+    if (pit.device_type == -1) {
+      storage_pool_.push_back(NDArray());
+      continue;
+    }
     std::vector<int64_t> shape;
     // This for loop is very fast since there are usually only a couple of
     // devices available on the same hardware.
@@ -304,10 +633,16 @@ void GraphRuntime::SetupStorage() {
   data_entry_.resize(num_node_entries());
   data_alignment_.resize(num_node_entries());
   for (size_t i = 0; i < data_entry_.size(); ++i) {
-    int storage_id = attrs_.storage_id[i];
-    CHECK_LT(static_cast<size_t>(storage_id), storage_pool_.size());
-    data_entry_[i] =
-        storage_pool_[storage_id].CreateView(attrs_.shape[i], vtype[i]);
+    if (!data_entry_[i].defined()) {
+      uint32_t sid = pool_ids[i];
+      CHECK_LT(sid, storage_pool_.size());
+      data_entry_[i] = storage_pool_[sid].CreateView(attrs_.shape[i], vtype[i]);
+      if (use_arena) {
+        // The kernels expect a zero byte offset, the data pointer is moved instead.
+        DLTensor* view = const_cast<DLTensor*>(data_entry_[i].operator->());
+        view->data = static_cast<char*>(view->data) + attrs_.storage_offset[i];
+      }
+    }
     const DLTensor* tmp = data_entry_[i].operator->();
     data_alignment_[i] = details::GetDataAlignment(*tmp);
   }
@@ -352,6 +687,100 @@ void GraphRuntime::SetupOpExecs() {
   }
 }
 
+void GraphRuntime::SetupOpDeps() {
+  op_num_deps_.assign(this->GetNumOfNodes(), 0);
+  op_consumers_.assign(this->GetNumOfNodes(), {});
+  // The memory plan lets entries with disjoint lifetimes in the serial order
+  // share a storage, so an operator writing a storage also has to wait for the
+  // previous writer and the readers of it.
+  size_t num_storage = 0;
+  for (int sid : attrs_.storage_id) {
+    num_storage = std::max(num_storage, static_cast<size_t>(sid) + 1);
+  }
+  // The storages planned in arenas also share their bytes with the storages of
+  // their device they do not overlap in time with, an operator writing a
+  // storage waits for the accesses of all the storages it overlaps in bytes.
+  std::vector<std::vector<int> > aliases(num_storage);
+  for (size_t sid = 0; sid < num_storage; ++sid) {
+    aliases[sid].push_back(static_cast<int>(sid));
+  }
+  if (!attrs_.storage_offset.empty()) {
+    // The device, the first and the past the last byte of each storage.
+    std::vector<std::tuple<int, int64_t, int64_t> > ranges(num_storage, std::make_tuple(-1, 0, 0));
+    for (size_t i = 0; i < attrs_.storage_id.size(); ++i) {
+      int64_t begin = attrs_.storage_offset[i];
+      int64_t end = begin + static_cast<int64_t>(details::GetDataBytes(
+          attrs_.shape[i], String2DLDataType(attrs_.dltype[i])));
+      auto& range = ranges[attrs_.storage_id[i]];
+      int device_type = attrs_.device_index.empty() ? 0 : attrs_.device_index[i];
+      if (std::get<0>(range) == -1) {
+        range = std::make_tuple(device_type, begin, end);
+      } else {
+        std::get<2>(range) = std::max(std::get<2>(range), end);
+      }
+    }
+    std::vector<int> order;
+    for (size_t sid = 0; sid < num_storage; ++sid) {
+      if (std::get<0>(ranges[sid]) != -1) order.push_back(static_cast<int>(sid));
+    }
+    std::sort(order.begin(), order.end(), [&ranges](int lhs, int rhs) {
+      return ranges[lhs] < ranges[rhs];
+    });
+    for (size_t i = 0; i < order.size(); ++i) {
+      const auto& range = ranges[order[i]];
+      for (size_t j = i + 1; j < order.size(); ++j) {
+        const auto& other = ranges[order[j]];
+        if (std::get<0>(other) != std::get<0>(range) ||
+            std::get<1>(other) >= std::get<2>(range)) {
+          break;
+        }
+        aliases[order[i]].push_back(order[j]);
+        aliases[order[j]].push_back(order[i]);
+      }
+    }
+  }
+  std::vector<int64_t> last_writer(num_storage, -1);
+  std::vector<std::vector<uint32_t> > readers(num_storage);
+  for (uint32_t nid = 0; nid < this->GetNumOfNodes(); ++nid) {
+    const auto& inode = nodes_[nid];
+    if (inode.op_type == "null") continue;
+    std::set<uint32_t> deps;
+    auto add_dep = [&](int64_t src) {
+      if (src >= 0 && src != nid && op_execs_[src]) {
+        deps.insert(static_cast<uint32_t>(src));
+      }
+    };
+    for (const auto& e : inode.inputs) {
+      add_dep(e.node_id);
+      add_dep(last_writer[attrs_.storage_id[this->entry_id(e)]]);
+    }
+    for (uint32_t dep : inode.control_deps) {
+      add_dep(dep);
+    }
+    for (uint32_t index = 0; index < inode.param.num_outputs; ++index) {
+      int sid = attrs_.storage_id[this->entry_id(nid, index)];
+      for (int alias : aliases[sid]) {
+        add_dep(last_writer[alias]);
+        for (uint32_t reader : readers[alias]) {
+          add_dep(reader);
+        }
+      }
+    }
+    for (const auto& e : inode.inputs) {
+      readers[attrs_.storage_id[this->entry_id(e)]].push_back(nid);
+    }
+    for (uint32_t index = 0; index < inode.param.num_outputs; ++index) {
+      int sid = attrs_.storage_id[this->entry_id(nid, index)];
+      last_writer[sid] = nid;
+      readers[sid].clear();
+    }
+    op_num_deps_[nid] = static_cast<uint32_t>(deps.size());
+    for (uint32_t dep : deps) {
+      op_consumers_[dep].push_back(nid);
+    }
+  }
+}
+
 std::pair<std::function<void()>, std::shared_ptr<GraphRuntime::OpArgs> > GraphRuntime::CreateTVMOp(
     const TVMOpParam& param,
     const std::vector<DLTensor>& args,
@@ -391,8 +820,7 @@ std::pair<std::function<void()>, std::shared_ptr<GraphRuntime::OpArgs> > GraphRu
 
   // Get compiled function from the module that contains both host and device
   // code.
-  tvm::runtime::PackedFunc pf = module_.GetFunction(param.func_name, true);
-  CHECK(pf != nullptr) << "no such function in module: " << param.func_name;
+  tvm::runtime::PackedFunc pf = GetOpFunction(param.func_name);
 
   auto fexec = [arg_ptr, pf]() {
     TVMRetValue rv;
@@ -404,6 +832,249 @@ std::pair<std::function<void()>, std::shared_ptr<GraphRuntime::OpArgs> > GraphRu
   return {fexec, arg_ptr};
 }
 
+const PackedFunc& GraphRuntime::GetOpFunction(const std::string& name) {
+  auto it = op_funcs_.find(name);
+  if (it == op_funcs_.end()) {
+    PackedFunc pf = module_.GetFunction(name, true);
+    CHECK(pf != nullptr) << "no such function in module: " << name;
+    it = op_funcs_.emplace(name, pf).first;
+  }
+  return it->second;
+}
+
+namespace {
+// Appends the sections of a binary graph, the strings go to a table written first.
+class GraphBinaryWriter {
+ public:
+  void WriteU32(uint32_t value) {
+    Append(&value, sizeof(value));
+  }
+
+  void WriteI64(int64_t value) {
+    Append(&value, sizeof(value));
+  }
+
+  void WriteString(const std::string& value) {
+    auto it = string_index_.find(value);
+    if (it == string_index_.end()) {
+      it = string_index_.emplace(value, static_cast<uint32_t>(strings_.size())).first;
+      strings_.push_back(value);
+    }
+    WriteU32(it->second);
+  }
+
+  template <typename T>
+  void WriteArray(const std::vector<T>& values) {
+    WriteU32(static_cast<uint32_t>(values.size()));
+    if (!values.empty()) Append(values.data(), values.size() * sizeof(T));
+  }
+
+  std::string Finish() {
+    std::string ret;
+    auto put = [&ret](const void* data, size_t size) {
+      ret.append(static_cast<const char*>(data), size);
+    };
+    put(&kTVMGraphBinaryMagic, sizeof(kTVMGraphBinaryMagic));
+    put(&kTVMGraphBinaryVersion, sizeof(kTVMGraphBinaryVersion));
+    uint32_t num_strings = static_cast<uint32_t>(strings_.size());
+    put(&num_strings, sizeof(num_strings));
+    for (const std::string& str : strings_) {
+      uint32_t size = static_cast<uint32_t>(str.size());
+      put(&size, sizeof(size));
+      put(str.data(), str.size());
+    }
+    ret += body_;
+    return ret;
+  }
+
+ private:
+  void Append(const void* data, size_t size) {
+    body_.append(static_cast<const char*>(data), size);
+  }
+
+  std::string body_;
+  std::vector<std::string> strings_;
+  std::unordered_map<std::string, uint32_t> string_index_;
+};
+
+// Reads a binary graph in place, checking the bounds.
+class GraphBinaryReader {
+ public:
+  explicit GraphBinaryReader(const std::string& data)
+      : ptr_(data.data()), end_(data.data() + data.size()) {
+    uint64_t magic;
+    Read(&magic, sizeof(magic));
+    CHECK_EQ(magic, kTVMGraphBinaryMagic) << "invalid binary graph";
+    version_ = ReadU32();
+    CHECK(version_ >= 1 && version_ <= kTVMGraphBinaryVersion)
+        << "unsupported binary graph version " << version_;
+    // Each string holds at least its size.
+    strings_.resize(ReadCount(sizeof(uint32_t)));
+    for (std::string& str : strings_) {
+      uint32_t size = ReadU32();
+      CHECK_LE(size, static_cast<size_t>(end_ - ptr_)) << "invalid binary graph";
+      str.assign(ptr_, size);
+      ptr_ += size;
+    }
+  }
+
+  uint32_t ReadU32() {
+    uint32_t value;
+    Read(&value, sizeof(value));
+    return value;
+  }
+
+  int64_t ReadI64() {
+    int64_t value;
+    Read(&value, sizeof(value));
+    return value;
+  }
+
+  /*!
+   * \brief Read the number of elements that follow, checked against the bytes left.
+   * \param min_bytes The size of the smallest element.
+   */
+  uint32_t ReadCount(size_t min_bytes) {
+    uint32_t count = ReadU32();
+    CHECK_LE(count, static_cast<size_t>(end_ - ptr_) / min_bytes) << "invalid binary graph";
+    return count;
+  }
+
+  const std::string& ReadString() {
+    uint32_t index = ReadU32();
+    CHECK_LT(index, strings_.size()) << "invalid binary graph";
+    return strings_[index];
+  }
+
+  template <typename T>
+  void ReadArray(std::vector<T>* values) {
+    uint32_t size = ReadCount(sizeof(T));
+    values->resize(size);
+    Read(values->data(), size * sizeof(T));
+  }
+
+  bool AtEnd() const {
+    return ptr_ == end_;
+  }
+
+  uint32_t version() const {
+    return version_;
+  }
+
+ private:
+  void Read(void* data, size_t size) {
+    CHECK_LE(size, static_cast<size_t>(end_ - ptr_)) << "invalid binary graph";
+    if (size != 0) std::memcpy(data, ptr_, size);
+    ptr_ += size;
+  }
+
+  const char* ptr_;
+  const char* end_;
+  uint32_t version_;
+  std::vector<std::string> strings_;
+};
+}  // namespace
+
+std::string GraphRuntime::SaveBinary() const {
+  GraphBinaryWriter writer;
+  auto write_entry = [&writer](const NodeEntry& e) {
+    writer.WriteU32(e.node_id);
+    writer.WriteU32(e.index);
+    writer.WriteU32(e.version);
+  };
+  writer.WriteU32(static_cast<uint32_t>(nodes_.size()));
+  for (const Node& node : nodes_) {
+    bool is_op = node.op_type != "null";
+    writer.WriteString(node.op_type);
+    writer.WriteString(node.name);
+    writer.WriteString(is_op ? node.param.func_name : std::string());
+    writer.WriteU32(is_op ? node.param.num_inputs : 0);
+    writer.WriteU32(is_op ? node.param.num_outputs : 1);
+    writer.WriteU32(is_op ? node.param.flatten_data : 0);
+    writer.WriteI64(node.param.flops);
+    writer.WriteU32(static_cast<uint32_t>(node.inputs.size()));
+    for (const NodeEntry& e : node.inputs) {
+      write_entry(e);
+    }
+    writer.WriteArray(node.control_deps);
+  }
+  writer.WriteArray(input_nodes_);
+  writer.WriteU32(static_cast<uint32_t>(outputs_.size()));
+  for (const NodeEntry& e : outputs_) {
+    write_entry(e);
+  }
+  writer.WriteArray(node_row_ptr_);
+  writer.WriteArray(attrs_.storage_id);
+  writer.WriteArray(attrs_.device_index);
+  writer.WriteArray(attrs_.storage_offset);
+  writer.WriteU32(static_cast<uint32_t>(attrs_.dltype.size()));
+  for (const std::string& dltype : attrs_.dltype) {
+    writer.WriteString(dltype);
+  }
+  writer.WriteU32(static_cast<uint32_t>(attrs_.shape.size()));
+  for (const auto& shape : attrs_.shape) {
+    writer.WriteArray(shape);
+  }
+  return writer.Finish();
+}
+
+void GraphRuntime::LoadBinary(const std::string& data) {
+  GraphBinaryReader reader(data);
+  auto read_entry = [&reader](NodeEntry* e) {
+    e->node_id = reader.ReadU32();
+    e->index = reader.ReadU32();
+    e->version = reader.ReadU32();
+  };
+  // The counts are checked against the smallest encoding of their elements:
+  // a string index or an array size for the nodes, dtypes and shapes, three
+  // fields for the node entries.
+  const size_t kEntryBytes = 3 * sizeof(uint32_t);
+  nodes_.resize(reader.ReadCount(sizeof(uint32_t)));
+  for (Node& node : nodes_) {
+    node.op_type = reader.ReadString();
+    node.name = reader.ReadString();
+    node.param.func_name = reader.ReadString();
+    node.param.num_inputs = reader.ReadU32();
+    node.param.num_outputs = reader.ReadU32();
+    node.param.flatten_data = reader.ReadU32();
+    node.param.flops = reader.ReadI64();
+    node.inputs.resize(reader.ReadCount(kEntryBytes));
+    for (NodeEntry& e : node.inputs) {
+      read_entry(&e);
+    }
+    reader.ReadArray(&node.control_deps);
+  }
+  reader.ReadArray(&input_nodes_);
+  outputs_.resize(reader.ReadCount(kEntryBytes));
+  for (NodeEntry& e : outputs_) {
+    read_entry(&e);
+  }
+  reader.ReadArray(&node_row_ptr_);
+  reader.ReadArray(&attrs_.storage_id);
+  reader.ReadArray(&attrs_.device_index);
+  // The storage offsets were added in version 2.
+  if (reader.version() >= 2) {
+    reader.ReadArray(&attrs_.storage_offset);
+  }
+  attrs_.dltype.resize(reader.ReadCount(sizeof(uint32_t)));
+  for (std::string& dltype : attrs_.dltype) {
+    dltype = reader.ReadString();
+  }
+  attrs_.shape.resize(reader.ReadCount(sizeof(uint32_t)));
+  for (auto& shape : attrs_.shape) {
+    reader.ReadArray(&shape);
+  }
+  CHECK(reader.AtEnd()) << "invalid binary graph";
+}
+
+std::string GraphRuntime::GraphJSONToBinary(const std::string& graph_json) {
+  GraphRuntime graph;
+  std::istringstream is(graph_json);
+  dmlc::JSONReader reader(&is);
+  graph.Load(&reader);
+  return graph.SaveBinary();
+}
+
 PackedFunc GraphRuntime::GetFunction(
     const std::string& name,
     const ObjectPtr<Object>& sptr_to_self) {
@@ -453,10 +1124,19 @@ PackedFunc GraphRuntime::GetFunction(
     return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
         this->Run();
       });
+  } else if (name == "run_parallel") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        int num_workers = args.num_args > 0 ? static_cast<int>(args[0]) : 0;
+        this->RunParallel(num_workers);
+      });
   } else if (name == "load_params") {
     return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
         this->LoadParams(args[0].operator std::string());
       });
+  } else if (name == "load_mapped_params") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        this->LoadMappedParams(args[0].operator std::string());
+      });
   } else if (name == "share_params") {
     return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
         const auto& module = args[0].operator Module();
@@ -492,6 +1172,15 @@ std::vector<TVMContext> GetAllContext(const TVMArgs& args) {
   return ret;
 }
 
+TVM_REGISTER_GLOBAL("tvm.graph_runtime.json_to_binary")
+.set_body([](TVMArgs args, TVMRetValue* rv) {
+    std::string data = GraphRuntime::GraphJSONToBinary(args[0]);
+    TVMByteArray arr;
+    arr.data = data.data();
+    arr.size = data.size();
+    *rv = arr;
+  });
+
 // 4-argument version is currently reserved to keep support of calling
 // from tvm4j and javascript, since they don't have heterogeneous
 // execution support yet. For heterogenenous execution, at least 5 arguments will
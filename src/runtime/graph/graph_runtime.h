@@ -33,6 +33,7 @@
 
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 #include <string>
@@ -50,6 +51,12 @@ namespace runtime {
 
 /*! \brief Magic number for NDArray list file  */
 constexpr uint64_t kTVMNDArrayListMagic = 0xF7E58D4F05049CB7;
+/*! \brief Magic number for the binary graph format, its first byte cannot start a json graph. */
+constexpr uint64_t kTVMGraphBinaryMagic = 0xF7E58D4F05049CC3;
+/*! \brief Version of the binary graph format. */
+constexpr uint32_t kTVMGraphBinaryVersion = 2;
+
+class InterOpPool;
 
 /*! \brief operator attributes about tvm op */
 struct TVMOpParam {
@@ -57,6 +64,7 @@ struct TVMOpParam {
   uint32_t num_inputs;
   uint32_t num_outputs;
   uint32_t flatten_data;
+  int64_t flops = -1;
 };
 
 /*!
@@ -90,10 +98,21 @@ class TVM_DLL GraphRuntime : public ModuleNode {
     return "GraphRuntime";
   }
   void Run();
+  /*!
+   * \brief Run the operators concurrently on a pool of inter-operator workers.
+   *
+   *  An operator is dispatched as soon as all of the operators it depends on
+   *  have finished. The dependencies include the data flow edges as well as
+   *  the ordering implied by storage sharing in the memory plan.
+   *
+   * \param num_workers The number of inter-operator workers, the number of
+   *  cores is used when it is not positive.
+   */
+  void RunParallel(int num_workers);
 
   /*!
    * \brief Initialize the graph executor with graph and context.
-   * \param graph_json The execution graph.
+   * \param graph_json The execution graph, in json or in the binary format.
    * \param module The module containing the compiled functions for the host
    *  processor.
    * \param ctxs The context of the host and devices where graph nodes will be
@@ -104,6 +123,16 @@ class TVM_DLL GraphRuntime : public ModuleNode {
             tvm::runtime::Module module,
             const std::vector<TVMContext>& ctxs);
 
+  /*!
+   * \brief Initialize the graph executor as an execution context of another one.
+   *
+   *  The graph, the code module and the loaded parameters are shared with
+   *  \p other, only the storage of the remaining entries is allocated.
+   *
+   * \param other An initialized GraphRuntime.
+   */
+  void InitExecutionContext(const GraphRuntime& other);
+
   /*!
    * \brief Get the input index given the name of input.
    * \param name The name of the input.
@@ -111,6 +140,13 @@ class TVM_DLL GraphRuntime : public ModuleNode {
    */
   int GetInputIndex(const std::string& name);
 
+  /*!
+   * \brief Whether an input holds a loaded parameter.
+   * \param index The input index.
+   * \return True if the parameters set the input.
+   */
+  bool IsParamInput(int index) const;
+
   /*!
    * \brief set index-th input to the graph.
    * \param index The input index.
@@ -159,6 +195,15 @@ class TVM_DLL GraphRuntime : public ModuleNode {
    * \param param_blob A binary blob of parameter.
    */
   void LoadParams(const std::string& param_blob);
+  /*!
+   * \brief Load parameters from a mapped params file.
+   *
+   *  Parameters of CPU inputs view the mapped file instead of being copied,
+   *  the others are copied to their device.
+   *
+   * \param file_name The name of the file.
+   */
+  void LoadMappedParams(const std::string& file_name);
 
   /*!
    * \brief Share parameters from pre-existing GraphRuntime instance.
@@ -180,6 +225,18 @@ class TVM_DLL GraphRuntime : public ModuleNode {
     return nodes_[nid].name;
   }
 
+  /*!
+   * \brief Convert a graph from json to the binary format.
+   *
+   *  The binary format holds the same graph as the json one, with the
+   *  strings in a table and the numbers in fixed width, so that it loads
+   *  without parsing. It is in the byte order of the host, as the params.
+   *
+   * \param graph_json The graph in json.
+   * \return The graph in the binary format.
+   */
+  static std::string GraphJSONToBinary(const std::string& graph_json);
+
 
  protected:
   // Memory pool entry.
@@ -239,6 +296,8 @@ class TVM_DLL GraphRuntime : public ModuleNode {
         } else if (key == "flatten_data") {
           param->flatten_data = strtoul(value.c_str(), nullptr, 10);
           bitmask |= 8;
+        } else if (key == "flops") {
+          param->flops = strtoll(value.c_str(), nullptr, 10);
         }
       }
       CHECK_EQ(bitmask, 1|2|4|8) << "invalid format";
@@ -273,6 +332,8 @@ class TVM_DLL GraphRuntime : public ModuleNode {
     size_t storage_num_not_alloctaed{0};
     std::vector<int> storage_id;
     std::vector<int> device_index;
+    /*! \brief The offsets of the entries in the arena of their device, when planned in arenas. */
+    std::vector<int64_t> storage_offset;
     std::vector<std::string> dltype;
     std::vector<std::vector<int64_t> > shape;
     // The graph attribute fields.
@@ -316,6 +377,14 @@ class TVM_DLL GraphRuntime : public ModuleNode {
           CHECK(reader->NextArrayItem());
           reader->Read(&device_index);
           CHECK(!reader->NextArrayItem());
+        } else if (key == "storage_offset") {
+          reader->BeginArray();
+          CHECK(reader->NextArrayItem());
+          reader->Read(&type);
+          CHECK_EQ(type, "list_int");
+          CHECK(reader->NextArrayItem());
+          reader->Read(&storage_offset);
+          CHECK(!reader->NextArrayItem());
         } else {
           reader->BeginArray();
           CHECK(reader->NextArrayItem());
@@ -366,10 +435,25 @@ class TVM_DLL GraphRuntime : public ModuleNode {
       }
       CHECK_EQ(bitmask, 1|2|4|8|16) << "invalid format";
   }
+  /*!
+   * \brief Load the graph from the binary format.
+   * \param data The graph.
+   */
+  void LoadBinary(const std::string& data);
+  /*! \return The loaded graph in the binary format. */
+  std::string SaveBinary() const;
+  /*!
+   * \brief Get a function of the module, resolving each name once.
+   * \param name The function name.
+   * \return The function.
+   */
+  const PackedFunc& GetOpFunction(const std::string& name);
   /*! \brief Setup the temporal storage */
   void SetupStorage();
   /*! \brief Setup the executors. */
   void SetupOpExecs();
+  /*! \brief Setup the dependency graph between the executors. */
+  void SetupOpDeps();
   /*!
    * \brief Create an execution function given input.
    * \param attrs The node attributes.
@@ -408,16 +492,26 @@ class TVM_DLL GraphRuntime : public ModuleNode {
   GraphAttr attrs_;
   /*! \brief The code module that contains both host and device code. */
   tvm::runtime::Module module_;
+  /*! \brief The functions of the module called by the nodes, by name. */
+  std::unordered_map<std::string, PackedFunc> op_funcs_;
   /*! \brief Execution context of all devices including the host. */
   std::vector<TVMContext> ctxs_;
   /*! \brief Common storage pool for all devices. */
   std::vector<NDArray> storage_pool_;
   /*! \brief Data entry of each node. */
   std::vector<NDArray> data_entry_;
+  /*! \brief Entry ids of the loaded parameters. */
+  std::unordered_set<uint32_t> param_eids_;
   /*! \brief Data alignment of each node. */
   std::vector<size_t> data_alignment_;
   /*! \brief Operator on each node. */
   std::vector<std::function<void()> > op_execs_;
+  /*! \brief Number of operators each operator waits for. */
+  std::vector<uint32_t> op_num_deps_;
+  /*! \brief Operators waiting for each operator. */
+  std::vector<std::vector<uint32_t> > op_consumers_;
+  /*! \brief Workers used by RunParallel, created on first use. */
+  std::shared_ptr<InterOpPool> inter_op_pool_;
 };
 
 std::vector<TVMContext> GetAllContext(const TVMArgs& args);
@@ -0,0 +1,255 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file graph_runtime_pool.cc
+ * \brief Execution contexts of one graph sharing the code and parameters.
+ */
+#include <tvm/runtime/packed_func.h>
+#include <tvm/runtime/registry.h>
+
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "graph_runtime.h"
+
+namespace tvm {
+namespace runtime {
+
+class GraphRuntimePool;
+
+/*!
+ * \brief Execution context handed out by GraphRuntimePool.
+ *
+ *  It exposes the functions of the GraphRuntime it wraps, and gives the
+ *  runtime back to the pool once the last reference goes away.
+ */
+class GraphExecutionContext : public ModuleNode {
+ public:
+  GraphExecutionContext(ObjectPtr<GraphRuntime> runtime, ObjectPtr<GraphRuntimePool> pool)
+      : runtime_(std::move(runtime)), pool_(std::move(pool)) {}
+
+  ~GraphExecutionContext();
+
+  const char* type_key() const final {
+    return "GraphExecutionContext";
+  }
+
+  PackedFunc GetFunction(const std::string& name,
+                         const ObjectPtr<Object>& sptr_to_self) final {
+    // The parameters are shared by every context of the pool, writing them
+    // through one context would change the others.
+    if (name == "set_input" || name == "set_input_zero_copy") {
+      PackedFunc set_input = runtime_->GetFunction(name, sptr_to_self);
+      return PackedFunc([sptr_to_self, set_input, this](TVMArgs args, TVMRetValue* rv) {
+          CHECK(!this->IsParamInput(args[0]))
+              << "Cannot set a parameter input of an execution context, "
+              << "the parameters are shared by the pool";
+          set_input.CallPacked(args, rv);
+        });
+    } else if (name == "is_param_input") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+          *rv = this->IsParamInput(args[0]);
+        });
+    } else if (name == "load_params" || name == "load_mapped_params" ||
+               name == "share_params") {
+      return PackedFunc([name](TVMArgs args, TVMRetValue* rv) {
+          LOG(FATAL) << "Cannot call " << name << " on an execution context, "
+                     << "load the parameters through the pool";
+        });
+    }
+    return runtime_->GetFunction(name, sptr_to_self);
+  }
+
+ private:
+  // Whether the input, given by name or index, is a shared parameter.
+  bool IsParamInput(const TVMArgValue& input) const {
+    int index;
+    if (input.type_code() == kTVMStr) {
+      index = runtime_->GetInputIndex(input.operator std::string());
+    } else {
+      index = input;
+    }
+    return index >= 0 && runtime_->IsParamInput(index);
+  }
+
+  ObjectPtr<GraphRuntime> runtime_;
+  ObjectPtr<GraphRuntimePool> pool_;
+};
+
+/*!
+ * \brief Pool of execution contexts of one graph.
+ *
+ *  The graph, the code module and the parameters are loaded once and shared
+ *  by every context. Each context owns the activation storage of one request
+ *  at a time, contexts released by their users are recycled by later requests.
+ */
+class GraphRuntimePool : public ModuleNode {
+ public:
+  const char* type_key() const final {
+    return "GraphRuntimePool";
+  }
+
+  /*!
+   * \brief Initialize the pool with graph and context.
+   * \param graph_json The execution graph.
+   * \param module The module containing the compiled functions.
+   * \param ctxs The context of the host and devices where graph nodes will be
+   *  executed on.
+   */
+  void Init(const std::string& graph_json,
+            tvm::runtime::Module module,
+            const std::vector<TVMContext>& ctxs) {
+    base_ = make_object<GraphRuntime>();
+    base_->Init(graph_json, module, ctxs);
+    idle_.push_back(base_);
+    num_contexts_ = 1;
+  }
+
+  /*!
+   * \brief Load the shared parameters.
+   * \param param_blob A binary blob of parameter.
+   */
+  void LoadParams(const std::string& param_blob) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK(num_contexts_ == 1 && idle_.size() == 1)
+        << "Parameters must be loaded before creating execution contexts";
+    base_->LoadParams(param_blob);
+  }
+
+  /*!
+   * \brief Load the shared parameters from a mapped params file.
+   * \param file_name The name of the file.
+   */
+  void LoadMappedParams(const std::string& file_name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK(num_contexts_ == 1 && idle_.size() == 1)
+        << "Parameters must be loaded before creating execution contexts";
+    base_->LoadMappedParams(file_name);
+  }
+
+  /*!
+   * \brief Get an execution context, reusing an idle one when available.
+   * \return The execution context.
+   */
+  Module CreateExecutionContext() {
+    ObjectPtr<GraphRuntime> runtime;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!idle_.empty()) {
+        runtime = std::move(idle_.back());
+        idle_.pop_back();
+      } else {
+        ++num_contexts_;
+      }
+    }
+    if (runtime == nullptr) {
+      runtime = make_object<GraphRuntime>();
+      runtime->InitExecutionContext(*base_);
+    }
+    auto exec = make_object<GraphExecutionContext>(
+        std::move(runtime), GetObjectPtr<GraphRuntimePool>(this));
+    return Module(exec);
+  }
+
+  /*!
+   * \brief Give a runtime back to the pool.
+   * \param runtime The runtime of a released execution context.
+   */
+  void Recycle(ObjectPtr<GraphRuntime> runtime) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    idle_.push_back(std::move(runtime));
+  }
+
+  /*! \brief Release the idle execution contexts except the base one. */
+  void ReleaseIdle() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<ObjectPtr<GraphRuntime> > kept;
+    for (auto& runtime : idle_) {
+      if (runtime == base_) {
+        kept.push_back(std::move(runtime));
+      } else {
+        --num_contexts_;
+      }
+    }
+    idle_.swap(kept);
+  }
+
+  PackedFunc GetFunction(const std::string& name,
+                         const ObjectPtr<Object>& sptr_to_self) final {
+    if (name == "load_params") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+          this->LoadParams(args[0].operator std::string());
+        });
+    } else if (name == "load_mapped_params") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+          this->LoadMappedParams(args[0].operator std::string());
+        });
+    } else if (name == "create_execution_context") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+          *rv = this->CreateExecutionContext();
+        });
+    } else if (name == "release_idle") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+          this->ReleaseIdle();
+        });
+    } else if (name == "get_num_contexts") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+          std::lock_guard<std::mutex> lock(mutex_);
+          *rv = static_cast<int64_t>(num_contexts_);
+        });
+    } else if (name == "get_num_idle") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+          std::lock_guard<std::mutex> lock(mutex_);
+          *rv = static_cast<int64_t>(idle_.size());
+        });
+    } else {
+      return PackedFunc();
+    }
+  }
+
+ private:
+  /*! \brief The runtime owning the parameters, shared by every context. */
+  ObjectPtr<GraphRuntime> base_;
+  /*! \brief Runtimes not used by any execution context. */
+  std::vector<ObjectPtr<GraphRuntime> > idle_;
+  /*! \brief Number of runtimes created, idle or in use. */
+  size_t num_contexts_{0};
+  /*! \brief Protects the idle list. */
+  std::mutex mutex_;
+};
+
+GraphExecutionContext::~GraphExecutionContext() {
+  pool_->Recycle(std::move(runtime_));
+}
+
+TVM_REGISTER_GLOBAL("tvm.graph_runtime_pool.create")
+  .set_body([](TVMArgs args, TVMRetValue* rv) {
+    CHECK_GE(args.num_args, 4)
+        << "The expected number of arguments for graph_runtime_pool.create is "
+           "at least 4, but it has "
+        << args.num_args;
+    auto pool = make_object<GraphRuntimePool>();
+    pool->Init(args[0], args[1], GetAllContext(args));
+    *rv = Module(pool);
+  });
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,240 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file mapped_params.cc
+ * \brief Parameter files that are loaded by mapping them into memory.
+ */
+#include <dmlc/memory_io.h>
+#include <tvm/runtime/c_runtime_api.h>
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/runtime/serializer.h>
+
+#if defined(_WIN32)
+#include <cstring>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "file_util.h"
+#include "mapped_params.h"
+
+namespace tvm {
+namespace runtime {
+
+/*! \brief A read only file mapped privately into memory. */
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string& file_name) {
+#if defined(_WIN32)
+    LoadBinaryFromFile(file_name, &buffer_);
+    data_ = &buffer_[0];
+    size_ = buffer_.size();
+#else
+    int fd = open(file_name.c_str(), O_RDONLY);
+    CHECK_GE(fd, 0) << "Cannot open " << file_name;
+    struct stat st;
+    CHECK_EQ(fstat(fd, &st), 0) << "Cannot stat " << file_name;
+    size_ = static_cast<size_t>(st.st_size);
+    void* ptr = size_ == 0 ? nullptr :
+        mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    CHECK(ptr != MAP_FAILED) << "Cannot map " << file_name;
+    data_ = static_cast<char*>(ptr);
+#endif
+  }
+  ~MappedFile() {
+#if !defined(_WIN32)
+    if (data_ != nullptr) {
+      munmap(data_, size_);
+    }
+#endif
+  }
+  char* data() const {
+    return data_;
+  }
+  size_t size() const {
+    return size_;
+  }
+
+ private:
+  char* data_{nullptr};
+  size_t size_{0};
+#if defined(_WIN32)
+  std::string buffer_;
+#endif
+};
+
+static size_t AlignUp(size_t value) {
+  return (value + kAllocAlignment - 1) / kAllocAlignment * kAllocAlignment;
+}
+
+static void WriteMappedParamsHeader(dmlc::Stream* strm,
+                                    const std::vector<std::string>& names,
+                                    const std::vector<NDArray>& arrays,
+                                    const std::vector<uint64_t>& offsets) {
+  uint64_t header = kTVMMappedParamsMagic, reserved = 0;
+  strm->Write(header);
+  strm->Write(reserved);
+  strm->Write(static_cast<uint64_t>(names.size()));
+  for (size_t i = 0; i < names.size(); ++i) {
+    const DLTensor* tensor = arrays[i].operator->();
+    strm->Write(names[i]);
+    strm->Write(tensor->dtype);
+    strm->Write(tensor->ndim);
+    strm->WriteArray(tensor->shape, tensor->ndim);
+    strm->Write(offsets[i]);
+    strm->Write(static_cast<uint64_t>(GetDataSize(*tensor)));
+  }
+}
+
+void SaveMappedParams(const std::string& file_name,
+                      const std::vector<std::string>& names,
+                      const std::vector<NDArray>& arrays) {
+  CHECK_EQ(names.size(), arrays.size());
+  // The header has a fixed size, write it once to know where the data begins.
+  std::vector<uint64_t> offsets(arrays.size(), 0);
+  std::string header;
+  {
+    dmlc::MemoryStringStream strm(&header);
+    WriteMappedParamsHeader(&strm, names, arrays, offsets);
+  }
+  size_t end = header.size();
+  for (size_t i = 0; i < arrays.size(); ++i) {
+    offsets[i] = AlignUp(end);
+    end = offsets[i] + GetDataSize(*arrays[i].operator->());
+  }
+  header.clear();
+  {
+    dmlc::MemoryStringStream strm(&header);
+    WriteMappedParamsHeader(&strm, names, arrays, offsets);
+  }
+
+  std::ofstream fs(file_name, std::ios::out | std::ios::binary);
+  CHECK(!fs.fail()) << "Cannot open " << file_name;
+  fs.write(header.data(), header.size());
+  size_t pos = header.size();
+  std::vector<char> bytes;
+  for (size_t i = 0; i < arrays.size(); ++i) {
+    const DLTensor* tensor = arrays[i].operator->();
+    size_t nbytes = GetDataSize(*tensor);
+    bytes.assign(offsets[i] - pos, 0);
+    fs.write(bytes.data(), bytes.size());
+    bytes.resize(nbytes);
+    CHECK_EQ(TVMArrayCopyToBytes(
+        const_cast<DLTensor*>(tensor), dmlc::BeginPtr(bytes), nbytes), 0)
+        << TVMGetLastError();
+    if (!DMLC_IO_NO_ENDIAN_SWAP) {
+      size_t elem_bytes = (tensor->dtype.bits * tensor->dtype.lanes + 7) / 8;
+      dmlc::ByteSwap(dmlc::BeginPtr(bytes), elem_bytes, nbytes / elem_bytes);
+    }
+    fs.write(bytes.data(), nbytes);
+    pos = offsets[i] + nbytes;
+  }
+  CHECK(!fs.fail()) << "Cannot write " << file_name;
+}
+
+// Keeps the mapping alive while an array views it.
+static void MappedNDArrayDeleter(Object* obj) {
+  auto* ptr = static_cast<NDArray::Container*>(obj);
+  delete static_cast<std::shared_ptr<MappedFile>*>(ptr->manager_ctx);
+  delete ptr;
+}
+
+std::vector<std::pair<std::string, NDArray> > LoadMappedParams(const std::string& file_name) {
+  auto file = std::make_shared<MappedFile>(file_name);
+  dmlc::MemoryFixedSizeStream strm(file->data(), file->size());
+  uint64_t header, reserved, num_params;
+  CHECK(strm.Read(&header) && header == kTVMMappedParamsMagic)
+      << "Invalid mapped parameters file format";
+  CHECK(strm.Read(&reserved))
+      << "Invalid mapped parameters file format";
+  CHECK(strm.Read(&num_params))
+      << "Invalid mapped parameters file format";
+
+  DLContext cpu_ctx;
+  cpu_ctx.device_type = kDLCPU;
+  cpu_ctx.device_id = 0;
+  std::vector<std::pair<std::string, NDArray> > params;
+  for (uint64_t i = 0; i < num_params; ++i) {
+    std::string name;
+    DLDataType dtype;
+    int ndim;
+    uint64_t offset, nbytes;
+    CHECK(strm.Read(&name) && strm.Read(&dtype) && strm.Read(&ndim))
+        << "Invalid mapped parameters file format";
+    std::vector<int64_t> shape(ndim);
+    if (ndim != 0) {
+      CHECK(strm.ReadArray(&shape[0], ndim))
+          << "Invalid mapped parameters file format";
+    }
+    CHECK(strm.Read(&offset) && strm.Read(&nbytes))
+        << "Invalid mapped parameters file format";
+    CHECK(offset % kAllocAlignment == 0 && offset + nbytes <= file->size())
+        << "Invalid mapped parameters file format";
+
+    char* data = file->data() + offset;
+    if (!DMLC_IO_NO_ENDIAN_SWAP) {
+      // Only the touched pages of the private mapping are copied.
+      size_t elem_bytes = (dtype.bits * dtype.lanes + 7) / 8;
+      dmlc::ByteSwap(data, elem_bytes, nbytes / elem_bytes);
+    }
+#if defined(_WIN32)
+    // Without mmap the file buffer gives no alignment guarantee.
+    NDArray array = NDArray::Empty(shape, dtype, cpu_ctx);
+    std::memcpy(array->data, data, nbytes);
+#else
+    NDArray::Container* container = new NDArray::Container(data, shape, dtype, cpu_ctx);
+    container->manager_ctx = new std::shared_ptr<MappedFile>(file);
+    container->SetDeleter(MappedNDArrayDeleter);
+    NDArray array(GetObjectPtr<Object>(container));
+#endif
+    CHECK_EQ(GetDataSize(*array.operator->()), nbytes)
+        << "Invalid mapped parameters file format";
+    params.emplace_back(std::move(name), std::move(array));
+  }
+  return params;
+}
+
+TVM_REGISTER_GLOBAL("runtime.SaveMappedParams")
+.set_body([](TVMArgs args, TVMRetValue* rv) {
+    CHECK_EQ(args.size() % 2, 1);
+    // `args` is in the form "file_name, key, value, key, value, ..."
+    std::string file_name = args[0];
+    std::vector<std::string> names;
+    std::vector<NDArray> arrays;
+    for (int i = 1; i < args.size(); i += 2) {
+      names.emplace_back(args[i].operator std::string());
+      arrays.emplace_back(args[i + 1].operator NDArray());
+    }
+    SaveMappedParams(file_name, names, arrays);
+  });
+
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,68 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file mapped_params.h
+ * \brief Parameter files that are loaded by mapping them into memory.
+ *
+ *  The file starts with a header that lists the name, type, shape and
+ *  location of every array, followed by the array contents, each aligned
+ *  to kAllocAlignment. Loading maps the file and the arrays view the
+ *  mapped pages directly: pages are read in when first touched and are
+ *  shared by every process that maps the same file.
+ */
+#ifndef TVM_RUNTIME_MAPPED_PARAMS_H_
+#define TVM_RUNTIME_MAPPED_PARAMS_H_
+
+#include <tvm/runtime/ndarray.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+
+/*! \brief Magic number for mapped params file */
+constexpr uint64_t kTVMMappedParamsMagic = 0xF7E58D4F05049CB8;
+
+/*!
+ * \brief Save named arrays into a mapped params file.
+ * \param file_name The name of the file.
+ * \param names The names of the arrays.
+ * \param arrays The arrays, they can live on any device.
+ */
+void SaveMappedParams(const std::string& file_name,
+                      const std::vector<std::string>& names,
+                      const std::vector<NDArray>& arrays);
+
+/*!
+ * \brief Map a params file saved by SaveMappedParams into memory.
+ *
+ *  The returned arrays are CPU arrays viewing the mapping, which is
+ *  released with the last of them. The mapping is private, so writing
+ *  to an array copies the touched pages instead of changing the file.
+ *
+ * \param file_name The name of the file.
+ * \return The named arrays in the order they were saved.
+ */
+std::vector<std::pair<std::string, NDArray> > LoadMappedParams(const std::string& file_name);
+
+}  // namespace runtime
+}  // namespace tvm
+#endif  // TVM_RUNTIME_MAPPED_PARAMS_H_
@@ -0,0 +1,194 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file memory.cc
+ * \brief The arena that objects are allocated from.
+ */
+#include <dmlc/logging.h>
+#include <tvm/runtime/memory.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+
+#if defined(__ANDROID__) && __ANDROID_API__ < 17
+#include <malloc.h>
+#endif
+
+namespace tvm {
+namespace runtime {
+
+struct ObjectArena::Page {
+  /*! \brief The objects in the page, plus one while the arena holds it. */
+  std::atomic<int64_t> ref_count{1};
+  /*! \brief The offset of the free space. */
+  size_t offset{0};
+};
+
+namespace {
+// The page header is padded so that the first object is aligned.
+constexpr size_t kPageHeaderSize = (sizeof(ObjectArena::Page) + 63) / 64 * 64;
+static_assert((ObjectArena::kPageSize & (ObjectArena::kPageSize - 1)) == 0,
+              "pages are found by masking the object address");
+
+thread_local ObjectArena* current_arena = nullptr;
+// The objects made on the thread, read by the pass instruments.
+thread_local int64_t thread_num_objects = 0;
+thread_local int64_t thread_object_bytes = 0;
+
+std::mutex global_stats_mutex;
+ObjectArena::Stats global_stats;
+
+void* AllocPage() {
+  void* ptr;
+#if _MSC_VER
+  ptr = _aligned_malloc(ObjectArena::kPageSize, ObjectArena::kPageSize);
+  if (ptr == nullptr) throw std::bad_alloc();
+#elif defined(__ANDROID__) && __ANDROID_API__ < 17
+  ptr = memalign(ObjectArena::kPageSize, ObjectArena::kPageSize);
+  if (ptr == nullptr) throw std::bad_alloc();
+#else
+  int ret = posix_memalign(&ptr, ObjectArena::kPageSize, ObjectArena::kPageSize);
+  if (ret != 0) throw std::bad_alloc();
+#endif
+  return ptr;
+}
+
+void FreePage(void* ptr) {
+#if _MSC_VER
+  _aligned_free(ptr);
+#else
+  free(ptr);
+#endif
+}
+}  // namespace
+
+std::atomic<int> ObjectArena::num_trackers_{0};
+
+ObjectArena::ObjectArena() : prev_(current_arena) {
+  current_arena = this;
+  num_trackers_.fetch_add(1, std::memory_order_relaxed);
+}
+
+ObjectArena::~ObjectArena() {
+  CHECK(current_arena == this)
+      << "ObjectArena: the arenas of a thread must exit in the reverse order";
+  current_arena = prev_;
+  num_trackers_.fetch_sub(1, std::memory_order_relaxed);
+  if (page_ != nullptr) full_pages_.push_back(page_);
+  for (Page* page : full_pages_) {
+    // The objects left in the page free it with the last of them.
+    if (page->ref_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      page->~Page();
+      FreePage(page);
+    } else {
+      ++stats_.num_escaped_pages;
+    }
+  }
+  std::lock_guard<std::mutex> lock(global_stats_mutex);
+  global_stats.num_objects += stats_.num_objects;
+  global_stats.object_bytes += stats_.object_bytes;
+  global_stats.num_heap_objects += stats_.num_heap_objects;
+  global_stats.num_pages += stats_.num_pages;
+  global_stats.num_reused_pages += stats_.num_reused_pages;
+  global_stats.num_escaped_pages += stats_.num_escaped_pages;
+}
+
+void* ObjectArena::Alloc(size_t size, size_t align) {
+  CHECK_LE(size, kMaxObjectSize);
+  size_t offset = 0;
+  if (page_ != nullptr) {
+    offset = (page_->offset + align - 1) / align * align;
+  }
+  if (page_ == nullptr || offset + size > kPageSize) {
+    if (page_ != nullptr) full_pages_.push_back(page_);
+    page_ = NewPage();
+    offset = (page_->offset + align - 1) / align * align;
+  }
+  page_->offset = offset + size;
+  page_->ref_count.fetch_add(1, std::memory_order_relaxed);
+  ++stats_.num_objects;
+  stats_.object_bytes += size;
+  return reinterpret_cast<char*>(page_) + offset;
+}
+
+ObjectArena::Page* ObjectArena::NewPage() {
+  // Check a few of the full pages, in a round robin, for one without objects.
+  const size_t kMaxProbes = 4;
+  for (size_t i = 0; i < kMaxProbes && i < full_pages_.size(); ++i) {
+    if (next_reuse_ >= full_pages_.size()) next_reuse_ = 0;
+    Page* page = full_pages_[next_reuse_];
+    // Only the arena can add objects to its pages, so a free page stays free.
+    if (page->ref_count.load(std::memory_order_acquire) == 1) {
+      full_pages_[next_reuse_] = full_pages_.back();
+      full_pages_.pop_back();
+      page->offset = kPageHeaderSize;
+      ++stats_.num_reused_pages;
+      return page;
+    }
+    ++next_reuse_;
+  }
+  Page* page = new (AllocPage()) Page();
+  page->offset = kPageHeaderSize;
+  ++stats_.num_pages;
+  return page;
+}
+
+void ObjectArena::Free(void* ptr) {
+  Page* page = reinterpret_cast<Page*>(
+      reinterpret_cast<uintptr_t>(ptr) & ~static_cast<uintptr_t>(kPageSize - 1));
+  if (page->ref_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    page->~Page();
+    FreePage(page);
+  }
+}
+
+ObjectArena* ObjectArena::Current() {
+  return current_arena;
+}
+
+ObjectArena* ObjectArena::CountObject(size_t size) {
+  ++thread_num_objects;
+  thread_object_bytes += size;
+  return current_arena;
+}
+
+void ObjectArena::EnableCounting(bool enable) {
+  if (enable) {
+    num_trackers_.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    int prev = num_trackers_.fetch_sub(1, std::memory_order_relaxed);
+    CHECK_GT(prev, 0) << "ObjectArena: the counting was disabled more times than enabled";
+  }
+}
+
+void ObjectArena::ThreadObjectCounts(int64_t* num_objects, int64_t* object_bytes) {
+  *num_objects = thread_num_objects;
+  *object_bytes = thread_object_bytes;
+}
+
+ObjectArena::Stats ObjectArena::GlobalStats() {
+  std::lock_guard<std::mutex> lock(global_stats_mutex);
+  return global_stats;
+}
+
+}  // namespace runtime
+}  // namespace tvm
@@ -34,12 +34,10 @@ namespace runtime {
 void ModuleNode::Import(Module other) {
   // specially handle rpc
   if (!std::strcmp(this->type_key(), "rpc")) {
-    static const PackedFunc* fimport_ = nullptr;
-    if (fimport_ == nullptr) {
-      fimport_ = runtime::Registry::Get("rpc._ImportRemoteModule");
-      CHECK(fimport_ != nullptr);
-    }
-    (*fimport_)(GetRef<Module>(this), other);
+    static const Registry* fimport = Registry::Intern("rpc._ImportRemoteModule");
+    const PackedFunc* f = fimport->function();
+    CHECK(f != nullptr);
+    (*f)(GetRef<Module>(this), other);
     return;
   }
   // cyclic detection.
@@ -0,0 +1,305 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file profiling.cc
+ * \brief Per operator profiling shared by the debug executors.
+ */
+#include <dmlc/json.h>
+#include <tvm/runtime/container.h>
+
+#if defined(__linux__)
+#include <dirent.h>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <unordered_map>
+#include <utility>
+
+#include "profiling.h"
+
+namespace tvm {
+namespace runtime {
+
+#if defined(__linux__)
+namespace {
+struct CounterConfig {
+  const char* name;
+  uint32_t type;
+  uint64_t config;
+};
+
+const CounterConfig kCounterConfigs[] = {
+  {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+  {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+  {"llc_misses", PERF_TYPE_HW_CACHE,
+   PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+   (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+};
+
+int OpenCounter(const CounterConfig& cfg, pid_t tid) {
+  perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = cfg.type;
+  attr.config = cfg.config;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  // The times tell how long the counter was scheduled when multiplexed.
+  attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  return static_cast<int>(syscall(__NR_perf_event_open, &attr, tid, -1, -1, 0));
+}
+
+std::vector<pid_t> ListThreads() {
+  std::vector<pid_t> tids;
+  DIR* dir = opendir("/proc/self/task");
+  if (dir == nullptr) return tids;
+  while (dirent* ent = readdir(dir)) {
+    if (ent->d_name[0] != '.') {
+      tids.push_back(static_cast<pid_t>(atoi(ent->d_name)));
+    }
+  }
+  closedir(dir);
+  return tids;
+}
+}  // namespace
+
+HardwareCounters::HardwareCounters() {
+  std::vector<pid_t> tids = ListThreads();
+  if (tids.empty()) return;
+  std::vector<const CounterConfig*> configs;
+  for (const CounterConfig& cfg : kCounterConfigs) {
+    // Keep the counters the kernel and the cpu support.
+    int fd = OpenCounter(cfg, tids[0]);
+    if (fd < 0) continue;
+    close(fd);
+    configs.push_back(&cfg);
+    names_.push_back(cfg.name);
+  }
+  for (pid_t tid : tids) {
+    std::vector<int> fds;
+    for (const CounterConfig* cfg : configs) {
+      fds.push_back(OpenCounter(*cfg, tid));
+    }
+    fds_.push_back(std::move(fds));
+  }
+}
+
+HardwareCounters::~HardwareCounters() {
+  for (const auto& fds : fds_) {
+    for (int fd : fds) {
+      if (fd >= 0) close(fd);
+    }
+  }
+}
+
+std::vector<double> HardwareCounters::Read() const {
+  std::vector<double> values(names_.size(), 0);
+  for (const auto& fds : fds_) {
+    for (size_t i = 0; i < fds.size(); ++i) {
+      // value, time enabled, time running
+      uint64_t data[3];
+      if (fds[i] < 0 || read(fds[i], data, sizeof(data)) != sizeof(data)) continue;
+      double value = static_cast<double>(data[0]);
+      if (data[2] != 0 && data[2] < data[1]) {
+        value = value * static_cast<double>(data[1]) / static_cast<double>(data[2]);
+      }
+      values[i] += value;
+    }
+  }
+  return values;
+}
+#else
+HardwareCounters::HardwareCounters() {}
+
+HardwareCounters::~HardwareCounters() {}
+
+std::vector<double> HardwareCounters::Read() const {
+  return std::vector<double>();
+}
+#endif
+
+OpProfiler::OpProfiler(bool use_counters) {
+  if (use_counters) {
+    counters_.reset(new HardwareCounters());
+    if (counters_->names().empty()) counters_.reset();
+  }
+  Reset();
+}
+
+void OpProfiler::Begin() {
+  if (counters_ != nullptr) begin_counters_ = counters_->Read();
+  begin_ = std::chrono::high_resolution_clock::now();
+}
+
+void OpProfiler::End(const std::string& name, int64_t bytes, int64_t flops) {
+  auto end = std::chrono::high_resolution_clock::now();
+  Event event;
+  event.name = name;
+  event.start_us = std::chrono::duration<double, std::micro>(begin_ - origin_).count();
+  event.duration_us = std::chrono::duration<double, std::micro>(end - begin_).count();
+  event.bytes = bytes;
+  event.flops = flops;
+  if (counters_ != nullptr) {
+    std::vector<double> end_counters = counters_->Read();
+    for (size_t i = 0; i < end_counters.size(); ++i) {
+      // The scaling of a multiplexed counter can make the difference negative.
+      double delta = end_counters[i] - begin_counters_[i];
+      event.counters.push_back(delta > 0 ? static_cast<uint64_t>(delta + 0.5) : 0);
+    }
+  }
+  events_.emplace_back(std::move(event));
+}
+
+void OpProfiler::Reset() {
+  events_.clear();
+  origin_ = std::chrono::high_resolution_clock::now();
+}
+
+namespace {
+// An event of the Chrome trace format.
+struct TraceEvent {
+  const OpProfiler::Event* event;
+  const std::vector<std::string>* counter_names;
+
+  void Save(dmlc::JSONWriter* writer) const {
+    std::map<std::string, double> args;
+    args["bytes"] = static_cast<double>(event->bytes);
+    if (event->flops >= 0) args["flops"] = static_cast<double>(event->flops);
+    for (size_t i = 0; i < event->counters.size(); ++i) {
+      args[(*counter_names)[i]] = static_cast<double>(event->counters[i]);
+    }
+    writer->BeginObject(false);
+    writer->WriteObjectKeyValue("name", event->name);
+    writer->WriteObjectKeyValue("cat", std::string("op"));
+    writer->WriteObjectKeyValue("ph", std::string("X"));
+    writer->WriteObjectKeyValue("ts", event->start_us);
+    writer->WriteObjectKeyValue("dur", event->duration_us);
+    writer->WriteObjectKeyValue("pid", 0);
+    writer->WriteObjectKeyValue("tid", 0);
+    writer->WriteObjectKeyValue("args", args);
+    writer->EndObject();
+  }
+};
+
+// The invocations of an operator.
+struct OpSummary {
+  std::string name;
+  int64_t count{0};
+  double duration_us{0};
+  int64_t bytes{0};
+  int64_t flops{0};
+  std::vector<uint64_t> counters;
+  const std::vector<std::string>* counter_names;
+
+  void Save(dmlc::JSONWriter* writer) const {
+    writer->BeginObject(false);
+    writer->WriteObjectKeyValue("name", name);
+    writer->WriteObjectKeyValue("count", count);
+    writer->WriteObjectKeyValue("total_us", duration_us);
+    writer->WriteObjectKeyValue("mean_us", duration_us / count);
+    writer->WriteObjectKeyValue("bytes", bytes / count);
+    // bytes per microsecond are megabytes per second.
+    writer->WriteObjectKeyValue("gbytes_per_sec", bytes / duration_us * 1e-3);
+    if (flops >= 0) {
+      writer->WriteObjectKeyValue("flops", flops / count);
+      writer->WriteObjectKeyValue("gflops_per_sec", flops / duration_us * 1e-3);
+      // A low intensity means the operator is likely bound by memory.
+      writer->WriteObjectKeyValue("flops_per_byte",
+                                  bytes != 0 ? static_cast<double>(flops) / bytes : 0.0);
+    }
+    std::map<std::string, uint64_t> totals;
+    for (size_t i = 0; i < counters.size(); ++i) {
+      totals[(*counter_names)[i]] = counters[i];
+    }
+    if (!totals.empty()) writer->WriteObjectKeyValue("counters", totals);
+    if (totals.count("cycles") && totals.count("instructions") && totals["cycles"] != 0) {
+      writer->WriteObjectKeyValue(
+          "ipc", static_cast<double>(totals["instructions"]) / totals["cycles"]);
+    }
+    writer->EndObject();
+  }
+};
+}  // namespace
+
+std::string OpProfiler::ToJSON() const {
+  static const std::vector<std::string> kNoCounters;
+  const std::vector<std::string>& counter_names =
+      counters_ != nullptr ? counters_->names() : kNoCounters;
+  std::vector<TraceEvent> trace_events;
+  std::vector<OpSummary> summary;
+  std::unordered_map<std::string, size_t> summary_index;
+  for (const Event& event : events_) {
+    trace_events.push_back({&event, &counter_names});
+    auto it = summary_index.find(event.name);
+    if (it == summary_index.end()) {
+      it = summary_index.emplace(event.name, summary.size()).first;
+      summary.emplace_back();
+      summary.back().name = event.name;
+      summary.back().counters.resize(counter_names.size(), 0);
+      summary.back().counter_names = &counter_names;
+    }
+    OpSummary& op = summary[it->second];
+    op.count += 1;
+    op.duration_us += event.duration_us;
+    op.bytes += event.bytes;
+    op.flops = (op.flops < 0 || event.flops < 0) ? -1 : op.flops + event.flops;
+    for (size_t i = 0; i < event.counters.size(); ++i) {
+      op.counters[i] += event.counters[i];
+    }
+  }
+  std::sort(summary.begin(), summary.end(), [](const OpSummary& lhs, const OpSummary& rhs) {
+    return lhs.duration_us > rhs.duration_us;
+  });
+
+  std::ostringstream os;
+  os << std::fixed << std::setprecision(3);
+  dmlc::JSONWriter writer(&os);
+  writer.BeginObject();
+  writer.WriteObjectKeyValue("traceEvents", trace_events);
+  writer.WriteObjectKeyValue("displayTimeUnit", std::string("ns"));
+  writer.WriteObjectKeyValue("summary", summary);
+  writer.EndObject();
+  return os.str();
+}
+
+int64_t GetArgBytes(const ObjectRef& arg) {
+  if (const auto* array = arg.as<NDArray::Container>()) {
+    return static_cast<int64_t>(GetDataSize(array->dl_tensor));
+  }
+  if (const auto* adt = arg.as<ADTObj>()) {
+    int64_t bytes = 0;
+    for (size_t i = 0; i < adt->size; ++i) {
+      bytes += GetArgBytes((*adt)[i]);
+    }
+    return bytes;
+  }
+  return 0;
+}
+
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,137 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file profiling.h
+ * \brief Per operator profiling shared by the debug executors.
+ *
+ *  The executors record every operator invocation with its wall time, the
+ *  bytes of its arguments and the estimated floating point operations of the
+ *  lowered function. On Linux the cycles, instructions and last level cache
+ *  misses of the invocation are also read from perf_event when the kernel
+ *  allows it. The report is a Chrome trace that additionally contains a
+ *  summary per operator, which can be opened in chrome://tracing.
+ */
+#ifndef TVM_RUNTIME_PROFILING_H_
+#define TVM_RUNTIME_PROFILING_H_
+
+#include <tvm/runtime/ndarray.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+
+/*!
+ * \brief Hardware performance counters of all the threads of the process.
+ *
+ *  The counters are opened for the threads that exist on construction, so
+ *  they should be created after the thread pool has been started.
+ */
+class HardwareCounters {
+ public:
+  HardwareCounters();
+  ~HardwareCounters();
+  /*! \return The names of the available counters, empty if none is. */
+  const std::vector<std::string>& names() const {
+    return names_;
+  }
+  /*!
+   * \return The current values of the counters, summed over the threads. The
+   *  values of multiplexed counters are estimates scaled by the share of time
+   *  they were running, so a later read can be lower than an earlier one.
+   */
+  std::vector<double> Read() const;
+
+ private:
+  /*! \brief The names of the available counters. */
+  std::vector<std::string> names_;
+  /*! \brief The file descriptors, one row of counters per thread. */
+  std::vector<std::vector<int> > fds_;
+};
+
+/*! \brief Records the operator invocations of an executor. */
+class OpProfiler {
+ public:
+  /*! \brief One operator invocation. */
+  struct Event {
+    /*! \brief The operator name. */
+    std::string name;
+    /*! \brief The start time in microseconds since the profiler was reset. */
+    double start_us;
+    /*! \brief The wall time in microseconds. */
+    double duration_us;
+    /*! \brief The bytes of the arguments. */
+    int64_t bytes;
+    /*! \brief The estimated floating point operations, -1 if unknown. */
+    int64_t flops;
+    /*! \brief The increments of the hardware counters, clamped at 0. */
+    std::vector<uint64_t> counters;
+  };
+  /*!
+   * \brief Create a profiler.
+   * \param use_counters Whether to read the hardware counters.
+   */
+  explicit OpProfiler(bool use_counters = true);
+  /*! \brief Mark the start of an invocation. */
+  void Begin();
+  /*!
+   * \brief Record the invocation started by the last Begin,
+   *  the device must have been synchronized.
+   * \param name The operator name.
+   * \param bytes The bytes of the arguments.
+   * \param flops The estimated floating point operations, -1 if unknown,
+   *  in which case the report has no flops for the invocation.
+   */
+  void End(const std::string& name, int64_t bytes, int64_t flops = -1);
+  /*! \brief Drop the recorded invocations. */
+  void Reset();
+  /*! \return The recorded invocations. */
+  const std::vector<Event>& events() const {
+    return events_;
+  }
+  /*! \return The report in the Chrome trace format, with a summary per operator. */
+  std::string ToJSON() const;
+
+ private:
+  /*! \brief The hardware counters, nullptr if unavailable. */
+  std::unique_ptr<HardwareCounters> counters_;
+  /*! \brief The time of the last reset. */
+  std::chrono::high_resolution_clock::time_point origin_;
+  /*! \brief The time of the last Begin. */
+  std::chrono::high_resolution_clock::time_point begin_;
+  /*! \brief The counters at the last Begin. */
+  std::vector<double> begin_counters_;
+  /*! \brief The recorded invocations. */
+  std::vector<Event> events_;
+};
+
+/*!
+ * \brief Get the bytes of the tensors in an argument of a packed function.
+ * \param arg The argument, an NDArray or an ADT of them.
+ * \return The total bytes, 0 for other objects.
+ */
+int64_t GetArgBytes(const ObjectRef& arg);
+
+}  // namespace runtime
+}  // namespace tvm
+#endif  // TVM_RUNTIME_PROFILING_H_
@@ -24,7 +24,9 @@
 #include <dmlc/logging.h>
 #include <dmlc/thread_local.h>
 #include <tvm/runtime/registry.h>
-#include <unordered_map>
+#include <atomic>
+#include <chrono>
+#include <functional>
 #include <mutex>
 #include <memory>
 #include <array>
@@ -34,72 +36,177 @@ namespace tvm {
 namespace runtime {
 
 struct Registry::Manager {
-  // map storing the functions.
-  // We delibrately used raw pointer
+  // An open addressing table of the entries. The entries are only added, and
+  // a full table is replaced by a larger copy, so that readers can probe it
+  // without locking. The replaced tables are kept, as readers may still
+  // probe them.
+  //
+  // We delibrately used raw pointer for the entries
   // This is because PackedFunc can contain callbacks into the host languge(python)
   // and the resource can become invalid because of indeterminstic order of destruction.
   // The resources will only be recycled during program exit.
-  std::unordered_map<std::string, Registry*> fmap;
-  // mutex
+  struct Table {
+    size_t mask;
+    std::unique_ptr<std::atomic<Registry*>[]> slots;
+
+    explicit Table(size_t capacity)
+        : mask(capacity - 1), slots(new std::atomic<Registry*>[capacity]) {
+      for (size_t i = 0; i < capacity; ++i) {
+        slots[i].store(nullptr, std::memory_order_relaxed);
+      }
+    }
+  };
+  // the current table.
+  std::atomic<Table*> table{nullptr};
+  // all the tables, the last one is the current.
+  std::vector<std::unique_ptr<Table> > tables;
+  // the number of entries.
+  size_t size{0};
+  // A function replaced or removed, freed once the grace period has passed.
+  struct Retired {
+    std::unique_ptr<const PackedFunc> func;
+    std::chrono::steady_clock::time_point time;
+  };
+  // the retired functions, oldest first.
+  std::vector<Retired> retired;
+  // serializes the writers.
   std::mutex mutex;
 
   Manager() {
+    tables.emplace_back(new Table(1024));
+    table.store(tables.back().get(), std::memory_order_release);
+  }
+
+  // Find the entry of a name, without locking.
+  Registry* Find(const std::string& name, size_t hash) const {
+    const Table* t = table.load(std::memory_order_acquire);
+    for (size_t i = hash & t->mask; ; i = (i + 1) & t->mask) {
+      Registry* r = t->slots[i].load(std::memory_order_acquire);
+      if (r == nullptr) return nullptr;
+      if (r->hash_ == hash && r->name_ == name) return r;
+    }
+  }
+
+  // Find or add the entry of a name, must hold the mutex.
+  Registry* FindOrAdd(const std::string& name, size_t hash) {
+    if (Registry* r = Find(name, hash)) return r;
+    // Keep the load below a half.
+    Table* t = table.load(std::memory_order_relaxed);
+    if ((size + 1) * 2 > t->mask + 1) {
+      std::unique_ptr<Table> grown(new Table((t->mask + 1) * 2));
+      for (size_t i = 0; i <= t->mask; ++i) {
+        if (Registry* r = t->slots[i].load(std::memory_order_relaxed)) {
+          Insert(grown.get(), r);
+        }
+      }
+      t = grown.get();
+      tables.emplace_back(std::move(grown));
+      table.store(t, std::memory_order_release);
+    }
+    Registry* r = new Registry();
+    r->name_ = name;
+    r->hash_ = hash;
+    Insert(t, r);
+    ++size;
+    return r;
+  }
+
+  // Retire the function replaced on an entry, and free the functions retired
+  // longer ago than the grace period, must hold the mutex. Lookups do not
+  // lock, so a caller may still be calling a function it looked up just
+  // before it was replaced.
+  void Retire(const PackedFunc* func) {
+    auto now = std::chrono::steady_clock::now();
+    auto it = retired.begin();
+    while (it != retired.end() && now - it->time > kGracePeriod) ++it;
+    retired.erase(retired.begin(), it);
+    if (func != nullptr) {
+      retired.push_back({std::unique_ptr<const PackedFunc>(func), now});
+    }
+  }
+
+  static void Insert(Table* t, Registry* r) {
+    size_t i = r->hash_ & t->mask;
+    while (t->slots[i].load(std::memory_order_relaxed) != nullptr) {
+      i = (i + 1) & t->mask;
+    }
+    t->slots[i].store(r, std::memory_order_release);
+  }
+
+  static size_t Hash(const std::string& name) {
+    return std::hash<std::string>()(name);
   }
 
   static Manager* Global() {
     // We deliberately leak the Manager instance, to avoid leak sanitizers
-    // complaining about the entries in Manager::fmap being leaked at program
+    // complaining about the entries in Manager::tables being leaked at program
     // exit.
     static Manager* inst = new Manager();
     return inst;
   }
+
+  static constexpr std::chrono::seconds kGracePeriod{10};
 };
 
+constexpr std::chrono::seconds Registry::Manager::kGracePeriod;
+
 Registry& Registry::set_body(PackedFunc f) {  // NOLINT(*)
-  func_ = f;
+  // The function is published fully constructed, and the one it replaces is
+  // kept for the grace period for the callers that looked it up.
+  Manager* m = Manager::Global();
+  std::lock_guard<std::mutex> lock(m->mutex);
+  m->Retire(func_.exchange(new PackedFunc(std::move(f)), std::memory_order_acq_rel));
   return *this;
 }
 
 Registry& Registry::Register(const std::string& name, bool override) {  // NOLINT(*)
   Manager* m = Manager::Global();
   std::lock_guard<std::mutex> lock(m->mutex);
-  auto it = m->fmap.find(name);
-  if (it == m->fmap.end()) {
-    Registry* r = new Registry();
-    r->name_ = name;
-    m->fmap[name] = r;
-    return *r;
-  } else {
+  Registry* r = m->FindOrAdd(name, Manager::Hash(name));
+  if (r->registered_) {
     CHECK(override)
       << "Global PackedFunc " << name << " is already registered";
-    return *it->second;
   }
+  // The name becomes visible to the lookups when set_body publishes the function.
+  r->registered_ = true;
+  return *r;
 }
 
 bool Registry::Remove(const std::string& name) {
   Manager* m = Manager::Global();
   std::lock_guard<std::mutex> lock(m->mutex);
-  auto it = m->fmap.find(name);
-  if (it == m->fmap.end()) return false;
-  m->fmap.erase(it);
+  Registry* r = m->Find(name, Manager::Hash(name));
+  if (r == nullptr || !r->registered_) return false;
+  // The entry stays for the handles, and the function for the callers holding it.
+  r->registered_ = false;
+  m->Retire(r->func_.exchange(nullptr, std::memory_order_acq_rel));
   return true;
 }
 
 const PackedFunc* Registry::Get(const std::string& name) {
+  const Registry* r = Manager::Global()->Find(name, Manager::Hash(name));
+  return r != nullptr ? r->function() : nullptr;
+}
+
+const Registry* Registry::Intern(const std::string& name) {
   Manager* m = Manager::Global();
+  size_t hash = Manager::Hash(name);
+  if (const Registry* r = m->Find(name, hash)) return r;
   std::lock_guard<std::mutex> lock(m->mutex);
-  auto it = m->fmap.find(name);
-  if (it == m->fmap.end()) return nullptr;
-  return &(it->second->func_);
+  return m->FindOrAdd(name, hash);
 }
 
 std::vector<std::string> Registry::ListNames() {
   Manager* m = Manager::Global();
   std::lock_guard<std::mutex> lock(m->mutex);
+  const Manager::Table* t = m->table.load(std::memory_order_relaxed);
   std::vector<std::string> keys;
-  keys.reserve(m->fmap.size());
-  for (const auto &kv : m->fmap) {
-    keys.push_back(kv.first);
+  keys.reserve(m->size);
+  for (size_t i = 0; i <= t->mask; ++i) {
+    const Registry* r = t->slots[i].load(std::memory_order_relaxed);
+    if (r != nullptr && r->function() != nullptr) {
+      keys.push_back(r->name_);
+    }
   }
   return keys;
 }
@@ -53,7 +53,7 @@ class RPCDeviceAPI final : public DeviceAPI {
   void FreeDataSpace(TVMContext ctx, void* ptr) final {
     RemoteSpace* space = static_cast<RemoteSpace*>(ptr);
     try {
-      GetSess(ctx)->CallRemote(
+      GetSess(ctx)->CallRemoteAsync(
           RPCCode::kDevFreeData, ctx, space->data);
     } catch (const dmlc::Error& e) {
       // fault tolerance to remote close.
@@ -22,8 +22,12 @@
  * \brief RPC module.
  */
 #include <tvm/runtime/registry.h>
+#include <tvm/runtime/ndarray.h>
 #include <memory>
 #include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
 #include "rpc_session.h"
 
 namespace tvm {
@@ -43,9 +47,34 @@ class RPCWrappedFunc {
   void operator()(TVMArgs args, TVMRetValue *rv) const {
     sess_->CallFunc(handle_, args, rv, UnwrapRemote, &fwrap_);
   }
+  /*!
+   * \brief Call the function and copy remote arrays back in one round trip.
+   * \param args The arguments.
+   * \param rv The return value.
+   * \param fetch Pairs of remote source and local destination arrays.
+   */
+  void CallAndFetch(TVMArgs args,
+                    TVMRetValue* rv,
+                    const std::vector<std::pair<NDArray, NDArray> >& fetch) const {
+    uint64_t seq = sess_->CallFuncAsync(handle_, args, rv, UnwrapRemote, fwrap_);
+    for (const auto& kv : fetch) {
+      const DLTensor* from = kv.first.operator->();
+      DLTensor* to = const_cast<DLTensor*>(kv.second.operator->());
+      CHECK_EQ(static_cast<int>(to->ctx.device_type), kDLCPU)
+          << "Can only fetch into a local CPU array";
+      CHECK(IsContiguous(*to));
+      size_t nbytes = GetDataSize(*from);
+      CHECK_EQ(nbytes, GetDataSize(*to))
+          << "Fetch of arrays with different sizes";
+      seq = sess_->CopyFromRemoteAsync(
+          static_cast<RemoteSpace*>(from->data)->data, from->byte_offset,
+          to->data, to->byte_offset, nbytes, from->ctx, from->dtype);
+    }
+    sess_->Wait(seq);
+  }
   ~RPCWrappedFunc() {
     try {
-      sess_->CallRemote(RPCCode::kFreeFunc, handle_);
+      sess_->CallRemoteAsync(RPCCode::kFreeFunc, handle_);
     } catch (const dmlc::Error& e) {
       // fault tolerance to remote close
     }
@@ -62,7 +91,7 @@ class RPCWrappedFunc {
   static void RemoteNDArrayDeleter(Object* obj) {
     auto* ptr = static_cast<NDArray::Container*>(obj);
     RemoteSpace* space = static_cast<RemoteSpace*>(ptr->dl_tensor.data);
-    space->sess->CallRemote(RPCCode::kNDArrayFree, ptr->manager_ctx);
+    space->sess->CallRemoteAsync(RPCCode::kNDArrayFree, ptr->manager_ctx);
     delete space;
     delete ptr;
   }
@@ -112,7 +141,7 @@ class RPCModuleNode final : public ModuleNode {
   ~RPCModuleNode() {
     if (module_handle_ != nullptr) {
       try {
-        sess_->CallRemote(RPCCode::kModuleFree, module_handle_);
+        sess_->CallRemoteAsync(RPCCode::kModuleFree, module_handle_);
       } catch (const dmlc::Error& e) {
         // fault tolerance to remote close
       }
@@ -158,6 +187,22 @@ class RPCModuleNode final : public ModuleNode {
     return module_handle_;
   }
 
+  void CallAndFetch(const std::string& name,
+                    TVMArgs args,
+                    TVMRetValue* rv,
+                    const std::vector<std::pair<NDArray, NDArray> >& fetch) {
+    // Keep the remote function around so repeated measurements
+    // do not pay a round trip to look it up.
+    auto it = func_cache_.find(name);
+    if (it == func_cache_.end()) {
+      RPCFuncHandle handle = GetFuncHandle(name);
+      CHECK(handle != nullptr) << "Cannot find remote function " << name;
+      it = func_cache_.emplace(
+          name, std::make_shared<RPCWrappedFunc>(handle, sess_)).first;
+    }
+    it->second->CallAndFetch(args, rv, fetch);
+  }
+
  private:
   PackedFunc WrapRemote(RPCFuncHandle handle) {
     if (handle == nullptr) return PackedFunc();
@@ -181,6 +226,8 @@ class RPCModuleNode final : public ModuleNode {
   void* module_handle_{nullptr};
   // The local channel
   std::shared_ptr<RPCSession> sess_;
+  // Functions used by CallAndFetch.
+  std::unordered_map<std::string, std::shared_ptr<RPCWrappedFunc> > func_cache_;
   // Wrap function to wrap remote module/function.
   PackedFunc fwrap_;
 };
@@ -276,6 +323,24 @@ TVM_REGISTER_GLOBAL("rpc._ImportRemoteModule")
                              cmod->module_handle());
   });
 
+TVM_REGISTER_GLOBAL("rpc._CallAndFetch")
+.set_body([](TVMArgs args, TVMRetValue* rv) {
+    Module m = args[0];
+    std::string tkey = m->type_key();
+    CHECK_EQ(tkey, "rpc");
+    std::string name = args[1];
+    int num_fetch = args[2];
+    int begin = 3 + 2 * num_fetch;
+    CHECK_LE(begin, args.size());
+    std::vector<std::pair<NDArray, NDArray> > fetch;
+    for (int i = 3; i < begin; i += 2) {
+      fetch.emplace_back(args[i].operator NDArray(), args[i + 1].operator NDArray());
+    }
+    static_cast<RPCModuleNode*>(m.operator->())->CallAndFetch(
+        name, TVMArgs(args.values + begin, args.type_codes + begin, args.size() - begin),
+        rv, fetch);
+  });
+
 TVM_REGISTER_GLOBAL("rpc._ModuleHandle")
 .set_body([](TVMArgs args, TVMRetValue* rv) {
     Module m = args[0];
@@ -42,6 +42,11 @@
 namespace tvm {
 namespace runtime {
 
+// Maximum bytes sent in one copy request.
+const size_t kRPCCopyChunkBytes = 1 << 20;
+// Maximum number of replies in flight before the client starts reading them.
+const size_t kRPCMaxPendingReplies = 64;
+
 // Temp buffer for data array
 struct RPCByteArrayBuffer {
   TVMByteArray arr;
@@ -899,8 +904,18 @@ void RPCSession::Init() {
   // Quick function to call remote.
   call_remote_ = PackedFunc([this](TVMArgs args, TVMRetValue* rv) {
       handler_->SendPackedSeq(args.values, args.type_codes, args.num_args, true);
-      RPCCode code = HandleUntilReturnEvent(rv, true, nullptr);
-      CHECK(code == RPCCode::kReturn) << "code=" << static_cast<int>(code);
+      PendingReply reply;
+      reply.code = RPCCode::kReturn;
+      reply.rv = rv;
+      Wait(PushReply(std::move(reply)));
+    });
+  send_remote_ = PackedFunc([this](TVMArgs args, TVMRetValue* rv) {
+      handler_->SendPackedSeq(args.values, args.type_codes, args.num_args, true);
+      PendingReply reply;
+      reply.code = RPCCode::kReturn;
+      reply.report_error = false;
+      PushReply(std::move(reply));
+      Flush();
     });
 }
 
@@ -975,6 +990,82 @@ int RPCSession::ServerEventHandler(const std::string& bytes, int event_flag) {
   return 1;
 }
 
+void RPCSession::Flush() {
+  while (writer_.bytes_available() != 0) {
+    writer_.ReadWithCallback([this](const void *data, size_t size) {
+        return channel_->Send(data, size);
+      }, writer_.bytes_available());
+  }
+}
+
+uint64_t RPCSession::PushReply(PendingReply reply) {
+  reply.seq = next_seq_++;
+  pending_.emplace_back(std::move(reply));
+  // Bound the replies the remote may queue up while we are not reading,
+  // so that neither side blocks forever on a full channel.
+  if (pending_.size() > kRPCMaxPendingReplies) {
+    Drain(pending_.front().seq);
+  }
+  return next_seq_ - 1;
+}
+
+void RPCSession::Drain(uint64_t seq) {
+  while (!pending_.empty() && pending_.front().seq <= seq) {
+    PendingReply reply = std::move(pending_.front());
+    pending_.pop_front();
+    TVMRetValue discard;
+    TVMRetValue* rv = reply.rv != nullptr ? reply.rv : &discard;
+    const PackedFunc* fwrap = reply.fwrap != nullptr ? &reply.fwrap : nullptr;
+    try {
+      RPCCode code = HandleUntilReturnEvent(rv, true, fwrap);
+      CHECK(code == reply.code) << "code=" << static_cast<int>(code);
+      if (code == RPCCode::kCopyAck) {
+        reader_.Reserve(reply.nbytes);
+        handler_->RequestBytes(reply.nbytes);
+        while (!handler_->Ready()) {
+          size_t bytes_needed = handler_->BytesNeeded();
+          reader_.WriteWithCallback([this](void* data, size_t size) {
+              size_t n = channel_->Recv(data, size);
+              CHECK_NE(n, 0U) << "Channel closes before we get neded bytes";
+              return n;
+            }, bytes_needed);
+        }
+        handler_->ReadArray(static_cast<char*>(reply.to), reply.nbytes);
+        handler_->FinishCopyAck();
+      }
+    } catch (const dmlc::Error& e) {
+      // A remote exception leaves the handler at a clean state and the
+      // later replies are still in the stream, anything else is fatal.
+      if (!handler_->CanCleanShutdown()) {
+        pending_.clear();
+        throw;
+      }
+      if (reply.report_error && pending_error_.empty()) {
+        pending_error_ = e.what();
+      }
+    }
+  }
+}
+
+void RPCSession::DrainLargeReplies() {
+  for (auto it = pending_.rbegin(); it != pending_.rend(); ++it) {
+    if (it->code == RPCCode::kCopyAck) {
+      Drain(it->seq);
+      return;
+    }
+  }
+}
+
+void RPCSession::Wait(uint64_t seq) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  Drain(seq);
+  if (!pending_error_.empty()) {
+    std::string msg;
+    std::swap(msg, pending_error_);
+    throw dmlc::Error(msg);
+  }
+}
+
 // Get remote function with name
 void RPCSession::CallFunc(void* h,
                           TVMArgs args,
@@ -982,15 +1073,44 @@ void RPCSession::CallFunc(void* h,
                           FUnwrapRemoteObject funwrap,
                           const PackedFunc* fwrap) {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
+  Wait(CallFuncAsync(h, args, rv, funwrap,
+                     fwrap != nullptr ? *fwrap : PackedFunc()));
+}
 
+uint64_t RPCSession::CallFuncAsync(void* h,
+                                   TVMArgs args,
+                                   TVMRetValue* rv,
+                                   FUnwrapRemoteObject funwrap,
+                                   const PackedFunc& fwrap) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  for (int i = 0; i < args.num_args; ++i) {
+    if (args.type_codes[i] == kTVMBytes) {
+      // Do not push a large blob while the remote may be blocked on
+      // sending us a large copy.
+      DrainLargeReplies();
+      break;
+    }
+  }
   RPCCode code = RPCCode::kCallFunc;
   handler_->Write(code);
   uint64_t handle = reinterpret_cast<uint64_t>(h);
   handler_->Write(handle);
   handler_->SendPackedSeq(
       args.values, args.type_codes, args.num_args, true, funwrap);
-  code = HandleUntilReturnEvent(rv, true, fwrap);
-  CHECK(code == RPCCode::kReturn) << "code=" << static_cast<int>(code);
+  PendingReply reply;
+  reply.code = RPCCode::kReturn;
+  reply.rv = rv;
+  reply.fwrap = fwrap;
+  uint64_t seq = PushReply(std::move(reply));
+  Flush();
+  return seq;
+}
+
+// Split copies into chunks so the remote can move one chunk to the
+// device while the next one is on the wire.
+static size_t CopyChunkBytes(DLDataType type_hint) {
+  size_t elem_bytes = std::max((type_hint.bits * type_hint.lanes + 7) / 8, 1);
+  return std::max(kRPCCopyChunkBytes / elem_bytes, size_t(1)) * elem_bytes;
 }
 
 void RPCSession::CopyToRemote(void* from,
@@ -1002,19 +1122,28 @@ void RPCSession::CopyToRemote(void* from,
                               DLDataType type_hint) {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
   ctx_to = handler_->StripSessMask(ctx_to);
-  RPCCode code = RPCCode::kCopyToRemote;
-  handler_->Write(code);
-  uint64_t handle = reinterpret_cast<uint64_t>(to);
-  handler_->Write(handle);
-  uint64_t offset = static_cast<uint64_t>(to_offset);
-  handler_->Write(offset);
-  uint64_t size = static_cast<uint64_t>(data_size);
-  handler_->Write(size);
-  handler_->Write(ctx_to);
-  handler_->Write(type_hint);
-  handler_->WriteArray(reinterpret_cast<char*>(from) + from_offset, data_size);
-  TVMRetValue rv;
-  CHECK(HandleUntilReturnEvent(&rv, true, nullptr) == RPCCode::kReturn);
+  DrainLargeReplies();
+  size_t chunk_bytes = CopyChunkBytes(type_hint);
+  size_t begin = 0;
+  do {
+    size_t nbytes = std::min(chunk_bytes, data_size - begin);
+    RPCCode code = RPCCode::kCopyToRemote;
+    handler_->Write(code);
+    uint64_t handle = reinterpret_cast<uint64_t>(to);
+    handler_->Write(handle);
+    uint64_t offset = static_cast<uint64_t>(to_offset + begin);
+    handler_->Write(offset);
+    uint64_t size = static_cast<uint64_t>(nbytes);
+    handler_->Write(size);
+    handler_->Write(ctx_to);
+    handler_->Write(type_hint);
+    handler_->WriteArray(reinterpret_cast<char*>(from) + from_offset + begin, nbytes);
+    PendingReply reply;
+    reply.code = RPCCode::kReturn;
+    PushReply(std::move(reply));
+    Flush();
+    begin += nbytes;
+  } while (begin < data_size);
 }
 
 void RPCSession::CopyFromRemote(void* from,
@@ -1025,31 +1154,43 @@ void RPCSession::CopyFromRemote(void* from,
                                 TVMContext ctx_from,
                                 DLDataType type_hint) {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
+  Wait(CopyFromRemoteAsync(
+      from, from_offset, to, to_offset, data_size, ctx_from, type_hint));
+}
+
+uint64_t RPCSession::CopyFromRemoteAsync(void* from,
+                                         size_t from_offset,
+                                         void* to,
+                                         size_t to_offset,
+                                         size_t data_size,
+                                         TVMContext ctx_from,
+                                         DLDataType type_hint) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
   ctx_from = handler_->StripSessMask(ctx_from);
-  RPCCode code = RPCCode::kCopyFromRemote;
-  handler_->Write(code);
-  uint64_t handle = reinterpret_cast<uint64_t>(from);
-  handler_->Write(handle);
-  uint64_t offset = static_cast<uint64_t>(from_offset);
-  handler_->Write(offset);
-  uint64_t size = static_cast<uint64_t>(data_size);
-  handler_->Write(size);
-  handler_->Write(ctx_from);
-  handler_->Write(type_hint);
-  TVMRetValue rv;
-  CHECK(HandleUntilReturnEvent(&rv, true, nullptr) == RPCCode::kCopyAck);
-  reader_.Reserve(data_size);
-  handler_->RequestBytes(data_size);
-  while (!handler_->Ready()) {
-    size_t bytes_needed = handler_->BytesNeeded();
-    reader_.WriteWithCallback([this](void* data, size_t size) {
-        size_t n = channel_->Recv(data, size);
-        CHECK_NE(n, 0U) << "Channel closes before we get neded bytes";
-        return n;
-      }, bytes_needed);
-  }
-  handler_->ReadArray(reinterpret_cast<char*>(to) + to_offset, data_size);
-  handler_->FinishCopyAck();
+  size_t chunk_bytes = CopyChunkBytes(type_hint);
+  size_t begin = 0;
+  uint64_t seq;
+  do {
+    size_t nbytes = std::min(chunk_bytes, data_size - begin);
+    RPCCode code = RPCCode::kCopyFromRemote;
+    handler_->Write(code);
+    uint64_t handle = reinterpret_cast<uint64_t>(from);
+    handler_->Write(handle);
+    uint64_t offset = static_cast<uint64_t>(from_offset + begin);
+    handler_->Write(offset);
+    uint64_t size = static_cast<uint64_t>(nbytes);
+    handler_->Write(size);
+    handler_->Write(ctx_from);
+    handler_->Write(type_hint);
+    PendingReply reply;
+    reply.code = RPCCode::kCopyAck;
+    reply.to = reinterpret_cast<char*>(to) + to_offset + begin;
+    reply.nbytes = nbytes;
+    seq = PushReply(std::move(reply));
+    begin += nbytes;
+  } while (begin < data_size);
+  Flush();
+  return seq;
 }
 
 RPCFuncHandle RPCSession::GetTimeEvaluator(
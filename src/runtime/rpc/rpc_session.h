@@ -26,6 +26,7 @@
 
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/device_api.h>
+#include <deque>
 #include <mutex>
 #include <string>
 #include <memory>
@@ -162,8 +163,32 @@ class RPCSession {
                 TVMRetValue* rv,
                 FUnwrapRemoteObject funwrap,
                 const PackedFunc* fwrap);
+  /*!
+   * \brief Send a call into remote function without waiting for its return.
+   *
+   *  The request is pipelined behind the requests already in flight.
+   *  rv is filled in once Wait returns for the returned sequence id,
+   *  so it must stay alive until then.
+   *
+   * \param handle The function handle
+   * \param args The arguments
+   * \param rv The return value.
+   * \param funpwrap Function that takes a remote object and returns the raw handle.
+   * \param fwrap Wrapper function to turn Function/Module handle into real return.
+   * \return The sequence id of the request.
+   */
+  uint64_t CallFuncAsync(RPCFuncHandle handle,
+                         TVMArgs args,
+                         TVMRetValue* rv,
+                         FUnwrapRemoteObject funwrap,
+                         const PackedFunc& fwrap);
   /*!
    * \brief Copy bytes into remote array content.
+   *
+   *  The copy is sent in chunks and does not wait for the remote to
+   *  acknowledge it, the host data is consumed before the call returns.
+   *  Failures are reported by the next call that waits on the session.
+   *
    * \param from The source host data.
    * \param from_offset The byte offeset in the from.
    * \param to The target array.
@@ -196,6 +221,38 @@ class RPCSession {
                       size_t nbytes,
                       TVMContext ctx_from,
                       DLDataType type_hint);
+  /*!
+   * \brief Request bytes from remote array content without waiting for them.
+   *
+   *  The copy is requested in chunks, the destination is filled in
+   *  once Wait returns for the returned sequence id.
+   *
+   * \param from The source host data.
+   * \param from_offset The byte offeset in the from.
+   * \param to The target array.
+   * \param to_offset The byte offset in the to.
+   * \param nbytes The size of the memory in bytes.
+   * \param ctx_from The source context.
+   * \param type_hint Hint of content data type.
+   * \return The sequence id of the last chunk.
+   */
+  uint64_t CopyFromRemoteAsync(void* from,
+                               size_t from_offset,
+                               void* to,
+                               size_t to_offset,
+                               size_t nbytes,
+                               TVMContext ctx_from,
+                               DLDataType type_hint);
+  /*!
+   * \brief Wait until the replies of all requests up to seq have arrived.
+   *
+   *  The remote handles requests in order, so the replies are matched
+   *  to the requests by their position in the stream.
+   *  Throws the first error reported by the remote since the last wait.
+   *
+   * \param seq The sequence id to wait for.
+   */
+  void Wait(uint64_t seq);
   /*!
    * \brief Get a remote timer function on ctx.
    *  This function consumes fhandle, caller should not call Free on fhandle.
@@ -230,6 +287,17 @@ class RPCSession {
    */
   template<typename... Args>
   inline TVMRetValue CallRemote(RPCCode fcode, Args&& ...args);
+  /*!
+   * \brief Send a remote defined system function without waiting for it.
+   *
+   *  Used for requests whose result is not needed, such as frees.
+   *  Errors of the request are ignored.
+   *
+   * \param fcode The function code.
+   * \param args The arguments
+   */
+  template<typename... Args>
+  inline void CallRemoteAsync(RPCCode fcode, Args&& ...args);
   /*!
    * \return The session table index of the session.
    */
@@ -257,10 +325,34 @@ class RPCSession {
 
  private:
   class EventHandler;
+  // A reply the client has not received yet, kept in request order.
+  struct PendingReply {
+    // The sequence id of the request.
+    uint64_t seq;
+    // The expected code, kReturn or kCopyAck.
+    RPCCode code;
+    // Where to store the return value, nullptr to discard it.
+    TVMRetValue* rv{nullptr};
+    // Wrapper of returned handles.
+    PackedFunc fwrap;
+    // Destination and size of a kCopyAck payload.
+    void* to{nullptr};
+    size_t nbytes{0};
+    // Whether an error of the request is reported by Wait.
+    bool report_error{true};
+  };
   // Handle events until receives a return
   // Also flushes channels so that the function advances.
   RPCCode HandleUntilReturnEvent(
       TVMRetValue* rv, bool client_mode, const PackedFunc* fwrap);
+  // Record a request that was just written, returns its sequence id.
+  uint64_t PushReply(PendingReply reply);
+  // Receive replies in order up to seq, errors are kept in pending_error_.
+  void Drain(uint64_t seq);
+  // Receive every reply that may carry a large payload.
+  void DrainLargeReplies();
+  // Send everything in the writer to the channel.
+  void Flush();
   // Initalization
   void Init();
   // Shutdown
@@ -275,6 +367,14 @@ class RPCSession {
   std::shared_ptr<EventHandler> handler_;
   // call remote with specified function code.
   PackedFunc call_remote_;
+  // send remote call with specified function code, ignoring its return.
+  PackedFunc send_remote_;
+  // Replies that are still in flight, in request order.
+  std::deque<PendingReply> pending_;
+  // The sequence id of the next request.
+  uint64_t next_seq_{0};
+  // The first error received since the last Wait.
+  std::string pending_error_;
   // The index of this session in RPC session table.
   int table_index_{0};
   // The name of the session.
@@ -359,6 +459,13 @@ inline TVMRetValue RPCSession::CallRemote(RPCCode code, Args&& ...args) {
   writer_.Write(&code, sizeof(code));
   return call_remote_(std::forward<Args>(args)...);
 }
+
+template<typename... Args>
+inline void RPCSession::CallRemoteAsync(RPCCode code, Args&& ...args) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  writer_.Write(&code, sizeof(code));
+  send_remote_(std::forward<Args>(args)...);
+}
 }  // namespace runtime
 }  // namespace tvm
 #endif  // TVM_RUNTIME_RPC_RPC_SESSION_H_
@@ -58,10 +58,34 @@ uint32_t GetSpinCount() {
   return atoi(val);
 }
 
+int GetChunksPerWorker() {
+  const char* val = getenv("TVM_THREAD_POOL_CHUNKS_PER_WORKER");
+  if (!val) {
+    return 0;
+  }
+  return atoi(val);
+}
+
 }  // namespace
 
 // stride in the page, fit to cache line.
 constexpr int kSyncStride = 64 / sizeof(std::atomic<int>);
+// task id that asks a worker to run the work-stealing loop of a launch.
+constexpr int32_t kStealTaskId = -1;
+
+class ThreadPool;
+
+/*!
+ * \brief The range of tasks owned by one thread in a work-stealing launch.
+ *  The owner takes tasks from the front, thieves take them from the back.
+ */
+struct TaskRange {
+  std::mutex mutex;
+  int32_t begin{0};
+  int32_t end{0};
+  // padding to avoid false sharing between the ranges.
+  char pad[kL1CacheBytes];
+};
 
 /*!
  * \brief Thread local master environment.
@@ -81,10 +105,11 @@ class ParallelLauncher {
     // reshape
     if (static_cast<size_t>(num_task) > par_errors_.size()) {
       par_errors_.resize(num_task + 1);
-      if (need_sync) {
-        delete[] sync_counter_;
-        sync_counter_ = new std::atomic<int>[num_task * kSyncStride];
-      }
+    }
+    if (need_sync && num_task > num_sync_counters_) {
+      delete[] sync_counter_;
+      sync_counter_ = new std::atomic<int>[num_task * kSyncStride];
+      num_sync_counters_ = num_task;
     }
     if (need_sync) {
       for (int i = 0; i < num_task; ++i) {
@@ -99,6 +124,58 @@ class ParallelLauncher {
   ~ParallelLauncher() {
     delete[] sync_counter_;
   }
+  // Split the tasks into contiguous ranges, one per thread of a work-stealing launch.
+  void InitTaskRanges(int num_ranges) {
+    if (task_ranges_ == nullptr) {
+      max_task_ranges_ = std::max(threading::MaxConcurrency(), 1);
+      task_ranges_.reset(new TaskRange[max_task_ranges_]);
+    }
+    CHECK_LE(num_ranges, max_task_ranges_);
+    int num_task = env.num_task;
+    for (int i = 0; i < num_ranges; ++i) {
+      std::lock_guard<std::mutex> lock(task_ranges_[i].mutex);
+      task_ranges_[i].begin = static_cast<int32_t>(static_cast<int64_t>(num_task) * i / num_ranges);
+      task_ranges_[i].end =
+          static_cast<int32_t>(static_cast<int64_t>(num_task) * (i + 1) / num_ranges);
+    }
+    num_task_ranges_.store(num_ranges);
+  }
+  // Take the next task from the range owned by the thread.
+  bool PopTask(int owner, int32_t* task_id) {
+    if (owner < 0 || owner >= num_task_ranges_.load()) return false;
+    TaskRange& range = task_ranges_[owner];
+    std::lock_guard<std::mutex> lock(range.mutex);
+    if (range.begin == range.end) return false;
+    *task_id = range.begin++;
+    return true;
+  }
+  // Steal the last task from the range of another thread, -1 steals from any range.
+  bool StealTask(int thief, int32_t* task_id) {
+    int num_ranges = num_task_ranges_.load();
+    for (int i = 1; i <= num_ranges; ++i) {
+      int victim = (thief + i) % num_ranges;
+      if (victim == thief) continue;
+      TaskRange& range = task_ranges_[victim];
+      std::lock_guard<std::mutex> lock(range.mutex);
+      if (range.begin != range.end) {
+        *task_id = --range.end;
+        return true;
+      }
+    }
+    return false;
+  }
+  // Run one task and signal its completion.
+  void RunTask(int32_t task_id) {
+    if ((*flambda)(task_id, &env, cdata) == 0) {
+      SignalJobFinish();
+    } else {
+      SignalJobError(task_id);
+    }
+  }
+  // The number of tasks yet to finish.
+  int32_t NumPending() const {
+    return num_pending_.load();
+  }
   // Wait n jobs to finish
   int WaitForJobs() {
     while (num_pending_.load() != 0) {
@@ -125,19 +202,12 @@ class ParallelLauncher {
   void SignalJobFinish() {
     num_pending_.fetch_sub(1);
   }
-  // Get thread local version of the store.
-  static ParallelLauncher* ThreadLocal() {
-    return dmlc::ThreadLocalStore<ParallelLauncher>::Get();
-  }
   // The parallel lambda
   FTVMParallelLambda flambda;
   // The closure data
   void* cdata;
   // Local env
   TVMParallelGroupEnv env;
-  // Whether this thread is worker of the pool.
-  // used to prevent recursive launch.
-  bool is_worker{false};
 
  private:
   // The pending jobs.
@@ -146,10 +216,59 @@ class ParallelLauncher {
   std::atomic<bool> has_error_;
   // The counter page.
   std::atomic<int32_t>* sync_counter_{nullptr};
+  // The number of tasks the counter page can host.
+  int num_sync_counters_{0};
+  // The task ranges of a work-stealing launch.
+  std::unique_ptr<TaskRange[]> task_ranges_;
+  // The number of allocated task ranges.
+  int max_task_ranges_{0};
+  // The number of task ranges used by the current launch.
+  std::atomic<int> num_task_ranges_{0};
   // The error message
   std::vector<std::string> par_errors_;
 };
 
+/*!
+ * \brief Thread local stack of launchers. A launch from inside a parallel
+ *  task is nested and uses the launcher one level up the stack.
+ */
+class LauncherStack {
+ public:
+  // Get thread local version of the store.
+  static LauncherStack* ThreadLocal() {
+    return dmlc::ThreadLocalStore<LauncherStack>::Get();
+  }
+  // Get the launcher of the next level and enter it.
+  ParallelLauncher* Push() {
+    if (static_cast<size_t>(depth) == launchers_.size()) {
+      launchers_.emplace_back(new ParallelLauncher());
+    }
+    return launchers_[depth++].get();
+  }
+  // Leave the current level.
+  void Pop() {
+    --depth;
+  }
+  // The number of launches in progress on this thread.
+  int depth{0};
+  // The pool if this thread is a worker, nullptr otherwise.
+  ThreadPool* pool{nullptr};
+
+ private:
+  std::vector<std::unique_ptr<ParallelLauncher> > launchers_;
+};
+
+/*! \brief RAII scope of a launch on the launcher stack. */
+struct LauncherScope {
+  explicit LauncherScope(LauncherStack* stack)
+      : stack(stack), launcher(stack->Push()) {}
+  ~LauncherScope() {
+    stack->Pop();
+  }
+  LauncherStack* stack;
+  ParallelLauncher* launcher;
+};
+
 /*! \brief Lock-free single-producer-single-consumer queue for each thread */
 class SpscTaskQueue {
  public:
@@ -289,6 +408,7 @@ class ThreadPool {
           num_workers_, [this](int worker_id) { this->RunWorker(worker_id); },
           exclude_worker0_ /* include_main_thread */));
     num_workers_used_ = threads_->Configure(threading::ThreadGroup::kBig, 0, exclude_worker0_);
+    chunks_per_worker_.store(GetChunksPerWorker());
   }
   ~ThreadPool() {
     for (std::unique_ptr<SpscTaskQueue>& q : queues_) {
@@ -300,9 +420,15 @@ class ThreadPool {
              void* cdata,
              int num_task,
              int need_sync) {
-    ParallelLauncher* launcher = ParallelLauncher::ThreadLocal();
-    CHECK(!launcher->is_worker)
-        << "Cannot launch parallel job inside worker, consider fuse then parallel";
+    LauncherStack* stack = LauncherStack::ThreadLocal();
+    if (stack->depth != 0 || stack->pool != nullptr) {
+      return LaunchNested(flambda, cdata, num_task, need_sync != 0);
+    }
+    LauncherScope scope(stack);
+    ParallelLauncher* launcher = scope.launcher;
+    if (num_task == 0 && UseWorkStealing(need_sync != 0)) {
+      return LaunchWorkStealing(launcher, flambda, cdata);
+    }
     if (num_task == 0) {
       num_task = num_workers_used_;
     }
@@ -321,49 +447,140 @@ class ThreadPool {
     }
     // use the master thread to run task 0
     if (exclude_worker0_) {
-      TVMParallelGroupEnv* penv = &(tsk.launcher->env);
-      if ((*tsk.launcher->flambda)(0, penv, cdata) == 0) {
-        tsk.launcher->SignalJobFinish();
-      } else {
-        tsk.launcher->SignalJobError(tsk.task_id);
-      }
+      launcher->RunTask(0);
     }
-    int res = launcher->WaitForJobs();
-    return res;
+    return launcher->WaitForJobs();
   }
 
   static ThreadPool* ThreadLocal() {
     return dmlc::ThreadLocalStore<ThreadPool>::Get();
   }
 
-  void UpdateWorkerConfiguration(threading::ThreadGroup::AffinityMode mode, int nthreads) {
+  void UpdateWorkerConfiguration(threading::ThreadGroup::AffinityMode mode, int nthreads,
+                                 int core_offset) {
     // this will also reset the affinity of the ThreadGroup
     // may use less than the MaxConcurrency number of workers
     num_workers_used_ = threads_->Configure(mode, nthreads,
-                                            exclude_worker0_);
+                                            exclude_worker0_, core_offset);
     // if MaxConcurrency restricted the number of workers (e.g., due to
     // hyperthreading), respect the restriction
     num_workers_used_ = std::min(num_workers_, num_workers_used_);
   }
 
+  void UpdateWorkStealing(int chunks_per_worker) {
+    chunks_per_worker_.store(chunks_per_worker);
+  }
+
  private:
+  // Whether to split a launch into chunks scheduled by work stealing. Only
+  // launches declared without the barrier can be split, because a barrier
+  // needs all the tasks to run at the same time.
+  bool UseWorkStealing(bool need_sync) {
+    return !need_sync && chunks_per_worker_.load() > 0;
+  }
+  // Launch from the master with tasks split into chunks that idle workers steal.
+  int LaunchWorkStealing(ParallelLauncher* launcher,
+                         FTVMParallelLambda flambda,
+                         void* cdata) {
+    launcher->Init(flambda, cdata, num_workers_used_ * chunks_per_worker_.load(), false);
+    launcher->InitTaskRanges(num_workers_used_);
+    SpscTaskQueue::Task tsk;
+    tsk.launcher = launcher;
+    tsk.task_id = kStealTaskId;
+    for (int i = exclude_worker0_; i < num_workers_used_; ++i) {
+      queues_[i]->Push(tsk);
+    }
+    if (exclude_worker0_) {
+      RunWorkStealing(launcher, 0);
+    }
+    return launcher->WaitForJobs();
+  }
+  // Launch from inside a parallel task. In work-stealing mode the chunks are
+  // published for idle threads to steal, otherwise the tasks run in order on
+  // the calling thread.
+  int LaunchNested(FTVMParallelLambda flambda,
+                   void* cdata,
+                   int num_task,
+                   bool need_sync) {
+    LauncherScope scope(LauncherStack::ThreadLocal());
+    ParallelLauncher* launcher = scope.launcher;
+    if (num_task == 0 && UseWorkStealing(need_sync)) {
+      launcher->Init(flambda, cdata, num_workers_used_ * chunks_per_worker_.load(), false);
+      launcher->InitTaskRanges(1);
+      {
+        std::lock_guard<std::mutex> lock(nested_mutex_);
+        nested_.push_back(launcher);
+      }
+      int32_t task_id;
+      while (launcher->PopTask(0, &task_id)) {
+        launcher->RunTask(task_id);
+      }
+      // help the other nested launches while the stolen chunks finish.
+      while (launcher->NumPending() != 0) {
+        if (!StealNested()) {
+          tvm::runtime::threading::Yield();
+        }
+      }
+      {
+        std::lock_guard<std::mutex> lock(nested_mutex_);
+        nested_.erase(std::find(nested_.begin(), nested_.end(), launcher));
+      }
+      return launcher->WaitForJobs();
+    }
+    if (num_task == 0) {
+      num_task = 1;
+    }
+    launcher->Init(flambda, cdata, num_task, need_sync);
+    for (int i = 0; i < num_task; ++i) {
+      launcher->RunTask(i);
+    }
+    return launcher->WaitForJobs();
+  }
+  // Run the chunks of a launch, stealing from the other threads when out of chunks.
+  void RunWorkStealing(ParallelLauncher* launcher, int worker_id) {
+    int32_t task_id;
+    while (true) {
+      if (launcher->PopTask(worker_id, &task_id) ||
+          launcher->StealTask(worker_id, &task_id)) {
+        launcher->RunTask(task_id);
+      } else if (!StealNested()) {
+        break;
+      }
+    }
+  }
+  // Run one chunk of a nested launch, return whether there was one.
+  bool StealNested() {
+    ParallelLauncher* victim = nullptr;
+    int32_t task_id;
+    {
+      // chunks are only taken while the launch is registered.
+      std::lock_guard<std::mutex> lock(nested_mutex_);
+      for (ParallelLauncher* launcher : nested_) {
+        if (launcher->StealTask(-1, &task_id)) {
+          victim = launcher;
+          break;
+        }
+      }
+    }
+    if (victim == nullptr) return false;
+    victim->RunTask(task_id);
+    return true;
+  }
   // Internal worker function.
   void RunWorker(int worker_id) {
     SpscTaskQueue* queue = queues_[worker_id].get();
     SpscTaskQueue::Task task;
-    ParallelLauncher::ThreadLocal()->is_worker = true;
+    LauncherStack::ThreadLocal()->pool = this;
     // Initialize the spin count (from envvar TVM_THREAD_POOL_SPIN_COUNT) on
     // the global first use of the ThreadPool.
     // TODO(tulloch): should we make this configurable via standard APIs?
     static size_t spin_count = GetSpinCount();
     while (queue->Pop(&task, spin_count)) {
       CHECK(task.launcher != nullptr);
-      TVMParallelGroupEnv* penv = &(task.launcher->env);
-      void* cdata = task.launcher->cdata;
-      if ((*task.launcher->flambda)(task.task_id, penv, cdata) == 0) {
-        task.launcher->SignalJobFinish();
+      if (task.task_id == kStealTaskId) {
+        RunWorkStealing(task.launcher, worker_id);
       } else {
-        task.launcher->SignalJobError(task.task_id);
+        task.launcher->RunTask(task.task_id);
       }
     }
   }
@@ -374,15 +591,41 @@ class ThreadPool {
   bool exclude_worker0_{true};
   std::vector<std::unique_ptr<SpscTaskQueue> > queues_;
   std::unique_ptr<tvm::runtime::threading::ThreadGroup> threads_;
+  // number of chunks per worker of a work-stealing launch, 0 disables work stealing
+  std::atomic<int> chunks_per_worker_{0};
+  // nested launches whose chunks can be stolen
+  std::mutex nested_mutex_;
+  std::vector<ParallelLauncher*> nested_;
 };
 
+// Launch on the pool of the calling thread, a launch from a worker goes to
+// the pool of the worker.
+inline int LaunchOnThreadPool(FTVMParallelLambda flambda, void* cdata,
+                              int num_task, int need_sync) {
+  ThreadPool* pool = LauncherStack::ThreadLocal()->pool;
+  if (pool == nullptr) {
+    pool = ThreadPool::ThreadLocal();
+  }
+  return pool->Launch(flambda, cdata, num_task, need_sync);
+}
+
 TVM_REGISTER_GLOBAL("runtime.config_threadpool")
 .set_body([](TVMArgs args, TVMRetValue* rv) {
     threading::ThreadGroup::AffinityMode mode =\
     static_cast<threading::ThreadGroup::AffinityMode>(\
     static_cast<int>(args[0]));
     int nthreads = args[1];
-    ThreadPool::ThreadLocal()->UpdateWorkerConfiguration(mode, nthreads);
+    int core_offset = -1;
+    if (args.size() > 2) {
+      core_offset = args[2];
+    }
+    ThreadPool::ThreadLocal()->UpdateWorkerConfiguration(mode, nthreads, core_offset);
+});
+
+TVM_REGISTER_GLOBAL("runtime.config_threadpool_work_stealing")
+.set_body([](TVMArgs args, TVMRetValue* rv) {
+    int chunks_per_worker = args[0];
+    ThreadPool::ThreadLocal()->UpdateWorkStealing(chunks_per_worker);
 });
 
 
@@ -395,9 +638,7 @@ int TVMBackendParallelLaunch(
     void* cdata,
     int num_task) {
 #if !TVM_THREADPOOL_USE_OPENMP
-  int res = tvm::runtime::ThreadPool::ThreadLocal()->Launch(
-      flambda, cdata, num_task, 1);
-  return res;
+  return tvm::runtime::LaunchOnThreadPool(flambda, cdata, num_task, 1);
 #else
   int num_workers = tvm::runtime::threading::MaxConcurrency();
   if (num_task == 0) num_task = num_workers;
@@ -412,6 +653,17 @@ int TVMBackendParallelLaunch(
 #endif
 }
 
+int TVMBackendParallelLaunchBarrierFree(
+    FTVMParallelLambda flambda,
+    void* cdata,
+    int num_task) {
+#if !TVM_THREADPOOL_USE_OPENMP
+  return tvm::runtime::LaunchOnThreadPool(flambda, cdata, num_task, 0);
+#else
+  return TVMBackendParallelLaunch(flambda, cdata, num_task);
+#endif
+}
+
 int TVMBackendParallelBarrier(int task_id, TVMParallelGroupEnv* penv) {
 #if TVM_THREADPOOL_USE_OPENMP
   #pragma omp barrier
@@ -59,7 +59,7 @@ class ThreadGroup::Impl {
     }
   }
 
-  int Configure(AffinityMode mode, int nthreads, bool exclude_worker0) {
+  int Configure(AffinityMode mode, int nthreads, bool exclude_worker0, int core_offset) {
     int num_workers_used = 0;
     if (mode == kLittle) {
       num_workers_used = little_count_;
@@ -81,10 +81,18 @@ class ThreadGroup::Impl {
 
     const char *val = getenv("TVM_BIND_THREADS");
     if (val == nullptr || atoi(val) == 1) {
-      // Do not set affinity if there are more workers than found cores
-      if (sorted_order_.size() >= static_cast<unsigned int>(num_workers_)) {
+      if (core_offset >= 0) {
+        if (static_cast<size_t>(core_offset + num_workers_used) <= sorted_order_.size()) {
+          SetRangeAffinity(exclude_worker0, mode == kLittle, core_offset, num_workers_used);
+        } else {
+          LOG(WARNING)
+            << "The thread affinity cannot be set when the requested cores "
+            << "go past the number of available cores in the system.";
+        }
+      } else if (sorted_order_.size() >= static_cast<unsigned int>(num_workers_)) {
           SetAffinity(exclude_worker0, mode == kLittle);
       } else {
+        // Do not set affinity if there are more workers than found cores
         LOG(WARNING)
           << "The thread affinity cannot be set when the number of workers"
           << "is larger than the number of available cores in the system.";
@@ -180,6 +188,39 @@ class ThreadGroup::Impl {
 #endif
   }
 
+  // bind the first num_workers_used workers to the cores that start at
+  // core_offset, one core each; the workers left idle keep their affinity.
+  void SetRangeAffinity(bool exclude_worker0, bool reverse,
+                        int core_offset, int num_workers_used) {
+#if defined(__linux__) || defined(__ANDROID__)
+    for (int i = 0; i < num_workers_used; ++i) {
+      int pos = core_offset + i;
+      unsigned core_id = reverse ? sorted_order_[sorted_order_.size() - pos - 1]
+                                 : sorted_order_[pos];
+      cpu_set_t cpuset;
+      CPU_ZERO(&cpuset);
+      CPU_SET(core_id, &cpuset);
+      if (exclude_worker0 && i == 0) {
+        // worker 0 is the master thread.
+#if defined(__ANDROID__)
+        sched_setaffinity(pthread_self(), sizeof(cpu_set_t), &cpuset);
+#else
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+#endif
+        continue;
+      }
+      size_t tid = i - exclude_worker0;
+      if (tid >= threads_.size()) break;
+#if defined(__ANDROID__)
+      sched_setaffinity(threads_[tid].native_handle(), sizeof(cpu_set_t), &cpuset);
+#else
+      pthread_setaffinity_np(threads_[tid].native_handle(),
+          sizeof(cpu_set_t), &cpuset);
+#endif
+    }
+#endif
+  }
+
   void InitSortedOrder() {
     unsigned int threads = std::thread::hardware_concurrency();
     std::vector<std::pair <unsigned int, int64_t> > max_freqs;
@@ -235,8 +276,9 @@ ThreadGroup::ThreadGroup(int num_workers,
 ThreadGroup::~ThreadGroup() { delete impl_; }
 void ThreadGroup::Join() { impl_->Join(); }
 
-int ThreadGroup::Configure(AffinityMode mode, int nthreads, bool exclude_worker0) {
-  return impl_->Configure(mode, nthreads, exclude_worker0);
+int ThreadGroup::Configure(AffinityMode mode, int nthreads, bool exclude_worker0,
+                           int core_offset) {
+  return impl_->Configure(mode, nthreads, exclude_worker0, core_offset);
 }
 
 void Yield() {
@@ -0,0 +1,535 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/vm/batching_server.cc
+ * \brief Serve concurrent requests by running them in batches on the VM.
+ */
+#include <dmlc/json.h>
+#include <tvm/runtime/container.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/runtime/vm.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace vm {
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+const DLContext kCPUContext = {kDLCPU, 0};
+
+// The bytes of the elements after the axis, one slice along the axis.
+int64_t SliceBytes(const NDArray& array, int axis) {
+  int64_t bytes = (array->dtype.bits * array->dtype.lanes + 7) / 8;
+  for (int i = axis + 1; i < array->ndim; ++i) {
+    bytes *= array->shape[i];
+  }
+  return bytes;
+}
+
+// The number of slices before the axis.
+int64_t OuterSize(const NDArray& array, int axis) {
+  int64_t size = 1;
+  for (int i = 0; i < axis; ++i) {
+    size *= array->shape[i];
+  }
+  return size;
+}
+
+char* DataPtr(const NDArray& array) {
+  return static_cast<char*>(array->data) + array->byte_offset;
+}
+
+NDArray ToCPU(const NDArray& array) {
+  return array->ctx.device_type == kDLCPU ? array : array.CopyTo(kCPUContext);
+}
+
+// Concatenate the arrays along the axis on the CPU.
+NDArray Concat(const std::vector<NDArray>& arrays, int axis) {
+  std::vector<int64_t> shape = arrays[0].Shape();
+  shape[axis] = 0;
+  for (const NDArray& array : arrays) {
+    shape[axis] += array->shape[axis];
+  }
+  NDArray ret = NDArray::Empty(shape, arrays[0]->dtype, kCPUContext);
+  int64_t outer = OuterSize(ret, axis);
+  int64_t row_bytes = shape[axis] * SliceBytes(ret, axis);
+  int64_t offset = 0;
+  for (const NDArray& array : arrays) {
+    NDArray src = ToCPU(array);
+    int64_t src_row_bytes = array->shape[axis] * SliceBytes(array, axis);
+    for (int64_t i = 0; i < outer; ++i) {
+      std::memcpy(DataPtr(ret) + i * row_bytes + offset,
+                  DataPtr(src) + i * src_row_bytes,
+                  src_row_bytes);
+    }
+    offset += src_row_bytes;
+  }
+  return ret;
+}
+
+// Copy the slices [begin, begin + size) along the axis of a CPU array.
+NDArray Slice(const NDArray& array, int axis, int64_t begin, int64_t size) {
+  std::vector<int64_t> shape = array.Shape();
+  shape[axis] = size;
+  NDArray ret = NDArray::Empty(shape, array->dtype, kCPUContext);
+  int64_t outer = OuterSize(array, axis);
+  int64_t slice_bytes = SliceBytes(array, axis);
+  int64_t row_bytes = array->shape[axis] * slice_bytes;
+  for (int64_t i = 0; i < outer; ++i) {
+    std::memcpy(DataPtr(ret) + i * size * slice_bytes,
+                DataPtr(array) + i * row_bytes + begin * slice_bytes,
+                size * slice_bytes);
+  }
+  return ret;
+}
+}  // namespace
+
+/*!
+ * \brief Serve concurrent requests by running them in batches on the VM.
+ *
+ *  Requests are queued and workers, each owning a VM of the executable,
+ *  concatenate the inputs of the requests at the front of the queue along
+ *  the batch axis, run the function once and split the outputs back along
+ *  the same axis. A worker runs a batch once it holds max_batch_size
+ *  samples or the oldest request has waited max_latency, so the latency
+ *  budget bounds the time a request spends waiting for others.
+ *
+ *  Requests are batched together only when their inputs have the same
+ *  types and the same shapes except along the batch axis, and every input
+ *  and output of the function must be batched along that axis.
+ */
+class BatchingServer : public ModuleNode {
+ public:
+  ~BatchingServer() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    queue_cv_.notify_all();
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  const char* type_key() const final {
+    return "VMBatchingServer";
+  }
+
+  /*!
+   * \brief Initialize the server and start the workers.
+   * \param exec The executable.
+   * \param func_name The function serving the requests.
+   * \param batch_axis The axis of the inputs and outputs the requests are batched along.
+   * \param max_batch_size The number of samples at which a batch is run without waiting.
+   * \param max_latency_us The time in microseconds a request waits for others at most.
+   * \param num_workers The number of workers, each running one batch at a time.
+   * \param ctx The context the VMs run on.
+   */
+  void Init(const Executable* exec,
+            const std::string& func_name,
+            int batch_axis,
+            int64_t max_batch_size,
+            int64_t max_latency_us,
+            int num_workers,
+            TVMContext ctx) {
+    CHECK(exec->global_map.count(func_name))
+        << "Cannot find function " << func_name << " in the executable";
+    CHECK_GE(batch_axis, 0);
+    CHECK_GT(max_batch_size, 0);
+    CHECK_GE(max_latency_us, 0);
+    CHECK_GT(num_workers, 0);
+    func_name_ = func_name;
+    batch_axis_ = batch_axis;
+    max_batch_size_ = max_batch_size;
+    max_latency_ = std::chrono::microseconds(max_latency_us);
+    for (int i = 0; i < num_workers; ++i) {
+      auto vm = make_object<VirtualMachine>();
+      vm->LoadExecutable(exec);
+      Module mod(vm);
+      mod.GetFunction("init")(static_cast<int>(ctx.device_type), ctx.device_id);
+      vms_.push_back(mod);
+    }
+    for (int i = 0; i < num_workers; ++i) {
+      workers_.emplace_back([this, i]() { this->WorkerLoop(vms_[i]); });
+    }
+  }
+
+  /*!
+   * \brief Run a request, blocking until its batch has run.
+   * \param inputs The inputs of the function.
+   * \return The output, an NDArray or an ADT of them.
+   */
+  ObjectRef Infer(std::vector<NDArray> inputs) {
+    CHECK(!inputs.empty()) << "A request needs at least one input";
+    std::unique_ptr<Request> req(new Request());
+    for (const NDArray& input : inputs) {
+      CHECK(input->strides == nullptr) << "The inputs must be compact";
+      CHECK_LT(batch_axis_, input->ndim)
+          << "The inputs must have the batch axis " << batch_axis_;
+      CHECK_EQ(input->shape[batch_axis_], inputs[0]->shape[batch_axis_])
+          << "The inputs of a request must have the same batch size";
+    }
+    req->batch_size = inputs[0]->shape[batch_axis_];
+    req->inputs = std::move(inputs);
+    req->arrival = Clock::now();
+    std::future<ObjectRef> result = req->result.get_future();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      CHECK(!stop_) << "The server has stopped";
+      queued_samples_ += req->batch_size;
+      queue_.push_back(std::move(req));
+    }
+    queue_cv_.notify_all();
+    return result.get();
+  }
+
+  /*!
+   * \brief Measure the server with clients that each send requests one after another.
+   * \param inputs The inputs of every request.
+   * \param num_clients The number of concurrent clients.
+   * \param num_requests The number of requests of each client.
+   * \return The throughput and the latencies as json.
+   */
+  std::string Benchmark(const std::vector<NDArray>& inputs, int num_clients, int num_requests) {
+    CHECK_GT(num_clients, 0);
+    CHECK_GT(num_requests, 0);
+    std::vector<std::vector<double> > latencies(num_clients);
+    std::vector<std::string> errors(num_clients);
+    int64_t batches_before = GetStats().num_batches;
+    auto start = Clock::now();
+    std::vector<std::thread> clients;
+    for (int i = 0; i < num_clients; ++i) {
+      clients.emplace_back([&, i]() {
+        try {
+          for (int j = 0; j < num_requests; ++j) {
+            auto begin = Clock::now();
+            Infer(inputs);
+            latencies[i].push_back(
+                std::chrono::duration<double, std::micro>(Clock::now() - begin).count());
+          }
+        } catch (const std::exception& e) {
+          errors[i] = e.what();
+        } catch (...) {
+          errors[i] = "unknown exception";
+        }
+      });
+    }
+    for (auto& client : clients) {
+      client.join();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    for (const std::string& error : errors) {
+      CHECK(error.empty()) << error;
+    }
+    int64_t num_batches = GetStats().num_batches - batches_before;
+
+    std::vector<double> all;
+    for (const auto& client : latencies) {
+      all.insert(all.end(), client.begin(), client.end());
+    }
+    std::sort(all.begin(), all.end());
+    auto percentile = [&all](double p) {
+      size_t index = static_cast<size_t>(p * (all.size() - 1) + 0.5);
+      return all[index];
+    };
+    double sum = 0;
+    for (double latency : all) {
+      sum += latency;
+    }
+    std::ostringstream os;
+    dmlc::JSONWriter writer(&os);
+    writer.BeginObject();
+    writer.WriteObjectKeyValue("num_requests", static_cast<int64_t>(all.size()));
+    writer.WriteObjectKeyValue("requests_per_sec", all.size() / seconds);
+    writer.WriteObjectKeyValue(
+        "mean_batch_requests", num_batches != 0 ? static_cast<double>(all.size()) / num_batches : 0.0);
+    writer.WriteObjectKeyValue("mean_latency_us", sum / all.size());
+    writer.WriteObjectKeyValue("p50_latency_us", percentile(0.5));
+    writer.WriteObjectKeyValue("p90_latency_us", percentile(0.9));
+    writer.WriteObjectKeyValue("p99_latency_us", percentile(0.99));
+    writer.WriteObjectKeyValue("max_latency_us", all.back());
+    writer.EndObject();
+    return os.str();
+  }
+
+  PackedFunc GetFunction(const std::string& name,
+                         const ObjectPtr<Object>& sptr_to_self) final {
+    if (name == "infer") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+          *rv = this->Infer(GetInputs(args, 0));
+        });
+    } else if (name == "benchmark") {
+      // `args` is in the form "num_clients, num_requests, input, input, ..."
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+          *rv = this->Benchmark(GetInputs(args, 2), args[0], args[1]);
+        });
+    } else if (name == "get_stats") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+          Stats stats = this->GetStats();
+          std::ostringstream os;
+          dmlc::JSONWriter writer(&os);
+          writer.BeginObject();
+          writer.WriteObjectKeyValue("num_requests", stats.num_requests);
+          writer.WriteObjectKeyValue("num_samples", stats.num_samples);
+          writer.WriteObjectKeyValue("num_batches", stats.num_batches);
+          writer.EndObject();
+          *rv = os.str();
+        });
+    } else {
+      return PackedFunc();
+    }
+  }
+
+ private:
+  /*! \brief A queued request. */
+  struct Request {
+    /*! \brief The inputs. */
+    std::vector<NDArray> inputs;
+    /*! \brief The size of the inputs along the batch axis. */
+    int64_t batch_size;
+    /*! \brief The time the request was queued. */
+    Clock::time_point arrival;
+    /*! \brief The output, or the error of the batch. */
+    std::promise<ObjectRef> result;
+  };
+
+  /*! \brief The counters of the server. */
+  struct Stats {
+    int64_t num_requests{0};
+    int64_t num_samples{0};
+    int64_t num_batches{0};
+  };
+
+  static std::vector<NDArray> GetInputs(const TVMArgs& args, int begin) {
+    std::vector<NDArray> inputs;
+    for (int i = begin; i < args.size(); ++i) {
+      inputs.push_back(args[i].operator NDArray());
+    }
+    return inputs;
+  }
+
+  Stats GetStats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+  }
+
+  // Whether the inputs can be concatenated along the batch axis.
+  bool CanBatch(const Request& lhs, const Request& rhs) const {
+    if (lhs.inputs.size() != rhs.inputs.size()) return false;
+    for (size_t i = 0; i < lhs.inputs.size(); ++i) {
+      const DLTensor* a = lhs.inputs[i].operator->();
+      const DLTensor* b = rhs.inputs[i].operator->();
+      if (a->ndim != b->ndim || a->dtype.code != b->dtype.code ||
+          a->dtype.bits != b->dtype.bits || a->dtype.lanes != b->dtype.lanes) {
+        return false;
+      }
+      for (int k = 0; k < a->ndim; ++k) {
+        if (k != batch_axis_ && a->shape[k] != b->shape[k]) return false;
+      }
+    }
+    return true;
+  }
+
+  /*!
+   * \brief Wait for the next batch.
+   * \return The requests of the batch, empty when the server stops.
+   */
+  std::vector<std::unique_ptr<Request> > NextBatch() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      queue_cv_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
+      if (queue_.empty()) return {};
+      // Wait for more samples while the oldest request is within its budget.
+      while (!stop_ && !queue_.empty() && queued_samples_ < max_batch_size_) {
+        Clock::time_point deadline = queue_.front()->arrival + max_latency_;
+        if (Clock::now() >= deadline) break;
+        queue_cv_.wait_until(lock, deadline);
+      }
+      // Another worker may have taken the requests.
+      if (queue_.empty()) continue;
+      std::vector<std::unique_ptr<Request> > batch;
+      int64_t batch_size = 0;
+      while (!queue_.empty()) {
+        const Request& req = *queue_.front();
+        if (!batch.empty() &&
+            (batch_size + req.batch_size > max_batch_size_ || !CanBatch(*batch[0], req))) {
+          break;
+        }
+        batch_size += req.batch_size;
+        queued_samples_ -= req.batch_size;
+        batch.push_back(std::move(queue_.front()));
+        queue_.pop_front();
+      }
+      stats_.num_requests += batch.size();
+      stats_.num_samples += batch_size;
+      stats_.num_batches += 1;
+      return batch;
+    }
+  }
+
+  // Split an output along the batch axis into the outputs of the requests. The
+  // outputs are on the CPU, whether or not the request was batched with others.
+  std::vector<ObjectRef> Scatter(const ObjectRef& output,
+                                 const std::vector<std::unique_ptr<Request> >& batch) const {
+    std::vector<ObjectRef> ret;
+    if (const auto* adt = output.as<ADTObj>()) {
+      std::vector<std::vector<ObjectRef> > fields(batch.size());
+      for (size_t i = 0; i < adt->size; ++i) {
+        std::vector<ObjectRef> parts = Scatter((*adt)[i], batch);
+        for (size_t j = 0; j < batch.size(); ++j) {
+          fields[j].push_back(parts[j]);
+        }
+      }
+      for (size_t j = 0; j < batch.size(); ++j) {
+        ret.push_back(ADT(adt->tag, fields[j]));
+      }
+      return ret;
+    }
+    CHECK(output->IsInstance<NDArray::ContainerType>())
+        << "The outputs must be tensors or tuples of them";
+    NDArray array = ToCPU(Downcast<NDArray>(output));
+    int64_t total = 0;
+    for (const auto& req : batch) {
+      total += req->batch_size;
+    }
+    CHECK(batch_axis_ < array->ndim && array->shape[batch_axis_] == total)
+        << "The outputs must have the batch size " << total << " along axis " << batch_axis_;
+    if (batch.size() == 1) {
+      // A lone request keeps the whole output.
+      return {array};
+    }
+    int64_t begin = 0;
+    for (const auto& req : batch) {
+      ret.push_back(Slice(array, batch_axis_, begin, req->batch_size));
+      begin += req->batch_size;
+    }
+    return ret;
+  }
+
+  void RunBatch(const PackedFunc& set_input, const PackedFunc& invoke,
+                const std::vector<std::unique_ptr<Request> >& batch) {
+    std::vector<ObjectRef> outputs;
+    try {
+      std::vector<NDArray> inputs;
+      for (size_t i = 0; i < batch[0]->inputs.size(); ++i) {
+        if (batch.size() == 1) {
+          inputs.push_back(batch[0]->inputs[i]);
+        } else {
+          std::vector<NDArray> parts;
+          for (const auto& req : batch) {
+            parts.push_back(req->inputs[i]);
+          }
+          inputs.push_back(Concat(parts, batch_axis_));
+        }
+      }
+      std::vector<TVMValue> values(inputs.size() + 1);
+      std::vector<int> type_codes(inputs.size() + 1);
+      TVMArgsSetter setter(values.data(), type_codes.data());
+      setter(0, func_name_);
+      for (size_t i = 0; i < inputs.size(); ++i) {
+        setter(i + 1, inputs[i]);
+      }
+      TVMRetValue rv;
+      set_input.CallPacked(
+          TVMArgs(values.data(), type_codes.data(), static_cast<int>(values.size())), &rv);
+      ObjectRef output = invoke(func_name_);
+      outputs = Scatter(output, batch);
+    } catch (...) {
+      // No promise is set before the outputs of all requests are ready.
+      for (const auto& req : batch) {
+        req->result.set_exception(std::current_exception());
+      }
+      return;
+    }
+    for (size_t i = 0; i < batch.size(); ++i) {
+      batch[i]->result.set_value(outputs[i]);
+    }
+  }
+
+  void WorkerLoop(Module vm) {
+    PackedFunc set_input = vm.GetFunction("set_input");
+    PackedFunc invoke = vm.GetFunction("invoke");
+    while (true) {
+      std::vector<std::unique_ptr<Request> > batch = NextBatch();
+      if (batch.empty()) break;
+      RunBatch(set_input, invoke, batch);
+    }
+  }
+
+  /*! \brief The function serving the requests. */
+  std::string func_name_;
+  /*! \brief The axis the requests are batched along. */
+  int batch_axis_{0};
+  /*! \brief The number of samples at which a batch runs without waiting. */
+  int64_t max_batch_size_{1};
+  /*! \brief The longest time a request waits for others. */
+  std::chrono::microseconds max_latency_{0};
+  /*! \brief The VMs, one for each worker. */
+  std::vector<Module> vms_;
+  /*! \brief The workers. */
+  std::vector<std::thread> workers_;
+  /*! \brief The queued requests. */
+  std::deque<std::unique_ptr<Request> > queue_;
+  /*! \brief The samples of the queued requests. */
+  int64_t queued_samples_{0};
+  /*! \brief The counters. */
+  Stats stats_;
+  /*! \brief Whether the server is stopping. */
+  bool stop_{false};
+  /*! \brief Protects the queue, the counters and the stop flag. */
+  std::mutex mutex_;
+  /*! \brief Signals new requests and the stop to the workers. */
+  std::condition_variable queue_cv_;
+};
+
+TVM_REGISTER_GLOBAL("runtime._VMBatchingServer")
+.set_body([](TVMArgs args, TVMRetValue* rv) {
+    runtime::Module mod = args[0];
+    const auto* exec = dynamic_cast<Executable*>(mod.operator->());
+    CHECK(exec) << "The virtual machine executable has not been defined yet.";
+    TVMContext ctx;
+    int device_type = args[6];
+    ctx.device_type = DLDeviceType(device_type);
+    ctx.device_id = args[7];
+    auto server = make_object<BatchingServer>();
+    server->Init(exec, args[1], args[2], args[3], args[4], args[5], ctx);
+    // The server keeps the executable alive.
+    server->Import(mod);
+    *rv = Module(server);
+  });
+
+}  // namespace vm
+}  // namespace runtime
+}  // namespace tvm
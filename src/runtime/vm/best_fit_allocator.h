@@ -0,0 +1,367 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file runtime/best_fit_allocator.h
+ */
+#ifndef TVM_RUNTIME_VM_BEST_FIT_ALLOCATOR_H_
+#define TVM_RUNTIME_VM_BEST_FIT_ALLOCATOR_H_
+
+#include <tvm/runtime/device_api.h>
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "memory_manager.h"
+
+namespace tvm {
+namespace runtime {
+namespace vm {
+
+/*!
+ * \brief Allocator carving buffers out of large chunks of device memory.
+ *
+ *  Requests are rounded up to size classes, four per power of two, and served
+ *  by the smallest free block that fits, which is split when the remainder is
+ *  large enough. Freed blocks are coalesced with their free neighbours, so that
+ *  requests of slightly different sizes (e.g. dynamic shapes) reuse the same
+ *  memory. Chunks left entirely free are returned to the device when the free
+ *  memory exceeds the configured cap.
+ *
+ *  Small blocks freed by a thread are first kept in a cache owned by the thread
+ *  and reused by its next allocations of the same size class without taking the
+ *  allocator lock.
+ *
+ *  Blocks are addressed by offsetting the chunk pointer, so the allocator is
+ *  only used on devices with a flat address space.
+ */
+class BestFitAllocator final : public Allocator {
+ public:
+  /*! \brief The smallest block, every block is aligned to it. */
+  static constexpr size_t kMinBlockSize = 256;
+  /*! \brief The size of the chunks requested from the device. */
+  static constexpr size_t kChunkSize = 2 << 20;
+  /*! \brief The largest block kept in the thread caches. */
+  static constexpr size_t kMaxCachedBlockSize = 1 << 20;
+  /*! \brief The number of blocks per size class kept in a thread cache. */
+  static constexpr size_t kThreadCacheDepth = 4;
+
+  /*!
+   * \brief Create the allocator.
+   * \param ctx The context of the allocated memory.
+   * \param max_cached_bytes Free memory above which free chunks are returned
+   *  to the device, 0 to keep all of them.
+   */
+  explicit BestFitAllocator(TVMContext ctx, size_t max_cached_bytes = 0)
+      : Allocator(kBestFit), ctx_(ctx), max_cached_bytes_(max_cached_bytes) {
+    std::lock_guard<std::mutex> lock(LiveMutex());
+    id_ = ++NextId();
+    LiveAllocators()[id_] = this;
+  }
+
+  ~BestFitAllocator() {
+    {
+      // The threads that exit from now on leave their caches to the destructor.
+      std::lock_guard<std::mutex> lock(LiveMutex());
+      LiveAllocators().erase(id_);
+    }
+    ReleaseAll();
+  }
+
+  Buffer Alloc(size_t nbytes, size_t alignment, DLDataType type_hint) override {
+    CHECK_LE(alignment, kMinBlockSize)
+        << "BestFitAllocator does not support alignment " << alignment;
+    size_t size = RoundToSizeClass(nbytes);
+    num_allocs_.fetch_add(1, std::memory_order_relaxed);
+    num_live_.fetch_add(1, std::memory_order_relaxed);
+    requested_bytes_.fetch_add(nbytes, std::memory_order_relaxed);
+    Buffer buf;
+    buf.ctx = ctx_;
+    buf.size = nbytes;
+    if (size <= kMaxCachedBlockSize && GetThreadCache()->Pop(size, &buf.data)) {
+      num_hits_.fetch_add(1, std::memory_order_relaxed);
+      return buf;
+    }
+    std::lock_guard<std::mutex> lock(mu_);
+    buf.data = AllocBlock(size, type_hint);
+    return buf;
+  }
+
+  void Free(const Buffer& buffer) override {
+    requested_bytes_.fetch_sub(buffer.size, std::memory_order_relaxed);
+    num_live_.fetch_sub(1, std::memory_order_relaxed);
+    size_t size = RoundToSizeClass(buffer.size);
+    if (size <= kMaxCachedBlockSize && GetThreadCache()->Push(size, buffer.data)) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(mu_);
+    FreeBlock(buffer.data);
+  }
+
+  size_t UsedMemory() const override {
+    std::lock_guard<std::mutex> lock(mu_);
+    return reserved_bytes_;
+  }
+
+  // The free chunks and the cached blocks are released with the allocator.
+  bool HasLiveBuffers() const override {
+    return num_live_.load(std::memory_order_relaxed) != 0;
+  }
+
+  AllocatorStats Stats() const override {
+    std::lock_guard<std::mutex> lock(mu_);
+    AllocatorStats stats;
+    stats.requested_bytes = requested_bytes_.load(std::memory_order_relaxed);
+    stats.allocated_bytes = allocated_bytes_;
+    stats.reserved_bytes = reserved_bytes_;
+    stats.peak_reserved_bytes = peak_reserved_bytes_;
+    stats.largest_free_block = free_blocks_.empty() ? 0 : free_blocks_.rbegin()->first;
+    stats.num_allocs = num_allocs_.load(std::memory_order_relaxed);
+    stats.num_hits = num_hits_.load(std::memory_order_relaxed);
+    return stats;
+  }
+
+  /*!
+   * \brief Round a request up to its size class.
+   * \param nbytes The requested size.
+   * \return The size of the block serving the request.
+   */
+  static size_t RoundToSizeClass(size_t nbytes) {
+    if (nbytes <= kMinBlockSize) return kMinBlockSize;
+    // Four classes per power of two bound the rounding overhead to 25%.
+    size_t msb = 0;
+    for (size_t v = nbytes - 1; v >>= 1;) ++msb;
+    size_t step = static_cast<size_t>(1) << (msb - 2);
+    size_t size = (nbytes + step - 1) / step * step;
+    return (size + kMinBlockSize - 1) / kMinBlockSize * kMinBlockSize;
+  }
+
+ private:
+  /*! \brief A block of a chunk, keyed by its address. */
+  struct Block {
+    /*! \brief The size of the block. */
+    size_t size;
+    /*! \brief The address of the chunk containing the block. */
+    uintptr_t chunk;
+    /*! \brief Whether the block is free. */
+    bool free;
+  };
+
+  /*! \brief Blocks freed by one thread, ready to be reused by it. */
+  class ThreadCache {
+   public:
+    bool Pop(size_t size, void** data) {
+      auto it = blocks_.find(size);
+      if (it == blocks_.end() || it->second.empty()) return false;
+      *data = it->second.back();
+      it->second.pop_back();
+      return true;
+    }
+
+    bool Push(size_t size, void* data) {
+      std::vector<void*>& blocks = blocks_[size];
+      if (blocks.size() >= kThreadCacheDepth) return false;
+      blocks.push_back(data);
+      return true;
+    }
+
+    /*! \brief Give the cached blocks back to the allocator, must hold its lock. */
+    void Release(BestFitAllocator* alloc) {
+      for (auto& kv : blocks_) {
+        for (void* data : kv.second) {
+          alloc->FreeBlock(data);
+        }
+      }
+      blocks_.clear();
+    }
+
+   private:
+    std::unordered_map<size_t, std::vector<void*> > blocks_;
+  };
+
+  /*!
+   * \brief The caches of a thread, keyed by the id of their allocator. The ids
+   *  are never reused, so an allocator made at the address of a destroyed one
+   *  does not find its caches. A thread that exits gives its blocks back to the
+   *  allocators that are still alive.
+   */
+  struct ThreadCaches {
+    std::unordered_map<uint64_t, ThreadCache*> caches;
+
+    ~ThreadCaches() {
+      std::lock_guard<std::mutex> lock(LiveMutex());
+      for (const auto& kv : caches) {
+        auto it = LiveAllocators().find(kv.first);
+        if (it != LiveAllocators().end()) it->second->DropThreadCache(kv.second);
+      }
+    }
+  };
+
+  // The registry of the live allocators is leaked, so that threads exiting
+  // after the static destructors still find it.
+  static std::mutex& LiveMutex() {
+    static std::mutex* mutex = new std::mutex();
+    return *mutex;
+  }
+
+  static std::unordered_map<uint64_t, BestFitAllocator*>& LiveAllocators() {
+    static auto* allocators = new std::unordered_map<uint64_t, BestFitAllocator*>();
+    return *allocators;
+  }
+
+  static uint64_t& NextId() {
+    static uint64_t next_id = 0;
+    return next_id;
+  }
+
+  ThreadCache* GetThreadCache() {
+    static thread_local ThreadCaches thread_caches;
+    ThreadCache*& cache = thread_caches.caches[id_];
+    if (cache == nullptr) {
+      std::unique_ptr<ThreadCache> owned(new ThreadCache());
+      cache = owned.get();
+      std::lock_guard<std::mutex> lock(mu_);
+      thread_caches_.push_back(std::move(owned));
+    }
+    return cache;
+  }
+
+  void DropThreadCache(ThreadCache* cache) {
+    std::lock_guard<std::mutex> lock(mu_);
+    cache->Release(this);
+    auto it = std::find_if(thread_caches_.begin(), thread_caches_.end(),
+                           [cache](const std::unique_ptr<ThreadCache>& c) {
+                             return c.get() == cache;
+                           });
+    if (it != thread_caches_.end()) thread_caches_.erase(it);
+  }
+
+  void* AllocBlock(size_t size, DLDataType type_hint) {
+    auto fit = free_blocks_.lower_bound(std::make_pair(size, static_cast<uintptr_t>(0)));
+    if (fit != free_blocks_.end()) {
+      num_hits_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+      size_t chunk_size = size > kChunkSize ? size : kChunkSize;
+      void* chunk = DeviceAPI::Get(ctx_)->AllocDataSpace(
+          ctx_, chunk_size, kMinBlockSize, type_hint);
+      uintptr_t addr = reinterpret_cast<uintptr_t>(chunk);
+      reserved_bytes_ += chunk_size;
+      peak_reserved_bytes_ = std::max(peak_reserved_bytes_, reserved_bytes_);
+      chunks_[addr] = chunk_size;
+      blocks_[addr] = Block{chunk_size, addr, true};
+      fit = free_blocks_.insert(std::make_pair(chunk_size, addr)).first;
+      DLOG(INFO) << "allocate chunk " << chunk_size << " B, reserved memory "
+                 << reserved_bytes_ << " B";
+    }
+    uintptr_t addr = fit->second;
+    free_blocks_.erase(fit);
+    Block& block = blocks_.at(addr);
+    if (block.size - size >= kMinBlockSize) {
+      uintptr_t rest = addr + size;
+      blocks_[rest] = Block{block.size - size, block.chunk, true};
+      free_blocks_.insert(std::make_pair(block.size - size, rest));
+      block.size = size;
+    }
+    block.free = false;
+    allocated_bytes_ += block.size;
+    return reinterpret_cast<void*>(addr);
+  }
+
+  void FreeBlock(void* data) {
+    auto it = blocks_.find(reinterpret_cast<uintptr_t>(data));
+    CHECK(it != blocks_.end() && !it->second.free)
+        << "BestFitAllocator: free of an unknown buffer";
+    allocated_bytes_ -= it->second.size;
+    it->second.free = true;
+    auto next = std::next(it);
+    if (next != blocks_.end() && next->second.free && next->second.chunk == it->second.chunk) {
+      free_blocks_.erase(std::make_pair(next->second.size, next->first));
+      it->second.size += next->second.size;
+      blocks_.erase(next);
+    }
+    if (it != blocks_.begin()) {
+      auto prev = std::prev(it);
+      if (prev->second.free && prev->second.chunk == it->second.chunk) {
+        free_blocks_.erase(std::make_pair(prev->second.size, prev->first));
+        prev->second.size += it->second.size;
+        blocks_.erase(it);
+        it = prev;
+      }
+    }
+    uintptr_t addr = it->first;
+    size_t size = it->second.size;
+    if (max_cached_bytes_ != 0 && addr == it->second.chunk && size == chunks_.at(addr) &&
+        reserved_bytes_ - allocated_bytes_ > max_cached_bytes_) {
+      DeviceAPI::Get(ctx_)->FreeDataSpace(ctx_, reinterpret_cast<void*>(addr));
+      reserved_bytes_ -= size;
+      chunks_.erase(addr);
+      blocks_.erase(it);
+      DLOG(INFO) << "release chunk " << size << " B, reserved memory "
+                 << reserved_bytes_ << " B";
+      return;
+    }
+    free_blocks_.insert(std::make_pair(size, addr));
+  }
+
+  void ReleaseAll() {
+    std::lock_guard<std::mutex> lock(mu_);
+    for (const auto& kv : chunks_) {
+      DeviceAPI::Get(ctx_)->FreeDataSpace(ctx_, reinterpret_cast<void*>(kv.first));
+    }
+    chunks_.clear();
+    blocks_.clear();
+    free_blocks_.clear();
+    reserved_bytes_ = 0;
+    allocated_bytes_ = 0;
+    DLOG(INFO) << "release all chunks";
+  }
+
+  TVMContext ctx_;
+  size_t max_cached_bytes_;
+  /*! \brief The id of the allocator, unique over the life of the process. */
+  uint64_t id_;
+  /*! \brief The caches of the threads that used the allocator. */
+  std::vector<std::unique_ptr<ThreadCache> > thread_caches_;
+  /*! \brief The size of each chunk, keyed by its address. */
+  std::map<uintptr_t, size_t> chunks_;
+  /*! \brief All the blocks ordered by address, used to find the neighbours. */
+  std::map<uintptr_t, Block> blocks_;
+  /*! \brief The free blocks ordered by size then address, used for best-fit. */
+  std::set<std::pair<size_t, uintptr_t> > free_blocks_;
+  size_t allocated_bytes_{0};
+  size_t reserved_bytes_{0};
+  size_t peak_reserved_bytes_{0};
+  std::atomic<size_t> requested_bytes_{0};
+  std::atomic<size_t> num_allocs_{0};
+  std::atomic<size_t> num_hits_{0};
+  std::atomic<size_t> num_live_{0};
+  mutable std::mutex mu_;
+};
+
+}  // namespace vm
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_VM_BEST_FIT_ALLOCATOR_H_
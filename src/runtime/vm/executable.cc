@@ -36,6 +36,7 @@
 #include <vector>
 
 #include "serialize_util.h"
+#include "../mapped_params.h"
 
 namespace tvm {
 namespace runtime {
@@ -68,6 +69,14 @@ PackedFunc Executable::GetFunction(const std::string& name,
     return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
       *rv = this->Save();
     });
+  } else if (name == "save_constants") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      this->SaveConstants(args[0]);
+    });
+  } else if (name == "load_constants") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      this->LoadConstants(args[0]);
+    });
   } else if (name == "get_function_arity") {
     return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
       std::string func_name = args[0];
@@ -199,6 +208,8 @@ std::string Executable::Stats() const {
 void SaveHeader(dmlc::Stream* strm) {
   uint64_t header = kTVMVMBytecodeMagic;
   strm->Write(header);
+  uint64_t bytecode_version = kTVMVMBytecodeVersion;
+  strm->Write(bytecode_version);
   std::string version = TVM_VERSION;
   strm->Write(version);
 }
@@ -245,7 +256,34 @@ void Executable::SaveGlobalSection(dmlc::Stream* strm) {
   strm->Write(glbs);
 }
 
+void Executable::SaveConstants(const std::string& file_name) {
+  std::vector<std::string> names;
+  std::vector<NDArray> arrays;
+  for (size_t i = 0; i < this->constants.size(); ++i) {
+    names.push_back(std::to_string(i));
+    arrays.push_back(Downcast<NDArray>(this->constants[i]));
+  }
+  runtime::SaveMappedParams(file_name, names, arrays);
+  this->external_constants = true;
+}
+
+void Executable::LoadConstants(const std::string& file_name) {
+  std::vector<ObjectRef> constants;
+  for (auto& kv : runtime::LoadMappedParams(file_name)) {
+    CHECK_EQ(kv.first, std::to_string(constants.size()))
+        << "Invalid constants file " << file_name;
+    constants.push_back(kv.second);
+  }
+  CHECK(this->constants.empty() || this->constants.size() == constants.size())
+      << "The constants file " << file_name << " does not match the executable";
+  this->constants = std::move(constants);
+}
+
 void Executable::SaveConstantSection(dmlc::Stream* strm) {
+  if (this->external_constants) {
+    strm->Write(static_cast<uint64_t>(0));
+    return;
+  }
   std::vector<DLTensor*> arrays;
   for (const auto& obj : this->constants) {
     const auto cell = Downcast<runtime::NDArray>(obj);
@@ -314,8 +352,9 @@ VMInstructionSerializer SerializeInstruction(const Instruction& instr) {
       break;
     }
     case Opcode::AllocTensor: {
-      // Number of fields = 5 + instr.alloc_tensor.ndim
+      // Number of fields = 7 + instr.alloc_tensor.ndim
       fields.push_back(instr.alloc_tensor.storage);
+      fields.push_back(instr.alloc_tensor.offset);
 
       // Save `DLDataType` and the dst register.
       const auto& dtype = instr.alloc_tensor.dtype;
@@ -337,8 +376,9 @@ VMInstructionSerializer SerializeInstruction(const Instruction& instr) {
       break;
     }
     case Opcode::AllocTensorReg: {
-      // Number of fields = 6
+      // Number of fields = 7
       fields.push_back(instr.alloc_tensor_reg.storage);
+      fields.push_back(instr.alloc_tensor_reg.offset);
       fields.push_back(instr.alloc_tensor_reg.shape_register);
       // Save `DLDataType` and the dst register.
       const auto& dtype = instr.alloc_tensor_reg.dtype;
@@ -461,6 +501,13 @@ void LoadHeader(dmlc::Stream* strm) {
   STREAM_CHECK(strm->Read(&header), "header");
   STREAM_CHECK(header == kTVMVMBytecodeMagic, "header");
 
+  // Check the bytecode version. The files saved before it was added have
+  // the length of the TVM version string here.
+  uint64_t bytecode_version;
+  STREAM_CHECK(strm->Read(&bytecode_version), "version");
+  CHECK_EQ(bytecode_version, kTVMVMBytecodeVersion)
+      << "Unsupported VM bytecode version, the executable must be saved again";
+
   // Check version.
   std::string version;
   STREAM_CHECK(strm->Read(&version), "version");
@@ -539,23 +586,23 @@ Instruction DeserializeInstruction(const VMInstructionSerializer& instr) {
   switch (opcode) {
     case Opcode::Move: {
       // Number of fields = 2
-      DCHECK_EQ(instr.fields.size(), 2U);
+      CHECK_EQ(instr.fields.size(), 2U);
       return Instruction::Move(instr.fields[0], instr.fields[1]);
     }
     case Opcode::Ret: {
       // Number of fields = 1
-      DCHECK_EQ(instr.fields.size(), 1U);
+      CHECK_EQ(instr.fields.size(), 1U);
       return Instruction::Ret(instr.fields[0]);
     }
     case Opcode::Fatal: {
       // Number of fields = 0
-      DCHECK(instr.fields.empty());
+      CHECK(instr.fields.empty());
       return Instruction::Fatal();
     }
     case Opcode::InvokePacked: {
       // Number of fields = 3 + instr.arity
-      DCHECK_GE(instr.fields.size(), 3U);
-      DCHECK_EQ(instr.fields.size(), 3U + static_cast<size_t>(instr.fields[1]));
+      CHECK_GE(instr.fields.size(), 3U);
+      CHECK_EQ(instr.fields.size(), 3U + static_cast<size_t>(instr.fields[1]));
 
       Index packed_index = instr.fields[0];
       Index arity = instr.fields[1];
@@ -564,44 +611,46 @@ Instruction DeserializeInstruction(const VMInstructionSerializer& instr) {
       return Instruction::InvokePacked(packed_index, arity, output_size, args);
     }
     case Opcode::AllocTensor: {
-      // Number of fields = 6 + instr.alloc_tensor.ndim
-      DCHECK_GE(instr.fields.size(), 6U);
-      DCHECK_EQ(instr.fields.size(), 6U + static_cast<size_t>(instr.fields[4]));
+      // Number of fields = 7 + instr.alloc_tensor.ndim
+      CHECK_GE(instr.fields.size(), 7U);
+      CHECK_EQ(instr.fields.size(), 7U + static_cast<size_t>(instr.fields[5]));
 
       RegName storage_reg = instr.fields[0];
+      Index offset = instr.fields[1];
 
       DLDataType dtype;
-      dtype.code = instr.fields[1];
-      dtype.bits = instr.fields[2];
-      dtype.lanes = instr.fields[3];
+      dtype.code = instr.fields[2];
+      dtype.bits = instr.fields[3];
+      dtype.lanes = instr.fields[4];
 
-      Index ndim = instr.fields[4];
-      RegName dst = instr.fields[5];
+      Index ndim = instr.fields[5];
+      RegName dst = instr.fields[6];
 
-      std::vector<Index> shape = ExtractFields(instr.fields, 6, ndim);
+      std::vector<Index> shape = ExtractFields(instr.fields, 7, ndim);
 
-      return Instruction::AllocTensor(storage_reg, shape, dtype, dst);
+      return Instruction::AllocTensor(storage_reg, offset, shape, dtype, dst);
     }
     case Opcode::AllocTensorReg: {
-      // Number of fields = 5
-      DCHECK_EQ(instr.fields.size(), 6U);
+      // Number of fields = 7
+      CHECK_EQ(instr.fields.size(), 7U);
 
       RegName storage_reg = instr.fields[0];
-      Index shape_register = instr.fields[1];
+      Index offset = instr.fields[1];
+      Index shape_register = instr.fields[2];
 
       DLDataType dtype;
-      dtype.code = instr.fields[2];
-      dtype.bits = instr.fields[3];
-      dtype.lanes = instr.fields[4];
+      dtype.code = instr.fields[3];
+      dtype.bits = instr.fields[4];
+      dtype.lanes = instr.fields[5];
 
-      RegName dst = instr.fields[5];
+      RegName dst = instr.fields[6];
 
-      return Instruction::AllocTensorReg(storage_reg, shape_register, dtype, dst);
+      return Instruction::AllocTensorReg(storage_reg, offset, shape_register, dtype, dst);
     }
     case Opcode::AllocADT: {
       // Number of fields = 3 + instr.num_fields
-      DCHECK_GE(instr.fields.size(), 3U);
-      DCHECK_EQ(instr.fields.size(), 3U + static_cast<size_t>(instr.fields[1]));
+      CHECK_GE(instr.fields.size(), 3U);
+      CHECK_EQ(instr.fields.size(), 3U + static_cast<size_t>(instr.fields[1]));
 
       Index constructor_tag = instr.fields[0];
       Index num_fields = instr.fields[1];
@@ -612,8 +661,8 @@ Instruction DeserializeInstruction(const VMInstructionSerializer& instr) {
     }
     case Opcode::AllocClosure: {
       // Number of fields = 3 + instr.num_freevar
-      DCHECK_GE(instr.fields.size(), 3U);
-      DCHECK_EQ(instr.fields.size(), 3U + static_cast<size_t>(instr.fields[1]));
+      CHECK_GE(instr.fields.size(), 3U);
+      CHECK_EQ(instr.fields.size(), 3U + static_cast<size_t>(instr.fields[1]));
 
       Index clo_index = instr.fields[0];
       Index num_freevar = instr.fields[1];
@@ -623,7 +672,7 @@ Instruction DeserializeInstruction(const VMInstructionSerializer& instr) {
       return Instruction::AllocClosure(clo_index, num_freevar, free_vars, dst);
     }
     case Opcode::AllocStorage: {
-      DCHECK_GE(instr.fields.size(), 6U);
+      CHECK_GE(instr.fields.size(), 6U);
       Index allocation_size = instr.fields[0];
       Index alignment = instr.fields[1];
 
@@ -642,7 +691,7 @@ Instruction DeserializeInstruction(const VMInstructionSerializer& instr) {
     }
     case Opcode::If: {
       // Number of fields = 4
-      DCHECK_EQ(instr.fields.size(), 4U);
+      CHECK_EQ(instr.fields.size(), 4U);
       Index test = instr.fields[0];
       Index target = instr.fields[1];
       Index true_offset = instr.fields[2];
@@ -652,8 +701,8 @@ Instruction DeserializeInstruction(const VMInstructionSerializer& instr) {
     }
     case Opcode::Invoke: {
       // Number of fields = 3 + instr.num_args
-      DCHECK_GE(instr.fields.size(), 3U);
-      DCHECK_EQ(instr.fields.size(), 3U + static_cast<size_t>(instr.fields[1]));
+      CHECK_GE(instr.fields.size(), 3U);
+      CHECK_EQ(instr.fields.size(), 3U + static_cast<size_t>(instr.fields[1]));
 
       Index func_index = instr.fields[0];
       Index num_args = instr.fields[1];
@@ -664,8 +713,8 @@ Instruction DeserializeInstruction(const VMInstructionSerializer& instr) {
     }
     case Opcode::InvokeClosure: {
       // Number of fields = 3 + instr.num_closure_args
-      DCHECK_GE(instr.fields.size(), 3U);
-      DCHECK_EQ(instr.fields.size(), 3U + static_cast<size_t>(instr.fields[1]));
+      CHECK_GE(instr.fields.size(), 3U);
+      CHECK_EQ(instr.fields.size(), 3U + static_cast<size_t>(instr.fields[1]));
 
       Index closure = instr.fields[0];
       Index num_closure_args = instr.fields[1];
@@ -676,27 +725,27 @@ Instruction DeserializeInstruction(const VMInstructionSerializer& instr) {
     }
     case Opcode::LoadConst: {
       // Number of fields = 2
-      DCHECK_EQ(instr.fields.size(), 2U);
+      CHECK_EQ(instr.fields.size(), 2U);
       return Instruction::LoadConst(instr.fields[0], instr.fields[1]);
     }
     case Opcode::LoadConsti: {
       // Number of fields = 2
-      DCHECK_EQ(instr.fields.size(), 2U);
+      CHECK_EQ(instr.fields.size(), 2U);
       return Instruction::LoadConsti(instr.fields[0], instr.fields[1]);
     }
     case Opcode::GetField: {
       // Number of fields = 3
-      DCHECK_EQ(instr.fields.size(), 3U);
+      CHECK_EQ(instr.fields.size(), 3U);
       return Instruction::GetField(instr.fields[0], instr.fields[1], instr.fields[2]);
     }
     case Opcode::GetTag: {
       // Number of fields = 2
-      DCHECK_EQ(instr.fields.size(), 2U);
+      CHECK_EQ(instr.fields.size(), 2U);
       return Instruction::GetTag(instr.fields[0], instr.fields[1]);
     }
     case Opcode::Goto: {
       // Number of fields = 1
-      DCHECK_EQ(instr.fields.size(), 1U);
+      CHECK_EQ(instr.fields.size(), 1U);
       return Instruction::Goto(instr.fields[0]);
     }
     default:
@@ -21,9 +21,12 @@
  * \file tvm/runtime/vm/memory_manager.cc
  * \brief Allocate and manage memory for the runtime.
  */
+#include <tvm/runtime/registry.h>
 #include <utility>
 #include <memory>
+#include <sstream>
 #include "memory_manager.h"
+#include "best_fit_allocator.h"
 #include "naive_allocator.h"
 #include "pooled_allocator.h"
 
@@ -76,8 +79,6 @@ inline size_t GetDataAlignment(const DLTensor& arr) {
 }
 
 NDArray StorageObj::AllocNDArray(size_t offset, std::vector<int64_t> shape, DLDataType dtype) {
-  // TODO(@jroesch): generalize later to non-overlapping allocations.
-  CHECK_EQ(offset, 0u);
   VerifyDataType(dtype);
 
   // crtical zone: allocate header, cannot throw
@@ -87,13 +88,13 @@ NDArray StorageObj::AllocNDArray(size_t offset, std::vector<int64_t> shape, DLDa
   size_t needed_size = GetDataSize(container->dl_tensor);
   this->IncRef();
   container->manager_ctx = reinterpret_cast<void*>(this);
-  container->dl_tensor.data = this->buffer.data;
+  container->dl_tensor.data = static_cast<char*>(this->buffer.data) + offset;
   NDArray ret(GetObjectPtr<Object>(container));
 
   // RAII in effect, now run the check.
-  // TODO(@jroesch): generalize later to non-overlapping allocations.
-  CHECK(needed_size == this->buffer.size)
-    << "size mistmatch required " << needed_size << " found " << this->buffer.size;
+  // Allocators may round the buffer size up, e.g. to a page or a size class.
+  CHECK(offset + needed_size <= this->buffer.size)
+    << "size mistmatch required " << offset + needed_size << " found " << this->buffer.size;
 
   return ret;
 }
@@ -114,6 +115,40 @@ Allocator* MemoryManager::GetAllocator(TVMContext ctx) {
   return allocators_.at(ctx).get();
 }
 
+Allocator* MemoryManager::SetAllocator(TVMContext ctx, AllocatorType type,
+                                       size_t max_cached_bytes) {
+  std::lock_guard<std::mutex> lock(mu_);
+  auto it = allocators_.find(ctx);
+  if (it != allocators_.end()) {
+    if (it->second->type() == type) return it->second.get();
+    CHECK(!it->second->HasLiveBuffers())
+        << "Cannot replace the allocator of " << DeviceName(ctx.device_type) << "("
+        << ctx.device_id << ") while memory is allocated from it";
+  }
+  if (type == kBestFit && ctx.device_type != kDLCPU && ctx.device_type != kDLGPU &&
+      ctx.device_type != kDLCPUPinned && ctx.device_type != kDLROCM) {
+    LOG(WARNING) << "BestFitAllocator needs a flat address space, use the pooled allocator for "
+                 << DeviceName(ctx.device_type);
+    type = kPooled;
+  }
+  std::unique_ptr<Allocator> alloc;
+  switch (type) {
+    case kNaive:
+      alloc.reset(new NaiveAllocator(ctx));
+      break;
+    case kPooled:
+      alloc.reset(new PooledAllocator(ctx));
+      break;
+    case kBestFit:
+      alloc.reset(new BestFitAllocator(ctx, max_cached_bytes));
+      break;
+    default:
+      LOG(FATAL) << "Unknown allocator type " << static_cast<int>(type);
+  }
+  allocators_[ctx] = std::move(alloc);
+  return allocators_.at(ctx).get();
+}
+
 NDArray Allocator::Empty(std::vector<int64_t> shape, DLDataType dtype, DLContext ctx) {
   VerifyDataType(dtype);
   NDArray::Container* container = new NDArray::Container(nullptr, shape, dtype, ctx);
@@ -127,6 +162,37 @@ NDArray Allocator::Empty(std::vector<int64_t> shape, DLDataType dtype, DLContext
   return NDArray(GetObjectPtr<Object>(container));
 }
 
+TVM_REGISTER_GLOBAL("runtime.VMSetAllocator")
+.set_body([](TVMArgs args, TVMRetValue* rv) {
+  TVMContext ctx;
+  ctx.device_type = static_cast<DLDeviceType>(args[0].operator int());
+  ctx.device_id = args[1];
+  int type = args[2];
+  int64_t max_cached_bytes = args[3];
+  CHECK_GE(max_cached_bytes, 0);
+  MemoryManager::Global()->SetAllocator(
+      ctx, static_cast<AllocatorType>(type), static_cast<size_t>(max_cached_bytes));
+});
+
+TVM_REGISTER_GLOBAL("runtime.VMGetAllocatorStats")
+.set_body([](TVMArgs args, TVMRetValue* rv) {
+  TVMContext ctx;
+  ctx.device_type = static_cast<DLDeviceType>(args[0].operator int());
+  ctx.device_id = args[1];
+  Allocator* alloc = MemoryManager::Global()->GetAllocator(ctx);
+  AllocatorStats stats = alloc->Stats();
+  std::ostringstream os;
+  os << "{\"type\": " << static_cast<int>(alloc->type())
+     << ", \"requested_bytes\": " << stats.requested_bytes
+     << ", \"allocated_bytes\": " << stats.allocated_bytes
+     << ", \"reserved_bytes\": " << stats.reserved_bytes
+     << ", \"peak_reserved_bytes\": " << stats.peak_reserved_bytes
+     << ", \"largest_free_block\": " << stats.largest_free_block
+     << ", \"num_allocs\": " << stats.num_allocs
+     << ", \"num_hits\": " << stats.num_hits << "}";
+  *rv = os.str();
+});
+
 }  // namespace vm
 }  // namespace runtime
 }  // namespace tvm
@@ -63,9 +63,34 @@ struct Buffer {
   TVMContext ctx;
 };
 
+/*! \brief The kinds of allocators. */
+enum AllocatorType {
+  kNaive = 1,
+  kPooled,
+  kBestFit,
+};
+
+/*! \brief Statistics collected by an allocator. */
+struct AllocatorStats {
+  /*! \brief Bytes requested by the live allocations. */
+  size_t requested_bytes{0};
+  /*! \brief Bytes of the blocks serving the live allocations. */
+  size_t allocated_bytes{0};
+  /*! \brief Bytes obtained from the device, allocated or cached. */
+  size_t reserved_bytes{0};
+  /*! \brief The peak of reserved_bytes. */
+  size_t peak_reserved_bytes{0};
+  /*! \brief The largest cached free block. */
+  size_t largest_free_block{0};
+  /*! \brief Number of allocations. */
+  size_t num_allocs{0};
+  /*! \brief Number of allocations served without allocating from the device. */
+  size_t num_hits{0};
+};
+
 class Allocator {
  public:
-  Allocator() {}
+  explicit Allocator(AllocatorType type) : type_(type) {}
 
   /*! \brief Allocate an empty NDArray using from the allocator.
    *  \param shape The shape of the NDArray.
@@ -91,14 +116,45 @@ class Allocator {
    *  \return The amount of memory currently allocated.
    */
   virtual size_t UsedMemory() const = 0;
+  /*! \return Whether buffers allocated from the allocator have not been freed. */
+  virtual bool HasLiveBuffers() const { return UsedMemory() != 0; }
+  /*! \brief The statistics of the allocator.
+   *  \return The statistics, only the memory usage is reported by default.
+   */
+  virtual AllocatorStats Stats() const {
+    AllocatorStats stats;
+    stats.reserved_bytes = UsedMemory();
+    return stats;
+  }
+  /*! \return The kind of the allocator. */
+  AllocatorType type() const { return type_; }
   virtual ~Allocator() = default;
+
+ private:
+  AllocatorType type_;
 };
 
 class MemoryManager {
  public:
   static MemoryManager* Global();
 
+  /*! \brief Get the allocator of a context, creating a naive one on first use.
+   *  \param ctx The context.
+   *  \return The allocator.
+   */
   Allocator* GetAllocator(TVMContext ctx);
+  /*! \brief Create the allocator of a context.
+   *
+   *  Buffers are returned to the current allocator of their context, so the
+   *  allocator can only be replaced while no memory is allocated from it.
+   *
+   *  \param ctx The context.
+   *  \param type The kind of allocator.
+   *  \param max_cached_bytes Free memory kept by the allocator before returning
+   *   it to the device, 0 for no limit. Only used by the best-fit allocator.
+   *  \return The allocator.
+   */
+  Allocator* SetAllocator(TVMContext ctx, AllocatorType type, size_t max_cached_bytes = 0);
 
  private:
   MemoryManager() {}
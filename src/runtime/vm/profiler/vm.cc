@@ -85,10 +85,16 @@ PackedFunc VirtualMachineDebug::GetFunction(
          << "Total Packed Functions: " << total_packed_funcs << std::endl;
       *rv = os.str();
     });
+  } else if (name == "get_profile") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      *rv = profiler_ != nullptr ? profiler_->ToJSON() : OpProfiler(false).ToJSON();
+    });
   } else if (name == "reset") {
     return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
       op_durations_.clear();
       op_invokes_.clear();
+      // The counters are reopened for the threads started since.
+      profiler_.reset();
     });
   } else {
     return VirtualMachine::GetFunction(name, sptr_to_self);
@@ -114,10 +120,21 @@ void VirtualMachineDebug::InvokePacked(Index packed_index,
   VirtualMachine::InvokePacked(packed_index, func, arg_count, output_size, args);
   TVMSynchronize(ctx.device_type, ctx.device_id, nullptr);
 
+  if (profiler_ == nullptr) {
+    profiler_.reset(new OpProfiler());
+  }
+  int64_t bytes = 0;
+  for (Index i = 0; i < arg_count; ++i) {
+    bytes += GetArgBytes(args[i]);
+  }
+  profiler_->Begin();
   auto op_begin = std::chrono::high_resolution_clock::now();
   VirtualMachine::InvokePacked(packed_index, func, arg_count, output_size, args);
   TVMSynchronize(ctx.device_type, ctx.device_id, nullptr);
   auto op_end = std::chrono::high_resolution_clock::now();
+  // The executable does not keep the lowered functions to estimate the
+  // flops, so the VM report has none.
+  profiler_->End(packed_index_map_[packed_index], bytes);
   double op_duration =
       std::chrono::duration_cast<std::chrono::duration<double> >(op_end -
                                                                  op_begin)
@@ -32,6 +32,8 @@
 #include <unordered_map>
 #include <vector>
 
+#include "../../profiling.h"
+
 namespace tvm {
 namespace runtime {
 namespace vm {
@@ -54,6 +56,7 @@ class VirtualMachineDebug : public VirtualMachine {
   std::unordered_map<Index, std::string> packed_index_map_;
   std::unordered_map<Index, std::vector<double>> op_durations_;
   std::unordered_map<Index, int> op_invokes_;
+  std::unique_ptr<OpProfiler> profiler_;
 };
 
 }  // namespace vm
@@ -39,6 +39,13 @@ namespace vm {
 /*! \brief The magic number for the serialized VM bytecode file  */
 constexpr uint64_t kTVMVMBytecodeMagic = 0xD225DE2F4214151D;
 
+/*!
+ * \brief The version of the layout of the serialized VM bytecode, bumped on
+ *  any change of the instruction fields. Version 2 adds the offset of
+ *  AllocTensor and AllocTensorReg.
+ */
+constexpr uint64_t kTVMVMBytecodeVersion = 2;
+
 template <typename T>
 static inline size_t VectorHash(size_t key, const std::vector<T>& values) {
   for (const auto& it : values) {
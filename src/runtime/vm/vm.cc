@@ -86,6 +86,7 @@ Instruction::Instruction(const Instruction& instr) {
       return;
     case Opcode::AllocTensor:
       this->alloc_tensor.storage = instr.alloc_tensor.storage;
+      this->alloc_tensor.offset = instr.alloc_tensor.offset;
       this->alloc_tensor.ndim = instr.alloc_tensor.ndim;
       this->alloc_tensor.shape = Duplicate<int64_t>(instr.alloc_tensor.shape,
                                                     instr.alloc_tensor.ndim);
@@ -93,6 +94,7 @@ Instruction::Instruction(const Instruction& instr) {
       return;
     case Opcode::AllocTensorReg:
       this->alloc_tensor_reg.storage = instr.alloc_tensor_reg.storage;
+      this->alloc_tensor_reg.offset = instr.alloc_tensor_reg.offset;
       this->alloc_tensor_reg.shape_register = instr.alloc_tensor_reg.shape_register;
       this->alloc_tensor_reg.dtype = instr.alloc_tensor_reg.dtype;
       return;
@@ -176,6 +178,7 @@ Instruction& Instruction::operator=(const Instruction& instr) {
       return *this;
     case Opcode::AllocTensor:
       this->alloc_tensor.storage = instr.alloc_tensor.storage;
+      this->alloc_tensor.offset = instr.alloc_tensor.offset;
       this->alloc_tensor.ndim = instr.alloc_tensor.ndim;
       this->alloc_tensor.shape = Duplicate<int64_t>(instr.alloc_tensor.shape,
                                                     instr.alloc_tensor.ndim);
@@ -183,6 +186,7 @@ Instruction& Instruction::operator=(const Instruction& instr) {
       return *this;
     case Opcode::AllocTensorReg:
       this->alloc_tensor_reg.storage = instr.alloc_tensor_reg.storage;
+      this->alloc_tensor_reg.offset = instr.alloc_tensor_reg.offset;
       this->alloc_tensor_reg.shape_register = instr.alloc_tensor_reg.shape_register;
       this->alloc_tensor_reg.dtype = instr.alloc_tensor_reg.dtype;
       return *this;
@@ -312,12 +316,14 @@ Instruction Instruction::InvokePacked(Index packed_index,
 
 Instruction Instruction::AllocTensor(
   RegName storage,
+  Index offset,
   const std::vector<int64_t>& shape,
   DLDataType dtype, Index dst) {
   Instruction instr;
   instr.op = Opcode::AllocTensor;
   instr.dst = dst;
   instr.alloc_tensor.storage = storage;
+  instr.alloc_tensor.offset = offset;
   instr.alloc_tensor.ndim = shape.size();
   instr.alloc_tensor.shape = new int64_t[shape.size()];
   for (size_t i = 0; i < shape.size(); ++i) {
@@ -329,12 +335,14 @@ Instruction Instruction::AllocTensor(
 
 Instruction Instruction::AllocTensorReg(
   RegName storage,
+  Index offset,
   RegName shape_register,
   DLDataType dtype, Index dst) {
   Instruction instr;
   instr.op = Opcode::AllocTensorReg;
   instr.dst = dst;
   instr.alloc_tensor_reg.storage = storage;
+  instr.alloc_tensor_reg.offset = offset;
   instr.alloc_tensor_reg.shape_register = shape_register;
   instr.alloc_tensor_reg.dtype = dtype;
   return instr;
@@ -525,7 +533,8 @@ void InstructionPrint(std::ostream& os, const Instruction& instr) {
     }
     case Opcode::AllocTensor: {
       os << "alloc_tensor $" << instr.dst << " $"
-         << instr.alloc_tensor.storage << " ["
+         << instr.alloc_tensor.storage << " "
+         << instr.alloc_tensor.offset << " ["
          << StrJoin<int64_t>(instr.alloc_tensor.shape, 0,
                              instr.alloc_tensor.ndim)
          << "] ";
@@ -534,7 +543,8 @@ void InstructionPrint(std::ostream& os, const Instruction& instr) {
     }
     case Opcode::AllocTensorReg: {
       os << "alloc_tensor_reg $" << instr.dst << " $"
-         << instr.alloc_tensor_reg.storage << " $"
+         << instr.alloc_tensor_reg.storage << " "
+         << instr.alloc_tensor_reg.offset << " $"
          << instr.alloc_tensor_reg.shape_register << " ";
       DLDatatypePrint(os, instr.alloc_tensor_reg.dtype);
       break;
@@ -619,6 +629,48 @@ std::ostream& operator<<(std::ostream& os, const VMFunction& vm_func) {
   return os;
 }
 
+// Dispatch with computed goto where labels as values are supported, so each
+// handler jumps to the next one directly instead of through the switch.
+#if (defined(__GNUC__) || defined(__clang__)) && !USE_RELAY_DEBUG
+#define TVM_VM_COMPUTED_GOTO 1
+#else
+#define TVM_VM_COMPUTED_GOTO 0
+#endif
+
+/*!
+ * \brief The keys the dispatch loop switches on. The opcodes are keys
+ *  themselves, superinstructions are numbered after them.
+ */
+enum DispatchKey : uint8_t {
+  /*!
+   * \brief AllocStorage immediately followed by an AllocTensor out of the
+   *  allocated storage, executed without re-reading the storage register.
+   */
+  kAllocStorageTensor = static_cast<uint8_t>(Opcode::AllocStorage) + 1,
+  kNumDispatchKeys
+};
+
+/*!
+ * \brief Pre-decode the dispatch keys of a function, fusing common
+ *  instruction sequences into superinstructions.
+ *
+ *  Only the key of the first instruction of a sequence is replaced, so a
+ *  jump into the middle of a sequence still executes the plain instruction.
+ */
+std::vector<uint8_t> DecodeDispatchKeys(const VMFunction& func) {
+  const auto& code = func.instructions;
+  std::vector<uint8_t> keys(code.size());
+  for (size_t i = 0; i < code.size(); ++i) {
+    keys[i] = static_cast<uint8_t>(code[i].op);
+    if (code[i].op == Opcode::AllocStorage && i + 1 < code.size() &&
+        code[i + 1].op == Opcode::AllocTensor &&
+        code[i + 1].alloc_tensor.storage == code[i].dst) {
+      keys[i] = kAllocStorageTensor;
+    }
+  }
+  return keys;
+}
+
 inline ObjectRef CopyTo(ObjectRef src, const DLContext& ctx) {
   if (src->IsInstance<NDArray::ContainerType>()) {
     auto nd_array = Downcast<NDArray>(src);
@@ -638,7 +690,7 @@ PackedFunc VirtualMachine::GetFunction(const std::string& name,
       auto git = exec_->global_map.find(func_name);
       CHECK(git != exec_->global_map.end())
         << "Cannot find function " << func_name << " in the executable";
-      auto func = exec_->functions[git->second];
+      const auto& func = exec_->functions[git->second];
       if (func.params.empty()) {
         *rv = Invoke(func, {});
       } else {
@@ -712,13 +764,17 @@ Index VirtualMachine::PopFrame() {
   const VMFrame& fr = frames_.back();
   func_index_ = fr.func_index;
   code_ = fr.code;
+  if (static_cast<size_t>(func_index_) < dispatch_tables_.size()) {
+    dispatch_ = dispatch_tables_[func_index_].data();
+  }
   pc_ = fr.pc;
   auto call_stack_size = frames_.size();
   frames_.pop_back();
   return call_stack_size;
 }
 
-void VirtualMachine::InvokeGlobal(const VMFunction& func, const std::vector<ObjectRef>& args) {
+void VirtualMachine::InvokeGlobal(Index func_index, const std::vector<ObjectRef>& args) {
+  const VMFunction& func = exec_->functions[func_index];
   DLOG(INFO) << "Invoking global " << func.name << " " << args.size();
 
   PushFrame(func.params.size(), this->pc_ + 1, func);
@@ -727,14 +783,19 @@ void VirtualMachine::InvokeGlobal(const VMFunction& func, const std::vector<Obje
   }
   DLOG(INFO) << "func.params= " << func.params.size();
 
+  func_index_ = func_index;
   code_ = func.instructions.data();
+  dispatch_ = dispatch_tables_[func_index].data();
   pc_ = 0;
 }
 
 ObjectRef VirtualMachine::Invoke(const VMFunction& func, const std::vector<ObjectRef>& args) {
   DLOG(INFO) << "Executing Function: " << std::endl << func;
 
-  InvokeGlobal(func, args);
+  auto it = exec_->global_map.find(func.name);
+  CHECK(it != exec_->global_map.end())
+    << "Cannot find function " << func.name << " in the executable";
+  InvokeGlobal(it->second, args);
   RunLoop();
   // TODO(wweic) ctx could be obtained from the ctxs list.
   auto alloc = MemoryManager::Global()->GetAllocator(ctxs_[0]);
@@ -804,6 +865,11 @@ void VirtualMachine::LoadExecutable(const Executable* exec) {
     CHECK(pf != nullptr) << "Cannot find function in module: " << packed_name;
     packed_funcs_[packed_index] = pf;
   }
+
+  dispatch_tables_.clear();
+  for (const auto& func : exec_->functions) {
+    dispatch_tables_.push_back(DecodeDispatchKeys(func));
+  }
 }
 
 
@@ -815,7 +881,7 @@ inline void VirtualMachine::WriteRegister(Index r, const ObjectRef& val) {
   frames_.back().register_file[r] = val;
 }
 
-inline ObjectRef VirtualMachine::ReadRegister(Index r) const {
+inline const ObjectRef& VirtualMachine::ReadRegister(Index r) const {
   return frames_.back().register_file[r];
 }
 
@@ -838,28 +904,51 @@ inline int32_t VirtualMachine::LoadScalarInt(Index r) const {
 void VirtualMachine::RunLoop() {
   CHECK(this->exec_);
   CHECK(this->code_);
+  CHECK(this->dispatch_);
   pc_ = 0;
   Index frame_start = frames_.size();
+
+#if TVM_VM_COMPUTED_GOTO
+  // Indexed by dispatch key, must follow the order of Opcode and DispatchKey.
+  static const void* dispatch_labels[kNumDispatchKeys] = {
+    &&op_Move, &&op_Ret, &&op_Invoke, &&op_InvokeClosure, &&op_InvokePacked,
+    &&op_AllocTensor, &&op_AllocTensorReg, &&op_AllocADT, &&op_AllocClosure,
+    &&op_GetField, &&op_If, &&op_LoadConst, &&op_Goto, &&op_GetTag,
+    &&op_LoadConsti, &&op_Fatal, &&op_AllocStorage, &&op_AllocStorageTensor,
+  };
+#define VM_CASE(key, label) case key: label:
+#define VM_DISPATCH() goto *dispatch_labels[dispatch_[pc_]]
+#else
+#define VM_CASE(key, label) case key:
+#define VM_DISPATCH() goto main_loop
+#endif  // TVM_VM_COMPUTED_GOTO
+#define VM_OPCODE(name) VM_CASE(static_cast<uint8_t>(Opcode::name), op_##name)
+
   while (true) {
+#if !TVM_VM_COMPUTED_GOTO
   main_loop:
-    auto const& instr = code_[this->pc_];
-    DLOG(INFO) << "Executing(" << pc_ << "): " << instr;
+#endif  // !TVM_VM_COMPUTED_GOTO
+    DLOG(INFO) << "Executing(" << pc_ << "): " << code_[this->pc_];
 #if USE_RELAY_DEBUG
-    InstructionPrint(std::cout, instr);
+    InstructionPrint(std::cout, code_[this->pc_]);
 #endif  // USE_RELAY_DEBUG
 
-    switch (instr.op) {
-      case Opcode::Move: {
+    switch (dispatch_[this->pc_]) {
+      VM_OPCODE(Move) {
+        auto const& instr = code_[this->pc_];
         ObjectRef from_obj;
         from_obj = ReadRegister(instr.from);
         WriteRegister(instr.dst, from_obj);
         pc_++;
-        goto main_loop;
+        VM_DISPATCH();
       }
-      case Opcode::Fatal: {
+      VM_OPCODE(Fatal) {
         throw std::runtime_error("VM encountered fatal error");
       }
-      case Opcode::LoadConst: {
+      VM_OPCODE(LoadConst) {
+        auto const& instr = code_[this->pc_];
+        CHECK_LT(static_cast<size_t>(instr.const_index), exec_->constants.size())
+            << "The constants are not loaded, see Executable::LoadConstants";
         auto constant_obj = exec_->constants[instr.const_index];
         // We cache the allocated object in the constant pool. To measure, the
         // first iteration will set the pool up. The other iterations will
@@ -874,25 +963,28 @@ void VirtualMachine::RunLoop() {
         }
         WriteRegister(instr.dst, const_pool_[instr.const_index]);
         pc_++;
-        goto main_loop;
+        VM_DISPATCH();
       }
-      case Opcode::LoadConsti: {
+      VM_OPCODE(LoadConsti) {
+        auto const& instr = code_[this->pc_];
         auto tensor = NDArray::Empty({1}, {kDLInt, 64, 1}, {kDLCPU, 0});
         reinterpret_cast<int64_t*>(tensor->data)[0] = instr.load_consti.val;
         WriteRegister(instr.dst, tensor);
         pc_++;
-        goto main_loop;
+        VM_DISPATCH();
       }
-      case Opcode::Invoke: {
+      VM_OPCODE(Invoke) {
+        auto const& instr = code_[this->pc_];
         std::vector<ObjectRef> args;
         for (Index i = 0; i < instr.num_args; ++i) {
           args.push_back(ReadRegister(instr.invoke_args_registers[i]));
         }
-        InvokeGlobal(exec_->functions[instr.func_index], args);
+        InvokeGlobal(instr.func_index, args);
         frames_.back().caller_return_register = instr.dst;
-        goto main_loop;
+        VM_DISPATCH();
       }
-      case Opcode::InvokePacked: {
+      VM_OPCODE(InvokePacked) {
+        auto const& instr = code_[this->pc_];
         DLOG(INFO) << "InvokedPacked " << "arity=" << instr.arity;
         const auto& func = packed_funcs_[instr.packed_index];
         const auto& arity = instr.arity;
@@ -908,9 +1000,10 @@ void VirtualMachine::RunLoop() {
         // through the registers mutably.
         InvokePacked(instr.packed_index, func, arity, instr.output_size, args);
         pc_++;
-        goto main_loop;
+        VM_DISPATCH();
       }
-      case Opcode::InvokeClosure: {
+      VM_OPCODE(InvokeClosure) {
+        auto const& instr = code_[this->pc_];
         auto object = ReadRegister(instr.closure);
         const auto* closure = object.as<VMClosureObj>();
 
@@ -921,19 +1014,21 @@ void VirtualMachine::RunLoop() {
         for (Index i = 0; i < instr.num_closure_args; ++i) {
           args.push_back(ReadRegister(instr.closure_args[i]));
         }
-        InvokeGlobal(exec_->functions[closure->func_index], args);
+        InvokeGlobal(closure->func_index, args);
         frames_.back().caller_return_register = instr.dst;
-        goto main_loop;
+        VM_DISPATCH();
       }
-      case Opcode::GetField: {
+      VM_OPCODE(GetField) {
+        auto const& instr = code_[this->pc_];
         auto object = ReadRegister(instr.object);
         const auto& tuple = Downcast<ADT>(object);
         auto field = tuple[instr.field_index];
         WriteRegister(instr.dst, field);
         pc_++;
-        goto main_loop;
+        VM_DISPATCH();
       }
-      case Opcode::GetTag: {
+      VM_OPCODE(GetTag) {
+        auto const& instr = code_[this->pc_];
         auto object = ReadRegister(instr.get_tag.object);
         const auto& adt = Downcast<ADT>(object);
         auto tag = adt.tag();
@@ -941,13 +1036,15 @@ void VirtualMachine::RunLoop() {
         reinterpret_cast<int32_t*>(tag_tensor->data)[0] = tag;
         WriteRegister(instr.dst, tag_tensor);
         pc_++;
-        goto main_loop;
+        VM_DISPATCH();
       }
-      case Opcode::Goto: {
+      VM_OPCODE(Goto) {
+        auto const& instr = code_[this->pc_];
         pc_ += instr.pc_offset;
-        goto main_loop;
+        VM_DISPATCH();
       }
-      case Opcode::If: {
+      VM_OPCODE(If) {
+        auto const& instr = code_[this->pc_];
         int32_t test_val = LoadScalarInt(instr.if_op.test);
         int32_t target_val = LoadScalarInt(instr.if_op.target);
 
@@ -959,9 +1056,10 @@ void VirtualMachine::RunLoop() {
           pc_ += instr.if_op.false_offset;
         }
 
-        goto main_loop;
+        VM_DISPATCH();
       }
-      case Opcode::AllocTensor: {
+      VM_OPCODE(AllocTensor) {
+        auto const& instr = code_[this->pc_];
         auto shape = std::vector<int64_t>(instr.alloc_tensor.ndim);
 
         for (uint32_t i = 0; i < instr.alloc_tensor.ndim; ++i) {
@@ -970,13 +1068,15 @@ void VirtualMachine::RunLoop() {
 
         auto storage_obj = ReadRegister(instr.alloc_tensor.storage);
         auto storage = Downcast<Storage>(storage_obj);
-        auto obj = storage->AllocNDArray(0, shape, instr.alloc_tensor.dtype);
+        auto obj = storage->AllocNDArray(instr.alloc_tensor.offset, shape,
+                                           instr.alloc_tensor.dtype);
 
         WriteRegister(instr.dst, obj);
         pc_++;
-        goto main_loop;
+        VM_DISPATCH();
       }
-      case Opcode::AllocTensorReg: {
+      VM_OPCODE(AllocTensorReg) {
+        auto const& instr = code_[this->pc_];
         DLContext cpu_ctx;
         cpu_ctx.device_type = kDLCPU;
         cpu_ctx.device_id = 0;
@@ -993,13 +1093,15 @@ void VirtualMachine::RunLoop() {
 
         auto storage_obj = ReadRegister(instr.alloc_tensor_reg.storage);
         auto storage = Downcast<Storage>(storage_obj);
-        auto obj = storage->AllocNDArray(0, shape, instr.alloc_tensor_reg.dtype);
+        auto obj = storage->AllocNDArray(instr.alloc_tensor_reg.offset, shape,
+                                           instr.alloc_tensor_reg.dtype);
 
         WriteRegister(instr.dst, obj);
         pc_++;
-        goto main_loop;
+        VM_DISPATCH();
       }
-      case Opcode::AllocADT: {
+      VM_OPCODE(AllocADT) {
+        auto const& instr = code_[this->pc_];
         std::vector<ObjectRef> fields;
         for (Index i = 0; i < instr.num_fields; ++i) {
           fields.push_back(ReadRegister(instr.datatype_fields[i]));
@@ -1007,18 +1109,20 @@ void VirtualMachine::RunLoop() {
         ObjectRef obj = ADT(instr.constructor_tag, fields);
         WriteRegister(instr.dst, obj);
         pc_++;
-        goto main_loop;
+        VM_DISPATCH();
       }
-      case Opcode::AllocClosure: {
+      VM_OPCODE(AllocClosure) {
+        auto const& instr = code_[this->pc_];
         std::vector<ObjectRef> free_vars;
         for (Index i = 0; i < instr.num_freevar; i++) {
           free_vars.push_back(ReadRegister(instr.free_vars[i]));
         }
         WriteRegister(instr.dst, VMClosure(instr.func_index, free_vars));
         pc_++;
-        goto main_loop;
+        VM_DISPATCH();
       }
-      case Opcode::AllocStorage: {
+      VM_OPCODE(AllocStorage) {
+        auto const& instr = code_[this->pc_];
         auto size = LoadScalarInt(instr.alloc_storage.allocation_size);
         auto alignment = LoadScalarInt(instr.alloc_storage.alignment);
 
@@ -1030,9 +1134,10 @@ void VirtualMachine::RunLoop() {
         auto storage = make_storage(size, alignment, instr.alloc_storage.dtype_hint, ctxs_[0]);
         WriteRegister(instr.dst, storage);
         pc_++;
-        goto main_loop;
+        VM_DISPATCH();
       }
-      case Opcode::Ret: {
+      VM_OPCODE(Ret) {
+        auto const& instr = code_[this->pc_];
         // If we have hit the point from which we started
         // running, we should return to the caller breaking
         // the dispatch loop.
@@ -1044,11 +1149,32 @@ void VirtualMachine::RunLoop() {
           // Otherwise we are just returning from a local call.
         } else {
           WriteRegister(caller_return_register, return_register_);
-          goto main_loop;
+          VM_DISPATCH();
         }
       }
+      VM_CASE(kAllocStorageTensor, op_AllocStorageTensor) {
+        auto const& instr = code_[this->pc_];
+        auto size = LoadScalarInt(instr.alloc_storage.allocation_size);
+        auto alignment = LoadScalarInt(instr.alloc_storage.alignment);
+        auto storage = make_storage(size, alignment, instr.alloc_storage.dtype_hint, ctxs_[0]);
+        WriteRegister(instr.dst, storage);
+
+        auto const& tensor_instr = code_[this->pc_ + 1];
+        std::vector<int64_t> shape(tensor_instr.alloc_tensor.shape,
+                                   tensor_instr.alloc_tensor.shape + tensor_instr.alloc_tensor.ndim);
+        auto obj = storage->AllocNDArray(tensor_instr.alloc_tensor.offset, shape,
+                                         tensor_instr.alloc_tensor.dtype);
+        WriteRegister(tensor_instr.dst, obj);
+        pc_ += 2;
+        VM_DISPATCH();
+      }
+      default:
+        LOG(FATAL) << "Unknown dispatch key " << static_cast<int>(dispatch_[this->pc_]);
     }
   }
+#undef VM_OPCODE
+#undef VM_DISPATCH
+#undef VM_CASE
 }
 
 runtime::Module CreateVirtualMachine(const Executable* exec) {
@@ -108,7 +108,8 @@ void ParseLLVMTargetOptions(const std::string& target_str,
       } else {
         LOG(FATAL) << "invalid -mfloat-abi option " << value;
       }
-    } else if (key == "-device" || key == "-libs" || key == "-model") {
+    } else if (key == "-device" || key == "-libs" || key == "-model" ||
+               key == "-codegen-threads") {
       // pass
     } else {
       LOG(FATAL) << "unknown option " << key;
@@ -137,6 +138,25 @@ void ParseLLVMTargetOptions(const std::string& target_str,
 }
 
 
+int GetLLVMCodegenThreads(const std::string& target_str) {
+  std::string key, value;
+  std::istringstream is(target_str);
+  while (is >> key) {
+    size_t pos = key.find('=');
+    if (pos != std::string::npos) {
+      value = key.substr(pos + 1);
+      key = key.substr(0, pos);
+    } else if (key == "-codegen-threads") {
+      CHECK(is >> value)
+          << "Unspecified value for option " << key;
+    }
+    if (key == "-codegen-threads") {
+      return std::stoi(value);
+    }
+  }
+  return 1;
+}
+
 std::unique_ptr<llvm::TargetMachine>
 GetLLVMTargetMachine(const std::string& target_str,
                      bool allow_null) {
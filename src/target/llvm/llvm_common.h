@@ -28,6 +28,7 @@
 #include <llvm/ExecutionEngine/MCJIT.h>
 
 #include <llvm/Analysis/TargetTransformInfo.h>
+#include <llvm/Bitcode/BitcodeReader.h>
 #include <llvm/Bitcode/BitcodeWriter.h>
 #include <llvm/Support/SourceMgr.h>
 
@@ -103,6 +104,13 @@ void ParseLLVMTargetOptions(const std::string& target_str,
                             std::string* mattr,
                             llvm::TargetOptions* options);
 
+/*!
+ * \brief Get the number of threads that generate the code of a module.
+ * \param target_str Target string, in format "llvm -codegen-threads=xxx"
+ * \return The value of -codegen-threads, 0 for all the cores, 1 if it is not given.
+ */
+int GetLLVMCodegenThreads(const std::string& target_str);
+
 /*!
  * \brief Get target machine from target_str string.
  * \param target_str Target string, in format "llvm -target=xxx -mcpu=xxx"
@@ -27,7 +27,12 @@
 #include <tvm/runtime/registry.h>
 #include <tvm/ir/module.h>
 #include <tvm/target/codegen.h>
+#include <tvm/tir/stmt_functor.h>
+#include <algorithm>
+#include <atomic>
+#include <functional>
 #include <mutex>
+#include <thread>
 #include "llvm_common.h"
 #include "codegen_llvm.h"
 #include "codegen_blob.h"
@@ -41,6 +46,75 @@ using runtime::TVMArgs;
 using runtime::TVMRetValue;
 using runtime::PackedFunc;
 
+// Emit the object code of a copy of the module, as code generation changes it.
+static void EmitObjectFile(const llvm::Module& module,
+                           llvm::TargetMachine* tm,
+                           llvm::raw_pwrite_stream& dest) {
+#if TVM_LLVM_VERSION <= 60
+  std::unique_ptr<llvm::Module> m = llvm::CloneModule(&module);
+#else
+  std::unique_ptr<llvm::Module> m = llvm::CloneModule(module);
+#endif
+  llvm::legacy::PassManager pass;
+  CHECK(tm);
+#if TVM_LLVM_VERSION <= 60
+  CHECK(tm->addPassesToEmitFile(
+      pass, dest, llvm::TargetMachine::CGFT_ObjectFile) == 0)
+      << "Cannot emit target CGFT_ObjectFile";
+#elif TVM_LLVM_VERSION <= 90
+  CHECK(tm->addPassesToEmitFile(
+      pass, dest, nullptr, llvm::TargetMachine::CGFT_ObjectFile) == 0)
+      << "Cannot emit target CGFT_ObjectFile";
+#else
+  CHECK(tm->addPassesToEmitFile(
+      pass, dest, nullptr, llvm::CGFT_ObjectFile) == 0)
+      << "Cannot emit target CGFT_ObjectFile";
+#endif
+  pass.run(*m);
+}
+
+// Add the flags that record the target of a generated module.
+static void AddTargetFlags(llvm::Module* module,
+                           llvm::TargetMachine* tm,
+                           const std::string& target) {
+  module->addModuleFlag(llvm::Module::Warning, "tvm_target",
+                        llvm::MDString::get(module->getContext(), target));
+  module->addModuleFlag(llvm::Module::Override, "Debug Info Version",
+                        llvm::DEBUG_METADATA_VERSION);
+
+  if (tm->getTargetTriple().isOSDarwin()) {
+    module->addModuleFlag(llvm::Module::Override, "Dwarf Version", 2);
+  }
+}
+
+// Run the jobs on at most num_threads threads, the errors are raised on the calling thread.
+static void ParallelRun(size_t num_jobs, int num_threads,
+                        const std::function<void(size_t)>& job) {
+  std::vector<std::string> errors(num_jobs);
+  std::atomic<size_t> next{0};
+  auto worker = [&]() {
+    for (size_t i = next++; i < num_jobs; i = next++) {
+      try {
+        job(i);
+      } catch (const dmlc::Error& e) {
+        errors[i] = e.what();
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  size_t num_workers = std::min(static_cast<size_t>(num_threads), num_jobs);
+  for (size_t i = 1; i < num_workers; ++i) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (const std::string& error : errors) {
+    CHECK(error.empty()) << error;
+  }
+}
+
 class LLVMModuleNode final : public runtime::ModuleNode {
  public:
   ~LLVMModuleNode() {
@@ -69,6 +143,10 @@ class LLVMModuleNode final : public runtime::ModuleNode {
       return PackedFunc([target_triple](TVMArgs args, TVMRetValue *rv) {
         *rv = target_triple;
       });
+    } else if (name == "_save_objects") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue *rv) {
+        *rv = SaveObjects(args[0]);
+      });
     }
     if (ee_ == nullptr) LazyInitJIT();
 
@@ -96,27 +174,7 @@ class LLVMModuleNode final : public runtime::ModuleNode {
     CHECK_EQ(ecode.value(), 0) << "Cannot open file: " << file_name
                                << " " << ecode.message();
     if (fmt == "o" || fmt == "obj") {
-#if TVM_LLVM_VERSION <= 60
-      std::unique_ptr<llvm::Module> m = llvm::CloneModule(mptr_);
-#else
-      std::unique_ptr<llvm::Module> m = llvm::CloneModule(*mptr_);
-#endif
-      llvm::legacy::PassManager pass;
-      CHECK(tm_);
-#if TVM_LLVM_VERSION <= 60
-      CHECK(tm_->addPassesToEmitFile(
-          pass, dest, llvm::TargetMachine::CGFT_ObjectFile) == 0)
-          << "Cannot emit target CGFT_ObjectFile";
-#elif TVM_LLVM_VERSION <= 90
-      CHECK(tm_->addPassesToEmitFile(
-          pass, dest, nullptr, llvm::TargetMachine::CGFT_ObjectFile) == 0)
-          << "Cannot emit target CGFT_ObjectFile";
-#else
-      CHECK(tm_->addPassesToEmitFile(
-          pass, dest, nullptr, llvm::CGFT_ObjectFile) == 0)
-          << "Cannot emit target CGFT_ObjectFile";
-#endif
-      pass.run(*m);
+      EmitObjectFile(*mptr_, tm_.get(), dest);
     } else if (fmt == "s" || fmt == "asm") {
 #if TVM_LLVM_VERSION <= 60
       std::unique_ptr<llvm::Module> m = llvm::CloneModule(mptr_);
@@ -205,7 +263,6 @@ class LLVMModuleNode final : public runtime::ModuleNode {
     tm_ = GetLLVMTargetMachine(target);
     bool system_lib = (target.find("-system-lib") != std::string::npos);
     ctx_ = std::make_shared<llvm::LLVMContext>();
-    std::unique_ptr<CodeGenLLVM> cg = CodeGenLLVM::Create(tm_.get());
 
     std::vector<PrimFunc> funcs;
     std::string entry_func;
@@ -221,25 +278,28 @@ class LLVMModuleNode final : public runtime::ModuleNode {
       funcs.push_back(f);
     }
     CHECK_NE(funcs.size(), 0U);
-    // TODO(tqchen): remove the entry function behavior as it does not
-    // makes sense when we start to use multiple modules.
-    cg->Init("TVMMod", tm_.get(), ctx_.get(), system_lib, system_lib);
-
-    for (const auto& f : funcs) {
-      cg->AddFunction(f);
+    int num_threads = GetLLVMCodegenThreads(target);
+    if (num_threads <= 0) {
+      num_threads = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
     }
+    if (num_threads > 1 && funcs.size() > 1) {
+      module_ = ParallelCodegen(funcs, entry_func, target, system_lib, num_threads);
+    } else {
+      std::unique_ptr<CodeGenLLVM> cg = CodeGenLLVM::Create(tm_.get());
+      // TODO(tqchen): remove the entry function behavior as it does not
+      // makes sense when we start to use multiple modules.
+      cg->Init("TVMMod", tm_.get(), ctx_.get(), system_lib, system_lib);
 
-    if (entry_func.length() != 0) {
-      cg->AddMainFunction(entry_func);
-    }
+      for (const auto& f : funcs) {
+        cg->AddFunction(f);
+      }
 
-    module_ = cg->Finish();
-    module_->addModuleFlag(llvm::Module::Warning, "tvm_target", llvm::MDString::get(*ctx_, target));
-    module_->addModuleFlag(llvm::Module::Override, "Debug Info Version",
-                           llvm::DEBUG_METADATA_VERSION);
+      if (entry_func.length() != 0) {
+        cg->AddMainFunction(entry_func);
+      }
 
-    if (tm_->getTargetTriple().isOSDarwin()) {
-      module_->addModuleFlag(llvm::Module::Override, "Dwarf Version", 2);
+      module_ = cg->Finish();
+      AddTargetFlags(module_.get(), tm_.get(), target);
     }
 
     std::string verify_errors_storage;
@@ -289,6 +349,129 @@ class LLVMModuleNode final : public runtime::ModuleNode {
   }
 
  private:
+  /*! \brief A part of the functions, generated in a context of its own. */
+  struct CodegenPart {
+    /*! \brief The functions of the part. */
+    std::vector<PrimFunc> funcs;
+    /*! \brief The total size of the function bodies. */
+    size_t size{0};
+    /*! \brief The context, declared first to outlive the module. */
+    std::shared_ptr<llvm::LLVMContext> ctx;
+    /*! \brief The optimized module. */
+    std::unique_ptr<llvm::Module> module;
+  };
+
+  /*!
+   * \brief Generate and optimize the functions in parts on several threads,
+   *  then link the parts into a module of ctx_.
+   *
+   *  The parts are kept so that their object code can be emitted in parallel
+   *  as well. The context variables are defined with linkonce linkage by every
+   *  part, so the linker merges them.
+   */
+  std::unique_ptr<llvm::Module> ParallelCodegen(const std::vector<PrimFunc>& funcs,
+                                                const std::string& entry_func,
+                                                const std::string& target,
+                                                bool system_lib,
+                                                int num_threads) {
+    // Balance the parts by the sizes of the function bodies, largest first.
+    std::vector<std::pair<size_t, size_t> > sizes;
+    for (size_t i = 0; i < funcs.size(); ++i) {
+      size_t size = 0;
+      tir::PostOrderVisit(funcs[i]->body, [&size](const ObjectRef& node) { ++size; });
+      sizes.emplace_back(size, i);
+    }
+    std::stable_sort(sizes.begin(), sizes.end(),
+                     [](const std::pair<size_t, size_t>& lhs,
+                        const std::pair<size_t, size_t>& rhs) {
+                       return lhs.first > rhs.first;
+                     });
+    parts_.clear();
+    parts_.resize(std::min(static_cast<size_t>(num_threads), funcs.size()));
+    for (const auto& kv : sizes) {
+      auto part = std::min_element(parts_.begin(), parts_.end(),
+                                   [](const CodegenPart& lhs, const CodegenPart& rhs) {
+                                     return lhs.size < rhs.size;
+                                   });
+      part->funcs.push_back(funcs[kv.second]);
+      part->size += kv.first;
+    }
+
+    std::vector<std::string> bitcodes(parts_.size());
+    ParallelRun(parts_.size(), num_threads, [&](size_t i) {
+      CodegenPart& part = parts_[i];
+      std::unique_ptr<llvm::TargetMachine> tm = GetLLVMTargetMachine(target);
+      part.ctx = std::make_shared<llvm::LLVMContext>();
+      std::unique_ptr<CodeGenLLVM> cg = CodeGenLLVM::Create(tm.get());
+      cg->Init("TVMMod", tm.get(), part.ctx.get(), system_lib, system_lib);
+      bool has_entry = false;
+      for (const auto& f : part.funcs) {
+        cg->AddFunction(f);
+        auto global_symbol = f->GetAttr<String>(tvm::attr::kGlobalSymbol);
+        has_entry |= global_symbol.defined() && global_symbol.value() == entry_func;
+      }
+      if (has_entry) {
+        cg->AddMainFunction(entry_func);
+      }
+      part.module = cg->Finish();
+      AddTargetFlags(part.module.get(), tm.get(), target);
+      // The modules of different contexts can only be linked through bitcode.
+      llvm::raw_string_ostream os(bitcodes[i]);
+#if TVM_LLVM_VERSION <= 60
+      llvm::WriteBitcodeToFile(part.module.get(), os);
+#else
+      llvm::WriteBitcodeToFile(*part.module, os);
+#endif
+      os.flush();
+    });
+
+    std::unique_ptr<llvm::Module> module;
+    for (const std::string& bitcode : bitcodes) {
+      std::unique_ptr<llvm::MemoryBuffer> buf =
+          llvm::MemoryBuffer::getMemBuffer(bitcode, "TVMMod", false);
+      auto part = llvm::parseBitcodeFile(buf->getMemBufferRef(), *ctx_);
+      if (!part) {
+        LOG(FATAL) << "Fail to load the bitcode of a part: "
+                   << llvm::toString(part.takeError());
+      }
+      if (module == nullptr) {
+        module = std::move(part.get());
+      } else {
+        CHECK(!llvm::Linker::linkModules(*module, std::move(part.get())))
+            << "Failed to link modules";
+      }
+    }
+    return module;
+  }
+
+  /*!
+   * \brief Save the object code into files, one file for each part of the functions.
+   * \param prefix The prefix of the file names.
+   * \return The names of the files.
+   */
+  Array<String> SaveObjects(const std::string& prefix) {
+    Array<String> files;
+    if (parts_.size() <= 1) {
+      files.push_back(prefix + ".o");
+      SaveToFile(prefix + ".o", "o");
+      return files;
+    }
+    for (size_t i = 0; i < parts_.size(); ++i) {
+      files.push_back(prefix + "_" + std::to_string(i) + ".o");
+    }
+    ParallelRun(parts_.size(), static_cast<int>(parts_.size()), [&](size_t i) {
+      std::string file_name = files[i];
+      std::error_code ecode;
+      llvm::raw_fd_ostream dest(file_name, ecode, llvm::sys::fs::F_None);
+      CHECK_EQ(ecode.value(), 0) << "Cannot open file: " << file_name
+                                 << " " << ecode.message();
+      std::unique_ptr<llvm::TargetMachine> tm = GetLLVMTargetMachine(target_);
+      EmitObjectFile(*parts_[i].module, tm.get(), dest);
+      dest.close();
+    });
+    return files;
+  }
+
   void LazyInitJIT() {
     std::lock_guard<std::mutex> lock(mutex_);
     if (ee_) {
@@ -366,6 +549,8 @@ class LLVMModuleNode final : public runtime::ModuleNode {
   std::unique_ptr<llvm::Module> module_;
   // the context.
   std::shared_ptr<llvm::LLVMContext> ctx_;
+  // The parts of a module generated in parallel.
+  std::vector<CodegenPart> parts_;
 };
 
 unsigned LookupLLVMIntrinsic(const std::string& name) {
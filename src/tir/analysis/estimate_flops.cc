@@ -0,0 +1,116 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file estimate_flops.cc
+ * \brief Estimate the floating point operations of a lowered function.
+ */
+#include <tvm/runtime/registry.h>
+#include <tvm/tir/analysis.h>
+#include <tvm/tir/stmt_functor.h>
+
+namespace tvm {
+namespace tir {
+
+class FlopEstimator : public StmtExprVisitor {
+ public:
+  int64_t Estimate(const Stmt& stmt) {
+    this->VisitStmt(stmt);
+    return unknown_ ? -1 : flops_;
+  }
+
+  void VisitStmt_(const ForNode* op) final {
+    const auto* extent = op->extent.as<IntImmNode>();
+    if (extent == nullptr) {
+      unknown_ = true;
+      return;
+    }
+    int64_t scale = scale_;
+    scale_ *= extent->value;
+    StmtExprVisitor::VisitStmt_(op);
+    scale_ = scale;
+  }
+
+  void VisitStmt_(const AttrStmtNode* op) final {
+    if (op->attr_key != attr::thread_extent && op->attr_key != attr::virtual_thread) {
+      StmtExprVisitor::VisitStmt_(op);
+      return;
+    }
+    const auto* extent = op->value.as<IntImmNode>();
+    if (extent == nullptr) {
+      unknown_ = true;
+      return;
+    }
+    int64_t scale = scale_;
+    scale_ *= extent->value;
+    StmtExprVisitor::VisitStmt_(op);
+    scale_ = scale;
+  }
+
+  void VisitExpr_(const AddNode* op) final {
+    Count(op->dtype);
+    StmtExprVisitor::VisitExpr_(op);
+  }
+  void VisitExpr_(const SubNode* op) final {
+    Count(op->dtype);
+    StmtExprVisitor::VisitExpr_(op);
+  }
+  void VisitExpr_(const MulNode* op) final {
+    Count(op->dtype);
+    StmtExprVisitor::VisitExpr_(op);
+  }
+  void VisitExpr_(const DivNode* op) final {
+    Count(op->dtype);
+    StmtExprVisitor::VisitExpr_(op);
+  }
+  void VisitExpr_(const MinNode* op) final {
+    Count(op->dtype);
+    StmtExprVisitor::VisitExpr_(op);
+  }
+  void VisitExpr_(const MaxNode* op) final {
+    Count(op->dtype);
+    StmtExprVisitor::VisitExpr_(op);
+  }
+  void VisitExpr_(const CallNode* op) final {
+    // math functions such as exp count as one operation.
+    if (op->call_type == CallNode::PureIntrinsic || op->call_type == CallNode::PureExtern) {
+      Count(op->dtype);
+    }
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+ private:
+  void Count(const DataType& dtype) {
+    if (dtype.is_float()) flops_ += scale_ * dtype.lanes();
+  }
+
+  int64_t flops_{0};
+  int64_t scale_{1};
+  bool unknown_{false};
+};
+
+int64_t EstimateFlops(const PrimFunc& func) {
+  return FlopEstimator().Estimate(func->body);
+}
+
+TVM_REGISTER_GLOBAL("tir.analysis.estimate_flops")
+.set_body_typed(EstimateFlops);
+
+}  // namespace tir
+}  // namespace tvm
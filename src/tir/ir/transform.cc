@@ -25,6 +25,8 @@
 #include <tvm/node/repr_printer.h>
 #include <tvm/tir/transform.h>
 
+#include <memory>
+
 
 namespace tvm {
 namespace tir {
@@ -95,28 +97,37 @@ IRModule PrimFuncPassNode::operator()(IRModule mod,
   const PassInfo& pass_info = Info();
   CHECK(mod.defined());
   pass_ctx.Trace(mod, pass_info, true);
+  pass_ctx.InstrumentBeforePass(mod, pass_info);
   std::vector<ObjectRef> deleted_list;
   IRModuleNode* mod_ptr = mod.CopyOnWrite();
   auto* func_dict = mod_ptr->functions.CopyOnWrite();
-  // directly loop over the underlying dict
-  for (auto& kv : func_dict->data) {
-    // only picks up tir::PrimFunc
-    if (kv.second->IsInstance<PrimFuncNode>()) {
-      // move out the function so that it is the only copy.
-      PrimFunc func = Downcast<PrimFunc>(std::move(kv.second));
-      func = pass_func(std::move(func), mod, pass_ctx);
-      kv.second = std::move(func);
-
-      if (!kv.second.defined()) {
-        deleted_list.push_back(kv.first);
+  try {
+    // directly loop over the underlying dict
+    for (auto& kv : func_dict->data) {
+      // only picks up tir::PrimFunc
+      if (kv.second->IsInstance<PrimFuncNode>()) {
+        // move out the function so that it is the only copy.
+        PrimFunc func = Downcast<PrimFunc>(std::move(kv.second));
+        std::unique_ptr<runtime::ObjectArena> arena;
+        if (pass_ctx->use_object_arena) arena.reset(new runtime::ObjectArena());
+        func = pass_func(std::move(func), mod, pass_ctx);
+        kv.second = std::move(func);
+
+        if (!kv.second.defined()) {
+          deleted_list.push_back(kv.first);
+        }
       }
     }
+  } catch (...) {
+    pass_ctx.InstrumentAfterFailedPass(pass_info);
+    throw;
   }
 
   // automatic removal of None
   for (const auto& gv : deleted_list) {
     func_dict->data.erase(gv);
   }
+  pass_ctx.InstrumentAfterPass(mod, pass_info);
   pass_ctx.Trace(mod, pass_info, false);
   return mod;
 }
@@ -23,6 +23,7 @@
 #include <tvm/te/operation.h>
 #include <tvm/runtime/registry.h>
 #include <tvm/driver/driver_api.h>
+#include <tvm/tir/stmt_functor.h>
 
 #include <string>
 #include <cmath>
@@ -61,6 +62,36 @@ TEST(BuildModule, Basic) {
   CHECK_EQ(mali_target->str(), "opencl -model=Mali-T860MP4@800Mhz -device=mali");
 }
 
+TEST(BuildModule, LowerLikePython) {
+  // The C++ lower is used by the parallel lowering of the compile engine,
+  // its functions must match the ones of tvm.lower in python.
+  using namespace tvm;
+  using namespace tvm::te;
+  Array<PrimExpr> shape{IntImm(DataType::Int(64), 16)};
+  auto A = placeholder(shape, DataType::Float(32), "A");
+  Array<Tensor> C = compute(shape, [&A](const Array<Var>& i) {
+    return Array<PrimExpr>{A(i) + 1.0f, A(i) * 2.0f};
+  }, "C");
+  auto s = create_schedule({ C[0]->op });
+  std::unordered_map<Tensor, Buffer> binds;
+  auto config = BuildConfig::Create();
+  auto lowered = lower(s, {A, C[0], C[1]}, "func", binds, config);
+  auto f = Downcast<tir::PrimFunc>(lowered->Lookup("func"));
+
+  // The outputs of a multi-output op are named like Tensor.name.
+  CHECK_EQ(f->buffer_map[f->params[0]]->name, "A");
+  CHECK_EQ(f->buffer_map[f->params[1]]->name, "C.v0");
+  CHECK_EQ(f->buffer_map[f->params[2]]->name, "C.v1");
+  auto noalias = f->GetAttr<IntImm>("tir.noalias");
+  CHECK(noalias.defined() && noalias.value()->dtype == DataType::Bool());
+  // The 64 bit indices are narrowed.
+  tir::PostOrderVisit(f->body, [](const ObjectRef& node) {
+    if (const auto* loop = node.as<tir::ForNode>()) {
+      CHECK(loop->loop_var.dtype() == DataType::Int(32));
+    }
+  });
+}
+
 TEST(BuildModule, Heterogeneous) {
   /* The testing network is like following, where the element-wise add and sub
    * ops are allocated to GPU and CPU, respectively:
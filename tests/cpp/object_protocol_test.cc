@@ -21,6 +21,8 @@
 #include <gtest/gtest.h>
 #include <tvm/runtime/object.h>
 #include <tvm/runtime/memory.h>
+#include <thread>
+#include <vector>
 
 namespace tvm {
 namespace test {
@@ -96,6 +98,71 @@ TEST(ObjectHierachy, Basic) {
   CHECK(refB.as<ObjB>() != nullptr);
 }
 
+TEST(ObjectArena, Basic) {
+  using namespace tvm::runtime;
+  using namespace tvm::test;
+
+  std::vector<ObjectRef> kept;
+  {
+    ObjectArena arena;
+    CHECK(ObjectArena::Current() == &arena);
+    for (int i = 0; i < 100000; ++i) {
+      ObjectRef ref(make_object<ObjAA>());
+      if (i % 20000 == 0) kept.push_back(ref);
+    }
+    CHECK_EQ(arena.stats().num_objects, 100000);
+    // The pages whose objects were all deleted are reused.
+    CHECK_GT(arena.stats().num_reused_pages, 0);
+    {
+      ObjectArena inner;
+      CHECK(ObjectArena::Current() == &inner);
+      kept.push_back(ObjectRef(make_object<ObjB>()));
+    }
+    CHECK(ObjectArena::Current() == &arena);
+  }
+  CHECK(ObjectArena::Current() == nullptr);
+  CHECK_GE(ObjectArena::GlobalStats().num_escaped_pages, 2);
+  // The objects that escaped the arenas stay valid, and can be deleted on any thread.
+  CHECK_EQ(kept.size(), 6U);
+  for (size_t i = 0; i < 5; ++i) {
+    CHECK(kept[i].as<ObjAA>() != nullptr);
+  }
+  CHECK(kept[5].as<ObjB>() != nullptr);
+  std::thread thread([&kept]() { kept.clear(); });
+  thread.join();
+}
+
+TEST(ObjectArena, ThreadObjectCounts) {
+  using namespace tvm::runtime;
+  using namespace tvm::test;
+  int64_t num_objects, object_bytes;
+  ObjectArena::EnableCounting(true);
+  ObjectArena::ThreadObjectCounts(&num_objects, &object_bytes);
+  ObjectRef a(make_object<ObjA>());
+  {
+    ObjectArena arena;
+    ObjectRef b(make_object<ObjB>());
+  }
+  int64_t new_num_objects, new_object_bytes;
+  ObjectArena::ThreadObjectCounts(&new_num_objects, &new_object_bytes);
+  CHECK_EQ(new_num_objects - num_objects, 2);
+  CHECK_EQ(new_object_bytes - object_bytes,
+           static_cast<int64_t>(sizeof(ObjA) + sizeof(ObjB)));
+  // The counters are per thread.
+  std::thread thread([]() {
+    int64_t num_objects, object_bytes;
+    ObjectArena::ThreadObjectCounts(&num_objects, &object_bytes);
+    CHECK_EQ(num_objects, 0);
+  });
+  thread.join();
+  ObjectArena::EnableCounting(false);
+  // Without an arena or the counting, make_object does not count.
+  ObjectArena::ThreadObjectCounts(&num_objects, &object_bytes);
+  ObjectRef c(make_object<ObjA>());
+  ObjectArena::ThreadObjectCounts(&new_num_objects, &new_object_bytes);
+  CHECK_EQ(new_num_objects, num_objects);
+}
+
 int main(int argc, char ** argv) {
   testing::InitGoogleTest(&argc, argv);
   testing::FLAGS_gtest_death_test_style = "threadsafe";
@@ -25,6 +25,16 @@
 #include <tvm/tir/transform.h>
 #include <tvm/tir/expr.h>
 
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
 TEST(PackedFunc, Basic) {
   using namespace tvm;
   using namespace tvm::tir;
@@ -325,6 +335,175 @@ TEST(TypedPackedFunc, RValue) {
   }
 }
 
+TEST(Registry, Intern) {
+  using namespace tvm::runtime;
+  const Registry* handle = Registry::Intern("test.registry.intern");
+  CHECK(handle->function() == nullptr);
+  CHECK(Registry::Get("test.registry.intern") == nullptr);
+  Registry::Register("test.registry.intern")
+  .set_body_typed([](int x) { return x + 1; });
+  CHECK(handle->function() != nullptr);
+  CHECK_EQ((*handle->function())(1).operator int(), 2);
+  CHECK(Registry::Remove("test.registry.intern"));
+  CHECK(handle->function() == nullptr);
+  CHECK(Registry::Get("test.registry.intern") == nullptr);
+  CHECK(!Registry::Remove("test.registry.intern"));
+  // The name keeps its entry.
+  Registry::Register("test.registry.intern")
+  .set_body_typed([](int x) { return x + 2; });
+  CHECK_EQ(Registry::Intern("test.registry.intern"), handle);
+  CHECK_EQ((*handle->function())(1).operator int(), 3);
+  Registry::Remove("test.registry.intern");
+}
+
+TEST(Registry, OverrideKeepsReplacedForCalls) {
+  using namespace tvm::runtime;
+  auto state = std::make_shared<int>(1);
+  Registry::Register("test.registry.override")
+  .set_body_typed([state]() { return *state; });
+  const PackedFunc* f = Registry::Get("test.registry.override");
+  Registry::Register("test.registry.override", true)
+  .set_body_typed([]() { return 2; });
+  // The replaced function is retired, not freed, while calls may be in progress.
+  CHECK_EQ(state.use_count(), 2);
+  CHECK_EQ((*f)().operator int(), 1);
+  CHECK_EQ((*Registry::Get("test.registry.override"))().operator int(), 2);
+  CHECK(Registry::Remove("test.registry.override"));
+}
+
+TEST(Registry, ConcurrentLookup) {
+  using namespace tvm::runtime;
+  Registry::Register("test.registry.base")
+  .set_body_typed([]() { return 1; });
+  // Look up while another thread registers enough names to grow the table.
+  const int kNumNames = 5000;
+  std::atomic<bool> done{false};
+  std::thread reader([&done]() {
+      while (!done) {
+        CHECK(Registry::Get("test.registry.base") != nullptr);
+      }
+    });
+  for (int i = 0; i < kNumNames; ++i) {
+    Registry::Register("test.registry.grow" + std::to_string(i))
+    .set_body_typed([i]() { return i; });
+  }
+  done = true;
+  reader.join();
+  for (int i = 0; i < kNumNames; i += 499) {
+    const PackedFunc* f = Registry::Get("test.registry.grow" + std::to_string(i));
+    CHECK(f != nullptr);
+    CHECK_EQ((*f)().operator int(), i);
+  }
+  for (int i = 0; i < kNumNames; ++i) {
+    Registry::Remove("test.registry.grow" + std::to_string(i));
+  }
+  Registry::Remove("test.registry.base");
+}
+
+TEST(Registry, ConcurrentRegisterAndCall) {
+  using namespace tvm::runtime;
+  // Call the names while they are registered, registered again and removed.
+  const int kNumNames = 200;
+  const int kNumThreads = 4;
+  std::atomic<bool> done{false};
+  std::atomic<int64_t> num_calls{0};
+  auto name = [](int i) { return "test.registry.live" + std::to_string(i); };
+  std::vector<std::thread> callers;
+  for (int t = 0; t < kNumThreads; ++t) {
+    callers.emplace_back([&, t]() {
+        std::vector<const PackedFunc*> held;
+        int i = t;
+        while (!done) {
+          if (const PackedFunc* f = Registry::Get(name(i))) {
+            // Every published body returns its name index plus a multiple of kNumNames.
+            CHECK_EQ((*f)().operator int() % kNumNames, i);
+            ++num_calls;
+            if (held.size() < 16) held.push_back(f);
+          }
+          // The functions looked up earlier stay callable for the grace period.
+          for (const PackedFunc* f : held) {
+            (*f)();
+          }
+          i = (i + 1) % kNumNames;
+        }
+      });
+  }
+  for (int round = 0; round < 5; ++round) {
+    for (int i = 0; i < kNumNames; ++i) {
+      int value = round * kNumNames + i;
+      Registry::Register(name(i), true)
+      .set_body_typed([value]() { return value; });
+    }
+    for (int i = 0; i < kNumNames; i += 2) {
+      CHECK(Registry::Remove(name(i)));
+    }
+  }
+  done = true;
+  for (auto& caller : callers) {
+    caller.join();
+  }
+  for (int i = 0; i < kNumNames; ++i) {
+    Registry::Remove(name(i));
+  }
+  CHECK_GT(num_calls.load(), 0);
+}
+
+// Time the lookups by name, through interned handles, and through a map under
+// a mutex as the registry did before its lookups became lock free. Set
+// TVM_REGISTRY_BENCH_LOOKUPS to the lookups of each thread to run it longer.
+TEST(Registry, LookupBenchmark) {
+  using namespace tvm::runtime;
+  const char* val = getenv("TVM_REGISTRY_BENCH_LOOKUPS");
+  int64_t num_lookups = val != nullptr ? atoll(val) : 10000;
+  std::vector<std::string> names = Registry::ListNames();
+  CHECK(!names.empty());
+  std::vector<const Registry*> handles;
+  std::unordered_map<std::string, const Registry*> map;
+  std::mutex map_mutex;
+  for (const std::string& name : names) {
+    handles.push_back(Registry::Intern(name));
+    map[name] = handles.back();
+  }
+  for (int num_threads : {1, 4, 16}) {
+    for (const std::string mode : {"mutex", "name", "handle"}) {
+      std::atomic<int64_t> found{0};
+      auto lookup = [&](int thread_id) {
+        int64_t count = 0;
+        size_t index = static_cast<size_t>(thread_id) * 7919 % names.size();
+        for (int64_t i = 0; i < num_lookups; ++i) {
+          const PackedFunc* f;
+          if (mode == "name") {
+            f = Registry::Get(names[index]);
+          } else if (mode == "handle") {
+            f = handles[index]->function();
+          } else {
+            std::lock_guard<std::mutex> lock(map_mutex);
+            f = map.find(names[index])->second->function();
+          }
+          count += f != nullptr;
+          if (++index == names.size()) index = 0;
+        }
+        found += count;
+      };
+      auto start = std::chrono::steady_clock::now();
+      std::vector<std::thread> threads;
+      for (int i = 1; i < num_threads; ++i) {
+        threads.emplace_back(lookup, i);
+      }
+      lookup(0);
+      for (auto& thread : threads) {
+        thread.join();
+      }
+      double seconds =
+          std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      CHECK_EQ(found.load(), num_lookups * num_threads);
+      LOG(INFO) << "mode=" << mode << " threads=" << num_threads
+                << " lookups/s=" << num_lookups * num_threads / seconds
+                << " ns/lookup=" << seconds * 1e9 / num_lookups;
+    }
+  }
+}
+
 int main(int argc, char ** argv) {
   testing::InitGoogleTest(&argc, argv);
   testing::FLAGS_gtest_death_test_style = "threadsafe";
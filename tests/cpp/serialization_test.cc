@@ -0,0 +1,71 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <dmlc/logging.h>
+#include <dmlc/memory_io.h>
+#include <gtest/gtest.h>
+#include <tvm/node/serialization.h>
+#include <tvm/te/operation.h>
+
+#include <string>
+
+TEST(Serialization, BinaryInStream) {
+  using namespace tvm;
+  using namespace tvm::tir;
+  Var x("x");
+  // large enough to take several chunks.
+  Array<PrimExpr> exprs;
+  for (int i = 0; i < 10000; ++i) {
+    exprs.push_back(max(x + i, 100 - i));
+  }
+  // A node followed by other data in the same stream.
+  std::string blob;
+  dmlc::MemoryStringStream wstrm(&blob);
+  SaveBinary(&wstrm, exprs);
+  wstrm.Write(std::string("tail"));
+  SaveBinary(&wstrm, x);
+
+  dmlc::MemoryStringStream rstrm(&blob);
+  Array<PrimExpr> loaded = Downcast<Array<PrimExpr> >(LoadBinary(&rstrm));
+  CHECK_EQ(loaded.size(), exprs.size());
+  const MaxNode* last = loaded[loaded.size() - 1].as<MaxNode>();
+  CHECK(last != nullptr);
+  CHECK_EQ(Downcast<IntImm>(last->b)->value, 100 - 9999);
+  std::string tail;
+  CHECK(rstrm.Read(&tail));
+  CHECK_EQ(tail, "tail");
+  CHECK(LoadBinary(&rstrm).as<VarNode>() != nullptr);
+}
+
+TEST(Serialization, BinaryVersion) {
+  using namespace tvm;
+  std::string blob;
+  dmlc::MemoryStringStream wstrm(&blob);
+  SaveBinary(&wstrm, tir::Var("x"));
+  // The version follows the 8 bytes of the magic number.
+  blob[8] += 1;
+  dmlc::MemoryStringStream rstrm(&blob);
+  EXPECT_ANY_THROW(LoadBinary(&rstrm));
+}
+
+int main(int argc, char ** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  testing::FLAGS_gtest_death_test_style = "threadsafe";
+  return RUN_ALL_TESTS();
+}
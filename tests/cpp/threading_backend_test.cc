@@ -23,6 +23,7 @@
 
 #include <gtest/gtest.h>
 #include <tvm/runtime/c_backend_api.h>
+#include <tvm/runtime/registry.h>
 
 constexpr size_t N = 128;
 
@@ -42,6 +43,75 @@ TEST(ThreadingBackend, TVMBackendParallelLaunch) {
   EXPECT_EQ(acc.load(std::memory_order_relaxed), N * (N - 1) / 2);
 }
 
+static FTVMParallelLambda nested_launch = [](int task_id, TVMParallelGroupEnv* penv,
+                                             void* cdata) -> int {
+  std::atomic<size_t> acc(0);
+  if (TVMBackendParallelLaunch(atomic_add_task_id, &acc, 0) != 0) return -1;
+  reinterpret_cast<std::atomic<size_t>*>(cdata)->fetch_add(acc.load(std::memory_order_relaxed));
+  return 0;
+};
+
+static FTVMParallelLambda count_with_barrier = [](int task_id, TVMParallelGroupEnv* penv,
+                                                  void* cdata) -> int {
+  reinterpret_cast<std::atomic<size_t>*>(cdata)->fetch_add(1);
+  return TVMBackendParallelBarrier(task_id, penv);
+};
+
+TEST(ThreadingBackend, TVMBackendParallelLaunchNested) {
+  std::atomic<size_t> acc(0);
+  EXPECT_EQ(TVMBackendParallelLaunch(nested_launch, &acc, 0), 0);
+  EXPECT_EQ(acc.load(std::memory_order_relaxed) % (N * (N - 1) / 2), 0);
+  EXPECT_GT(acc.load(std::memory_order_relaxed), 0);
+}
+
+static FTVMParallelLambda nested_launch_barrier_free = [](int task_id, TVMParallelGroupEnv* penv,
+                                                          void* cdata) -> int {
+  std::atomic<size_t> acc(0);
+  if (TVMBackendParallelLaunchBarrierFree(atomic_add_task_id, &acc, 0) != 0) return -1;
+  reinterpret_cast<std::atomic<size_t>*>(cdata)->fetch_add(acc.load(std::memory_order_relaxed));
+  return 0;
+};
+
+static FTVMParallelLambda record_num_task = [](int task_id, TVMParallelGroupEnv* penv,
+                                               void* cdata) -> int {
+  auto* num_task = reinterpret_cast<std::atomic<int>*>(cdata);
+  num_task[0].store(penv->num_task);
+  num_task[1].fetch_add(1);
+  return 0;
+};
+
+TEST(ThreadingBackend, TVMBackendParallelLaunchWorkStealing) {
+  const auto* config = tvm::runtime::Registry::Get("runtime.config_threadpool_work_stealing");
+  ASSERT_TRUE(config != nullptr);
+  const int chunks_per_worker = 4;
+  (*config)(chunks_per_worker);
+  for (int i = 0; i < 3; ++i) {
+    // Only the launches declared barrier free are split into chunks.
+    std::atomic<int> plain[2] = {{0}, {0}};
+    EXPECT_EQ(TVMBackendParallelLaunch(record_num_task, plain, 0), 0);
+    EXPECT_EQ(plain[1].load(), plain[0].load());
+    std::atomic<int> chunked[2] = {{0}, {0}};
+    EXPECT_EQ(TVMBackendParallelLaunchBarrierFree(record_num_task, chunked, 0), 0);
+    EXPECT_EQ(chunked[0].load(), plain[0].load() * chunks_per_worker);
+    EXPECT_EQ(chunked[1].load(), chunked[0].load());
+
+    std::atomic<size_t> acc(0);
+    EXPECT_EQ(TVMBackendParallelLaunchBarrierFree(atomic_add_task_id, &acc, 0), 0);
+    EXPECT_EQ(acc.load(std::memory_order_relaxed), N * (N - 1) / 2);
+
+    std::atomic<size_t> nested(0);
+    EXPECT_EQ(TVMBackendParallelLaunchBarrierFree(nested_launch_barrier_free, &nested, 0), 0);
+    EXPECT_EQ(nested.load(std::memory_order_relaxed) % (N * (N - 1) / 2), 0);
+    EXPECT_GT(nested.load(std::memory_order_relaxed), 0);
+
+    // A lambda that uses the barrier keeps one task per worker.
+    std::atomic<size_t> count(0);
+    EXPECT_EQ(TVMBackendParallelLaunch(count_with_barrier, &count, 0), 0);
+    EXPECT_EQ(count.load(), static_cast<size_t>(plain[0].load()));
+  }
+  (*config)(0);
+}
+
 TEST(ThreadingBackend, TVMBackendParallelLaunchMultipleThreads) {
   // TODO(tulloch) use parameterised tests when available.
   size_t num_jobs_per_thread = 3;
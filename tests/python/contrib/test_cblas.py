@@ -64,6 +64,8 @@ def test_matmul_add():
     verify_matmul_add(1, 16, 3, True, False)
     verify_matmul_add(1, 16, 3, False, False)
     verify_matmul_add(1, 16, 3, True, True)
+    verify_matmul_add(67, 300, 129, dtype="float64")
+    verify_matmul_add(67, 300, 129, True, True, dtype="float64")
 
 def verify_batch_matmul(batch, m, l, n, transa=False, transb=False, iterative=False, dtype="float32"):
     ashape = (batch, l, n) if transa else (batch, n, l)
@@ -108,6 +110,8 @@ def test_batch_matmul():
     verify_batch_matmul(1, 1, 16, 3, False, False)
     verify_batch_matmul(1, 1, 16, 3, True, True)
     verify_batch_matmul(1, 1, 16, 3, iterative=True)
+    verify_batch_matmul(5, 33, 257, 65)
+    verify_batch_matmul(5, 33, 257, 65, True, True, dtype="float64")
 
 if __name__ == "__main__":
     test_matmul_add()
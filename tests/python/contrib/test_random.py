@@ -90,7 +90,63 @@ def test_normal():
     verify()
 
 
+def test_philox():
+    m = 1024
+    n = 1024
+
+    def build(A):
+        s = te.create_schedule(A.op)
+        return tvm.build(s, [A], "llvm")
+
+    def verify():
+        if not tvm.runtime.enabled("llvm"):
+            print("skip because llvm is not enabled...")
+            return
+        if not tvm.get_global_func("tvm.contrib.random.philox_uniform", True):
+            print("skip because extern function is not available")
+            return
+        ctx = tvm.cpu(0)
+        f = build(random.philox_normal(3, 4, size=(m, n), seed=7))
+        a = tvm.nd.array(np.zeros((m, n), dtype="float32"), ctx)
+        f(a)
+        na = a.asnumpy()
+        assert abs(np.mean(na) - 3) < 1e-2
+        assert abs(np.std(na) - 4) < 1e-2
+        # The same seed and offset give the same stream.
+        b = tvm.nd.array(np.zeros((m, n), dtype="float32"), ctx)
+        f(b)
+        np.testing.assert_equal(na, b.asnumpy())
+        # A fill from an offset continues the stream at that position.
+        f = build(random.philox_normal(3, 4, size=(m * n - 5,), seed=7, offset=5))
+        c = tvm.nd.array(np.zeros((m * n - 5,), dtype="float32"), ctx)
+        f(c)
+        np.testing.assert_equal(na.reshape(-1)[5:], c.asnumpy())
+
+        f = build(random.philox_uniform(0, 1, size=(m, n), seed=1))
+        f(a)
+        na = a.asnumpy()
+        assert abs(np.mean(na) - 0.5) < 1e-2
+        assert np.min(na) >= 0 and np.max(na) < 1
+
+        f = build(random.philox_randint(-127, 128, size=(m, n), seed=1, dtype="int32"))
+        d = tvm.nd.array(np.zeros((m, n), dtype="int32"), ctx)
+        f(d)
+        nd = d.asnumpy()
+        assert abs(np.mean(nd)) < 0.2
+        assert np.min(nd) == -127
+        assert np.max(nd) == 127
+        # The chunks of a fill from an offset off the counter boundaries still
+        # continue the stream.
+        f = build(random.philox_randint(-127, 128, size=(m * n - 3,), seed=1, offset=3,
+                                        dtype="int32"))
+        e = tvm.nd.array(np.zeros((m * n - 3,), dtype="int32"), ctx)
+        f(e)
+        np.testing.assert_equal(nd.reshape(-1)[3:], e.asnumpy())
+    verify()
+
+
 if __name__ == "__main__":
     test_randint()
     test_uniform()
     test_normal()
+    test_philox()
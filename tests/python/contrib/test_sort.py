@@ -74,6 +74,88 @@ def test_sort_np():
     f(a, b, c)
     tvm.testing.assert_allclose(c.asnumpy(), np_out, rtol=1e-5)
 
+def test_topk_np():
+    dshape = (64, 1000)
+    k = 10
+    ctx = tvm.cpu(0)
+    for dtype in ["float32", "float16", "int32", "int64"]:
+        for is_ascend in [True, False]:
+            data = te.placeholder(dshape, name='data', dtype=dtype)
+            values, indices = te.extern(
+                [(dshape[0], k), (dshape[0], k)], [data],
+                lambda ins, outs: tvm.tir.call_packed(
+                    "tvm.contrib.sort.topk", ins[0], outs[0], outs[1],
+                    k, 1, "both", is_ascend),
+                dtype=[dtype, "int64"], name="topk_tensor")
+            s = te.create_schedule(values.op)
+            f = tvm.build(s, [data, values, indices], "llvm")
+
+            # few distinct values to check that ties keep their order.
+            np_data = np.random.randint(-20, 20, size=dshape).astype(dtype)
+            order = np.argsort(np_data if is_ascend else -np_data, axis=1, kind="stable")
+            np_indices = order[:, :k]
+            np_values = np.take_along_axis(np_data, np_indices, axis=1)
+            a = tvm.nd.array(np_data, ctx)
+            b = tvm.nd.array(np.zeros((dshape[0], k), dtype=dtype), ctx)
+            c = tvm.nd.array(np.zeros((dshape[0], k), dtype="int64"), ctx)
+            f(a, b, c)
+            tvm.testing.assert_allclose(c.asnumpy(), np_indices)
+            tvm.testing.assert_allclose(b.asnumpy(), np_values)
+
+def test_argsort_radix():
+    # Rows of at least 64 elements with 32 bit keys take the radix sort, the
+    # 64 bit ones the comparison sort. Few distinct values check that ties keep
+    # their order, the sorted axis is strided.
+    dshape = (3, 200, 2)
+    axis = 1
+    ctx = tvm.cpu(0)
+    for dtype in ["float32", "int32", "float64", "int64"]:
+        for is_ascend in [True, False]:
+            data = te.placeholder(dshape, name='data', dtype=dtype)
+            out = te.extern(dshape, [data],
+                            lambda ins, outs: tvm.tir.call_packed(
+                                "tvm.contrib.sort.argsort", ins[0], outs[0], axis, is_ascend),
+                            dtype="int32", name="sort_tensor")
+            s = te.create_schedule(out.op)
+            f = tvm.build(s, [data, out], "llvm")
+
+            np_data = np.random.randint(-20, 20, size=dshape).astype(dtype)
+            if dtype.startswith("float"):
+                np_data += np.random.choice([0, 0.5, -0.25], size=dshape).astype(dtype)
+            np_out = np.argsort(np_data if is_ascend else -np_data, axis=axis, kind="stable")
+            a = tvm.nd.array(np_data, ctx)
+            c = tvm.nd.array(np.zeros(dshape, dtype="int32"), ctx)
+            f(a, c)
+            tvm.testing.assert_allclose(c.asnumpy(), np_out)
+
+    # argsort_nms sorts the first sort_num elements of a row and keeps the others in place.
+    sort_num_input = np.array([[200, 150], [64, 100], [10, 200]], dtype="int32")
+    for is_ascend in [True, False]:
+        data = te.placeholder(dshape, name='data')
+        sort_num = te.placeholder(sort_num_input.shape, name="sort_num", dtype="int32")
+        out = te.extern(dshape, [data, sort_num],
+                        lambda ins, outs: tvm.tir.call_packed(
+                            "tvm.contrib.sort.argsort_nms", ins[0], ins[1], outs[0],
+                            axis, is_ascend),
+                        dtype="int32", name="sort_tensor")
+        s = te.create_schedule(out.op)
+        f = tvm.build(s, [data, sort_num, out], "llvm")
+
+        np_data = np.random.randint(-20, 20, size=dshape).astype("float32")
+        np_out = np.tile(np.arange(dshape[axis]).reshape(1, -1, 1), (dshape[0], 1, dshape[2]))
+        for i in range(dshape[0]):
+            for j in range(dshape[2]):
+                num = sort_num_input[i, j]
+                row = np_data[i, :num, j]
+                np_out[i, :num, j] = np.argsort(row if is_ascend else -row, kind="stable")
+        a = tvm.nd.array(np_data, ctx)
+        b = tvm.nd.array(sort_num_input, ctx)
+        c = tvm.nd.array(np.zeros(dshape, dtype="int32"), ctx)
+        f(a, b, c)
+        tvm.testing.assert_allclose(c.asnumpy(), np_out)
+
 if __name__ == "__main__":
     test_sort()
     test_sort_np()
+    test_topk_np()
+    test_argsort_radix()
@@ -14,12 +14,14 @@
 # KIND, either express or implied.  See the License for the
 # specific language governing permissions and limitations
 # under the License.
+import os
 import numpy as np
 import tvm
 from tvm import te
 import tvm.testing
 from tvm import relay
 from tvm import autotvm
+from tvm.contrib import util, graph_runtime
 import topi
 from tvm.relay.testing import run_infer_type
 from tvm.relay.testing.temp_op_attr import TempOpAttr
@@ -177,6 +179,125 @@ def test_compile_engine():
                 y.asnumpy(), x.asnumpy() * 3)
     engine.dump()
 
+def test_compile_engine_object():
+    # The engine handed out by C++ is wrapped in the registered python class.
+    engine = relay.backend.compile_engine.get()
+    assert isinstance(engine, relay.backend.compile_engine.CompileEngine)
+    x = relay.var("x", shape=(4,))
+    mod = tvm.IRModule.from_expr(relay.Function([x], relay.exp(x)))
+    mod = relay.transform.InferType()(mod)
+    cached_func = engine.lower(mod["main"], "llvm")
+    assert len(cached_func.outputs) == 1
+    assert cached_func.func_name in [str(gv.name_hint) for gv in cached_func.funcs.get_global_vars()]
+
+
+def test_compile_engine_disk_cache():
+    engine = relay.backend.compile_engine.get()
+    x = relay.var("x", shape=(10,))
+    func = relay.Function([x], relay.multiply(relay.add(x, x), x))
+    func = run_infer_type(func)
+    temp = util.tempdir()
+    cache_dir = temp.relpath("compile_cache")
+    try:
+        engine.clear()
+        engine.set_disk_cache(cache_dir)
+        z1 = engine.lower(func, "llvm")
+        entries = os.listdir(cache_dir)
+        assert len(entries) == 1 and entries[0].startswith("lower-")
+
+        # A fresh engine state loads the lowered function from the disk.
+        engine.clear()
+        z2 = engine.lower(func, "llvm")
+        assert not z2.same_as(z1)
+        tvm.ir.assert_structural_equal(z1.funcs, z2.funcs)
+
+        if tvm.context("llvm").exist:
+            for _ in range(2):
+                engine.clear()
+                f = engine.jit(func, "llvm")
+                a = tvm.nd.array(np.arange(10).astype("float32"))
+                b = tvm.nd.empty((10,))
+                f(a, b)
+                tvm.testing.assert_allclose(b.asnumpy(), a.asnumpy() * a.asnumpy() * 2)
+
+        # The pass context and the AutoTVM configs are part of the keys.
+        def num_lowered():
+            return len([e for e in os.listdir(cache_dir) if e.startswith("lower-")])
+        engine.clear()
+        with tvm.transform.PassContext(opt_level=1):
+            engine.lower(func, "llvm")
+        assert num_lowered() == 2
+        engine.clear()
+        with autotvm.apply_history_best([]):
+            engine.lower(func, "llvm")
+        assert num_lowered() == 3
+        # A dispatch context that cannot be keyed bypasses the cache.
+        engine.clear()
+        with autotvm.task.ApplyConfig(None):
+            engine.lower(func, "llvm")
+        assert num_lowered() == 3
+
+        # Every entry is over the size limit.
+        engine.clear()
+        engine.set_disk_cache(cache_dir, max_bytes=1)
+        engine.lower(run_infer_type(relay.Function([x], relay.add(x, x))), "llvm")
+        assert not os.listdir(cache_dir)
+    finally:
+        engine.set_disk_cache(None)
+        engine.clear()
+
+
+def test_compile_engine_lower_batch():
+    engine = relay.backend.compile_engine.get()
+    x = relay.var("x", shape=(10,))
+    funcs = [run_infer_type(relay.Function([x], relay.add(x, x))),
+             run_infer_type(relay.Function([x], relay.multiply(x, x))),
+             run_infer_type(relay.Function([x], relay.nn.relu(relay.subtract(x, x))))]
+
+    def get_prim_func(cached_func):
+        # The names depend on the functions lowered before.
+        prim_func = cached_func.funcs[cached_func.func_name]
+        return prim_func.with_attr("global_symbol", "func")
+
+    try:
+        engine.clear()
+        expected = [get_prim_func(engine.lower(func, "llvm")) for func in funcs]
+        engine.clear()
+        engine.set_num_threads(4)
+        engine.lower_batch(funcs, "llvm")
+        names = []
+        for func, prim_func in zip(funcs, expected):
+            cached_func = engine.lower(func, "llvm")
+            names.append(cached_func.func_name)
+            tvm.ir.assert_structural_equal(get_prim_func(cached_func), prim_func,
+                                           map_free_vars=True)
+        assert len(set(names)) == len(names)
+
+        y = relay.var("y", shape=(4, 8))
+        z = relay.nn.relu(relay.add(y, relay.const(1.0)))
+        z = relay.nn.softmax(relay.multiply(z, z))
+        z = relay.add(relay.exp(z), relay.sum(z, axis=1, keepdims=True))
+        mod = tvm.IRModule.from_expr(relay.Function([y], z))
+        data = np.random.uniform(-1, 1, size=(4, 8)).astype("float32")
+        outputs = []
+        builds = []
+        for num_threads in [1, 4]:
+            engine.clear()
+            engine.set_num_threads(num_threads)
+            graph, lib, params = relay.build(mod, "llvm")
+            builds.append((graph, lib.get_source()))
+            m = graph_runtime.create(graph, lib, tvm.cpu())
+            m.run(y=data)
+            outputs.append(m.get_output(0).asnumpy())
+        tvm.testing.assert_allclose(outputs[0], outputs[1])
+        # The parallel build emits the same graph and the same code as the serial one.
+        assert builds[0][0] == builds[1][0]
+        assert builds[0][1] == builds[1][1]
+    finally:
+        engine.set_num_threads(1)
+        engine.clear()
+
+
 def test_compile_placeholder_bypass():
     engine = relay.backend.compile_engine.get()
     x = relay.var("x", shape=(2, 3))
@@ -238,6 +359,9 @@ if __name__ == "__main__":
     test_get_valid_implementations()
     test_select_implementation()
     test_compile_engine()
+    test_compile_engine_object()
+    test_compile_engine_disk_cache()
+    test_compile_engine_lower_batch()
     test_compile_placeholder_bypass()
     test_compile_injective_with_tuple()
     test_compile_tuple_dup()
@@ -14,6 +14,8 @@
 # KIND, either express or implied.  See the License for the
 # specific language governing permissions and limitations
 # under the License.
+import json
+
 import numpy as np
 
 import tvm
@@ -141,6 +143,85 @@ def test_plan_memory():
     assert len(device_types) == 1
 
 
+def test_plan_memory_arena():
+    x = relay.var("x", shape=(10,))
+    z = x
+    for _ in range(6):
+        z = relay.exp(z)
+    func = relay.Function([x], z)
+    mod = tvm.IRModule.from_expr(func)
+    mod = relay.transform.FuseOps(0)(mod)
+    func = mod["main"]
+    smap = relay.backend._backend.GraphPlanMemoryArena(func)
+    storage_ids = set()
+    offsets = set()
+    for k, v in smap.items():
+        assert len(v) == 3
+        for x in v[0]:
+            storage_ids.add(x.value)
+        for x in v[2]:
+            offsets.add(x.value)
+    # Every tensor has its own storage, the input, the last input and
+    # the output of a call are live at the same time.
+    assert len(storage_ids) == 7
+    assert len(offsets) == 3
+
+    report = json.loads(relay.backend._backend.GraphMemoryPlanReport(func))
+    assert report["arena_bytes"] == report["lower_bound_bytes"]
+    assert report["arena_bytes"] < report["pool_bytes"]
+    assert len(report["devices"]) == 1
+    assert report["devices"][0]["num_storages"] == 7
+
+
+def test_run_memory_arena():
+    x = relay.var("x", shape=(10, 5))
+    y = relay.var("y", shape=(1, 5))
+    z = relay.add(x, relay.exp(y))
+    w = relay.exp(z)
+    out = relay.Tuple([relay.add(w, z), relay.exp(w)])
+    func = relay.Function([x, y], out)
+    x_data = np.random.rand(10, 5).astype('float32')
+    y_data = np.random.rand(1, 5).astype('float32')
+    with tvm.transform.PassContext(opt_level=0, graph_memory_arena=True):
+        graph, lib, params = relay.build(tvm.IRModule.from_expr(func), "llvm",
+                                         params={"y": y_data})
+    assert "storage_offset" in json.loads(graph)["attrs"]
+    for data in [graph, graph_runtime.graph_json_to_binary(graph)]:
+        mod = graph_runtime.create(data, lib, ctx=tvm.cpu(0))
+        mod.set_input(**params)
+        mod.set_input(x=x_data)
+        mod.run()
+        ref_z = x_data + np.exp(y_data)
+        tvm.testing.assert_allclose(mod.get_output(0).asnumpy(), np.exp(ref_z) + ref_z, rtol=1e-5)
+        tvm.testing.assert_allclose(mod.get_output(1).asnumpy(), np.exp(np.exp(ref_z)), rtol=1e-5)
+
+    # Two independent chains, whose dead intermediates leave their bytes to the
+    # later ones, run concurrently by the inter-op workers.
+    x = relay.var("x", shape=(64, 64))
+    b, c = x, x
+    for _ in range(4):
+        b = relay.sigmoid(b)
+        c = relay.tanh(c)
+    func = relay.Function([x], relay.add(b, c))
+    with tvm.transform.PassContext(opt_level=0, graph_memory_arena=True):
+        graph, lib, _ = relay.build(tvm.IRModule.from_expr(func), "llvm")
+    attrs = json.loads(graph)["attrs"]
+    storage_ids = attrs["storage_id"][1]
+    offsets = attrs["storage_offset"][1]
+    storage_offsets = dict(zip(storage_ids, offsets))
+    assert len(set(storage_offsets.values())) < len(storage_offsets)
+    x_data = np.random.uniform(-1, 1, size=(64, 64)).astype('float32')
+    ref_b, ref_c = x_data, x_data
+    for _ in range(4):
+        ref_b = 1 / (1 + np.exp(-ref_b))
+        ref_c = np.tanh(ref_c)
+    mod = graph_runtime.create(graph, lib, ctx=tvm.cpu(0))
+    for num_workers in [2, 4]:
+        for _ in range(10):
+            mod.run_parallel(num_workers, x=x_data)
+            tvm.testing.assert_allclose(mod.get_output(0).asnumpy(), ref_b + ref_c, rtol=1e-5)
+
+
 def test_gru_like():
     def unit(rnn_dim):
         X = relay.var("X", shape=(1, rnn_dim))
@@ -180,6 +261,8 @@ def test_gru_like():
 
 if __name__ == "__main__":
     test_plan_memory()
+    test_plan_memory_arena()
+    test_run_memory_arena()
     test_with_params()
     test_add_op_scalar()
     test_add_op_tensor()
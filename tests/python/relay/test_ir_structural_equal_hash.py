@@ -705,6 +705,43 @@ def test_fn_attribute():
     assert not consistent_equal(add_fn, add_1_fn)
 
 
+def test_hash_cache():
+    x = relay.var("x", shape=(10, 10))
+    w = [relay.var("w%d" % i, shape=(10, 10)) for i in range(20)]
+    body = x
+    for wi in w:
+        body = relay.Tuple([relay.add(body, wi), body])[0]
+    func = relay.Function([x] + w, body)
+    cache = tvm.ir.StructuralHashCache()
+    for map_free_vars in [False, True]:
+        expect = tvm.ir.structural_hash(func, map_free_vars)
+        assert tvm.ir.structural_hash(func, map_free_vars, cache) == expect
+        assert tvm.ir.structural_hash(func, map_free_vars, cache) == expect
+    assert len(cache) > 0
+    # A changed function shares the unchanged subterms with the hashed one.
+    let_var = relay.var("y")
+    changed = [
+        relay.Function([x] + w, relay.Tuple([body])),
+        relay.Function([x] + w, relay.Let(let_var, body, relay.add(let_var, body))),
+        relay.Function([x] + w, relay.add(body, x)).with_attr("Primitive", 1),
+        relay.Tuple([func, body, w[3]]),
+        body,
+    ]
+    for expr in changed:
+        for map_free_vars in [False, True]:
+            expect = tvm.ir.structural_hash(expr, map_free_vars)
+            assert tvm.ir.structural_hash(expr, map_free_vars, cache) == expect
+    cache.clear()
+    assert len(cache) == 0
+    # A full cache is cleared before the next hash.
+    small = tvm.ir.StructuralHashCache(max_entries=8)
+    assert tvm.ir.structural_hash(func, False, small) == tvm.ir.structural_hash(func)
+    num_func_entries = len(small)
+    assert num_func_entries > 8
+    assert tvm.ir.structural_hash(body, False, small) == tvm.ir.structural_hash(body)
+    assert len(small) < num_func_entries
+
+
 if __name__ == "__main__":
     test_tensor_type_sequal()
     test_incomplete_type_sequal()
@@ -732,3 +769,4 @@ if __name__ == "__main__":
     test_graph_equal()
     test_hash_unequal()
     test_fn_attribute()
+    test_hash_cache()
@@ -76,13 +76,109 @@ def test_calibrate_memory_bound():
     dataset = get_calibration_dataset("data")
     import multiprocessing
     num_cpu = multiprocessing.cpu_count()
-    with relay.quantize.qconfig(calibrate_mode="kl_divergence",
-                                calibrate_chunk_by=num_cpu):
+    # The calibration streams the batches, the chunking option only warns.
+    with pytest.warns(DeprecationWarning):
+        config = relay.quantize.qconfig(calibrate_mode="kl_divergence",
+                                        calibrate_chunk_by=num_cpu)
+    with config:
         relay.quantize.quantize(mod, params, dataset)
 
 
+@pytest.mark.parametrize("calibrate_mode", ["percentile", "mse"])
+def test_calibrate_modes(calibrate_mode):
+    mod, params = testing.resnet.get_workload(num_layers=18)
+    dataset = get_calibration_dataset("data")
+    with relay.quantize.qconfig(calibrate_mode=calibrate_mode):
+        relay.quantize.quantize(mod, params, dataset)
+
+
+def test_calibration_stats():
+    from tvm.contrib import graph_runtime
+    from tvm.relay.quantize import _quantize
+    x = relay.var("x", shape=(4, 1000))
+    func = relay.Function([x], relay.Tuple([x, x * relay.const(4.0)]))
+    graph, lib, _ = relay.build(tvm.IRModule.from_expr(func), "llvm")
+    runtime = graph_runtime.create(graph, lib, tvm.cpu())
+
+    num_bins = 2001
+    stats = _quantize.CalibrationStats(2, num_bins)
+    # The second batch grows the range of the histograms.
+    for scale in [1.0, 5.0]:
+        runtime.set_input("x", np.random.uniform(-scale, scale, size=(4, 1000)).astype("float32"))
+        runtime.run()
+        _quantize.CalibrationStatsUpdate(stats, runtime.module)
+
+    counts, edges = _quantize.CalibrationStatsHistogram(stats, 0)
+    counts = np.array([c.value for c in counts])
+    edges = np.array([e.value for e in edges])
+    assert counts.sum() == 8000
+    assert len(edges) == num_bins + 1
+    np.testing.assert_allclose(edges[0], -edges[-1], rtol=1e-5)
+    assert edges[-1] >= 5.0 * 0.9
+
+    # The values that are not finite are skipped.
+    runtime.set_input("x", np.array([[np.nan, np.inf, -np.inf, 1.0] * 250] * 4, "float32"))
+    runtime.run()
+    _quantize.CalibrationStatsUpdate(stats, runtime.module)
+    counts, _ = _quantize.CalibrationStatsHistogram(stats, 0)
+    assert sum(c.value for c in counts) == 8000 + 1000
+
+    for mode in ["kl_divergence", "percentile", "mse"]:
+        small, large = [t.value for t in
+                        _quantize.CalibrationStatsFindThresholds(stats, mode, 255, 0.999)]
+        assert 0 < small <= edges[-1]
+        np.testing.assert_allclose(large, 4 * small, rtol=0.05)
+
+    # Nearly all values of a uniform distribution are needed to cover 99.9% of them.
+    small, _ = [t.value for t in
+                _quantize.CalibrationStatsFindThresholds(stats, "percentile", 255, 0.999)]
+    assert small > 4.5
+
+
+def test_calibrate_zero_layer():
+    from tvm.contrib import graph_runtime
+    from tvm.relay.quantize import _quantize
+    # The first convolution has zero weights, the layers after it only see zeros.
+    data = relay.var("data", shape=(1, 3, 16, 16))
+    conv = relay.nn.conv2d(data, relay.var("weight0"), kernel_size=(3, 3),
+                           padding=(1, 1), channels=8)
+    act = relay.nn.relu(conv)
+    out = relay.nn.conv2d(act, relay.var("weight1"), kernel_size=(3, 3),
+                          padding=(1, 1), channels=8)
+    mod, params = testing.create_workload(relay.Function(relay.analysis.free_vars(out), out))
+    params["weight0"] = tvm.nd.array(np.zeros(params["weight0"].shape, "float32"))
+    dataset = [{"data": np.random.uniform(size=(1, 3, 16, 16)).astype("float32")}
+               for _ in range(2)]
+
+    x = relay.var("x", shape=(4, 10))
+    func = relay.Function([x], relay.Tuple([x * relay.const(0.0)]))
+    graph, lib, _ = relay.build(tvm.IRModule.from_expr(func), "llvm")
+    runtime = graph_runtime.create(graph, lib, tvm.cpu())
+    stats = _quantize.CalibrationStats(1, 2001)
+    runtime.set_input("x", np.random.uniform(-1, 1, size=(4, 10)).astype("float32"))
+    runtime.run()
+    _quantize.CalibrationStatsUpdate(stats, runtime.module)
+    for mode in ["kl_divergence", "percentile", "mse"]:
+        thresholds = _quantize.CalibrationStatsFindThresholds(stats, mode, 255, 0.999)
+        assert thresholds[0].value > 0
+
+    for mode in ["kl_divergence", "percentile", "mse"]:
+        with relay.quantize.qconfig(calibrate_mode=mode, skip_conv_layers=[]):
+            qmod = relay.quantize.quantize(mod, params, dataset)
+        graph, lib, qparams = relay.build(qmod, "llvm")
+        runtime = graph_runtime.create(graph, lib, tvm.cpu())
+        runtime.set_input(**qparams)
+        runtime.set_input("data", dataset[0]["data"])
+        runtime.run()
+        assert np.all(np.isfinite(runtime.get_output(0).asnumpy()))
+
+
 if __name__ == "__main__":
     test_mul_rewrite()
     test_calibrate_target(False)
     test_calibrate_target(True)
     test_calibrate_memory_bound()
+    test_calibrate_modes("percentile")
+    test_calibrate_modes("mse")
+    test_calibration_stats()
+    test_calibrate_zero_layer()
@@ -499,6 +499,121 @@ def test_sequential_with_scoping():
     assert tvm.ir.structural_equal(zz, zexpected)
 
 
+def test_pass_context_object_arena():
+    shape = (1, 2, 3)
+    c_data = np.array(shape).astype("float32")
+    tp = relay.TensorType(shape, "float32")
+    def before():
+        c = relay.const(c_data)
+        x = relay.var("x", tp)
+        y = relay.add(c, c)
+        y = relay.multiply(y, relay.const(2, "float32"))
+        y = relay.add(x, y)
+        z = relay.add(y, c)
+        z1 = relay.add(y, c)
+        return relay.Function([x], relay.add(z, z1))
+
+    seq = _transform.Sequential([
+        relay.transform.InferType(),
+        relay.transform.FoldConstant(),
+        relay.transform.EliminateCommonSubexpr(),
+        relay.transform.FuseOps(),
+    ])
+
+    with tvm.transform.PassContext(opt_level=3):
+        expected = seq(tvm.IRModule({"main": before()}))
+
+    stats = tvm.transform.object_arena_stats()
+    with tvm.transform.PassContext(opt_level=3, use_object_arena=True):
+        mod = seq(tvm.IRModule({"main": before()}))
+    new_stats = tvm.transform.object_arena_stats()
+    assert new_stats["num_objects"] > stats["num_objects"]
+    assert new_stats["num_pages"] > stats["num_pages"]
+
+    # The nodes that outlive the passes stay valid.
+    tvm.ir.assert_structural_equal(mod["main"], expected["main"])
+    mod = relay.transform.InferType()(mod)
+    tvm.ir.assert_structural_equal(mod["main"], expected["main"])
+
+
+def test_pass_instrument():
+    shape = (1, 2, 3)
+    tp = relay.TensorType(shape, "float32")
+    x = relay.var("x", tp)
+    y = relay.add(x, relay.add(relay.const(1, "float32"), relay.const(1, "float32")))
+    z = relay.add(relay.multiply(y, y), relay.multiply(y, y))
+    func = relay.Function([x], z)
+
+    seq = _transform.Sequential([
+        relay.transform.InferType(),
+        relay.transform.FoldConstant(),
+        relay.transform.EliminateCommonSubexpr(),
+    ])
+
+    events = []
+    instrument = tvm.transform.pass_instrument(
+        lambda mod, info: events.append(("before", info.name)),
+        lambda mod, info: events.append(("after", info.name)))
+    timing = tvm.transform.PassTimingInstrument()
+    with tvm.transform.PassContext(opt_level=3, instruments=[instrument, timing]):
+        mod = seq(tvm.IRModule({"main": func}))
+
+    # The passes of the sequential are nested in its own calls, and the
+    # required InferType runs before EliminateCommonSubexpr.
+    names = ["InferType", "FoldConstant", "InferType", "EliminateCommonSubexpr"]
+    assert events[0] == ("before", "sequential")
+    assert events[-1] == ("after", "sequential")
+    assert len([e for e in events if e[0] == "before"]) * 2 == len(events)
+
+    report = timing.report()
+    assert len(report["passes"]) == 1
+    root = report["passes"][0]
+    assert root["name"] == "sequential"
+    assert [p["name"] for p in root["passes"]] == names
+    assert root["duration_us"] >= sum(p["duration_us"] for p in root["passes"])
+    assert root["num_objects"] >= sum(p["num_objects"] for p in root["passes"])
+    fold = root["passes"][1]
+    assert fold["num_objects"] > 0
+    assert fold["nodes_in"] > 0 and fold["nodes_out"] > 0
+    assert root["nodes_out"] == tvm.transform.count_ir_nodes(mod)
+    summary = {p["name"]: p for p in report["summary"]}
+    assert summary["InferType"]["count"] >= 2
+    assert "EliminateCommonSubexpr" in timing.render()
+
+    timing.reset()
+    assert not timing.report()["passes"]
+
+
+def test_pass_instrument_error():
+    x = relay.var("x", shape=(1, 2, 3))
+    func = relay.Function([x], relay.add(x, relay.const(1, "float32")))
+
+    @tvm.transform.module_pass(opt_level=0)
+    def failing(mod, ctx):
+        raise ValueError("failing pass")
+
+    events = []
+    instrument = tvm.transform.pass_instrument(
+        lambda mod, info: events.append(("before", info.name, mod is None)),
+        lambda mod, info: events.append(("after", info.name, mod is None)))
+    timing = tvm.transform.PassTimingInstrument()
+    with tvm.transform.PassContext(opt_level=3, instruments=[instrument, timing]):
+        with pytest.raises((tvm.error.TVMError, ValueError)):
+            _transform.Sequential([relay.transform.InferType(), failing])(
+                tvm.IRModule({"main": func}))
+        # The after hooks ran for the failed pass and for its sequential, with no module.
+        assert events[-2:] == [("after", "failing", True), ("after", "sequential", True)]
+        relay.build(tvm.IRModule({"main": func}), "llvm")
+
+    # The passes after the failure are not nested in the failed ones.
+    report = timing.report()
+    failed = report["passes"][0]
+    assert failed["name"] == "sequential"
+    assert [p["name"] for p in failed["passes"]] == ["InferType", "failing"]
+    assert not failed["passes"][1]["passes"]
+    assert len(report["passes"]) > 1
+
+
 def test_print_ir(capfd):
     shape = (1, 2, 3)
     tp = relay.TensorType(shape, "float32")
@@ -622,5 +622,105 @@ def test_loop_free_var():
         mod["main"] = relay.Function(relay.analysis.free_vars(ret), ret)
         check_result(args, expected, mod=mod)
 
+def test_vm_best_fit_allocator():
+    ctx = tvm.cpu()
+    # The allocator of the context is shared by the process, restore it for the
+    # other tests once the buffers of the VM are freed.
+    kinds = {1: "naive", 2: "pooled", 3: "best_fit"}
+    prev_kind = kinds[runtime.vm.get_allocator_stats(ctx)["type"]]
+    runtime.vm.set_allocator(ctx, "best_fit")
+    try:
+        check_best_fit_allocator(ctx)
+    finally:
+        runtime.vm.set_allocator(ctx, prev_kind)
+
+
+def check_best_fit_allocator(ctx):
+    x = relay.var('x', shape=(relay.Any(),), dtype='float32')
+    f = relay.Function([x], relay.exp(relay.add(x, x)))
+    mod = tvm.IRModule()
+    mod["main"] = f
+    exe = relay.vm.compile(mod, "llvm")
+    vm = runtime.vm.VirtualMachine(exe)
+    vm.init(ctx)
+    for n in [1000, 1010, 990, 1000, 1020]:
+        x_data = np.random.rand(n).astype('float32')
+        res = vm.invoke("main", x_data)
+        tvm.testing.assert_allclose(res.asnumpy(), np.exp(x_data + x_data),
+                                    rtol=1e-5)
+        del res
+    stats = runtime.vm.get_allocator_stats(ctx)
+    assert stats["num_allocs"] > 0
+    assert stats["hit_rate"] > 0
+    assert stats["peak_reserved_bytes"] == stats["reserved_bytes"]
+
+
+def test_vm_memory_plan():
+    x = relay.var('x', shape=(32, 32), dtype='float32')
+    y1 = relay.annotation.stop_fusion(relay.add(x, x))
+    y2 = relay.annotation.stop_fusion(relay.exp(y1))
+    y3 = relay.annotation.stop_fusion(relay.multiply(y2, y2))
+    y4 = relay.annotation.stop_fusion(relay.subtract(y3, y1))
+    f = relay.Function([x], relay.add(y4, x))
+    mod = tvm.IRModule()
+    mod["main"] = f
+    exe = relay.vm.compile(mod, "llvm")
+    # The intermediates share one arena, only the output is allocated apart.
+    code = exe.bytecode
+    assert code.count("alloc_storage") == 2
+    assert code.count("alloc_tensor") == 5
+
+    x_data = np.random.rand(32, 32).astype('float32')
+    y1_data = x_data + x_data
+    ref_res = np.exp(y1_data) * np.exp(y1_data) - y1_data + x_data
+    res = veval(f, x_data)
+    tvm.testing.assert_allclose(res.asnumpy(), ref_res, rtol=1e-5)
+
+
+def test_vm_batching_server():
+    import threading
+    x = relay.var('x', shape=(relay.Any(), 4), dtype='float32')
+    y = relay.var('y', shape=(relay.Any(), 4), dtype='float32')
+    f = relay.Function([x, y], relay.Tuple([relay.add(x, y), relay.exp(x)]))
+    mod = tvm.IRModule()
+    mod["main"] = f
+    exe = relay.vm.compile(mod, "llvm")
+    server = runtime.vm.BatchingServer(exe, tvm.cpu(), max_batch_size=8,
+                                       max_latency_us=20000, num_workers=2)
+    inputs = [(np.random.rand(n, 4).astype('float32'),
+               np.random.rand(n, 4).astype('float32')) for n in [1, 2, 3, 1, 1, 2, 4, 1]]
+    results = [None] * len(inputs)
+
+    def client(i):
+        results[i] = server.infer(*inputs[i])
+
+    threads = [threading.Thread(target=client, args=(i,)) for i in range(len(inputs))]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    for (x_data, y_data), res in zip(inputs, results):
+        # Lone and batched requests get their outputs on the same context.
+        assert res[0].ctx == tvm.cpu() and res[1].ctx == tvm.cpu()
+        tvm.testing.assert_allclose(res[0].asnumpy(), x_data + y_data, rtol=1e-5)
+        tvm.testing.assert_allclose(res[1].asnumpy(), np.exp(x_data), rtol=1e-5)
+    stats = server.stats()
+    assert stats["num_requests"] == len(inputs)
+    assert stats["num_samples"] == sum(x_data.shape[0] for x_data, _ in inputs)
+    assert stats["num_batches"] <= stats["num_requests"]
+
+    report = server.benchmark(*inputs[0], num_clients=4, num_requests=10)
+    assert report["num_requests"] == 40
+    assert report["mean_batch_requests"] >= 1
+    assert report["p50_latency_us"] <= report["max_latency_us"]
+
+    # The error of a batch reaches its requests, and the server keeps serving.
+    bad = np.random.rand(2, 5).astype('float32')
+    with pytest.raises(tvm.error.TVMError):
+        server.infer(bad, bad)
+    res = server.infer(*inputs[0])
+    tvm.testing.assert_allclose(res[1].asnumpy(), np.exp(inputs[0][0]), rtol=1e-5)
+
+
 if __name__ == "__main__":
     pytest.main([__file__])
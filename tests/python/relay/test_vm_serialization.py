@@ -16,6 +16,8 @@
 # under the License.
 # pylint: disable=invalid-name, missing-docstring, no-else-return
 """Unit tests for the Relay VM serialization and deserialization."""
+import struct
+
 import numpy as np
 
 import tvm
@@ -162,6 +164,40 @@ def test_const():
     tvm.testing.assert_allclose(res.asnumpy(), x_data + 1)
 
 
+def test_bytecode_version():
+    x = relay.var('x', shape=(10, 10), dtype='float32')
+    exe = create_exec(relay.Function([x], x + x))
+    code, lib = exe.save()
+    # The bytecode version follows the 8 bytes of the magic number, an older
+    # layout of the instructions is rejected.
+    old_code = bytearray(code)
+    old_code[8:16] = struct.pack("<Q", 1)
+    try:
+        _vm.Executable.load_exec(old_code, lib)
+        assert False
+    except tvm.error.TVMError:
+        pass
+    _vm.Executable.load_exec(code, lib)
+
+
+def test_mapped_constants():
+    c = relay.const(np.random.rand(10, 10).astype('float32'))
+    x = relay.var('x', shape=(10, 10), dtype='float32')
+    f = relay.Function([x], x + c)
+    exe = create_exec(f)
+    tmp = util.tempdir()
+    path = tmp.relpath("consts.params")
+    exe.save_constants(path)
+    code, lib = exe.save()
+    des_exec = _vm.Executable.load_exec(code, lib)
+    des_exec.load_constants(path)
+    des_vm = _vm.VirtualMachine(des_exec)
+    des_vm.init(tvm.cpu())
+    x_data = np.random.rand(10, 10).astype('float32')
+    res = veval(des_vm, x_data)
+    tvm.testing.assert_allclose(res.asnumpy(), x_data + c.data.asnumpy())
+
+
 def test_if():
     x = relay.var('x', shape=(10, 10))
     y = relay.var('y', shape=(10, 10))
@@ -336,6 +372,8 @@ if __name__ == "__main__":
     test_serializer()
     test_save_load()
     test_const()
+    test_bytecode_version()
+    test_mapped_constants()
     test_if()
     test_loop()
     test_tuple()
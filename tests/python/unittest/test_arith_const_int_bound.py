@@ -284,6 +284,52 @@ def test_size_var_bound():
     assert bd.max_value == bd.POS_INF
 
 
+def test_analyzer_memo():
+    analyzer = tvm.arith.Analyzer()
+    x, y = te.var("x"), te.var("y")
+    analyzer.update(x, tvm.arith.ConstIntBound(0, 9))
+    analyzer.bind(y, tvm.tir.const(3, "int32"))
+    e = x * 2 + y
+
+    def check(fcall, hits, misses):
+        begin = analyzer.memo_stats()
+        fcall()
+        end = analyzer.memo_stats()
+        assert (end[0] - begin[0], end[1] - begin[1]) == (hits, misses)
+
+    def check_bound(max_value, hits, misses):
+        def fcall():
+            assert analyzer.const_int_bound(e).max_value == max_value
+        check(fcall, hits, misses)
+
+    check_bound(21, 0, 1)
+    check_bound(21, 1, 0)
+    simplified = analyzer.simplify(e)
+    def check_simplify():
+        assert analyzer.simplify(e).same_as(simplified)
+    check(check_simplify, 1, 0)
+
+    # the constraint gives a new context
+    with analyzer.constraint_scope(x < 4):
+        check_bound(9, 0, 1)
+        check_bound(9, 1, 0)
+    # the results of the outer context are valid again
+    check_bound(21, 1, 0)
+
+    # binding a var invalidates the results
+    analyzer.update(te.var("z"), tvm.arith.ConstIntBound(0, 1))
+    check_bound(21, 0, 1)
+    analyzer.update(x, tvm.arith.ConstIntBound(0, 1), True)
+    check_bound(5, 0, 1)
+    # so does a var bound in a constraint scope
+    with analyzer.constraint_scope(x < 1):
+        analyzer.bind(te.var("w"), tvm.tir.const(0, "int32"))
+    check_bound(5, 0, 1)
+
+    analyzer.set_memo_capacity(0)
+    check_bound(5, 0, 0)
+
+
 if __name__ == "__main__":
     test_dtype_bound()
     test_cast_bound()
@@ -298,3 +344,4 @@ if __name__ == "__main__":
     test_shift_and_bound()
     test_mix_index_bound()
     test_size_var_bound()
+    test_analyzer_memo()
@@ -14,8 +14,10 @@
 # KIND, either express or implied.  See the License for the
 # specific language governing permissions and limitations
 # under the License.
+import numpy as np
 import tvm
 from tvm import te
+from tvm import relay
 
 def test_const_saveload_json():
     # save load json
@@ -101,7 +103,29 @@ def test_string():
     tvm.ir.assert_structural_equal(s1, s2)
 
 
+def test_binary_saveload():
+    x = tvm.tir.const(1, "int32")
+    y = tvm.tir.const(-10, "int64")
+    smap = tvm.runtime.convert({"x": x, "y": y, "s": tvm.runtime.String("xy\x01z")})
+    arr = tvm.ir.load_binary(tvm.ir.save_binary(tvm.runtime.convert([smap, 1.5])))
+    tvm.ir.assert_structural_equal(arr, [smap, 1.5], map_free_vars=True)
+
+    # relay module with a constant, compare against the json path.
+    data = relay.var("data", shape=(1, 16), dtype="float32")
+    weight = relay.const(np.random.uniform(size=(8, 16)).astype("float32"))
+    func = relay.Function([data], relay.nn.dense(data, weight))
+    mod = tvm.IRModule.from_expr(func)
+    blob = tvm.ir.save_binary(mod)
+    mod_bin = tvm.ir.load_binary(blob)
+    mod_json = tvm.ir.load_json(tvm.ir.save_json(mod))
+    tvm.ir.assert_structural_equal(mod_bin, mod)
+    tvm.ir.assert_structural_equal(mod_bin, mod_json)
+    # saving again gives the same bytes.
+    assert bytes(tvm.ir.save_binary(mod_bin)) == bytes(blob)
+
+
 if __name__ == "__main__":
+    test_binary_saveload()
     test_string()
     test_env_func()
     test_make_node()
@@ -18,6 +18,8 @@ import tvm
 from tvm import te
 import numpy as np
 import json
+import multiprocessing
+import struct
 from tvm import rpc
 from tvm.contrib import util, graph_runtime
 
@@ -123,5 +125,191 @@ def test_graph_simple():
     check_remote()
     check_sharing()
 
+def test_graph_run_parallel():
+    if not tvm.runtime.enabled("llvm"):
+        print("Skip because llvm is not enabled")
+        return
+    from tvm import relay
+    x = relay.var('x', shape=(1, 16))
+    branches = [relay.nn.relu(relay.add(x, relay.const(float(i))))
+                for i in range(4)]
+    y = branches[0]
+    for b in branches[1:]:
+        y = relay.multiply(y, b)
+    func = relay.Function([x], y)
+    graph, lib, _ = relay.build(func, target="llvm")
+    mod = graph_runtime.create(graph, lib, tvm.cpu(0))
+
+    a = np.random.uniform(size=(1, 16)).astype("float32")
+    mod.run(x=a)
+    expected = mod.get_output(0).asnumpy()
+    for num_workers in [0, 1, 2, 4]:
+        mod.run_parallel(num_workers, x=a)
+        out = mod.get_output(0).asnumpy()
+        np.testing.assert_allclose(out, expected, rtol=1e-5)
+
+
+def test_graph_run_parallel_intra_op():
+    if not tvm.runtime.enabled("llvm"):
+        print("Skip because llvm is not enabled")
+        return
+    from tvm import relay
+    # branches large enough for the operators to launch on the thread pool
+    # of the worker that runs them.
+    shape = (64, 256)
+    x = relay.var('x', shape=shape)
+    ws = [np.random.uniform(size=(256, 256)).astype("float32") for _ in range(4)]
+    branches = [relay.nn.relu(relay.nn.dense(x, relay.const(w))) for w in ws]
+    func = relay.Function([x], relay.concatenate(branches, axis=1))
+    graph, lib, _ = relay.build(func, target="llvm")
+    mod = graph_runtime.create(graph, lib, tvm.cpu(0))
+
+    a = np.random.uniform(size=shape).astype("float32")
+    expected = np.concatenate([np.maximum(a.dot(w.T), 0) for w in ws], axis=1)
+    # more workers than cores runs the workers unbound.
+    for num_workers in [2, 3, multiprocessing.cpu_count() + 1]:
+        for _ in range(3):
+            mod.run_parallel(num_workers, x=a)
+            out = mod.get_output(0).asnumpy()
+            np.testing.assert_allclose(out, expected, rtol=1e-4)
+
+
+def test_graph_runtime_pool():
+    if not tvm.runtime.enabled("llvm"):
+        print("Skip because llvm is not enabled")
+        return
+    from tvm import relay
+    x = relay.var('x', shape=(1, 10))
+    y = relay.var('y', shape=(1, 10))
+    func = relay.Function([x, y], relay.add(x, y))
+    x_in = np.ones((1, 10)).astype("float32")
+    graph, lib, params = relay.build(func, target="llvm", params={'x': x_in})
+
+    pool = graph_runtime.create_pool(graph, lib, tvm.cpu(0))
+    pool.load_params(relay.save_param_dict(params))
+    ctxs = [pool.create_execution_context() for _ in range(4)]
+    assert pool.num_contexts == 4
+    assert pool.num_idle == 0
+    inputs = [np.random.uniform(size=(1, 10)).astype("float32") for _ in ctxs]
+    for ctx, a in zip(ctxs, inputs):
+        ctx.set_input(y=a)
+    # The shared parameters cannot be written through a context.
+    param_name = list(params.keys())[0]
+    param_index = [i for i in range(2) if ctxs[0].module["is_param_input"](i)][0]
+    assert ctxs[0].module["is_param_input"](param_name)
+    assert not ctxs[0].module["is_param_input"]("y")
+    for write_param in [lambda: ctxs[0].set_input(**{param_name: x_in * 2}),
+                        lambda: ctxs[0].set_input(param_index, x_in * 2),
+                        lambda: ctxs[0].module["set_input"](param_name, tvm.nd.array(x_in * 2)),
+                        lambda: ctxs[0].load_params(relay.save_param_dict(params))]:
+        try:
+            write_param()
+            assert False
+        except (ValueError, tvm.error.TVMError):
+            pass
+    for ctx in ctxs:
+        ctx.run()
+    for ctx, a in zip(ctxs, inputs):
+        np.testing.assert_equal(ctx.get_output(0).asnumpy(), x_in + a)
+
+    del ctx
+    ctxs = None
+    assert pool.num_idle == 4
+    ctx = pool.create_execution_context()
+    assert pool.num_contexts == 4
+    a = np.random.uniform(size=(1, 10)).astype("float32")
+    ctx.run(y=a)
+    np.testing.assert_equal(ctx.get_output(0).asnumpy(), x_in + a)
+    del ctx
+    pool.release_idle()
+    assert pool.num_contexts == 1
+
+
+def test_graph_load_mapped_params():
+    if not tvm.runtime.enabled("llvm"):
+        print("Skip because llvm is not enabled")
+        return
+    from tvm import relay
+    from tvm.contrib import util
+    x = relay.var('x', shape=(1, 10))
+    w = relay.var('w', shape=(3, 7), dtype="int8")
+    y = relay.var('y', shape=(1, 10))
+    func = relay.Function([x, w, y], relay.Tuple([relay.add(x, y), relay.add(w, w)]))
+    x_in = np.random.uniform(size=(1, 10)).astype("float32")
+    w_in = np.random.randint(-10, 10, size=(3, 7)).astype("int8")
+    graph, lib, params = relay.build(func, target="llvm", params={'x': x_in, 'w': w_in})
+
+    temp = util.tempdir()
+    path = temp.relpath("deploy.params")
+    relay.save_mapped_param_dict(params, path)
+    mod = graph_runtime.create(graph, lib, tvm.cpu(0))
+    mod.load_mapped_params(path)
+    a = np.random.uniform(size=(1, 10)).astype("float32")
+    mod.run(y=a)
+    np.testing.assert_equal(mod.get_output(0).asnumpy(), x_in + a)
+    np.testing.assert_equal(mod.get_output(1).asnumpy(), w_in + w_in)
+    # The storages left to the mapped params are released, loading again still works.
+    mod.load_mapped_params(path)
+    mod.run(y=a)
+    np.testing.assert_equal(mod.get_output(0).asnumpy(), x_in + a)
+
+    pool = graph_runtime.create_pool(graph, lib, tvm.cpu(0))
+    pool.load_mapped_params(path)
+    ctx = pool.create_execution_context()
+    ctx.run(y=a)
+    np.testing.assert_equal(ctx.get_output(0).asnumpy(), x_in + a)
+
+
+def test_graph_binary():
+    if not tvm.runtime.enabled("llvm"):
+        print("Skip because llvm is not enabled")
+        return
+    from tvm import relay
+    x = relay.var('x', shape=(1, 10))
+    y = relay.var('y', shape=(1, 10))
+    z = relay.add(x, y)
+    func = relay.Function([x, y], relay.Tuple([relay.nn.relu(z), relay.multiply(z, y)]))
+    bld_mod = relay.build_module.BuildModule()
+    graph, lib, _ = bld_mod.build(tvm.IRModule.from_expr(func), "llvm")
+    binary = bld_mod.get_graph_binary()
+    assert binary == graph_runtime.graph_json_to_binary(graph)
+    assert len(binary) < len(graph)
+
+    a = np.random.uniform(-1, 1, size=(1, 10)).astype("float32")
+    b = np.random.uniform(-1, 1, size=(1, 10)).astype("float32")
+    expected = [np.maximum(a + b, 0), (a + b) * b]
+    # The graph also loads as bytes, as read from a file.
+    temp = util.tempdir()
+    path = temp.relpath("graph.bin")
+    with open(path, "wb") as fo:
+        fo.write(binary)
+    with open(path, "rb") as fi:
+        binary_bytes = fi.read()
+    for create in [graph_runtime.create, graph_runtime.create_pool]:
+        for data in [binary, binary_bytes]:
+            mod = create(data, lib, tvm.cpu(0))
+            if create is graph_runtime.create_pool:
+                mod = mod.create_execution_context()
+            mod.run(x=a, y=b)
+            for i, ref in enumerate(expected):
+                np.testing.assert_allclose(mod.get_output(i).asnumpy(), ref, rtol=1e-5)
+
+    # A truncated graph, and a string count far beyond the bytes that follow
+    # (after the 8 byte magic and the version), are rejected.
+    huge_count = bytearray(binary)
+    huge_count[12:16] = struct.pack("I", 0xFFFFFFFF)
+    for data in [binary[:-4], huge_count]:
+        try:
+            graph_runtime.create(data, lib, tvm.cpu(0))
+            assert False
+        except tvm.error.TVMError:
+            pass
+
+
 if __name__ == "__main__":
     test_graph_simple()
+    test_graph_run_parallel()
+    test_graph_run_parallel_intra_op()
+    test_graph_runtime_pool()
+    test_graph_load_mapped_params()
+    test_graph_binary()
@@ -132,5 +132,55 @@ def test_graph_simple():
     check_verify()
     check_remote()
 
+def test_graph_profile():
+    if not tvm.runtime.enabled("llvm"):
+        print("Skip because llvm is not enabled")
+        return
+    n = 4
+    A = te.placeholder((n,), name='A')
+    B = te.compute(A.shape, lambda *i: A(*i) + 1.0, name='B')
+    s = te.create_schedule(B.op)
+    mlib = tvm.build(s, [A, B], "llvm", name="myadd")
+
+    node0 = {"op": "null", "name": "x", "inputs": []}
+    node1 = {"op": "tvm_op", "name": "add",
+             "inputs": [[0, 0, 0]],
+             "attrs": {"func_name": "myadd",
+                       "flatten_data": "1",
+                       "num_inputs": "1",
+                       "num_outputs": "1",
+                       "flops": "4"}}
+    shape = (n,)
+    graph = json.dumps({
+        "nodes": [node0, node1],
+        "arg_nodes": [0],
+        "node_row_ptr": [0, 1, 2],
+        "heads": [[1, 0, 0]],
+        "attrs": {
+            "shape": ["list_shape", [shape, shape]],
+            "dltype": ["list_str", ["float32", "float32"]],
+            "storage_id": ["list_int", [0, 1]],
+        }})
+    try:
+        mod = graph_runtime.create(graph, mlib, tvm.cpu(0))
+    except ValueError:
+        return
+    mod.set_input(x=np.random.uniform(size=(n,)).astype(A.dtype))
+
+    profile = mod.profile(number=3)
+    events = profile["traceEvents"]
+    assert len(events) == 3
+    assert all(event["name"] == 'add' and event["ph"] == 'X' for event in events)
+    assert all(event["args"]["bytes"] == 2 * n * 4 for event in events)
+    summary = profile["summary"]
+    assert len(summary) == 1
+    assert summary[0]["count"] == 3
+    assert summary[0]["flops"] == 4
+    assert summary[0]["flops_per_byte"] == 4 / (2 * n * 4)
+    # The counter increments are never negative, even when they are scaled.
+    assert all(value >= 0 for value in summary[0].get("counters", {}).values())
+    mod.exit()
+
 if __name__ == "__main__":
     test_graph_simple()
+    test_graph_profile()
@@ -101,6 +101,43 @@ def test_rpc_array():
     fremote = remote.get_function("rpc.test.remote_array_func")
     fremote(r_cpu)
 
+def test_rpc_pipeline():
+    if not tvm.runtime.enabled("rpc"):
+        return
+    # larger than one copy chunk, uploads are not waited for.
+    x = np.random.uniform(size=(3, 1 << 18)).astype("float32")
+    @tvm.register_func("rpc.test.remote_pipeline_check")
+    def remote_pipeline_check(y, i):
+        np.testing.assert_equal(y.asnumpy(), x + i)
+    server = rpc.Server("localhost")
+    remote = rpc.connect(server.host, server.port)
+    ctx = remote.cpu(0)
+    arrs = [tvm.nd.array(x + i, ctx) for i in range(4)]
+    fcheck = remote.get_function("rpc.test.remote_pipeline_check")
+    for i, arr in enumerate(arrs):
+        fcheck(arr, i)
+        np.testing.assert_equal(arr.asnumpy(), x + i)
+
+    n = 1024
+    A = te.placeholder((n,), name='A')
+    B = te.compute(A.shape, lambda *i: A(*i) + 1.0, name='B')
+    s = te.create_schedule(B.op)
+    if not tvm.runtime.enabled("llvm"):
+        return
+    temp = util.tempdir()
+    f = tvm.build(s, [A, B], "llvm", name="myadd")
+    path_dso = temp.relpath("dev_lib.so")
+    f.export_library(path_dso)
+    remote.upload(path_dso)
+    f1 = remote.load_module("dev_lib.so")
+    for _ in range(3):
+        a_np = np.random.uniform(size=n).astype(A.dtype)
+        a = tvm.nd.array(a_np, ctx)
+        b = tvm.nd.empty((n,), B.dtype, ctx)
+        b_local = tvm.nd.empty((n,), B.dtype)
+        remote.call_and_fetch(f1, "myadd", [a, b], [(b, b_local)])
+        np.testing.assert_equal(b_local.asnumpy(), a_np + 1)
+
 def test_rpc_file_exchange():
     if not tvm.runtime.enabled("rpc"):
         return
@@ -340,6 +377,7 @@ if __name__ == "__main__":
     test_rpc_remote_module()
     test_rpc_file_exchange()
     test_rpc_array()
+    test_rpc_pipeline()
     test_rpc_simple()
     test_local_func()
     test_rpc_tracker_register()
@@ -37,5 +37,14 @@ def test_basic():
     print("\n{}".format(vm.get_stat()))
     print("\n{}".format(vm.get_stat(False)))
 
+    profile = vm.get_profile()
+    assert len(profile["traceEvents"]) > 0
+    assert all(op["count"] > 0 and op["bytes"] > 0 for op in profile["summary"])
+    # The VM has no estimate of the flops of its ops.
+    assert all("flops" not in op for op in profile["summary"])
+    assert all("flops" not in event["args"] for event in profile["traceEvents"])
+    vm.reset()
+    assert len(vm.get_profile()["traceEvents"]) == 0
+
 if __name__ == "__main__":
     test_basic()
@@ -352,6 +352,48 @@ def test_multiple_func():
 
 
 
+def test_llvm_codegen_threads():
+    n = 256
+    A = te.placeholder((n,), name='A')
+    B = te.placeholder((n,), name='B')
+    funcs = []
+    for i, fcompute in enumerate([lambda i: A[i] + B[i],
+                                  lambda i: A[i] * B[i],
+                                  lambda i: A[i] - B[i] * 2.0,
+                                  lambda i: te.exp(A[i]) + B[i]]):
+        C = te.compute(A.shape, fcompute, name='C')
+        s = te.create_schedule(C.op)
+        xo, xi = s[C].split(C.op.axis[0], factor=4)
+        s[C].parallel(xo)
+        s[C].vectorize(xi)
+        funcs.append(tvm.lower(s, [A, B, C], name="f%d" % i))
+    a_np = np.random.uniform(size=n).astype(A.dtype)
+    b_np = np.random.uniform(size=n).astype(B.dtype)
+    expected = [a_np + b_np, a_np * b_np, a_np - b_np * 2.0, np.exp(a_np) + b_np]
+
+    def check(m):
+        ctx = tvm.cpu(0)
+        a = tvm.nd.array(a_np, ctx)
+        b = tvm.nd.array(b_np, ctx)
+        for i, c_np in enumerate(expected):
+            c = tvm.nd.array(np.zeros(n, dtype=A.dtype), ctx)
+            m["f%d" % i](a, b, c)
+            tvm.testing.assert_allclose(c.asnumpy(), c_np, rtol=1e-5)
+
+    def check_llvm(target):
+        if not tvm.runtime.enabled("llvm"):
+            return
+        m = tvm.build(funcs, target)
+        check(m)
+        temp = util.tempdir()
+        path_dso = temp.relpath("lib.so")
+        m.export_library(path_dso)
+        check(tvm.runtime.load_module(path_dso))
+
+    check_llvm("llvm -codegen-threads=3")
+    check_llvm("llvm -codegen-threads=0")
+
+
 def test_llvm_condition():
     def check_llvm(n, offset):
         if not tvm.runtime.enabled("llvm"):
@@ -693,6 +735,7 @@ def test_llvm_shuffle():
 
 if __name__ == "__main__":
     test_multiple_func()
+    test_llvm_codegen_threads()
     test_llvm_large_uintimm()
     test_llvm_import()
     test_alignment()
@@ -0,0 +1,44 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import tvm
+from tvm import te
+
+
+def test_estimate_flops_matmul():
+    n = 16
+    A = te.placeholder((n, n), name='A')
+    B = te.placeholder((n, n), name='B')
+    k = te.reduce_axis((0, n), name='k')
+    C = te.compute((n, n), lambda i, j: te.sum(A[i, k] * B[k, j], axis=k), name='C')
+    s = te.create_schedule(C.op)
+    mod = tvm.lower(s, [A, B, C], name="main")
+    # one multiply and one add per iteration, the index arithmetic is not counted.
+    assert tvm.tir.analysis.estimate_flops(mod["main"]) == 2 * n * n * n
+
+
+def test_estimate_flops_unknown():
+    n = te.var("n")
+    A = te.placeholder((n,), name='A')
+    B = te.compute(A.shape, lambda i: A[i] + 1.0, name="B")
+    s = te.create_schedule(B.op)
+    mod = tvm.lower(s, [A, B], name="main")
+    assert tvm.tir.analysis.estimate_flops(mod["main"]) == -1
+
+
+if __name__ == "__main__":
+    test_estimate_flops_matmul()
+    test_estimate_flops_unknown()